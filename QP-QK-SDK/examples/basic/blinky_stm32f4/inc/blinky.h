@@ -13,6 +13,7 @@
 
 #include "qpc.h"
 #include "project_config.h"
+#include "time_wheel.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -26,6 +27,7 @@ enum BlinkySignals {
     TIMEOUT_SIG = Q_USER_SIG,   // Timer timeout signal
     BUTTON_SIG,                 // Button press signal
     TICK_SIG,                   // System tick signal
+    FLOW_BENCH_SIG,             // Flow benchmark fan-out (FLOW_BENCH=1)
     MAX_SIG                     // Keep last
 };
 
@@ -42,7 +44,7 @@ enum BlinkySignals {
 typedef struct {
     QActive super;              /**< Inherit from QActive base class */
     
-    QTimeEvt timeEvt;          /**< Timer event for periodic blinking */
+    AppTimeEvt timeEvt;        /**< Timer event for periodic blinking */
     
     uint32_t blink_count;      /**< Number of blinks performed */
     bool is_running;           /**< Running state flag */
@@ -121,6 +123,32 @@ QState Blinky_on(Blinky * const me, QEvt const * const e);
  */
 #define BLINKY_QUEUE_LEN        10U
 
+/**
+ * @brief TICK_SIG rate
+ * 
+ * Rate at which the tick divider posts TICK_SIG to the Blinky AO.
+ */
+#define BLINKY_TICK_HZ          10U
+
+/**
+ * @brief Latency probe setup (make LAT_PROBE=1)
+ * 
+ * EXTI0 -> BUTTON_SIG is measured on channel LAT_CH_BUTTON. The load AOs
+ * run one priority above Blinky (delays BUTTON_SIG handling) and one
+ * below (preempted by it; only its critical sections add latency).
+ */
+#define LAT_CH_BUTTON           0U
+#define AO_LOAD_HI_PRIO         (AO_BLINKY_PRIO + 1U)
+#define AO_LOAD_LO_PRIO         (AO_BLINKY_PRIO - 1U)
+
+/**
+ * @brief Event-flow benchmark setup (make FLOW_BENCH=1, make bench)
+ * 
+ * The benchmark source runs above the load AOs and its sinks above it, so
+ * a run is not disturbed by Blinky or the latency probe.
+ */
+#define AO_FLOW_BENCH_PRIO      (AO_LOAD_HI_PRIO + 1U)
+
 /**
  * @brief QS trace records for Blinky
  * 
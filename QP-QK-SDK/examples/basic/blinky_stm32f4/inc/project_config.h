@@ -30,6 +30,16 @@ extern "C" {
 // QK kernel configuration
 #define QK_PREEMPTION_PRIO      32U          // Maximum priority levels
 
+// Kernel-aware ISR entry/exit: QK needs them, the cooperative QV kernel
+// (make KERNEL=qv) does not. The QP port on the include path decides.
+#ifdef QK_ISR_ENTRY
+#define BSP_ISR_ENTRY()         QK_ISR_ENTRY()
+#define BSP_ISR_EXIT()          QK_ISR_EXIT()
+#else
+#define BSP_ISR_ENTRY()         ((void)0)
+#define BSP_ISR_EXIT()          ((void)0)
+#endif
+
 //============================================================================
 // ACTIVE OBJECT PRIORITIES
 //============================================================================
@@ -44,7 +54,7 @@ enum ActiveObjectPriorities {
 // EVENT POOL CONFIGURATION
 //============================================================================
 
-// Memory pools for events
+// Memory pools for events (resized by tools/analyzers/pool_sizer.py)
 #define SMALL_EVENT_POOL_SIZE   10U
 #define MEDIUM_EVENT_POOL_SIZE  5U
 #define LARGE_EVENT_POOL_SIZE   2U
@@ -76,7 +86,15 @@ enum ActiveObjectPriorities {
 #define QS_UART_TX_PIN          GPIO_PIN_2
 #define QS_UART_RX_PIN          GPIO_PIN_3
 #define QS_UART_AF              GPIO_AF7_USART2
-#define QS_UART_BAUDRATE        115200U
+#define QS_UART_BAUDRATE        921600U
+
+// QS trace transport: USART2 DMA (default) or SWO/ITM for faster probes
+#define QS_TRANSPORT_UART_DMA   1U
+#define QS_TRANSPORT_SWO        2U
+#define QS_TRANSPORT            QS_TRANSPORT_UART_DMA
+#define QS_SWO_BAUDRATE         2000000U
+#define QS_DMA_BLOCK_SIZE       256U
+#define QS_RX_DMA_SIZE          64U
 
 //============================================================================
 // QS SOFTWARE TRACING CONFIGURATION
@@ -86,7 +104,11 @@ enum ActiveObjectPriorities {
     // QS buffer sizes
     #define QS_TX_BUFFER_SIZE   2048U
     #define QS_RX_BUFFER_SIZE   256U
+    #ifdef QS_COMPACT_ENABLE
+    #define QS_TSTAMP_SIZE      2U    // Unrolled on the host via SYNC records
+    #else
     #define QS_TSTAMP_SIZE      4U
+    #endif
     
     // Enable all QS trace groups for debugging
     #define QS_GLB_FILTER_INIT  QS_ALL_RECORDS
@@ -98,6 +120,7 @@ enum ActiveObjectPriorities {
         QS_USER_02,             // Timing information
         QS_USER_03,             // Performance data
         QS_USER_04              // Reset events
+        // NOTE: QS_USER + 15..24 are reserved for templates/services
     };
     
 #endif // Q_SPY
@@ -158,8 +181,11 @@ void BSP_ledOn(uint8_t led);
 void BSP_ledOff(uint8_t led);
 void BSP_ledToggle(uint8_t led);
 uint32_t BSP_getTime(void);
-uint32_t BSP_getTimeUs(void);
+uint32_t BSP_getTimeUs(void);     // TIM2, 1 us, wraps every ~71 min
+uint64_t BSP_getTimeUs64(void);   // TIM5:TIM2, lock-free 64-bit read
+uint32_t BSP_cycles(void);              // DWT cycle counter (profiling)
 void BSP_tickHook(void);
+uint32_t BSP_tickAdvance(void);        // Ticks covered by this SysTick IRQ
 
 //============================================================================
 // QS SOFTWARE TRACING INTERFACE
@@ -170,6 +196,7 @@ void BSP_tickHook(void);
     void QS_onCleanup(void);
     void QS_onFlush(void);
     QSTimeCtr QS_onGetTime(void);
+    void BSP_qsPoll(void);
     void QS_onCommand(uint8_t cmdId, uint32_t param1, 
                       uint32_t param2, uint32_t param3);
 #endif
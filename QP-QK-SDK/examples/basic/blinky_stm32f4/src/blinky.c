@@ -13,6 +13,10 @@
  */
 
 #include "blinky.h"
+#include "tick_divider.h"
+#include "qs_compact.h"
+#include "latency_probe.h"
+#include "qs_dict.h"
 
 Q_DEFINE_THIS_FILE
 
@@ -30,6 +34,21 @@ Q_DEFINE_THIS_FILE
 // The single instance of the Blinky Active Object
 Blinky AO_Blinky;
 
+#ifdef Q_SPY
+// QS dictionaries of the Blinky AO (qs_dict.h)
+static QS_DICT_TABLE(Blinky) = {
+    QS_DICT_OBJ(&AO_Blinky),
+    QS_DICT_OBJ(&AO_Blinky.timeEvt),
+
+    QS_DICT_SIG(TIMEOUT_SIG, &AO_Blinky),
+    QS_DICT_SIG(BUTTON_SIG, &AO_Blinky),
+
+    QS_DICT_FUN(&Blinky_initial),
+    QS_DICT_FUN(&Blinky_off),
+    QS_DICT_FUN(&Blinky_on),
+};
+#endif
+
 //============================================================================
 // LOCAL FUNCTION PROTOTYPES
 //============================================================================
@@ -47,7 +66,7 @@ void Blinky_ctor(void) {
     QActive_ctor(&me->super, Q_STATE_CAST(&Blinky_initial));
     
     // Initialize time event for periodic blinking
-    QTimeEvt_ctorX(&me->timeEvt, &me->super, TIMEOUT_SIG, 0U);
+    APP_TIMEEVT_CTOR(&me->timeEvt, &me->super, TIMEOUT_SIG);
     
     // Initialize private data
     me->blink_count = 0U;
@@ -63,18 +82,10 @@ QState Blinky_initial(Blinky * const me, QEvt const * const e) {
     
     // Subscribe to published events
     QActive_subscribe(&me->super, BUTTON_SIG);
-    QActive_subscribe(&me->super, TICK_SIG);
+    TickDiv_subscribe(&me->super, BSP_TICKS_PER_SEC / BLINKY_TICK_HZ);
     
     // QS trace
-    QS_OBJ_DICTIONARY(&AO_Blinky);
-    QS_OBJ_DICTIONARY(&AO_Blinky.timeEvt);
-    
-    QS_SIG_DICTIONARY(TIMEOUT_SIG, &AO_Blinky);
-    QS_SIG_DICTIONARY(BUTTON_SIG, &AO_Blinky);
-    
-    QS_FUN_DICTIONARY(&Blinky_initial);
-    QS_FUN_DICTIONARY(&Blinky_off);
-    QS_FUN_DICTIONARY(&Blinky_on);
+    QS_DICT_SEND(Blinky);
     
     // Start in the "off" state
     return Q_TRAN(&Blinky_off);
@@ -90,11 +101,11 @@ QState Blinky_off(Blinky * const me, QEvt const * const e) {
             me->is_running = true;
             
             // Arm the timer for next blink
-            QTimeEvt_armX(&me->timeEvt, BLINK_PERIOD_TICKS, 0U);
+            APP_TIMEEVT_ARM(&me->timeEvt, BLINK_PERIOD_TICKS, 0U);
             
             // QS trace
             QS_BEGIN_ID(QS_USER_00, AO_Blinky.super.prio)
-                QS_STR_("LED OFF");
+                QS_STR_ID_("LED OFF");
                 QS_U32_(me->blink_count);
             QS_END_()
             
@@ -104,7 +115,7 @@ QState Blinky_off(Blinky * const me, QEvt const * const e) {
         
         case Q_EXIT_SIG: {
             // Exit action: disarm the timer
-            QTimeEvt_disarm(&me->timeEvt);
+            APP_TIMEEVT_DISARM(&me->timeEvt);
             status_ = Q_HANDLED();
             break;
         }
@@ -116,12 +127,15 @@ QState Blinky_off(Blinky * const me, QEvt const * const e) {
         }
         
         case BUTTON_SIG: {
+            // Close the EXTI0 latency sample before any other work
+            LAT_PROBE_DISPATCH(LAT_CH_BUTTON);
+            
             // Button pressed - toggle error LED
             BSP_ledToggle(3);  // Error LED (LD5)
             
             // QS trace
             QS_BEGIN_ID(QS_USER_01, AO_Blinky.super.prio)
-                QS_STR_("BUTTON");
+                QS_STR_ID_("BUTTON");
                 QS_U8_(0);  // Pressed in OFF state
             QS_END_()
             
@@ -130,7 +144,7 @@ QState Blinky_off(Blinky * const me, QEvt const * const e) {
         }
         
         case TICK_SIG: {
-            // System tick - count ticks (every 10th tick)
+            // Tick at BLINKY_TICK_HZ - count ticks (every 10th tick)
             if ((me->blink_count % 10U) == 0U) {
                 // Periodic processing in OFF state
                 // Could be used for power management, etc.
@@ -158,18 +172,18 @@ QState Blinky_on(Blinky * const me, QEvt const * const e) {
             me->blink_count++;
             
             // Arm the timer for next blink
-            QTimeEvt_armX(&me->timeEvt, BLINK_PERIOD_TICKS, 0U);
+            APP_TIMEEVT_ARM(&me->timeEvt, BLINK_PERIOD_TICKS, 0U);
             
             // QS trace
             QS_BEGIN_ID(QS_USER_00, AO_Blinky.super.prio)
-                QS_STR_("LED ON");
+                QS_STR_ID_("LED ON");
                 QS_U32_(me->blink_count);
             QS_END_()
             
             // Performance demonstration: measure entry time
             uint32_t entry_time = BSP_getTimeUs();
             QS_BEGIN_ID(QS_USER_02, AO_Blinky.super.prio)
-                QS_STR_("ENTRY_TIME");
+                QS_STR_ID_("ENTRY_TIME");
                 QS_U32_(entry_time);
             QS_END_()
             
@@ -179,7 +193,7 @@ QState Blinky_on(Blinky * const me, QEvt const * const e) {
         
         case Q_EXIT_SIG: {
             // Exit action: disarm the timer
-            QTimeEvt_disarm(&me->timeEvt);
+            APP_TIMEEVT_DISARM(&me->timeEvt);
             status_ = Q_HANDLED();
             break;
         }
@@ -191,12 +205,15 @@ QState Blinky_on(Blinky * const me, QEvt const * const e) {
         }
         
         case BUTTON_SIG: {
+            // Close the EXTI0 latency sample before any other work
+            LAT_PROBE_DISPATCH(LAT_CH_BUTTON);
+            
             // Button pressed - toggle error LED
             BSP_ledToggle(3);  // Error LED (LD5)
             
             // QS trace
             QS_BEGIN_ID(QS_USER_01, AO_Blinky.super.prio)
-                QS_STR_("BUTTON");
+                QS_STR_ID_("BUTTON");
                 QS_U8_(1);  // Pressed in ON state
             QS_END_()
             
@@ -205,14 +222,14 @@ QState Blinky_on(Blinky * const me, QEvt const * const e) {
         }
         
         case TICK_SIG: {
-            // System tick - performance monitoring
-            // Every 1000 ticks (1 second), report statistics
+            // Tick at BLINKY_TICK_HZ - performance monitoring
+            // Every BLINKY_TICK_HZ ticks (1 second), report statistics
             static uint32_t tick_counter = 0U;
             
-            if ((++tick_counter % 1000U) == 0U) {
+            if ((++tick_counter % BLINKY_TICK_HZ) == 0U) {
                 // Report performance statistics
                 QS_BEGIN_ID(QS_USER_03, AO_Blinky.super.prio)
-                    QS_STR_("PERFORMANCE");
+                    QS_STR_ID_("PERFORMANCE");
                     QS_U32_(me->blink_count);
                     QS_U32_(tick_counter);
                 QS_END_()
@@ -250,7 +267,7 @@ static void Blinky_performBlink(Blinky * const me, uint8_t led_state) {
     
     // QS trace
     QS_BEGIN_ID(QS_USER_00, me->super.prio)
-        QS_STR_(led_state ? "LED ON" : "LED OFF");
+        QS_STR_ID_(led_state ? "LED ON" : "LED OFF");
         QS_U32_(me->blink_count);
     QS_END_()
 }
@@ -275,6 +292,6 @@ void Blinky_reset(void) {
     
     // QS trace
     QS_BEGIN_ID(QS_USER_04, me->super.prio)
-        QS_STR_("RESET");
+        QS_STR_ID_("RESET");
     QS_END_()
 }
\ No newline at end of file
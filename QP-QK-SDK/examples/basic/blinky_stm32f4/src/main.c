@@ -6,10 +6,23 @@
  * 
  * Main application file for the Blinky example using QP/QK framework.
  * Demonstrates proper QK initialization and Active Object startup.
+ * Builds unchanged for the cooperative QV kernel with make KERNEL=qv.
  */
 
 #include "project_config.h"
 #include "blinky.h"
+#include "rtc_profiler.h"
+#include "pool_monitor.h"
+#include "queue_monitor.h"
+#include "tick_divider.h"
+#include "tickless.h"
+#include "qs_compact.h"
+#include "latency_probe.h"
+#include "trace_replay.h"
+#include "time_wheel.h"
+#include "qs_dict.h"
+#include "qs_filter.h"
+#include "flow_bench.h"
 
 Q_DEFINE_THIS_FILE
 
@@ -50,6 +63,21 @@ static QSubscrList l_subscrSto[MAX_SIG];
 static uint8_t l_qsTxBuf[QS_TX_BUFFER_SIZE];
 static uint8_t l_qsRxBuf[QS_RX_BUFFER_SIZE];
 
+// QS dictionaries of this module (qs_dict.h)
+static QS_DICT_TABLE(main) = {
+    // User-defined trace records
+    QS_DICT_USR(QS_USER_00),    // LED state
+    QS_DICT_USR(QS_USER_01),    // Button events
+    QS_DICT_USR(QS_USER_02),    // Timing info
+    QS_DICT_USR(QS_USER_03),    // Performance
+    QS_DICT_USR(QS_USER_04),    // Reset events
+
+    // Signal dictionary for readable trace output
+    QS_DICT_SIG(TIMEOUT_SIG, (void *)0),
+    QS_DICT_SIG(BUTTON_SIG, (void *)0),
+    QS_DICT_SIG(TICK_SIG, (void *)0),
+};
+
 #endif // Q_SPY
 
 //============================================================================
@@ -63,15 +91,30 @@ int main(void) {
     
     // Initialize Board Support Package
     BSP_init();
+    FLOW_BENCH_INIT(BSP_SYSTEM_CLOCK_HZ / 1000000U); // Boot time from here
+    
+    // Start RTC profiler time base (no-op unless RTC_PROF_ENABLE)
+    RTC_PROF_INIT(BSP_SYSTEM_CLOCK_HZ / 1000000U);
+    LAT_PROBE_INIT(BSP_SYSTEM_CLOCK_HZ / 1000000U);
     
     // Initialize event pools
     QF_poolInit(l_smlPoolSto, sizeof(l_smlPoolSto), sizeof(l_smlPoolSto[0]));
     QF_poolInit(l_medPoolSto, sizeof(l_medPoolSto), sizeof(l_medPoolSto[0]));
     QF_poolInit(l_lrgPoolSto, sizeof(l_lrgPoolSto), sizeof(l_lrgPoolSto[0]));
     
+    // Monitor the pools in QF pool ID order (no-op unless POOL_MON_ENABLE)
+    POOL_MON_INIT(BSP_TICKS_PER_SEC);
+    QUEUE_MON_INIT(BSP_TICKS_PER_SEC);
+    POOL_MON_REGISTER(l_smlPoolSto, sizeof(l_smlPoolSto), sizeof(l_smlPoolSto[0]));
+    POOL_MON_REGISTER(l_medPoolSto, sizeof(l_medPoolSto), sizeof(l_medPoolSto[0]));
+    POOL_MON_REGISTER(l_lrgPoolSto, sizeof(l_lrgPoolSto), sizeof(l_lrgPoolSto[0]));
+    
     // Initialize publish-subscribe mechanism
     QActive_psInit(l_subscrSto, Q_DIM(l_subscrSto));
     
+    // TICK_SIG fan-out (AOs call TickDiv_subscribe() with their period)
+    TickDiv_init(TICK_SIG);
+    
 #ifdef Q_SPY
     // Initialize QS software tracing
     if (!QS_INIT(l_qsTxBuf, sizeof(l_qsTxBuf), 
@@ -79,24 +122,21 @@ int main(void) {
         Q_ERROR();
     }
     
+    // Compact trace mode: string dictionary + SYNC (no-op unless enabled)
+    QS_COMPACT_INIT();
+    
     // Setup QS filters
     QS_GLB_FILTER(QS_ALL_RECORDS);   // Enable all QS records
     QS_GLB_FILTER(-QS_QF_TICK);      // Disable tick records (too frequent)
     
+    // Per-AO filters start from this setting (no-op unless QS_FILT=1)
+    QS_FILT_INIT(BSP_SYSTEM_CLOCK_HZ / 1000000U);
+    
     // Enable local filters for Blinky AO
     QS_LOC_FILTER(QS_AO_OBJ, &AO_Blinky);
     
-    // User-defined trace records
-    QS_USR_DICTIONARY(QS_USER_00);   // LED state
-    QS_USR_DICTIONARY(QS_USER_01);   // Button events
-    QS_USR_DICTIONARY(QS_USER_02);   // Timing info
-    QS_USR_DICTIONARY(QS_USER_03);   // Performance
-    QS_USR_DICTIONARY(QS_USER_04);   // Reset events
-    
-    // Signal dictionary for readable trace output
-    QS_SIG_DICTIONARY(TIMEOUT_SIG, (void *)0);
-    QS_SIG_DICTIONARY(BUTTON_SIG, (void *)0);
-    QS_SIG_DICTIONARY(TICK_SIG, (void *)0);
+    // Dictionaries (only their build IDs with QS_DICT_ROM=1)
+    QS_DICT_SEND(main);
     
 #endif // Q_SPY
     
@@ -109,8 +149,18 @@ int main(void) {
                   (void *)0,        // Stack storage (not used in QK)
                   0U,               // Stack size (not used in QK)
                   (void *)0);       // Initialization parameter
+    RTC_PROF_ATTACH(&AO_Blinky.super, MAX_RTC_DURATION_MS * 1000U);
+    QUEUE_MON_ATTACH(&AO_Blinky.super);
+    QS_FILT_ATTACH(&AO_Blinky.super);  // After RTC_PROF_ATTACH
+    
+    // Background load for the latency probe (idle until QS command 11)
+    LAT_PROBE_LOAD_START(0U, AO_LOAD_HI_PRIO);
+    LAT_PROBE_LOAD_START(1U, AO_LOAD_LO_PRIO);
     
-    // Transfer control to QK kernel
+    // Event-flow benchmark AOs (idle until QS command 24, FLOW_BENCH=1)
+    FLOW_BENCH_START(AO_FLOW_BENCH_PRIO, FLOW_BENCH_SIG);
+    
+    // Transfer control to the kernel (QK or QV)
     return QF_run();
 }
 
@@ -119,11 +169,14 @@ int main(void) {
 //============================================================================
 
 void QF_onStartup(void) {
+    FLOW_BENCH_BOOTED();   // End of the boot time measurement
+    
     // Enable interrupts that are used by the application
     
     // Configure system tick for QF
     SystemCoreClockUpdate();
     SysTick_Config(SystemCoreClock / BSP_TICKS_PER_SEC);
+    TICKLESS_INIT();   // SysTick from HCLK/8 for long tickless periods
     
     // Set interrupt priorities for QK kernel
     // SysTick has the lowest priority among kernel-aware interrupts
@@ -132,6 +185,9 @@ void QF_onStartup(void) {
     // Enable button interrupt
     NVIC_SetPriority(BUTTON_EXTI_IRQn, QF_AWARE_ISR_CMSIS_PRI + 2U);
     NVIC_EnableIRQ(BUTTON_EXTI_IRQn);
+
+    // Trace the button events for host replay (REPLAY_CAPTURE=1)
+    REPLAY_CAPTURE_START(&SysTick_Handler);
 }
 
 void QF_onCleanup(void) {
@@ -139,10 +195,8 @@ void QF_onCleanup(void) {
     BSP_terminate(0);
 }
 
-void QK_onIdle(void) {
-    // Called when no Active Objects are ready to run
-    // This is an ideal place for power management
-    
+// Idle work of both kernels (interrupts enabled)
+static void idleWork(void) {
     // Toggle heartbeat LED to show system is alive
     static uint32_t idle_counter = 0;
     if ((++idle_counter % 100000U) == 0U) {
@@ -154,33 +208,64 @@ void QK_onIdle(void) {
     
     // QS trace output during idle time
 #ifdef Q_SPY
+    BSP_qsPoll();  // Move RX DMA bytes to QS-RX, hand next TX block to DMA
     QS_rxParse();  // Parse QS-RX input
-    QS_doOutput(); // Perform QS-TX output
 #endif
 }
 
+#ifdef QK_ISR_ENTRY
+
+void QK_onIdle(void) {
+    // Called when no Active Objects are ready to run
+    // This is an ideal place for power management
+    idleWork();
+    
+    // Tickless idle: sleep until the nearest time event instead of
+    // waking up every tick (no-op unless TICKLESS_IDLE_ENABLE)
+    TICKLESS_IDLE();
+}
+
+#else // QV
+
+void QV_onIdle(void) {
+    // Called with interrupts disabled: sleep before the idle work, so a
+    // post made by an ISR in between cannot be slept through
+#ifdef TICKLESS_IDLE_ENABLE
+    TICKLESS_IDLE();       // Returns with interrupts enabled
+#else
+    QF_INT_ENABLE();
+#endif
+    idleWork();
+}
+
+#endif // QK_ISR_ENTRY
+
 //============================================================================
 // QK KERNEL HOOKS
 //============================================================================
 
+#ifdef QK_ISR_ENTRY
+
 void QK_onContextSw(QActive *prev, QActive *next) {
-    // Called on every context switch in QK
-    // Useful for profiling and debugging
+    // Called on every context switch in QK (with interrupts disabled)
+    // prev or next is NULL when switching from/to the idle loop
     
 #ifdef Q_SPY
     QS_BEGIN_ID(QS_SCHED_PREEMPT, 0U)
         QS_TIME_();                           // Timestamp
-        QS_2U8_((uint8_t)prev->prio,          // Previous AO priority
-                (uint8_t)next->prio);         // Next AO priority
+        QS_2U8_((uint8_t)((prev != (QActive *)0) ? prev->prio : 0U),
+                (uint8_t)((next != (QActive *)0) ? next->prio : 0U));
     QS_END_()
 #endif
     
-    // Performance monitoring
-    // Can be used to measure context switch overhead
+    // Performance monitoring: exclude preemption time from RTC steps
+    RTC_PROF_CONTEXT_SW(prev, next);
     (void)prev;
     (void)next;
 }
 
+#endif // QK_ISR_ENTRY (QV has no context switches: AOs run to completion)
+
 //============================================================================
 // ASSERTION AND ERROR HANDLING
 //============================================================================
@@ -217,20 +302,32 @@ void Q_onAssert(char const *module, int loc) {
 //============================================================================
 
 void SysTick_Handler(void) {
-    // Kernel-aware interrupt handling for QK
-    QK_ISR_ENTRY();   // Inform QK kernel about ISR entry
+    // Kernel-aware interrupt handling (QK; nothing to do for QV)
+    BSP_ISR_ENTRY();  // Inform the kernel about ISR entry
+    FLOW_BENCH_TICK_BEGIN();
     
-    // Publish system tick event to all subscribers
-    static QEvt const tick_evt = QEVT_INITIALIZER(TICK_SIG);
-    QACTIVE_PUBLISH(&tick_evt, &SysTick_Handler);
-    
-    // Process QF time events
-    QTIMEEVT_TICK_X(0U, &SysTick_Handler);
-    
-    // Call BSP tick hook for application-specific processing
-    BSP_tickHook();
+    // Ticks covered by this interrupt (more than one after tickless sleep)
+    uint32_t nTicks = BSP_tickAdvance();
+    while (nTicks != 0U) {
+        --nTicks;
+        REPLAY_CAPTURE_TICK();   // Replay tick count (REPLAY_CAPTURE=1)
+        
+        // Post TICK_SIG only to subscribers whose period has elapsed
+        // (ticks are coalescible: dropped rather than filling a queue)
+        TickDiv_tick(&SysTick_Handler);
+        
+        // Process QF time events (and the time wheel, if enabled)
+        TIME_WHEEL_TICK(&SysTick_Handler);
+        
+        // Call BSP tick hook for application-specific processing
+        BSP_tickHook();
+        POOL_MON_TICK();
+        QUEUE_MON_TICK();
+        QS_COMPACT_TICK();
+    }
     
-    QK_ISR_EXIT();    // Inform QK kernel about ISR exit
+    FLOW_BENCH_TICK_END();
+    BSP_ISR_EXIT();   // Inform the kernel about ISR exit
 }
 
 //============================================================================
@@ -238,20 +335,25 @@ void SysTick_Handler(void) {
 //============================================================================
 
 void EXTI0_IRQHandler(void) {
-    // QK-aware interrupt entry
-    QK_ISR_ENTRY();
+    // Latency probe entry stamp, before anything else (LAT_PROBE=1)
+    LAT_PROBE_ISR_ENTRY(LAT_CH_BUTTON);
+    
+    // Kernel-aware interrupt entry
+    BSP_ISR_ENTRY();
     
     // Handle button interrupt
     if (__HAL_GPIO_EXTI_GET_IT(BUTTON_PIN) != 0x00U) {
         __HAL_GPIO_EXTI_CLEAR_IT(BUTTON_PIN);
         
-        // Post button event to system
+        // Post button event to system (never shed: ticks are, see
+        // TickDiv_tick())
         static QEvt const button_evt = QEVT_INITIALIZER(BUTTON_SIG);
+        LAT_PROBE_POSTED(LAT_CH_BUTTON);
         QACTIVE_PUBLISH(&button_evt, &EXTI0_IRQHandler);
     }
     
-    // QK-aware interrupt exit
-    QK_ISR_EXIT();
+    // Kernel-aware interrupt exit
+    BSP_ISR_EXIT();
 }
 
 //============================================================================
@@ -308,6 +410,72 @@ void QS_onCommand(uint8_t cmdId, uint32_t param1,
             NVIC_SystemReset();
             break;
         }
+        case 4U: {
+            // Command 4: Report RTC profile (param1 = AO prio, 0 = all)
+            RTC_PROF_REPORT((uint_fast8_t)param1);
+            break;
+        }
+        case 5U: {
+            // Command 5: Reset RTC profile statistics
+            RTC_PROF_RESET();
+            break;
+        }
+        case 6U: {
+            // Command 6: Report event pool usage
+            POOL_MON_REPORT();
+            break;
+        }
+        case 7U: {
+            // Command 7: Report AO queue usage (param1 = AO prio, 0 = all)
+            QUEUE_MON_REPORT((uint_fast8_t)param1);
+            break;
+        }
+        case 8U: {
+            // Command 8: Re-send the compact QS string dictionary
+            QS_COMPACT_DUMP();
+            break;
+        }
+        case 9U: {
+            // Command 9: Report latency probe (param1 = channel + 1, 0 = all)
+            LAT_PROBE_REPORT((uint_fast8_t)param1);
+            break;
+        }
+        case 10U: {
+            // Command 10: Reset latency probe statistics
+            LAT_PROBE_RESET();
+            break;
+        }
+        case 11U: {
+            // Command 11: Load AO param1: busy param3 us every param2 ticks
+            LAT_PROBE_LOAD((uint_fast8_t)param1, param2, param3);
+            break;
+        }
+        case 12U: {
+            // Command 12: EXTI0 edge generator, param1 = mean us (0 = off)
+            LAT_PROBE_GEN(param1);
+            break;
+        }
+        case 21U: {
+            // Command 21: Per-AO QS filter (param1 prio, 0 = all, 0xFF = non-AO;
+            // param2 group mask, 0xFFFF = global; param3 0 set, 1 add, 2 remove)
+            QS_FILT_SET(param1, param2, param3);
+            break;
+        }
+        case 22U: {
+            // Command 22: Report the QS filters and trace cost (param1 prio, 0 = all)
+            QS_FILT_REPORT(param1);
+            break;
+        }
+        case 23U: {
+            // Command 23: Reset the trace cost counters (start a new window)
+            QS_FILT_RESET();
+            break;
+        }
+        case 24U: {
+            // Command 24: Event-flow benchmark (param1 rounds, 0 = default)
+            FLOW_BENCH_RUN(param1);
+            break;
+        }
         default: {
             break;
         }
@@ -10,6 +10,9 @@
  */
 
 #include "{{AO_NAME_LOWER}}.h"
+#include "pool_monitor.h"
+#include "tick_divider.h"
+#include "multicast.h"
 
 Q_DEFINE_THIS_FILE
 
@@ -20,6 +23,11 @@ Q_DEFINE_THIS_FILE
 // Internal timing constants
 #define PERIODIC_TIMEOUT_TICKS  (BSP_TICKS_PER_SEC / {{FREQUENCY}})
 #define WATCHDOG_TIMEOUT_TICKS  (BSP_TICKS_PER_SEC * {{TIMEOUT_VALUE}} / 1000U)
+#define TICK_DIV_PERIOD_TICKS   \
+    ({{AO_NAME_UPPER}}_TICK_PERIOD_MS * BSP_TICKS_PER_SEC / 1000U)
+
+// A TICK_SIG period below one system tick would round down to 0
+Q_ASSERT_STATIC(TICK_DIV_PERIOD_TICKS >= 1U);
 
 // Internal state flags
 #define FLAG_INITIALIZED        (1U << 0)
@@ -65,8 +73,10 @@ void {{AO_NAME}}_ctor(void) {
     QActive_ctor(&me->super, Q_STATE_CAST(&{{AO_NAME}}_initial));
     
     // Initialize time events
-    QTimeEvt_ctorX(&me->timeEvt, &me->super, {{AO_NAME_UPPER}}_TIMEOUT_SIG, 0U);
-    QTimeEvt_ctorX(&me->timeoutEvt, &me->super, {{AO_NAME_UPPER}}_TIMEOUT_SIG, 0U);
+    APP_TIMEEVT_CTOR(&me->timeEvt, &me->super, {{AO_NAME_UPPER}}_TIMEOUT_SIG);
+    APP_TIMEEVT_CTOR(&me->timeoutEvt, &me->super, {{AO_NAME_UPPER}}_TIMEOUT_SIG);
+    WorkChunk_ctor(&me->work, &me->super, {{AO_NAME_UPPER}}_WORK_SIG,
+                   {{AO_NAME_UPPER}}_WORK_BUDGET_US);
     
     // Initialize private data members
     me->counter = 0U;
@@ -101,9 +111,9 @@ QState {{AO_NAME}}_initial({{AO_NAME}} * const me, QEvt const * const e) {
     {{AO_NAME_UPPER}}_TRACE_STATE_ENTRY(initial);
     
     // Subscribe to published events that this AO needs
-    QActive_subscribe(&me->super, TICK_SIG);
-    QActive_subscribe(&me->super, FAULT_SIG);
-    QActive_subscribe(&me->super, MODE_CHANGE_SIG);
+    TickDiv_subscribe(&me->super, TICK_DIV_PERIOD_TICKS);
+    Mcast_subscribe(&me->super, FAULT_SIG);       // MCAST_PUBLISH()ed
+    Mcast_subscribe(&me->super, MODE_CHANGE_SIG);
     
     // {{SUBSCRIPTION_LIST}}
     
@@ -216,6 +226,7 @@ QState {{AO_NAME}}_active({{AO_NAME}} * const me, QEvt const * const e) {
         case Q_EXIT_SIG: {
             // Exit actions for active state
             {{AO_NAME}}_stopPeriodicTimer(me);
+            WorkChunk_cancel(&me->work);
             
             // {{ACTIVE_EXIT_ACTIONS}}
             
@@ -255,15 +266,22 @@ QState {{AO_NAME}}_active({{AO_NAME}} * const me, QEvt const * const e) {
             break;
         }
         
+        case {{AO_NAME_UPPER}}_WORK_SIG: {
+            // Next chunk of a long operation (also while paused)
+            if (WorkChunk_run(&me->work)) {
+                // {{WORK_DONE_ACTIONS}}
+            }
+            
+            status_ = Q_HANDLED();
+            break;
+        }
+        
         case TICK_SIG: {
-            // System tick - increment counter
+            // Tick every {{AO_NAME_UPPER}}_TICK_PERIOD_MS - increment counter
             me->counter++;
             
-            // Check for periodic processing
-            if ((me->counter % 100U) == 0U) {
-                // Periodic processing every 100 ticks
-                // {{PERIODIC_PROCESSING}}
-            }
+            // Periodic processing
+            // {{PERIODIC_PROCESSING}}
             
             status_ = Q_HANDLED();
             break;
@@ -360,12 +378,11 @@ QState {{AO_NAME}}_running({{AO_NAME}} * const me, QEvt const * const e) {
             // Timeout event from periodic timer
             {{AO_NAME_UPPER}}_TRACE_EVENT({{AO_NAME_UPPER}}_TIMEOUT_SIG);
             
-            // Perform main operation
+            // Perform main operation (timeEvt is periodic, armed in active)
+            // Anything longer than {{AO_NAME_UPPER}}_WORK_BUDGET_US goes into
+            // a step function: WorkChunk_start(&me->work, step, ctx)
             // {{MAIN_OPERATION_CODE}}
             
-            // Restart the timer for next cycle
-            QTimeEvt_armX(&me->timeEvt, PERIODIC_TIMEOUT_TICKS, 0U);
-            
             status_ = Q_HANDLED();
             break;
         }
@@ -382,6 +399,8 @@ QState {{AO_NAME}}_running({{AO_NAME}} * const me, QEvt const * const e) {
             break;
         }
         
+        // {{RUNNING_EVENT_HANDLERS}}
+        
         default: {
             status_ = Q_SUPER(&{{AO_NAME}}_active);
             break;
@@ -406,7 +425,7 @@ QState {{AO_NAME}}_paused({{AO_NAME}} * const me, QEvt const * const e) {
             
             // Entry actions for paused sub-state
             // Stop periodic processing
-            QTimeEvt_disarm(&me->timeEvt);
+            APP_TIMEEVT_DISARM(&me->timeEvt);
             
             // {{PAUSED_ENTRY_ACTIONS}}
             
@@ -416,6 +435,9 @@ QState {{AO_NAME}}_paused({{AO_NAME}} * const me, QEvt const * const e) {
         
         case Q_EXIT_SIG: {
             // Exit actions for paused sub-state
+            // Resume the periodic timer the active state expects running
+            {{AO_NAME}}_startPeriodicTimer(me);
+            
             // {{PAUSED_EXIT_ACTIONS}}
             
             status_ = Q_HANDLED();
@@ -461,7 +483,7 @@ QState {{AO_NAME}}_error({{AO_NAME}} * const me, QEvt const * const e) {
             me->error_count++;
             
             // Start watchdog timer for recovery attempt
-            QTimeEvt_armX(&me->timeoutEvt, WATCHDOG_TIMEOUT_TICKS, 0U);
+            APP_TIMEEVT_ARM(&me->timeoutEvt, WATCHDOG_TIMEOUT_TICKS, 0U);
             
             // {{ERROR_ENTRY_ACTIONS}}
             
@@ -472,7 +494,7 @@ QState {{AO_NAME}}_error({{AO_NAME}} * const me, QEvt const * const e) {
         case Q_EXIT_SIG: {
             // Exit actions for error state
             me->config_flags &= ~FLAG_ERROR_STATE;
-            QTimeEvt_disarm(&me->timeoutEvt);
+            APP_TIMEEVT_DISARM(&me->timeoutEvt);
             
             // {{ERROR_EXIT_ACTIONS}}
             
@@ -489,7 +511,7 @@ QState {{AO_NAME}}_error({{AO_NAME}} * const me, QEvt const * const e) {
                 // Too many errors - stay in error state
                 // Reset error count for next attempt
                 me->error_count = 0U;
-                QTimeEvt_armX(&me->timeoutEvt, WATCHDOG_TIMEOUT_TICKS, 0U);
+                APP_TIMEEVT_ARM(&me->timeoutEvt, WATCHDOG_TIMEOUT_TICKS, 0U);
                 status_ = Q_HANDLED();
             }
             break;
@@ -530,7 +552,7 @@ static void {{AO_NAME}}_initializeHardware({{AO_NAME}} * const me) {
  */
 static void {{AO_NAME}}_startPeriodicTimer({{AO_NAME}} * const me) {
     // Arm the periodic time event
-    QTimeEvt_armX(&me->timeEvt, PERIODIC_TIMEOUT_TICKS, PERIODIC_TIMEOUT_TICKS);
+    APP_TIMEEVT_ARM(&me->timeEvt, PERIODIC_TIMEOUT_TICKS, PERIODIC_TIMEOUT_TICKS);
 }
 
 /**
@@ -538,7 +560,7 @@ static void {{AO_NAME}}_startPeriodicTimer({{AO_NAME}} * const me) {
  */
 static void {{AO_NAME}}_stopPeriodicTimer({{AO_NAME}} * const me) {
     // Disarm the periodic time event
-    QTimeEvt_disarm(&me->timeEvt);
+    APP_TIMEEVT_DISARM(&me->timeEvt);
 }
 
 /**
@@ -547,14 +569,14 @@ static void {{AO_NAME}}_stopPeriodicTimer({{AO_NAME}} * const me) {
 static void {{AO_NAME}}_handleError({{AO_NAME}} * const me, uint16_t error_code) {
     // Log the error
 #ifdef Q_SPY
-    QS_BEGIN_ID({{AO_NAME_UPPER}}_ERROR_DETECTED, AO_{{AO_NAME}}->prio)
+    QS_BEGIN_ID({{AO_NAME_UPPER}}_ERROR_DETECTED, AO_{{AO_NAME}}.super.prio)
         QS_U16_(error_code);
         QS_TIME_();
     QS_END_()
 #endif
     
     // Create and post error event to self
-    {{AO_NAME}}ErrorEvt *err_evt = Q_NEW({{AO_NAME}}ErrorEvt, {{AO_NAME_UPPER}}_ERROR_SIG);
+    {{AO_NAME}}ErrorEvt *err_evt = POOL_MON_NEW({{AO_NAME}}ErrorEvt, {{AO_NAME_UPPER}}_ERROR_SIG);
     err_evt->error_code = error_code;
     err_evt->error_data = me->counter;
     err_evt->error_msg = "{{AO_NAME}} Error";
@@ -14,6 +14,9 @@
 
 #include "qpc.h"
 #include "project_template.h"
+#include "qs_compact.h"
+#include "work_chunk.h"
+#include "time_wheel.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -35,9 +38,12 @@ extern "C" {
 typedef struct {
     QActive super;              /**< Inherit from QActive base class */
     
-    // Time events for this Active Object
-    QTimeEvt timeEvt;          /**< Periodic time event */
-    QTimeEvt timeoutEvt;       /**< Timeout event */
+    // Time events for this Active Object (QTimeEvt or wheel, time_wheel.h)
+    AppTimeEvt timeEvt;        /**< Periodic time event */
+    AppTimeEvt timeoutEvt;     /**< Timeout event */
+    
+    // Long operations, run in RTC-sized chunks (WORK_SIG)
+    WorkChunk work;            /**< Chunked operation in progress */
     
     // Private state variables
     uint32_t counter;          /**< Internal counter */
@@ -95,6 +101,7 @@ enum {{AO_NAME}}Signals {
     {{AO_NAME_UPPER}}_CONFIG_SIG,                   /**< Configuration */
     {{AO_NAME_UPPER}}_TIMEOUT_SIG,                  /**< Timeout occurred */
     {{AO_NAME_UPPER}}_ERROR_SIG,                    /**< Error condition */
+    {{AO_NAME_UPPER}}_WORK_SIG,                     /**< Next work chunk */
     
     // {{CUSTOM_SIGNALS}}
     
@@ -162,16 +169,26 @@ QState {{AO_NAME}}_paused({{AO_NAME}} * const me, QEvt const * const e);
  * 
  * This defines the maximum time any event handler in this
  * Active Object should take to complete. Critical for QK
- * real-time performance.
+ * real-time performance. Pass it to RTC_PROF_ATTACH() to have
+ * the RTC profiler (templates/services) report violations.
  */
 #define {{AO_NAME_UPPER}}_MAX_RTC_TIME_US    {{MAX_RTC_TIME}}U
 
+/**
+ * @brief Time per chunk of a long operation (work_chunk.h)
+ * 
+ * Half the RTC budget leaves room for the other events that are
+ * dispatched between two chunks.
+ */
+#define {{AO_NAME_UPPER}}_WORK_BUDGET_US    ({{AO_NAME_UPPER}}_MAX_RTC_TIME_US / 2U)
+
 /**
  * @brief Event queue depth
  * 
  * Size of the event queue for this Active Object.
  * Should be sized based on expected event arrival rate
- * and processing time.
+ * and processing time. QUEUE_MON_ATTACH() (templates/services)
+ * reports the measured high-water mark and arrival rates.
  */
 #define {{AO_NAME_UPPER}}_QUEUE_LEN         {{QUEUE_LENGTH}}U
 
@@ -189,6 +206,9 @@ QState {{AO_NAME}}_paused({{AO_NAME}} * const me, QEvt const * const e);
 
 /**
  * @brief Periodic timer intervals
+ * 
+ * TICK_PERIOD_MS is the rate at which the tick divider posts TICK_SIG
+ * to this AO (templates/services/tick_divider.h).
  */
 #define {{AO_NAME_UPPER}}_TICK_PERIOD_MS    {{TICK_PERIOD}}U
 #define {{AO_NAME_UPPER}}_TIMEOUT_MS        {{TIMEOUT_VALUE}}U
@@ -224,13 +244,13 @@ enum {{AO_NAME}}TraceRecords {
  * @brief Performance monitoring macros
  */
 #define {{AO_NAME_UPPER}}_TRACE_STATE_ENTRY(state) \
-    QS_BEGIN_ID({{AO_NAME_UPPER}}_STATE_ENTRY, AO_{{AO_NAME}}->prio) \
-        QS_STR_(#state); \
+    QS_BEGIN_ID({{AO_NAME_UPPER}}_STATE_ENTRY, AO_{{AO_NAME}}.super.prio) \
+        QS_STR_ID_(#state); \
         QS_TIME_(); \
     QS_END_()
 
 #define {{AO_NAME_UPPER}}_TRACE_EVENT(sig) \
-    QS_BEGIN_ID({{AO_NAME_UPPER}}_EVENT_RECEIVED, AO_{{AO_NAME}}->prio) \
+    QS_BEGIN_ID({{AO_NAME_UPPER}}_EVENT_RECEIVED, AO_{{AO_NAME}}.super.prio) \
         QS_SIG_(sig); \
         QS_TIME_(); \
     QS_END_()
@@ -292,6 +312,7 @@ void {{AO_NAME}}_test_injectEvent(QEvt const * const e);
  * 
  * QK-Specific Considerations:
  * - All event handlers must complete in bounded time
+ * - Long computations run in chunks via WorkChunk_start() (work_chunk.h)
  * - No blocking operations allowed
  * - Priority assignment should follow RMA principles
  * - Event queue sizing should consider worst-case scenarios
@@ -0,0 +1,239 @@
+/**
+ * @file {{AO_NAME_LOWER}}.c
+ * @brief {{AO_DESCRIPTION}} Sensor Pipeline Active Object Implementation
+ * @version 1.0.0
+ * @date {{GENERATION_DATE}}
+ *
+ * Template for block-based sensor pipelines in QK-based projects.
+ * Each SENSOR_BLOCK_SIG is one RTC step: filter, statistics and spectrum
+ * over DSP_BLOCK_LEN samples, read in place from the BufEvt. The block
+ * returns to the buffer pool when the step ends. Results of
+ * RESULT_DECIMATION blocks are folded into one published
+ * SensorResultEvt.
+ */
+
+#include "{{AO_NAME_LOWER}}.h"
+#include <math.h>
+
+Q_DEFINE_THIS_FILE
+
+#ifndef BUF_POOL_ENABLE
+#error "The sensor pipeline needs BUF_POOL_ENABLE (blocks are BufEvt)"
+#endif
+
+//============================================================================
+// LOCAL CONSTANTS AND MACROS
+//============================================================================
+
+// The DMA block must be whole samples and fit a buffer event
+Q_ASSERT_STATIC({{AO_NAME_UPPER}}_BLOCK_BYTES <= BUF_POOL_BLOCK_SIZE);
+Q_ASSERT_STATIC({{AO_NAME_UPPER}}_RESULT_DECIMATION >= 1U);
+Q_ASSERT_STATIC({{AO_NAME_UPPER}}_RESULT_DECIMATION <= 255U);
+
+// Filter: Butterworth low-pass sections at fs/4, CMSIS-DSP sign convention
+// (b0, b1, b2, a1, a2 per section, a1/a2 negated). Replace for the sensor.
+static float32_t const l_coeffs[] = {
+    0.29289322f, 0.58578644f, 0.29289322f, 0.0f, -0.17157288f,
+    0.29289322f, 0.58578644f, 0.29289322f, 0.0f, -0.17157288f,
+    // {{FILTER_COEFFICIENTS}}
+};
+Q_ASSERT_STATIC(Q_DIM(l_coeffs) == (5U * DSP_BIQUAD_STAGES));
+
+//============================================================================
+// ACTIVE OBJECT INSTANCE
+//============================================================================
+
+{{AO_NAME}} AO_{{AO_NAME}};
+
+//============================================================================
+// LOCAL FUNCTION PROTOTYPES
+//============================================================================
+
+static void {{AO_NAME}}_fold(DspResult * const acc, DspResult const * const r,
+                             uint_fast8_t const n);
+static void {{AO_NAME}}_publish({{AO_NAME}} * const me, uint16_t const seq);
+
+//============================================================================
+// ACTIVE OBJECT CONSTRUCTOR
+//============================================================================
+
+void {{AO_NAME}}_ctor(void) {
+    {{AO_NAME}} * const me = &AO_{{AO_NAME}};
+
+    QActive_ctor(&me->super, Q_STATE_CAST(&{{AO_NAME}}_initial));
+
+    DspChain_init(&me->chain, l_coeffs,
+                  (float32_t){{AO_NAME_UPPER}}_SAMPLE_RATE_HZ);
+    me->nextSeq = 0U;
+    me->folded = 0U;
+    me->blocks = 0U;
+    me->gaps = 0U;
+
+    // {{CONSTRUCTOR_INITIALIZATION}}
+}
+
+//============================================================================
+// STATE MACHINE IMPLEMENTATION
+//============================================================================
+
+/**
+ * @brief Initial transition: blocks are dropped until START
+ */
+QState {{AO_NAME}}_initial({{AO_NAME}} * const me, QEvt const * const e) {
+    (void)e; // Unused parameter
+
+    // {{SUBSCRIPTION_LIST}}
+
+    return Q_TRAN(&{{AO_NAME}}_idle);
+}
+
+/**
+ * @brief Idle state - incoming blocks are recycled unprocessed
+ */
+QState {{AO_NAME}}_idle({{AO_NAME}} * const me, QEvt const * const e) {
+    QState status_;
+
+    switch (e->sig) {
+        case SENSOR_BLOCK_SIG: {
+            // Not processing: QF recycles the block after this step
+            status_ = Q_HANDLED();
+            break;
+        }
+
+        case {{AO_NAME_UPPER}}_START_SIG: {
+            status_ = Q_TRAN(&{{AO_NAME}}_processing);
+            break;
+        }
+
+        default: {
+            status_ = Q_SUPER(&QHsm_top);
+            break;
+        }
+    }
+
+    return status_;
+}
+
+/**
+ * @brief Processing state - one RTC step per sample block
+ */
+QState {{AO_NAME}}_processing({{AO_NAME}} * const me, QEvt const * const e) {
+    QState status_;
+
+    switch (e->sig) {
+        case Q_ENTRY_SIG: {
+            // Start clean: no filter history, no partial decimation
+            DspChain_reset(&me->chain);
+            me->folded = 0U;
+
+            // {{PROCESSING_ENTRY_ACTIONS}}
+
+            status_ = Q_HANDLED();
+            break;
+        }
+
+        case SENSOR_BLOCK_SIG: {
+            BufEvt const * const be = Q_EVT_CAST(BufEvt);
+            uint16_t const n = be->len / (uint16_t)sizeof(int16_t);
+
+            // A gap means the DMA overwrote blocks: the filter history and
+            // the partial decimation no longer belong to this block
+            if ((me->blocks != 0U) && (be->seq != me->nextSeq)) {
+                ++me->gaps;
+                DspChain_reset(&me->chain);
+                me->folded = 0U;
+            }
+            me->nextSeq = (uint16_t)(be->seq + 1U);
+            ++me->blocks;
+
+            if (n != 0U) {
+                DspResult r;
+                DspChain_process(&me->chain, (int16_t const *)be->data,
+                                 (n < DSP_BLOCK_LEN) ? n : (uint16_t)DSP_BLOCK_LEN,
+                                 &r);
+                ++me->folded;
+                {{AO_NAME}}_fold(&me->acc, &r, me->folded);
+
+                // {{BLOCK_PROCESSING}}
+
+                if (me->folded >= {{AO_NAME_UPPER}}_RESULT_DECIMATION) {
+                    {{AO_NAME}}_publish(me, be->seq);
+                    me->folded = 0U;
+                }
+            }
+
+            status_ = Q_HANDLED();
+            break;
+        }
+
+        case {{AO_NAME_UPPER}}_STOP_SIG: {
+            status_ = Q_TRAN(&{{AO_NAME}}_idle);
+            break;
+        }
+
+        // {{PROCESSING_EVENT_HANDLERS}}
+
+        default: {
+            status_ = Q_SUPER(&QHsm_top);
+            break;
+        }
+    }
+
+    return status_;
+}
+
+//============================================================================
+// LOCAL HELPER FUNCTIONS
+//============================================================================
+
+// Fold result r as the n-th block of the decimation window into acc
+static void {{AO_NAME}}_fold(DspResult * const acc, DspResult const * const r,
+                             uint_fast8_t const n)
+{
+    if (n == 1U) {
+        *acc = *r;
+        return;
+    }
+    float32_t const w = 1.0f / (float32_t)n;
+    acc->mean += (r->mean - acc->mean) * w;
+    // RMS of equal-length blocks: mean of the squares
+    float32_t const sq = (acc->rms * acc->rms)
+                         + (((r->rms * r->rms) - (acc->rms * acc->rms)) * w);
+    acc->rms = sqrtf(sq);
+    acc->min = (r->min < acc->min) ? r->min : acc->min;
+    acc->max = (r->max > acc->max) ? r->max : acc->max;
+    if (r->peakAmp > acc->peakAmp) {
+        acc->peakHz = r->peakHz;
+        acc->peakAmp = r->peakAmp;
+    }
+}
+
+static void {{AO_NAME}}_publish({{AO_NAME}} * const me, uint16_t const seq) {
+    SensorResultEvt * const re = Q_NEW(SensorResultEvt, SENSOR_RESULT_SIG);
+    re->sensor_id = {{AO_NAME_UPPER}}_SENSOR_ID;
+    re->seq = seq;
+    re->timestamp = BSP_getTime();
+    re->mean = me->acc.mean;
+    re->rms = me->acc.rms;
+    re->min = me->acc.min;
+    re->max = me->acc.max;
+    re->peak_hz = me->acc.peakHz;
+    re->peak_amp = me->acc.peakAmp;
+    QACTIVE_PUBLISH(&re->super, &me->super);
+}
+
+//============================================================================
+// UNIT TESTING SUPPORT
+//============================================================================
+
+#ifdef UNIT_TEST
+
+uint32_t {{AO_NAME}}_test_getBlocks(void) {
+    return AO_{{AO_NAME}}.blocks;
+}
+
+uint32_t {{AO_NAME}}_test_getGaps(void) {
+    return AO_{{AO_NAME}}.gaps;
+}
+
+#endif // UNIT_TEST
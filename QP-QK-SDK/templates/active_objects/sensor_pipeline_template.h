@@ -0,0 +1,166 @@
+/**
+ * @file {{AO_NAME_LOWER}}.h
+ * @brief {{AO_DESCRIPTION}} Sensor Pipeline Active Object Header
+ * @version 1.0.0
+ * @date {{GENERATION_DATE}}
+ *
+ * Template for block-based sensor pipelines in QK-based projects.
+ * The AO receives DMA-filled sample blocks as zero-copy BufEvt
+ * (templates/services/buf_pool.h). It runs them through the filter,
+ * statistics and spectrum stages of templates/services/dsp_block.h and
+ * publishes only the reduced SensorResultEvt. One event per block instead
+ * of one per sample takes the event overhead out of the sample rate.
+ */
+
+#ifndef {{AO_NAME_UPPER}}_H
+#define {{AO_NAME_UPPER}}_H
+
+#include "qpc.h"
+#include "project_template.h"
+#include "buf_pool.h"
+#include "dsp_block.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//============================================================================
+// ACTIVE OBJECT STRUCTURE
+//============================================================================
+
+/**
+ * @brief {{AO_NAME}} Active Object structure
+ *
+ * The DspChain holds the filter state and the work buffers of the
+ * pipeline (about 2 KB), so they live in the AO and not on the stack.
+ */
+typedef struct {
+    QActive super;              /**< Inherit from QActive base class */
+
+    DspChain chain;             /**< Filter state and block buffers */
+    DspResult acc;              /**< Result folded over the decimation */
+    uint16_t nextSeq;           /**< Expected BufEvt.seq */
+    uint8_t folded;             /**< Blocks folded into acc */
+    uint32_t blocks;            /**< Blocks processed */
+    uint32_t gaps;              /**< Sequence gaps (blocks the DMA dropped) */
+
+    // {{PRIVATE_DATA_MEMBERS}}
+
+} {{AO_NAME}};
+
+//============================================================================
+// ACTIVE OBJECT INTERFACE
+//============================================================================
+
+/**
+ * @brief Global Active Object instance
+ */
+extern {{AO_NAME}} AO_{{AO_NAME}};
+
+/**
+ * @brief Active Object Constructor
+ *
+ * Sets up the DSP chain. Called once during system initialization.
+ */
+void {{AO_NAME}}_ctor(void);
+
+//============================================================================
+// EVENT SIGNALS SPECIFIC TO THIS ACTIVE OBJECT
+//============================================================================
+
+/**
+ * @brief {{AO_NAME}}-specific event signals
+ *
+ * Sample blocks arrive as SENSOR_BLOCK_SIG (posted by a BufStream bound
+ * to this AO), results leave as SENSOR_RESULT_SIG (published).
+ */
+enum {{AO_NAME}}Signals {
+    {{AO_NAME_UPPER}}_START_SIG = {{SIGNAL_BASE}},  /**< Start processing */
+    {{AO_NAME_UPPER}}_STOP_SIG,                     /**< Stop processing */
+
+    // {{CUSTOM_SIGNALS}}
+
+    {{AO_NAME_UPPER}}_MAX_SIG                       /**< Keep last */
+};
+
+//============================================================================
+// STATE MACHINE DECLARATIONS
+//============================================================================
+
+QState {{AO_NAME}}_initial({{AO_NAME}} * const me, QEvt const * const e);
+QState {{AO_NAME}}_idle({{AO_NAME}} * const me, QEvt const * const e);
+QState {{AO_NAME}}_processing({{AO_NAME}} * const me, QEvt const * const e);
+
+//============================================================================
+// CONFIGURATION PARAMETERS
+//============================================================================
+
+/**
+ * @brief Input of the pipeline
+ *
+ * Pass BLOCK_BYTES as the length to BufStream_init(). SAMPLE_RATE_HZ is
+ * the rate the DMA is paced at (converts FFT bins to Hz).
+ */
+#define {{AO_NAME_UPPER}}_SENSOR_ID         {{SENSOR_ID}}U
+#define {{AO_NAME_UPPER}}_SAMPLE_RATE_HZ    {{SAMPLE_RATE_HZ}}U
+#define {{AO_NAME_UPPER}}_BLOCK_BYTES       (DSP_BLOCK_LEN * sizeof(int16_t))
+
+/**
+ * @brief Blocks folded into one published SensorResultEvt
+ */
+#define {{AO_NAME_UPPER}}_RESULT_DECIMATION {{RESULT_DECIMATION}}U
+
+/**
+ * @brief Maximum Run-to-Completion time for this AO
+ *
+ * One block is one RTC step. Pass it to RTC_PROF_ATTACH() to check that
+ * the DSP stages fit; if they do not, shorten DSP_BLOCK_LEN.
+ */
+#define {{AO_NAME_UPPER}}_MAX_RTC_TIME_US   {{MAX_RTC_TIME}}U
+
+/**
+ * @brief Event queue depth
+ *
+ * Blocks in flight between the DMA and this AO. BUF_POOL_BLOCKS bounds
+ * them anyway, so a few entries are enough.
+ */
+#define {{AO_NAME_UPPER}}_QUEUE_LEN         {{QUEUE_LENGTH}}U
+
+//============================================================================
+// UNIT TESTING SUPPORT
+//============================================================================
+
+#ifdef UNIT_TEST
+uint32_t {{AO_NAME}}_test_getBlocks(void);
+uint32_t {{AO_NAME}}_test_getGaps(void);
+#endif // UNIT_TEST
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // {{AO_NAME_UPPER}}_H
+
+/**
+ * @brief Template Usage Instructions for AI Agents
+ *
+ * 1. Replace all {{TEMPLATE_VARIABLES}} with actual values
+ * 2. Bind the DMA stream to this AO in the BSP:
+ *    BufStream_init(&l_adcStream, &AO_{{AO_NAME}}.super,
+ *                   SENSOR_BLOCK_SIG, {{AO_NAME_UPPER}}_BLOCK_BYTES);
+ * 3. Replace the filter coefficients in the .c file for the application
+ * 4. Build the target with -DDSP_USE_CMSIS -DARM_MATH_CM4 and link
+ *    CMSIS-DSP (libarm_cortexM4lf_math.a); the host build uses the
+ *    portable kernels
+ *
+ * Template Variables to Replace:
+ * - {{AO_NAME_UPPER}}, {{AO_NAME_LOWER}}, {{AO_NAME}}: AO name
+ * - {{AO_DESCRIPTION}}: Brief description of the AO's purpose
+ * - {{GENERATION_DATE}}: Date of code generation
+ * - {{SIGNAL_BASE}}: Base signal number for this AO
+ * - {{SENSOR_ID}}: SensorResultEvt.sensor_id of the results
+ * - {{SAMPLE_RATE_HZ}}: Sample rate of the DMA'd input
+ * - {{RESULT_DECIMATION}}: Blocks per published result (1 = every block)
+ * - {{MAX_RTC_TIME}}: Maximum run-to-completion time in microseconds
+ * - {{QUEUE_LENGTH}}: Event queue depth
+ */
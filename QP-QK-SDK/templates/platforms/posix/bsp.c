@@ -0,0 +1,1061 @@
+/**
+ * @file bsp.c
+ * @brief Board Support Package for POSIX Host Builds
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * Implements the BSP_* API of the STM32F4 template on Linux/POSIX for the
+ * QP posix-qv port: monotonic-clock time base, simulated LEDs, QS tracing
+ * as a TCP client of QSPY, and a load generator thread that injects
+ * events into AO queues at a fixed rate for host-side load tests. With
+ * REPLAY_ENABLE, --replay runs a captured trace instead (trace_replay.h):
+ * a replay thread takes over the clock and the time base from the ticker.
+ * With BRIDGE_ENABLE, --bridge connects a bridge link (bridge.h) to a
+ * peer process over UDP, one frame per datagram.
+ *
+ * QS is implemented here instead of linking the port's qs_port.c, so the
+ * transport matches the target BSP (BSP_qsPoll()) and can be pointed at
+ * any QSPY with --qs host:port, or turned off for pure load runs.
+ */
+
+#if !defined(_POSIX_C_SOURCE) && !defined(_GNU_SOURCE)
+#define _POSIX_C_SOURCE 200809L   // clock_nanosleep(), getaddrinfo()
+#endif
+#if defined(REPLAY_ENABLE) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE           // syscall() for perf_event_open()
+#endif
+
+#include "project_template.h"
+#include "bench_stats.h"
+#include "trace_replay.h"
+#include "bridge.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <signal.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#ifdef REPLAY_ENABLE
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+#ifdef BRIDGE_ENABLE
+#include <sys/time.h>
+#endif
+
+#ifdef TICKLESS_IDLE_ENABLE
+#error "Tickless idle needs the target SysTick; the POSIX ticker is a thread"
+#endif
+
+#ifdef LAT_PROBE_ENABLE
+#error "The latency probe measures target interrupts; use --load on the host"
+#endif
+
+//============================================================================
+// LOCAL CONSTANTS AND MACROS
+//============================================================================
+
+#define BSP_LOAD_MAX            8U          // --load options per run
+#define BSP_LOAD_PERIOD_NS      1000000L    // Injection period (1 ms)
+#define BSP_NS_PER_SEC          1000000000ULL
+#define BSP_REPLAY_LINE         160U        // Longest replay script line
+
+//============================================================================
+// LOCAL TYPES
+//============================================================================
+
+// One --load generator: a static event posted to one AO at a fixed rate
+typedef struct {
+    QEvt evt;                   // Static event (never recycled)
+    uint8_t prio;               // Target AO
+    uint32_t rate;              // Events per second
+    uint32_t count;             // Events to post, 0 = until the run ends
+    uint64_t posted;            // Accepted by the AO queue
+    uint64_t dropped;           // Queue full (margin 0 post failed)
+} LoadGen;
+
+#ifdef BRIDGE_ENABLE
+// One --bridge link: a connected UDP socket and its receive thread
+typedef struct {
+    char host[64];              // Peer
+    char port[8];
+    uint16_t localPort;
+    int sock;
+    BufStream *rx;
+    pthread_t thread;
+} BridgeUdp;
+#endif
+
+//============================================================================
+// LOCAL VARIABLES
+//============================================================================
+
+// Command line
+static uint32_t l_durationMs;           // 0 = run until stopped
+static bool l_verbose;
+#ifdef Q_SPY
+static char const *l_qsHost = QS_TCP_HOST;
+static char l_qsPort[8];
+static bool l_qsOff;
+#endif
+
+// Monotonic time of BSP_init()
+static uint64_t l_startNs;
+
+// Simulated LEDs
+static bool l_led[LED_COUNT];
+
+// Random number seed
+static uint32_t l_rndSeed;
+
+// Termination requests (SIGINT, --duration)
+static volatile sig_atomic_t l_sigInt;
+static bool l_stopping;
+
+// Event injection
+static LoadGen l_load[BSP_LOAD_MAX];
+static uint8_t l_nLoad;
+static pthread_t l_loadThread;
+static volatile bool l_loadRun;
+static uint64_t l_loadStartNs;
+static uint64_t l_loadEndNs;
+
+// QS sender of the injected events
+static uint8_t const l_loadSender = 0U;
+
+#ifdef Q_SPY
+// TCP connection to QSPY, -1 = not connected (output is discarded)
+static int l_qsSock = -1;
+#endif
+
+#ifdef BRIDGE_ENABLE
+// Bridge links, in --bridge order
+static BridgeUdp l_bridge[BRIDGE_MAX_LINKS];
+static uint8_t l_nBridge;
+#endif
+
+#ifdef REPLAY_ENABLE
+// Trace replay (--replay): while l_replayRun, the replay thread owns the
+// tick and BSP_getTime*() return the replayed time
+static char const *l_replayPath;
+static char const *l_replayReport;
+static FILE *l_replayFile;
+static pthread_t l_replayThread;
+static volatile bool l_replayRun;
+static uint32_t volatile l_replayTick;
+static uint64_t volatile l_replayUs;
+static __thread bool l_onReplayThread;  // Set by the replay thread itself
+
+// Hardware counters of the dispatch thread: -2 = not opened yet, -1 = none
+static int l_perfFd[2] = { -2, -1 };
+#endif
+
+//============================================================================
+// LOCAL FUNCTION PROTOTYPES
+//============================================================================
+
+static uint64_t BSP_nowNs_(void);
+static void BSP_usage_(char const *prog);
+static bool BSP_parseLoad_(char const *spec);
+static void BSP_onSigInt_(int sig);
+static void *BSP_loadThread_(void *arg);
+#ifdef REPLAY_ENABLE
+static void *BSP_replayThread_(void *arg);
+static void BSP_replayIdle_(void);
+static bool BSP_onReplayThread_(void);
+#endif
+#ifdef BRIDGE_ENABLE
+static bool BSP_parseBridge_(char const *spec);
+static void *BSP_bridgeThread_(void *arg);
+#endif
+#ifdef Q_SPY
+static int BSP_qsConnect_(void);
+static uint16_t BSP_qsTake_(uint8_t * const buf);
+static void BSP_qsSend_(uint8_t const *buf, uint16_t nBytes);
+#endif
+
+//============================================================================
+// BSP IMPLEMENTATION
+//============================================================================
+
+void BSP_hostArgs(int argc, char *argv[]) {
+#ifdef Q_SPY
+    snprintf(l_qsPort, sizeof(l_qsPort), "%u", (unsigned)QS_TCP_PORT);
+#endif
+
+    for (int i = 1; i < argc; ++i) {
+        char const *arg = argv[i];
+        char const *val = (i + 1 < argc) ? argv[i + 1] : (char const *)0;
+
+        if (strcmp(arg, "--verbose") == 0) {
+            l_verbose = true;
+        } else if ((strcmp(arg, "--duration") == 0) && (val != 0)) {
+            l_durationMs = (uint32_t)(atof(val) * 1000.0);
+            ++i;
+        } else if ((strcmp(arg, "--load") == 0) && (val != 0)) {
+            if (!BSP_parseLoad_(val)) {
+                fprintf(stderr, "Error: bad --load '%s'\n", val);
+                BSP_usage_(argv[0]);
+            }
+            ++i;
+        } else if (((strcmp(arg, "--replay") == 0)
+                    || (strcmp(arg, "--replay-report") == 0)) && (val != 0)) {
+#ifdef REPLAY_ENABLE
+            if (arg[8] == '\0') {
+                l_replayPath = val;
+            } else {
+                l_replayReport = val;
+            }
+#else
+            fprintf(stderr, "Error: %s needs a REPLAY_ENABLE build\n", arg);
+            exit(1);
+#endif
+            ++i;
+        } else if ((strcmp(arg, "--bridge") == 0) && (val != 0)) {
+#ifdef BRIDGE_ENABLE
+            if (!BSP_parseBridge_(val)) {
+                fprintf(stderr, "Error: bad --bridge '%s'\n", val);
+                BSP_usage_(argv[0]);
+            }
+#else
+            fprintf(stderr, "Error: %s needs a BRIDGE_ENABLE build\n", arg);
+            exit(1);
+#endif
+            ++i;
+        } else if ((strcmp(arg, "--qs") == 0) && (val != 0)) {
+#ifdef Q_SPY
+            static char host[64];
+            if (strcmp(val, "off") == 0) {
+                l_qsOff = true;
+            } else {
+                snprintf(host, sizeof(host), "%s", val);
+                char *colon = strrchr(host, ':');
+                if (colon != (char *)0) {
+                    *colon = '\0';
+                    snprintf(l_qsPort, sizeof(l_qsPort), "%s", colon + 1);
+                }
+                l_qsHost = host;
+            }
+#endif
+            ++i;
+        } else {
+            BSP_usage_(argv[0]);
+        }
+    }
+}
+
+void BSP_init(void) {
+    l_startNs = 0U;
+    l_startNs = BSP_nowNs_();
+
+    // Ctrl-C ends the run through QF_stop(), so QF_onCleanup() still runs
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = &BSP_onSigInt_;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, (struct sigaction *)0);
+
+    // Initialize random number seed
+    l_rndSeed = 0x12345678U;
+
+    // Initialize LEDs (all off)
+    for (uint8_t i = 0; i < LED_COUNT; ++i) {
+        l_led[i] = false;
+    }
+
+    if (l_verbose) {
+        printf("BSP_init: %u Hz tick, %u load generator(s)\n",
+               (unsigned)BSP_TICKS_PER_SEC, (unsigned)l_nLoad);
+    }
+}
+
+void BSP_terminate(int16_t result) {
+    if (!l_stopping) {
+        l_stopping = true;
+        if (l_verbose) {
+            printf("BSP_terminate(%d) at %u ms\n", (int)result,
+                   (unsigned)(BSP_getTimeUs() / 1000U));
+        }
+        QF_stop();   // QF_run() returns after QF_onCleanup()
+    }
+}
+
+//============================================================================
+// LED CONTROL FUNCTIONS
+//============================================================================
+
+void BSP_ledOn(uint8_t led) {
+    if (led < LED_COUNT) {
+        l_led[led] = true;
+        if (l_verbose) {
+            printf("%10u us  LED%u ON\n", (unsigned)BSP_getTimeUs(),
+                   (unsigned)led);
+        }
+    }
+}
+
+void BSP_ledOff(uint8_t led) {
+    if (led < LED_COUNT) {
+        l_led[led] = false;
+        if (l_verbose) {
+            printf("%10u us  LED%u OFF\n", (unsigned)BSP_getTimeUs(),
+                   (unsigned)led);
+        }
+    }
+}
+
+void BSP_ledToggle(uint8_t led) {
+    if (led < LED_COUNT) {
+        if (l_led[led]) {
+            BSP_ledOff(led);
+        } else {
+            BSP_ledOn(led);
+        }
+    }
+}
+
+//============================================================================
+// SYSTEM TIMING FUNCTIONS
+//============================================================================
+
+uint32_t BSP_tickAdvance(void) {
+#ifdef REPLAY_ENABLE
+    // During a replay only the replay thread's ticks count
+    if (l_replayRun) {
+        return BSP_onReplayThread_() ? 1U : 0U;
+    }
+#endif
+    // The ticker thread runs every tick, there is no tickless sleep here
+    return 1U;
+}
+
+void BSP_tickHook(void) {
+    // Called once per tick from QF_onClockTick() (ticker thread)
+
+    // Update random seed
+    l_rndSeed = l_rndSeed * 1103515245U + 12345U;
+
+    // End of the run: Ctrl-C or --duration elapsed
+    if ((l_sigInt != 0)
+        || ((l_durationMs != 0U)
+            && ((BSP_getTimeUs() / 1000U) >= l_durationMs)))
+    {
+        BSP_terminate(0);
+    }
+
+    // {{PERIODIC_BSP_PROCESSING}}
+}
+
+static uint64_t BSP_nowNs_(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (((uint64_t)ts.tv_sec * BSP_NS_PER_SEC) + (uint64_t)ts.tv_nsec)
+           - l_startNs;
+}
+
+uint32_t BSP_getTime(void) {
+#ifdef REPLAY_ENABLE
+    if (l_replayRun) {
+        return l_replayTick;
+    }
+#endif
+    // Ticks since BSP_init(), derived from the clock (never drifts)
+    return (uint32_t)(BSP_nowNs_()
+                      / (BSP_NS_PER_SEC / BSP_TICKS_PER_SEC));
+}
+
+uint32_t BSP_getTimeUs(void) {
+    return (uint32_t)BSP_getTimeUs64();
+}
+
+uint64_t BSP_getTimeUs64(void) {
+#ifdef REPLAY_ENABLE
+    if (l_replayRun) {
+        return l_replayUs;
+    }
+#endif
+    return BSP_nowNs_() / 1000U;
+}
+
+uint32_t BSP_cycles(void) {
+    // Nanoseconds, wraps every ~4.3 s (only differences are used)
+    return (uint32_t)BSP_nowNs_();
+}
+
+#ifdef BENCH_ENABLE
+
+uint32_t BSP_stackPeak(void) {
+    // QF_run() dispatches on the main thread, whose stack mapping grows on
+    // demand and never shrinks: VmStk is its high-water mark (page size)
+    unsigned kb = 0U;
+    char line[64];
+    FILE * const f = fopen("/proc/self/status", "r");
+    if (f != (FILE *)0) {
+        while (fgets(line, sizeof(line), f) != (char *)0) {
+            if (sscanf(line, "VmStk: %u kB", &kb) == 1) {
+                break;
+            }
+        }
+        fclose(f);
+    }
+    return (uint32_t)kb * 1024U;
+}
+
+#endif // BENCH_ENABLE
+
+#ifdef REPLAY_ENABLE
+
+bool BSP_perfRead(uint64_t counts[2]) {
+    // Opened by the first call, so the counters follow the calling thread
+    // (QF_run()'s, which dispatches all AOs in posix-qv)
+    if (l_perfFd[0] == -2) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.exclude_kernel = 1U;
+        attr.exclude_hv = 1U;
+        attr.read_format = PERF_FORMAT_GROUP;
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        l_perfFd[0] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0UL);
+        if (l_perfFd[0] >= 0) {
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            l_perfFd[1] = (int)syscall(SYS_perf_event_open, &attr, 0, -1,
+                                       l_perfFd[0], 0UL);
+        }
+        if ((l_perfFd[0] >= 0) && (l_perfFd[1] < 0)) {
+            close(l_perfFd[0]);
+            l_perfFd[0] = -1;
+        }
+        if (l_perfFd[0] < 0) {
+            fprintf(stderr, "Replay: no perf counters (%s), wall time only\n",
+                    strerror(errno));
+        }
+    }
+
+    // Group read: { nr, instructions, cycles }
+    uint64_t buf[3];
+    if ((l_perfFd[0] < 0)
+        || (read(l_perfFd[0], buf, sizeof(buf)) != (ssize_t)sizeof(buf)))
+    {
+        return false;
+    }
+    counts[0] = buf[1];
+    counts[1] = buf[2];
+    return true;
+}
+
+#endif // REPLAY_ENABLE
+
+//============================================================================
+// RANDOM NUMBER GENERATION
+//============================================================================
+
+uint32_t BSP_random(void) {
+    // Simple linear congruential generator
+    l_rndSeed = l_rndSeed * 1103515245U + 12345U;
+    return l_rndSeed;
+}
+
+void BSP_randomSeed(uint32_t seed) {
+    l_rndSeed = seed;
+}
+
+//============================================================================
+// ERROR HANDLING
+//============================================================================
+
+void BSP_error_handler(ErrorCode_t error, const char* file, int line) {
+#ifdef Q_SPY
+    // QS trace error
+    QS_BEGIN_ID(QS_ERROR_INFO, 0U)
+        QS_U16_((uint16_t)error);
+        QS_STR_(file);
+        QS_U16_((uint16_t)line);
+    QS_END_()
+    QS_onFlush();
+#endif
+
+    fprintf(stderr, "BSP error %d at %s:%d\n", (int)error, file, line);
+    exit(-1);
+}
+
+//============================================================================
+// EVENT INJECTION
+//============================================================================
+
+static bool BSP_parseLoad_(char const *spec) {
+    unsigned prio;
+    unsigned sig;
+    unsigned rate;
+    unsigned count = 0U;
+    int const n = sscanf(spec, "%u:%u:%u:%u", &prio, &sig, &rate, &count);
+
+    if ((n < 3) || (l_nLoad >= BSP_LOAD_MAX)
+        || (prio == 0U) || (prio > QF_MAX_ACTIVE)
+        || (sig < (unsigned)Q_USER_SIG) || (rate == 0U))
+    {
+        return false;
+    }
+
+    LoadGen * const gen = &l_load[l_nLoad];
+    ++l_nLoad;
+    memset(gen, 0, sizeof(*gen));
+    gen->evt.sig = (QSignal)sig;   // poolId_ 0: static, never recycled
+    gen->prio = (uint8_t)prio;
+    gen->rate = rate;
+    gen->count = count;
+    return true;
+}
+
+void BSP_loadStart(void) {
+    if (l_nLoad == 0U) {
+        return;
+    }
+
+    for (uint8_t i = 0U; i < l_nLoad; ++i) {
+        if (QActive_registry_[l_load[i].prio] == (QActive *)0) {
+            fprintf(stderr, "Error: --load: no AO at priority %u\n",
+                    (unsigned)l_load[i].prio);
+            exit(1);
+        }
+    }
+
+    QS_OBJ_DICTIONARY(&l_loadSender);
+
+    l_loadRun = true;
+    l_loadStartNs = BSP_nowNs_();
+    if (pthread_create(&l_loadThread, (pthread_attr_t *)0,
+                       &BSP_loadThread_, (void *)0) != 0)
+    {
+        fprintf(stderr, "Error: cannot start the load thread\n");
+        exit(1);
+    }
+}
+
+void BSP_loadStop(void) {
+    if (!l_loadRun) {
+        return;
+    }
+    l_loadRun = false;
+    (void)pthread_join(l_loadThread, (void **)0);
+
+    double const secs = (double)(l_loadEndNs - l_loadStartNs) / 1e9;
+    printf("\nLoad Test Results (%.3f s)\n", secs);
+    printf("%-5s %-5s %10s %12s %10s %12s\n",
+           "Prio", "Sig", "Target/s", "Posted", "Dropped", "Achieved/s");
+    for (uint8_t i = 0U; i < l_nLoad; ++i) {
+        LoadGen const * const gen = &l_load[i];
+        printf("%-5u %-5u %10u %12llu %10llu %12.0f\n",
+               (unsigned)gen->prio, (unsigned)gen->evt.sig,
+               (unsigned)gen->rate,
+               (unsigned long long)gen->posted,
+               (unsigned long long)gen->dropped,
+               (secs > 0.0) ? ((double)gen->posted / secs) : 0.0);
+    }
+}
+
+// Every period, post whatever the elapsed time is owed. The due count is
+// computed from the start time, so late wakeups catch up instead of
+// drifting, and any rate up to QF's posting capacity is reproduced on
+// average even though the period is 1 ms.
+static void *BSP_loadThread_(void *arg) {
+    (void)arg;
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    uint64_t const t0 = BSP_nowNs_();
+
+    while (l_loadRun) {
+        next.tv_nsec += BSP_LOAD_PERIOD_NS;
+        if (next.tv_nsec >= 1000000000L) {
+            next.tv_nsec -= 1000000000L;
+            ++next.tv_sec;
+        }
+        (void)clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next,
+                              (struct timespec *)0);
+
+        uint64_t const us = (BSP_nowNs_() - t0) / 1000U;
+        for (uint8_t i = 0U; i < l_nLoad; ++i) {
+            LoadGen * const gen = &l_load[i];
+            uint64_t due = (gen->rate * us) / 1000000U;
+            if ((gen->count != 0U) && (due > gen->count)) {
+                due = gen->count;
+            }
+            QActive * const ao = QActive_registry_[gen->prio];
+            while ((gen->posted + gen->dropped) < due) {
+                // Margin 0: a full queue is counted, never asserted
+                if (QACTIVE_POST_X(ao, &gen->evt, 0U, &l_loadSender)) {
+                    ++gen->posted;
+                } else {
+                    ++gen->dropped;
+                }
+            }
+        }
+        l_loadEndNs = BSP_nowNs_();
+    }
+    return (void *)0;
+}
+
+//============================================================================
+// TRACE REPLAY
+//============================================================================
+
+#ifdef REPLAY_ENABLE
+
+void BSP_replayStart(void) {
+    if (l_replayPath == (char const *)0) {
+        return;
+    }
+    if (l_nLoad != 0U) {
+        fprintf(stderr, "Error: --replay and --load cannot be combined\n");
+        exit(1);
+    }
+    l_replayFile = fopen(l_replayPath, "r");
+    if (l_replayFile == (FILE *)0) {
+        fprintf(stderr, "Error: cannot open --replay '%s'\n", l_replayPath);
+        exit(1);
+    }
+
+    // On the dispatch thread: opens the counters there
+    Replay_start();
+
+    l_replayTick = 0U;
+    l_replayUs = 0U;
+    l_replayRun = true;    // From here on the ticker thread is idle
+    if (pthread_create(&l_replayThread, (pthread_attr_t *)0,
+                       &BSP_replayThread_, (void *)0) != 0)
+    {
+        fprintf(stderr, "Error: cannot start the replay thread\n");
+        exit(1);
+    }
+}
+
+// Runs the tick chain up to each step's tick, then injects the step.
+// Every tick and every event starts with all AOs idle, so the AOs see
+// the same sequence on every run regardless of host scheduling.
+static void *BSP_replayThread_(void *arg) {
+    (void)arg;
+    l_onReplayThread = true;
+    char line[BSP_REPLAY_LINE];
+    ReplayStep step;
+
+    while (!l_stopping
+           && (fgets(line, sizeof(line), l_replayFile) != (char *)0))
+    {
+        if (!Replay_parse(line, &step)) {
+            continue;
+        }
+        while (!l_stopping && (l_replayTick < step.tick)) {
+            BSP_replayIdle_();
+            ++l_replayTick;
+            uint64_t const us = ((uint64_t)l_replayTick * 1000000U)
+                                / BSP_TICKS_PER_SEC;
+            if (us > l_replayUs) {
+                l_replayUs = us;
+            }
+            QF_onClockTick();
+        }
+        BSP_replayIdle_();
+        if (step.timeUs > l_replayUs) {
+            l_replayUs = step.timeUs;
+        }
+        if (!Replay_inject(&step) && l_verbose) {
+            fprintf(stderr, "Replay: tick %u: cannot inject sig %u to %u\n",
+                    (unsigned)step.tick, (unsigned)step.sig,
+                    (unsigned)step.prio);
+        }
+    }
+    BSP_replayIdle_();
+    fclose(l_replayFile);
+
+    if (!Replay_report(l_replayReport, l_replayTick)) {
+        fprintf(stderr, "Error: cannot write '%s'\n", l_replayReport);
+    }
+    BSP_terminate(0);
+    return (void *)0;
+}
+
+static void BSP_replayIdle_(void) {
+    while (!Replay_isIdle() && !l_stopping) {
+        (void)sched_yield();
+    }
+}
+
+static bool BSP_onReplayThread_(void) {
+    return l_onReplayThread;
+}
+
+#endif // REPLAY_ENABLE
+
+//============================================================================
+// EVENT BRIDGE LINK DRIVER
+//============================================================================
+
+#ifdef BRIDGE_ENABLE
+
+static bool BSP_parseBridge_(char const *spec) {
+    // lport:host:port (the host may not contain ':')
+    if (l_nBridge >= BRIDGE_MAX_LINKS) {
+        return false;
+    }
+    BridgeUdp * const b = &l_bridge[l_nBridge];
+    char *end;
+    unsigned long const lport = strtoul(spec, &end, 10);
+    char const * const colon = strrchr(spec, ':');
+    if ((*end != ':') || (lport == 0UL) || (lport > 65535UL)
+        || (colon == end) || (colon[1] == '\0'))
+    {
+        return false;
+    }
+    size_t const hostLen = (size_t)(colon - (end + 1));
+    if (hostLen >= sizeof(b->host)) {
+        return false;
+    }
+    memcpy(b->host, end + 1, hostLen);
+    b->host[hostLen] = '\0';
+    snprintf(b->port, sizeof(b->port), "%s", colon + 1);
+    b->localPort = (uint16_t)lport;
+    b->sock = -1;
+    ++l_nBridge;
+    return true;
+}
+
+static int BSP_bridgeOpen_(BridgeUdp const * const b) {
+    struct addrinfo hints;
+    struct addrinfo *res;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    if (getaddrinfo(b->host, b->port, &hints, &res) != 0) {
+        return -1;
+    }
+
+    int sock = -1;
+    for (struct addrinfo *ai = res; ai != (struct addrinfo *)0;
+         ai = ai->ai_next)
+    {
+        sock = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (sock < 0) {
+            continue;
+        }
+        // Local port on any address of the peer's family
+        struct sockaddr_storage local;
+        memset(&local, 0, sizeof(local));
+        local.ss_family = (sa_family_t)ai->ai_family;
+        if (ai->ai_family == AF_INET6) {
+            ((struct sockaddr_in6 *)&local)->sin6_port = htons(b->localPort);
+        } else {
+            ((struct sockaddr_in *)&local)->sin_port = htons(b->localPort);
+        }
+        if ((bind(sock, (struct sockaddr *)&local, ai->ai_addrlen) == 0)
+            && (connect(sock, ai->ai_addr, ai->ai_addrlen) == 0))
+        {
+            break;
+        }
+        close(sock);
+        sock = -1;
+    }
+    freeaddrinfo(res);
+
+    if (sock >= 0) {
+        // The receive thread checks l_stopping between timeouts
+        struct timeval const tv = { 0, 100000 };
+        (void)setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    }
+    return sock;
+}
+
+static void *BSP_bridgeThread_(void *arg) {
+    // recv() writes each datagram straight into the block, like the DMA
+    BridgeUdp * const b = (BridgeUdp *)arg;
+    uint8_t *buf = BufStream_start(b->rx);
+    while (!l_stopping) {
+        if (buf == (uint8_t *)0) {
+            struct timespec const ts = { 0, 1000000L };
+            (void)nanosleep(&ts, (struct timespec *)0);
+            buf = BufStream_start(b->rx);   // BufPool was exhausted
+            continue;
+        }
+        // Errors: timeout, or ICMP unreachable while the peer is down
+        ssize_t const n = recv(b->sock, buf, BRIDGE_FRAME_SIZE, 0);
+        if (n > 0) {
+            buf = BufStream_swapN(b->rx, (uint16_t)n, b);
+        }
+    }
+    return (void *)0;
+}
+
+static void BSP_bridgeStart_(uint_fast8_t link, BufStream * const rx) {
+    if (link >= l_nBridge) {
+        fprintf(stderr, "Warning: bridge link %u has no --bridge peer\n",
+                (unsigned)link);
+        return;
+    }
+    BridgeUdp * const b = &l_bridge[link];
+    b->rx = rx;
+    b->sock = BSP_bridgeOpen_(b);
+    if (b->sock < 0) {
+        fprintf(stderr, "Error: --bridge: cannot use UDP port %u for %s:%s\n",
+                (unsigned)b->localPort, b->host, b->port);
+        exit(1);
+    }
+    if (pthread_create(&b->thread, (pthread_attr_t *)0,
+                       &BSP_bridgeThread_, b) != 0)
+    {
+        fprintf(stderr, "Error: cannot start the bridge thread\n");
+        exit(1);
+    }
+    if (l_verbose) {
+        printf("Bridge link %u: UDP %u -> %s:%s\n", (unsigned)link,
+               (unsigned)b->localPort, b->host, b->port);
+    }
+}
+
+static bool BSP_bridgeSend_(uint_fast8_t link, uint8_t const * const frame,
+                            uint16_t len)
+{
+    if ((link >= l_nBridge) || (l_bridge[link].sock < 0)) {
+        return false;
+    }
+    if (send(l_bridge[link].sock, frame, len, 0) != (ssize_t)len) {
+        return false;                   // E.g. the peer is not running yet
+    }
+    Bridge_txDone(link);                // The datagram is copied
+    return true;
+}
+
+static BridgeDriver const l_bridgeUdpDriver = {
+    &BSP_bridgeStart_,
+    &BSP_bridgeSend_
+};
+
+BridgeDriver const *BSP_bridgeDriver(uint_fast8_t const link) {
+    (void)link;
+    return &l_bridgeUdpDriver;
+}
+
+#endif // BRIDGE_ENABLE
+
+static void BSP_onSigInt_(int sig) {
+    (void)sig;
+    l_sigInt = 1;   // QF_stop() is not async-signal-safe: BSP_tickHook()
+}
+
+static void BSP_usage_(char const *prog) {
+    fprintf(stderr,
+        "Usage: %s [options]\n"
+        "  --duration S                  Stop after S seconds\n"
+        "  --load prio:sig:rate[:count]  Post sig to the AO at prio,\n"
+        "                                rate events/s (up to %u options)\n"
+        "  --bridge lport:host:port      Bridge link over UDP, one option per\n"
+        "                                link (BRIDGE_ENABLE builds)\n"
+        "  --qs host:port | off          QSPY endpoint (default %s:%u)\n"
+        "  --replay FILE                 Replay a qs_replay.py script, then\n"
+        "                                stop (REPLAY_ENABLE builds)\n"
+        "  --replay-report FILE          Handler costs of the replay (JSON)\n"
+        "  --verbose                     Print LED changes\n",
+        prog, (unsigned)BSP_LOAD_MAX,
+#ifdef Q_SPY
+        QS_TCP_HOST, (unsigned)QS_TCP_PORT
+#else
+        "none", 0U
+#endif
+        );
+    exit(1);
+}
+
+//============================================================================
+// QS SOFTWARE TRACING IMPLEMENTATION
+//============================================================================
+
+#ifdef Q_SPY
+
+uint8_t QS_onStartup(void const *arg) {
+    static uint8_t qsTxBuf[QS_TX_BUFFER_SIZE];
+    static uint8_t qsRxBuf[QS_RX_BUFFER_SIZE];
+    (void)arg;
+
+    QS_initBuf(qsTxBuf, sizeof(qsTxBuf));
+    QS_rxInitBuf(qsRxBuf, sizeof(qsRxBuf));
+
+    if (!l_qsOff) {
+        l_qsSock = BSP_qsConnect_();
+        if (l_qsSock < 0) {
+            fprintf(stderr, "QS: no QSPY at %s:%s, trace discarded\n",
+                    l_qsHost, l_qsPort);
+        }
+    }
+    return 1U;  // Tracing without QSPY is not an error on the host
+}
+
+void QS_onCleanup(void) {
+    QS_onFlush();
+    if (l_qsSock >= 0) {
+        close(l_qsSock);
+        l_qsSock = -1;
+    }
+}
+
+void BSP_qsPoll(void) {
+    uint8_t buf[QS_TCP_CHUNK];
+
+#ifdef REPLAY_ENABLE
+    // The ticker thread keeps servicing QS while the replay owns the tick
+    if (BSP_onReplayThread_()) {
+        return;
+    }
+#endif
+
+    // Feed bytes QSPY sent since the last tick, without blocking
+    if (l_qsSock >= 0) {
+        for (;;) {
+            ssize_t const n = recv(l_qsSock, buf, sizeof(buf), MSG_DONTWAIT);
+            if (n > 0) {
+                for (ssize_t i = 0; i < n; ++i) {
+                    QS_rxPut(buf[i]);
+                }
+            } else {
+                if ((n == 0)
+                    || ((errno != EAGAIN) && (errno != EWOULDBLOCK)))
+                {
+                    close(l_qsSock);   // QSPY went away
+                    l_qsSock = -1;
+                }
+                break;
+            }
+        }
+        QS_rxParse();
+    }
+
+    // Send the output produced since the last tick (stops at a short
+    // block, so a busy producer cannot keep the ticker here forever)
+    uint16_t nBytes;
+    do {
+        nBytes = BSP_qsTake_(buf);
+        BSP_qsSend_(buf, nBytes);
+    } while (nBytes == QS_TCP_CHUNK);
+}
+
+void QS_onFlush(void) {
+    uint8_t buf[QS_TCP_CHUNK];
+    uint16_t nBytes = BSP_qsTake_(buf);
+    while (nBytes != 0U) {
+        BSP_qsSend_(buf, nBytes);
+        nBytes = BSP_qsTake_(buf);
+    }
+}
+
+QSTimeCtr QS_onGetTime(void) {
+    // Return current timestamp for QS
+    return (QSTimeCtr)BSP_getTimeUs();
+}
+
+void QS_onReset(void) {
+    // No hardware to reset: end the run cleanly
+    BSP_terminate(0);
+}
+
+// Copy the next block out of the QS buffer. The buffer is shared with
+// every AO and the load thread, so it is read under the QF critical
+// section (a mutex on POSIX, QF_INT_DISABLE() is empty here).
+static uint16_t BSP_qsTake_(uint8_t * const buf) {
+    uint16_t nBytes = QS_TCP_CHUNK;
+    QF_CRIT_ENTRY(dummy);
+    uint8_t const *block = QS_getBlock(&nBytes);
+    if (block != (uint8_t *)0) {
+        memcpy(buf, block, nBytes);
+    } else {
+        nBytes = 0U;
+    }
+    QF_CRIT_EXIT(dummy);
+    return nBytes;
+}
+
+static void BSP_qsSend_(uint8_t const *buf, uint16_t nBytes) {
+    // Blocking send keeps the trace lossless while QSPY keeps up
+    while ((nBytes != 0U) && (l_qsSock >= 0)) {
+        ssize_t const n = send(l_qsSock, buf, nBytes, MSG_NOSIGNAL);
+        if (n > 0) {
+            buf += n;
+            nBytes = (uint16_t)(nBytes - (uint16_t)n);
+        } else if ((n < 0) && (errno != EINTR)) {
+            close(l_qsSock);
+            l_qsSock = -1;
+        }
+    }
+}
+
+static int BSP_qsConnect_(void) {
+    struct addrinfo hints;
+    struct addrinfo *res;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(l_qsHost, l_qsPort, &hints, &res) != 0) {
+        return -1;
+    }
+
+    int sock = -1;
+    for (struct addrinfo *ai = res; ai != (struct addrinfo *)0;
+         ai = ai->ai_next)
+    {
+        sock = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (sock < 0) {
+            continue;
+        }
+        if (connect(sock, ai->ai_addr, ai->ai_addrlen) == 0) {
+            break;
+        }
+        close(sock);
+        sock = -1;
+    }
+    freeaddrinfo(res);
+
+    if (sock >= 0) {
+        // QS blocks are small and latency matters to QSPY/QView
+        int const on = 1;
+        (void)setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    }
+    return sock;
+}
+
+#endif // Q_SPY
+
+//============================================================================
+// TEMPLATE EXPANSION MARKERS
+//============================================================================
+
+// These markers are used by code generation tools:
+// {{ADDITIONAL_BSP_FUNCTIONS}}
+// {{PROJECT_SPECIFIC_BSP_CODE}}
+
+/**
+ * @brief Template Usage Instructions for AI Agents
+ *
+ * This BSP template provides:
+ *
+ * 1. The BSP_* API of the target BSP on Linux/POSIX (posix-qv port)
+ * 2. Time from CLOCK_MONOTONIC: BSP_getTime(), BSP_getTimeUs(),
+ *    BSP_cycles() in nanoseconds for the RTC profiler
+ * 3. QS tracing to QSPY over TCP (qspy -t), --qs host:port or off
+ * 4. Event injection with --load prio:sig:rate[:count] for load tests
+ * 5. Trace replay with --replay FILE (REPLAY_ENABLE): the replay thread
+ *    steps the tick, time is the trace's, dispatches are measured with
+ *    perf_event_open() counters (BSP_perfRead())
+ *
+ * Differences to the target:
+ * - QF_INT_DISABLE() is empty; shared data uses QF_CRIT_ENTRY()
+ * - AOs run one at a time (QV): no preemption, no QK_onContextSw()
+ * - Benchmark stack peak is the main thread's VmStk (page granularity)
+ * - Tickless idle is not available (the tick is a thread)
+ */
@@ -0,0 +1,417 @@
+/**
+ * @file main.c
+ * @brief POSIX Host Main Application Template
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * Host counterpart of templates/platforms/stm32f4/main.c on the QP
+ * posix-qv port. The startup sequence, pools, services and AO start
+ * sequence are the same; the SysTick ISR becomes QF_onClockTick(), which
+ * the port calls from its ticker thread BSP_TICKS_PER_SEC times a second.
+ *
+ * Usage: firmware.elf [--duration S] [--qs host:port|off] [--verbose]
+ *                     [--load prio:sig:rate[:count]]...
+ *                     [--replay FILE [--replay-report FILE]]
+ *                     [--bridge lport:host:port]...
+ */
+
+#include "project_template.h"
+#include "rtc_profiler.h"
+#include "pool_monitor.h"
+#include "queue_monitor.h"
+#include "tick_divider.h"
+#include "qs_compact.h"
+#include "buf_pool.h"
+#include "coalesce.h"
+#include "multicast.h"
+#include "work_chunk.h"
+#include "dsp_block.h"
+#include "bench_stats.h"
+#include "trace_replay.h"
+#include "bridge.h"
+#include "time_wheel.h"
+#include "qs_dict.h"
+#include "qs_filter.h"
+#include "flow_bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+Q_DEFINE_THIS_FILE
+
+//============================================================================
+// LOCAL STORAGE FOR ACTIVE OBJECTS
+//============================================================================
+
+// {{ACTIVE_OBJECT_STORAGE_DECLARATIONS}}
+
+//============================================================================
+// EVENT POOL STORAGE
+//============================================================================
+
+// Small event pool (events with no parameters)
+QF_MPOOL_EL(BaseEvt) l_smlPoolSto[SMALL_EVENT_POOL_SIZE];
+
+// Medium event pool (sensor data, GPIO events)
+QF_MPOOL_EL(SensorDataEvt) l_medPoolSto[MEDIUM_EVENT_POOL_SIZE];
+
+// Large event pool (configuration events, reduced sample blocks)
+// Bulk data (ADC/SPI/UART blocks) travels in BufEvt from buf_pool.c instead
+QF_MPOOL_EL(SensorResultEvt) l_lrgPoolSto[LARGE_EVENT_POOL_SIZE];
+
+//============================================================================
+// PUBLISH-SUBSCRIBE STORAGE
+//============================================================================
+
+// Subscriber list storage for published events
+static QSubscrList l_subscrSto[MAX_SIG];
+
+// QS sender of the clock tick (stands in for the SysTick ISR)
+static uint8_t const l_clockTick = 0U;
+
+#ifdef Q_SPY
+// QS dictionaries of this module, sent as one const table (qs_dict.h)
+static QS_DICT_TABLE(main) = {
+    QS_DICT_OBJ(&l_clockTick),
+
+    // User-defined trace records
+    QS_DICT_USR(QS_SENSOR_DATA),
+    QS_DICT_USR(QS_GPIO_CHANGE),
+    QS_DICT_USR(QS_TIMING_INFO),
+    QS_DICT_USR(QS_ERROR_INFO),
+
+    // Signal dictionary for readable trace output
+    QS_DICT_SIG(TICK_SIG, (void *)0),
+    QS_DICT_SIG(SENSOR_DATA_SIG, (void *)0),
+    QS_DICT_SIG(SENSOR_BLOCK_SIG, (void *)0),
+    QS_DICT_SIG(SENSOR_RESULT_SIG, (void *)0),
+    QS_DICT_SIG(FAULT_SIG, (void *)0),
+    QS_DICT_SIG(MODE_CHANGE_SIG, (void *)0),
+    QS_DICT_SIG(START_SIG, (void *)0),
+    QS_DICT_SIG(STOP_SIG, (void *)0),
+    QS_DICT_SIG(RESET_SIG, (void *)0),
+    QS_DICT_SIG(CONFIG_SIG, (void *)0),
+    QS_DICT_SIG(GPIO_SIG, (void *)0),
+    QS_DICT_SIG(TIMER_SIG, (void *)0),
+    QS_DICT_SIG(UART_RX_SIG, (void *)0),
+    QS_DICT_SIG(SPI_COMPLETE_SIG, (void *)0),
+};
+#endif // Q_SPY
+
+//============================================================================
+// MAIN FUNCTION
+//============================================================================
+
+int main(int argc, char *argv[]) {
+
+    // Command line: run time, QSPY endpoint, event injection
+    BSP_hostArgs(argc, argv);
+
+    // Initialize QF framework
+    QF_init();
+
+    // Initialize Board Support Package
+    BSP_init();
+    FLOW_BENCH_INIT(BSP_SYSTEM_CLOCK_HZ / 1000000U); // Boot time from here
+
+    // Start RTC profiler time base (no-op unless RTC_PROF_ENABLE)
+    RTC_PROF_INIT(BSP_SYSTEM_CLOCK_HZ / 1000000U);
+    BENCH_INIT(BSP_SYSTEM_CLOCK_HZ / 1000000U,
+               BSP_SYSTEM_CLOCK_HZ / BSP_TICKS_PER_SEC);
+    WORK_CHUNK_INIT(BSP_SYSTEM_CLOCK_HZ / 1000000U);
+
+    // Initialize event pools
+    QF_poolInit(l_smlPoolSto, sizeof(l_smlPoolSto), sizeof(l_smlPoolSto[0]));
+    QF_poolInit(l_medPoolSto, sizeof(l_medPoolSto), sizeof(l_medPoolSto[0]));
+    QF_poolInit(l_lrgPoolSto, sizeof(l_lrgPoolSto), sizeof(l_lrgPoolSto[0]));
+
+    // Monitor the pools in QF pool ID order (no-op unless POOL_MON_ENABLE)
+    POOL_MON_INIT(BSP_TICKS_PER_SEC);
+    QUEUE_MON_INIT(BSP_TICKS_PER_SEC);
+    POOL_MON_REGISTER(l_smlPoolSto, sizeof(l_smlPoolSto), sizeof(l_smlPoolSto[0]));
+    POOL_MON_REGISTER(l_medPoolSto, sizeof(l_medPoolSto), sizeof(l_medPoolSto[0]));
+    POOL_MON_REGISTER(l_lrgPoolSto, sizeof(l_lrgPoolSto), sizeof(l_lrgPoolSto[0]));
+
+    // Zero-copy buffer pool for streamed data (largest blocks, so last;
+    // no-op unless BUF_POOL_ENABLE, which needs QF_MAX_EPOOL >= 4)
+    BUF_POOL_INIT();
+
+    // Initialize publish-subscribe mechanism
+    QActive_psInit(l_subscrSto, Q_DIM(l_subscrSto));
+
+    // Bitmask multicast for FAULT_SIG/MODE_CHANGE_SIG (Mcast_subscribe())
+    Mcast_init();
+
+    // TICK_SIG fan-out (AOs call TickDiv_subscribe() with their period)
+    TickDiv_init(TICK_SIG);
+
+    // Last-value-wins sensor samples: one pending event per sensor_id
+    COALESCE_ADD(SENSOR_DATA_SIG, SensorDataEvt, sensor_id);
+
+    // Replayed events with parameters (same list as the target's main.c)
+    REPLAY_EVT(SENSOR_DATA_SIG, SensorDataEvt);
+
+#ifdef Q_SPY
+    // Initialize QS software tracing (connects to QSPY, see bsp.c)
+    if (!QS_INIT((void *)0)) {
+        Q_ERROR();
+    }
+
+    // Compact trace mode: string dictionary + SYNC (no-op unless enabled)
+    QS_COMPACT_INIT();
+
+    // Setup QS filters
+    QS_GLB_FILTER(QS_ALL_RECORDS);   // Enable all QS records
+    QS_GLB_FILTER(-QS_QF_TICK);      // Disable tick records (too frequent)
+
+    // Per-AO filters start from this setting (no-op unless QS_FILT_ENABLE)
+    QS_FILT_INIT(BSP_SYSTEM_CLOCK_HZ / 1000000U);
+
+    // Dictionaries (only their build IDs with QS_DICT_ROM_ENABLE)
+    QS_DICT_SEND(main);
+
+    // {{QS_SIGNAL_DICTIONARY_ENTRIES}}
+
+#endif // Q_SPY
+
+    // Start Active Objects in priority order (lowest to highest)
+
+    // {{ACTIVE_OBJECT_START_SEQUENCE}}
+
+    // Example Active Object start (template):
+    /*
+    static QEvt const *myAO_queueSto[10];
+
+    MyAO_ctor();  // Constructor
+    QACTIVE_START(AO_MyAO,
+                  AO_MYAO_PRIO,                    // Priority
+                  myAO_queueSto, Q_DIM(myAO_queueSto), // Event queue
+                  (void *)0, 0U,                   // No private stack
+                  (void *)0);                      // Initialization parameter
+    RTC_PROF_ATTACH(AO_MyAO, AO_MYAO_MAX_RTC_TIME_US); // After start (prio set)
+    QUEUE_MON_ATTACH(AO_MyAO);                          // After start (queue set)
+    QS_FILT_ATTACH(AO_MyAO);                            // After RTC_PROF_ATTACH
+    */
+
+    // Event bridge to the peer node (no-op unless BRIDGE_ENABLE). The peer
+    // imports what this node exports; -DBRIDGE_NODE_CONTROLLER builds the
+    // controller side of the pair.
+    BRIDGE_START(0U, AO_COMM_PRIO, BSP_bridgeDriver(0U));
+#ifdef BRIDGE_NODE_CONTROLLER
+    BRIDGE_EXPORT(0U, CONFIG_SIG, ConfigEvt);
+    BRIDGE_IMPORT(0U, SENSOR_DATA_SIG, SensorDataEvt);
+#else
+    BRIDGE_EXPORT(0U, SENSOR_DATA_SIG, SensorDataEvt);
+    BRIDGE_IMPORT(0U, CONFIG_SIG, ConfigEvt);
+#endif
+
+    // Event-flow benchmark AOs above the application (no-op unless
+    // FLOW_BENCH_ENABLE): source and FLOW_BENCH_SINKS sinks, run by command 24
+    FLOW_BENCH_START(AO_CRITICAL_PRIO + 1U, FLOW_BENCH_SIG);
+
+    // Run the event loop until BSP_terminate() (or --duration) stops QF
+    return QF_run();
+}
+
+//============================================================================
+// QF CALLBACKS
+//============================================================================
+
+void QF_onStartup(void) {
+    FLOW_BENCH_BOOTED();   // End of the boot time measurement
+
+    // Ticker thread calls QF_onClockTick() BSP_TICKS_PER_SEC times a second
+    QF_setTickRate(BSP_TICKS_PER_SEC, BSP_TICKER_PRIO);
+
+    // All AOs are started now: begin posting the --load events
+    BSP_loadStart();
+
+    // --replay: the replay thread takes over the tick (REPLAY_ENABLE only)
+#ifdef REPLAY_ENABLE
+    BSP_replayStart();
+#endif
+    REPLAY_CAPTURE_START(&l_clockTick);   // No-op unless enabled
+
+    // {{INTERRUPT_CONFIGURATION}}
+}
+
+void QF_onCleanup(void) {
+    // Stop event injection and print the achieved rates
+    BSP_loadStop();
+}
+
+void QF_onClockTick(void) {
+    // Same tick chain as SysTick_Handler on the target
+    FLOW_BENCH_TICK_BEGIN();
+    uint32_t nTicks = BSP_tickAdvance();
+    while (nTicks != 0U) {
+        --nTicks;
+        REPLAY_CAPTURE_TICK();   // Replay tick count (no-op unless enabled)
+
+        // Benchmark clock: releases are due at the tick (no-op unless enabled)
+        BENCH_TICK();
+
+        // Post TICK_SIG only to subscribers whose period has elapsed
+        TickDiv_tick(&l_clockTick);
+
+        // Process QF time events (and the time wheel, if enabled)
+        TIME_WHEEL_TICK(&l_clockTick);
+
+        // Call BSP tick hook (also ends the run after --duration)
+        BSP_tickHook();
+        POOL_MON_TICK();
+        QUEUE_MON_TICK();
+        QS_COMPACT_TICK();
+    }
+    FLOW_BENCH_TICK_END();
+
+#ifdef Q_SPY
+    // No idle callback in posix-qv: service QS from the ticker thread
+    BSP_qsPoll();
+#endif
+}
+
+//============================================================================
+// ASSERTION AND ERROR HANDLING
+//============================================================================
+
+void Q_onAssert(char const *module, int loc) {
+    // Called when a QP assertion fails
+    fprintf(stderr, "Assertion failed in %s:%d\n", module, loc);
+
+#ifdef Q_SPY
+    // Log assertion failure and push it to QSPY before exiting
+    QS_ASSERTION(module, loc, 10000U);
+    QS_onFlush();
+#endif
+
+    exit(-1);
+}
+
+//============================================================================
+// QS SOFTWARE TRACING CALLBACKS
+//============================================================================
+
+#ifdef Q_SPY
+
+void QS_onCommand(uint8_t cmdId, uint32_t param1,
+                  uint32_t param2, uint32_t param3) {
+    // Handle commands received via QS-RX (same numbering as the target)
+    (void)param2;
+    (void)param3;
+    switch (cmdId) {
+        case 0U: {
+            // Command 0: Toggle LED
+            BSP_ledToggle((uint8_t)param1);
+            break;
+        }
+        case 1U: {
+            // Command 1: Reset system (end the run)
+            BSP_terminate(0);
+            break;
+        }
+        case 4U: {
+            // Command 4: Report RTC profile (param1 = AO prio, 0 = all)
+            RTC_PROF_REPORT((uint_fast8_t)param1);
+            WORK_CHUNK_REPORT();            // Chunk sizes of long operations
+            break;
+        }
+        case 5U: {
+            // Command 5: Reset RTC profile statistics
+            RTC_PROF_RESET();
+            WORK_CHUNK_RESET();
+            break;
+        }
+        case 6U: {
+            // Command 6: Report event pool usage
+            POOL_MON_REPORT();
+            break;
+        }
+        case 7U: {
+            // Command 7: Report AO queue usage (param1 = AO prio, 0 = all)
+            QUEUE_MON_REPORT((uint_fast8_t)param1);
+            break;
+        }
+        case 8U: {
+            // Command 8: Re-send the compact QS string dictionary
+            QS_COMPACT_DUMP();
+            break;
+        }
+        case 13U: {
+            // Command 13: Report scheduling benchmark statistics
+            BENCH_REPORT();
+            break;
+        }
+        case 14U: {
+            // Command 14: Reset benchmark statistics (start a new window)
+            BENCH_RESET();
+            break;
+        }
+        case 15U: {
+            // Command 15: Report coalesced posts per signal
+            COALESCE_REPORT();
+            break;
+        }
+        case 16U: {
+            // Command 16: Benchmark block DSP vs per-sample events
+            DSP_BENCH_RUN(BSP_SYSTEM_CLOCK_HZ / 1000000U,
+                          SensorDataEvt, SENSOR_DATA_SIG);
+            break;
+        }
+        case 17U: {
+            // Command 17: Report event bridge link counters
+            BRIDGE_REPORT();
+            break;
+        }
+        case 18U: {
+            // Command 18: Reset event bridge counters (start a new window)
+            BRIDGE_RESET();
+            break;
+        }
+        case 19U: {
+            // Command 19: Time wheel vs QF list tick (param1 timers, param2 ticks)
+            TIME_WHEEL_BENCH_RUN(BSP_SYSTEM_CLOCK_HZ / 1000000U, param1, param2);
+            break;
+        }
+        case 20U: {
+            // Command 20: Send the QS dictionary tables again
+            QS_DICT_RESEND();
+            break;
+        }
+        case 21U: {
+            // Command 21: Per-AO QS filter (param1 prio, 0 = all, 0xFF = non-AO;
+            // param2 group mask, 0xFFFF = global; param3 0 set, 1 add, 2 remove)
+            QS_FILT_SET(param1, param2, param3);
+            break;
+        }
+        case 22U: {
+            // Command 22: Report the QS filters and trace cost (param1 prio, 0 = all)
+            QS_FILT_REPORT(param1);
+            break;
+        }
+        case 23U: {
+            // Command 23: Reset the trace cost counters (start a new window)
+            QS_FILT_RESET();
+            break;
+        }
+        case 24U: {
+            // Command 24: Event-flow benchmark (param1 rounds, 0 = default)
+            FLOW_BENCH_RUN(param1);
+            break;
+        }
+        // Add more commands as needed
+        // {{QS_COMMAND_HANDLERS}}
+        default: {
+            break;
+        }
+    }
+}
+
+#endif // Q_SPY
+
+//============================================================================
+// PROJECT-SPECIFIC INITIALIZATION
+//============================================================================
+
+// Add project-specific initialization functions here
+// {{PROJECT_SPECIFIC_FUNCTIONS}}
@@ -0,0 +1,278 @@
+/**
+ * @file project_template.h
+ * @brief POSIX Host Project Template Header
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * Template for running QP/C applications natively on Linux/POSIX with the
+ * QP posix-qv port. Active Objects, events and services are the same as
+ * on the STM32F4 template; only the BSP is replaced, so application code
+ * can be exercised and load-tested on the host before it goes to target.
+ */
+
+#ifndef PROJECT_TEMPLATE_H
+#define PROJECT_TEMPLATE_H
+
+#include "qpc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//============================================================================
+// PLATFORM CONFIGURATION
+//============================================================================
+
+// System clock configuration
+#define BSP_TICKS_PER_SEC    1000U
+#define BSP_SYSTEM_CLOCK_HZ  1000000000U  // BSP_cycles() counts nanoseconds
+
+// Priority of the QF ticker thread (SCHED_FIFO when permitted)
+#define BSP_TICKER_PRIO      50
+
+// QK kernel configuration (priority range kept for AO compatibility)
+#define QK_PREEMPTION_PRIO   64U  // Maximum priority levels
+
+// Memory pools configuration (resized by tools/analyzers/pool_sizer.py)
+// The zero-copy buffer pool (buf_pool.h, BUF_POOL_ENABLE) is a fourth pool
+#define SMALL_EVENT_POOL_SIZE   16U
+#define MEDIUM_EVENT_POOL_SIZE  8U
+#define LARGE_EVENT_POOL_SIZE   4U
+
+//============================================================================
+// ACTIVE OBJECT PRIORITIES
+//============================================================================
+// Same assignment as the target, so AO code builds unchanged.
+// Higher number = higher priority
+
+enum {
+    AO_IDLE_PRIO = 0U,        // Reserved for idle (never used)
+
+    // Low priority - non-critical background tasks
+    AO_LOGGER_PRIO = 1U,      // Data logging, file operations
+    AO_COMM_PRIO = 2U,        // Communication protocols
+
+    // Medium priority - application logic
+    AO_SENSOR_PRIO = 3U,      // Sensor data processing
+    AO_ACTUATOR_PRIO = 4U,    // Actuator control
+    AO_CONTROLLER_PRIO = 5U,  // Main application controller
+
+    // High priority - time-critical tasks
+    AO_SAFETY_PRIO = 6U,      // Safety monitoring
+    AO_TIMER_PRIO = 7U,       // Time-critical operations
+
+    // Highest priority - interrupt-like tasks
+    AO_CRITICAL_PRIO = 8U,    // Critical system tasks
+
+    MAX_AO_PRIO = QK_PREEMPTION_PRIO - 1U
+};
+
+//============================================================================
+// EVENT SIGNALS
+//============================================================================
+
+enum ProjectSignals {
+    // Published signals (one-to-many)
+    TICK_SIG = Q_USER_SIG,    // System tick event
+    SENSOR_DATA_SIG,          // Sensor data available
+    SENSOR_BLOCK_SIG,         // Sample block (BufEvt, zero-copy)
+    SENSOR_RESULT_SIG,        // Reduced sample block (SensorResultEvt)
+    FAULT_SIG,                // System fault detected
+    MODE_CHANGE_SIG,          // Operating mode change
+
+    // Point-to-point signals
+    START_SIG,                // Start operation
+    STOP_SIG,                 // Stop operation
+    RESET_SIG,                // Reset command
+    CONFIG_SIG,               // Configuration change
+
+    // Hardware interface signals
+    GPIO_SIG,                 // GPIO state change
+    TIMER_SIG,                // Timer event
+    UART_RX_SIG,             // UART receive
+    SPI_COMPLETE_SIG,        // SPI transaction complete
+
+    // Service signals
+    FLOW_BENCH_SIG,           // Flow benchmark fan-out (flow_bench.h)
+
+    // Add project-specific signals here
+    // {{PROJECT_SIGNALS}}
+
+    MAX_SIG                   // Keep last
+};
+
+//============================================================================
+// EVENT STRUCTURES
+//============================================================================
+
+// Base event (no parameters)
+typedef struct {
+    QEvt super;
+} BaseEvt;
+
+// Sensor data event (single sample; stream sample blocks as BufEvt from
+// templates/services/buf_pool.h instead of enlarging this event)
+typedef struct {
+    QEvt super;
+    uint16_t sensor_id;
+    uint32_t timestamp;
+    float value;
+    uint8_t status;
+} SensorDataEvt;
+
+// Reduced sample block, published by the sensor pipeline AO template
+// (templates/active_objects/sensor_pipeline_template.c)
+typedef struct {
+    QEvt super;
+    uint16_t sensor_id;
+    uint16_t seq;             // BufEvt.seq of the last block folded in
+    uint32_t timestamp;
+    float mean;
+    float rms;
+    float min;
+    float max;
+    float peak_hz;            // Strongest non-DC frequency (0 = none)
+    float peak_amp;
+} SensorResultEvt;
+
+// Configuration event
+typedef struct {
+    QEvt super;
+    uint16_t param_id;
+    uint32_t value;
+} ConfigEvt;
+
+// GPIO event
+typedef struct {
+    QEvt super;
+    uint16_t pin;
+    uint8_t state;
+} GpioEvt;
+
+//============================================================================
+// ACTIVE OBJECT DECLARATIONS
+//============================================================================
+
+// {{ACTIVE_OBJECT_DECLARATIONS}}
+
+//============================================================================
+// BOARD SUPPORT PACKAGE (BSP) INTERFACE
+//============================================================================
+
+// BSP initialization and control
+void BSP_hostArgs(int argc, char *argv[]);  // Before BSP_init()
+void BSP_init(void);
+void BSP_terminate(int16_t result);  // Stops QF (QF_run() returns)
+void BSP_ledOn(uint8_t led);
+void BSP_ledOff(uint8_t led);
+void BSP_ledToggle(uint8_t led);
+
+// System timing (CLOCK_MONOTONIC since BSP_init())
+void BSP_tickHook(void);
+uint32_t BSP_tickAdvance(void);  // Always 1: the ticker thread never sleeps
+uint32_t BSP_getTime(void);
+uint32_t BSP_getTimeUs(void);     // Wraps every ~71 min
+uint64_t BSP_getTimeUs64(void);   // Never wraps
+uint32_t BSP_cycles(void);   // Nanoseconds (profiling time base)
+
+// Random numbers
+uint32_t BSP_random(void);
+void BSP_randomSeed(uint32_t seed);
+
+// Event injection (--load prio:sig:rate[:count] on the command line)
+void BSP_loadStart(void);    // From QF_onStartup(), after all AOs started
+void BSP_loadStop(void);     // From QF_onCleanup(), prints the report
+
+// Trace replay (--replay FILE, REPLAY_ENABLE builds, see trace_replay.h)
+void BSP_replayStart(void);  // From QF_onStartup(), after BSP_loadStart()
+
+//============================================================================
+// QS SOFTWARE TRACING CONFIGURATION
+//============================================================================
+
+#ifdef Q_SPY
+    // QS buffer sizes
+    #define QS_TX_BUFFER_SIZE   (64U * 1024U)
+    #define QS_RX_BUFFER_SIZE   1024U
+    #ifdef QS_COMPACT_ENABLE
+    #define QS_TSTAMP_SIZE      2U    // Unrolled on the host via SYNC records
+    #else
+    #define QS_TSTAMP_SIZE      4U
+    #endif
+
+    // QS trace transport: TCP client of QSPY (qspy -t), --qs host:port
+    #define QS_TCP_HOST         "localhost"
+    #define QS_TCP_PORT         6601U
+    #define QS_TCP_CHUNK        1024U     // Bytes per send()
+
+    // QS trace records
+    enum QSUserRecords {
+        QS_USER_00 = QS_USER,
+        QS_SENSOR_DATA,           // Sensor data trace
+        QS_GPIO_CHANGE,           // GPIO state change
+        QS_TIMING_INFO,           // Timing measurements
+        QS_ERROR_INFO,            // Error information
+        // Add project-specific trace records
+        // {{QS_USER_RECORDS}}
+        // NOTE: QS_USER + 15..24 are reserved for templates/services
+    };
+
+    // QS_onStartup() and the other QS callbacks are declared by qs.h
+
+    // Moves QS output to QSPY and QSPY input to QS-RX (ticker thread)
+    void BSP_qsPoll(void);
+
+#endif // Q_SPY
+
+//============================================================================
+// ASSERT AND ERROR HANDLING
+//============================================================================
+
+// QP assertion handler
+void Q_onAssert(char const *module, int loc);
+
+// Error handling
+typedef enum {
+    ERROR_NONE = 0,
+    ERROR_INIT_FAILED,
+    ERROR_INVALID_PARAM,
+    ERROR_TIMEOUT,
+    ERROR_HARDWARE_FAULT,
+    ERROR_MEMORY_FULL,
+    ERROR_COMMUNICATION_LOST
+} ErrorCode_t;
+
+void BSP_error_handler(ErrorCode_t error, const char* file, int line);
+
+//============================================================================
+// MEMORY MANAGEMENT
+//============================================================================
+
+// Memory pool storage declarations
+extern QF_MPOOL_EL(BaseEvt) l_smlPoolSto[SMALL_EVENT_POOL_SIZE];
+extern QF_MPOOL_EL(SensorDataEvt) l_medPoolSto[MEDIUM_EVENT_POOL_SIZE];
+extern QF_MPOOL_EL(SensorResultEvt) l_lrgPoolSto[LARGE_EVENT_POOL_SIZE];
+
+//============================================================================
+// PROJECT-SPECIFIC CONFIGURATION
+//============================================================================
+
+// Application-specific constants
+#define APP_VERSION_MAJOR    1U
+#define APP_VERSION_MINOR    0U
+#define APP_VERSION_PATCH    0U
+
+// Simulated hardware
+#define LED_COUNT           4U
+#define SENSOR_COUNT        8U
+
+// Timing constraints
+#define MAX_RTC_DURATION_MS  10U    // Maximum Run-to-Completion time
+
+// {{PROJECT_SPECIFIC_CONFIG}}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PROJECT_TEMPLATE_H
@@ -10,7 +10,17 @@
  */
 
 #include "project_template.h"
+#include "rtc_profiler.h"
+#include "pool_monitor.h"
+#include "queue_monitor.h"
+#include "tickless.h"
+#include "qs_compact.h"
+#include "latency_probe.h"
+#include "bench_stats.h"
+#include "bridge.h"
+#include "qs_dict.h"
 #include "stm32f4xx_hal.h"
+#include <string.h>
 
 Q_DEFINE_THIS_FILE
 
@@ -41,11 +51,73 @@ Q_DEFINE_THIS_FILE
 #define QS_UART_TX_PIN          GPIO_PIN_2
 #define QS_UART_RX_PIN          GPIO_PIN_3
 #define QS_UART_AF              GPIO_AF7_USART2
+#define QS_UART_IRQn            USART2_IRQn
+#ifndef QS_UART_BAUDRATE
 #define QS_UART_BAUDRATE        115200U
+#endif
+
+// DMA configuration for QS trace transport (USART2 on DMA1 channel 4)
+#define QS_DMA_CLK_ENABLE()     __HAL_RCC_DMA1_CLK_ENABLE()
+#define QS_DMA_CHANNEL          DMA_CHANNEL_4
+#define QS_DMA_TX_STREAM        DMA1_Stream6
+#define QS_DMA_TX_IRQn          DMA1_Stream6_IRQn
+#define QS_DMA_RX_STREAM        DMA1_Stream5
+#ifndef QS_TRANSPORT
+#define QS_TRANSPORT            QS_TRANSPORT_UART_DMA
+#endif
+#ifndef QS_DMA_BLOCK_SIZE
+#define QS_DMA_BLOCK_SIZE       256U    // Bytes per TX DMA transfer
+#endif
+#ifndef QS_RX_DMA_SIZE
+#define QS_RX_DMA_SIZE          64U     // Circular RX DMA buffer
+#endif
+#ifndef QS_SWO_BAUDRATE
+#define QS_SWO_BAUDRATE         2000000U
+#endif
 
 // System timing
 #define BSP_SYSTICK_FREQ        1000U   // 1ms system tick
 
+// Microsecond time base: TIM2 counts 1 us, TIM5 counts TIM2 wraps (ITR0).
+// APB1 runs at HCLK/4 (SystemClock_Config), so its timers get 2 x PCLK1.
+#define TIMEBASE_LO             TIM2
+#define TIMEBASE_HI             TIM5
+#define TIMEBASE_CLK_HZ         (BSP_SYSTEM_CLOCK_HZ / 2U)
+
+// Latency probe generator: fires EXTI line LAT_PROBE_GEN_LINE in software
+// (no wiring), or drives LAT_PROBE_GEN_PIN jumpered to the button input
+#ifndef LAT_PROBE_GEN_LINE
+#define LAT_PROBE_GEN_LINE      BUTTON_PIN
+#endif
+#ifndef LAT_PROBE_GEN_PORT
+#define LAT_PROBE_GEN_PORT      GPIOA
+#endif
+
+// Event bridge link 0: USART6 (PC6 TX, PC7 RX) on DMA2 channel 5. A frame
+// ends at the idle line after it, so both ends must leave a gap between
+// frames (one DMA transfer per frame does).
+#define BRIDGE_UART             USART6
+#define BRIDGE_UART_CLK_ENABLE() __HAL_RCC_USART6_CLK_ENABLE()
+#define BRIDGE_UART_GPIO_PORT   GPIOC
+#define BRIDGE_UART_GPIO_CLK_ENABLE() __HAL_RCC_GPIOC_CLK_ENABLE()
+#define BRIDGE_UART_TX_PIN      GPIO_PIN_6
+#define BRIDGE_UART_RX_PIN      GPIO_PIN_7
+#define BRIDGE_UART_AF          GPIO_AF8_USART6
+#define BRIDGE_UART_IRQn        USART6_IRQn
+#define BRIDGE_DMA_CLK_ENABLE() __HAL_RCC_DMA2_CLK_ENABLE()
+#define BRIDGE_DMA_CHANNEL      DMA_CHANNEL_5
+#define BRIDGE_DMA_TX_STREAM    DMA2_Stream6
+#define BRIDGE_DMA_TX_IRQn      DMA2_Stream6_IRQn
+#define BRIDGE_DMA_RX_STREAM    DMA2_Stream1
+#define BRIDGE_DMA_RX_IRQn      DMA2_Stream1_IRQn
+#ifndef BRIDGE_UART_BAUDRATE
+#define BRIDGE_UART_BAUDRATE    2000000U    // APB2 (84 MHz) / 16 / 2.625
+#endif
+
+// Benchmark stack painting (main stack: QK runs every AO on it)
+#define BSP_STACK_PAINT         0xDEADBEEFU
+#define BSP_STACK_PAINT_GAP     64U     // Bytes left below the live SP
+
 //============================================================================
 // LOCAL VARIABLES
 //============================================================================
@@ -53,14 +125,59 @@ Q_DEFINE_THIS_FILE
 // System tick counter for timing
 static volatile uint32_t l_tickCtr = 0U;
 
+// Ticks covered by the running SysTick period (> 1 during tickless sleep)
+static volatile uint32_t l_periodTicks = 1U;
+
 // UART handle for QS tracing
 #ifdef Q_SPY
 static UART_HandleTypeDef l_uartHandle;
+
+// Circular RX DMA buffer, drained into QS-RX by BSP_qsPoll()
+static DMA_HandleTypeDef l_dmaRxHandle;
+static uint8_t l_qsRxDmaBuf[QS_RX_DMA_SIZE];
+static uint16_t l_qsRxDmaPos;
+
+#if (QS_TRANSPORT == QS_TRANSPORT_UART_DMA)
+// Double-buffered TX: DMA sends one block while the other is refilled
+static DMA_HandleTypeDef l_dmaTxHandle;
+static uint8_t l_qsTxDmaBuf[2][QS_DMA_BLOCK_SIZE];
+static volatile uint16_t l_qsTxDmaLen[2];
+static volatile uint8_t l_qsTxDmaIdx;   // Buffer owned by the DMA
+static volatile bool l_qsTxDmaBusy;
+#endif
+
+// QS dictionaries of the BSP (the user records are in main.c's table)
+static QS_DICT_TABLE(bsp) = {
+    QS_DICT_OBJ(&l_tickCtr),
+};
 #endif
 
 // Random number seed
 static uint32_t l_rndSeed;
 
+#ifdef LAT_PROBE_ENABLE
+// Loopback edge generator (TIM7, 1 us counts, one-pulse per interval)
+static volatile uint32_t l_latGenMeanUs;
+static uint32_t l_latGenRnd = 0x2545F491U;  // Own LCG: not shared with AOs
+#ifdef LAT_PROBE_GEN_PIN
+static bool l_latGenHigh;
+#endif
+#endif
+
+#ifdef BRIDGE_ENABLE
+// Bridge link: RX DMA writes each frame straight into a BufEvt block
+static UART_HandleTypeDef l_bridgeUart;
+static DMA_HandleTypeDef l_bridgeDmaTx;
+static DMA_HandleTypeDef l_bridgeDmaRx;
+static BufStream *l_bridgeRx;
+#endif
+
+#ifdef BENCH_ENABLE
+// Main stack region from the CubeMX linker script
+extern uint32_t _estack;
+extern uint32_t _Min_Stack_Size;
+#endif
+
 //============================================================================
 // LOCAL FUNCTION PROTOTYPES
 //============================================================================
@@ -68,7 +185,20 @@ static uint32_t l_rndSeed;
 static void SystemClock_Config(void);
 static void GPIO_Init(void);
 static void UART_Init(void);
+static void TimeBase_Init(void);
+static void DWT_Init(void);
 static void Error_Handler(void);
+#ifdef BENCH_ENABLE
+static void BSP_stackPaint_(void);
+#endif
+#ifdef Q_SPY
+static void QS_DMA_Init(void);
+#if (QS_TRANSPORT == QS_TRANSPORT_UART_DMA)
+static void QS_txStart(uint8_t idx);
+#elif (QS_TRANSPORT == QS_TRANSPORT_SWO)
+static void SWO_Init(void);
+#endif
+#endif
 
 //============================================================================
 // BSP IMPLEMENTATION
@@ -89,6 +219,16 @@ void BSP_init(void) {
     // Initialize UART for QS tracing
     UART_Init();
     
+    // Start the microsecond time base (timestamps) and the DWT cycle
+    // counter (RTC profiling time base)
+    TimeBase_Init();
+    DWT_Init();
+    
+#ifdef BENCH_ENABLE
+    // Fill the unused stack to measure its high-water mark later
+    BSP_stackPaint_();
+#endif
+    
     // Initialize random number seed
     l_rndSeed = 0x12345678U;
     
@@ -102,11 +242,7 @@ void BSP_init(void) {
     if (!QS_INIT((void *)0)) {
         Q_ERROR();
     }
-    QS_OBJ_DICTIONARY(&l_tickCtr);
-    QS_USR_DICTIONARY(QS_SENSOR_DATA);
-    QS_USR_DICTIONARY(QS_GPIO_CHANGE);
-    QS_USR_DICTIONARY(QS_TIMING_INFO);
-    QS_USR_DICTIONARY(QS_ERROR_INFO);
+    QS_DICT_SEND(bsp);
 #endif
     
     // BSP initialization complete trace
@@ -210,35 +346,172 @@ void BSP_ledToggle(uint8_t led) {
 // SYSTEM TIMING FUNCTIONS
 //============================================================================
 
+uint32_t BSP_tickAdvance(void) {
+    // Called first in SysTick_Handler: account all ticks of the period
+    QF_INT_DISABLE();
+    uint32_t const nTicks = l_periodTicks;
+    l_tickCtr += nTicks;
+    l_periodTicks = 1U;
+    QF_INT_ENABLE();
+    return nTicks;
+}
+
 void BSP_tickHook(void) {
-    // Increment system tick counter
-    ++l_tickCtr;
+    // Called once per tick (several times after a tickless sleep)
+    static uint32_t hookCtr = 0U;
     
     // Update random seed
     l_rndSeed = l_rndSeed * 1103515245U + 12345U;
     
     // Periodic BSP processing (every 100ms)
-    if ((l_tickCtr % 100U) == 0U) {
+    if ((++hookCtr % 100U) == 0U) {
         // Example: watchdog refresh, periodic checks, etc.
         // {{PERIODIC_BSP_PROCESSING}}
     }
 }
 
+// Current time as whole ticks plus SysTick clocks into the current tick.
+// Tick boundaries are at multiples of one tick period (LOAD + 1) of the
+// down-counter, also during a long tickless period, and a wrap whose ISR
+// has not run yet is accounted so the time never goes backwards.
+static uint32_t BSP_now_(uint32_t * const clocksIntoTick) {
+    uint32_t const primask = __get_PRIMASK();
+    __disable_irq();
+    
+    uint32_t ticks = l_tickCtr;
+    uint32_t span = l_periodTicks;
+    uint32_t const period = SysTick->LOAD + 1U;
+    uint32_t val = SysTick->VAL;
+    if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0U) {
+        val = SysTick->VAL;     // Re-read: certainly after the reload
+        ticks += span;
+        span = 1U;
+    }
+    
+    __set_PRIMASK(primask);
+    
+    uint32_t const left = (val + period - 1U) / period; // Ticks left in span
+    *clocksIntoTick = (left * period) - val;
+    return ticks + span - left;
+}
+
 uint32_t BSP_getTime(void) {
-    return l_tickCtr;
+    uint32_t clocks;
+    return BSP_now_(&clocks);
 }
 
 uint32_t BSP_getTimeUs(void) {
-    // Get current SysTick value (counts down)
-    uint32_t systick_val = SysTick->VAL;
-    uint32_t systick_load = SysTick->LOAD;
+    // Free-running, independent of SysTick and tickless periods
+    return TIMEBASE_LO->CNT;
+}
+
+uint64_t BSP_getTimeUs64(void) {
+    // No lock and no ISR: a changed high word means the low word wrapped
+    // between the reads. TIM5 counts the wrap a few timer clocks after
+    // TIM2 reads 0, so 0 is skipped (at most 1 us, once per ~71 min).
+    uint32_t hi;
+    uint32_t lo;
+    do {
+        hi = TIMEBASE_HI->CNT;
+        do {
+            lo = TIMEBASE_LO->CNT;
+        } while (lo == 0U);
+    } while (hi != TIMEBASE_HI->CNT);
+    return ((uint64_t)hi << 32) | lo;
+}
+
+//============================================================================
+// TICKLESS IDLE
+//============================================================================
+
+#ifdef TICKLESS_IDLE_ENABLE
+
+// Run one SysTick period of 'clocks', then fall back to the tick period.
+// LOAD is only used at reload: force a reload now, wait for it, restore.
+static void BSP_sysTickOneShot_(uint32_t clocks, uint32_t period) {
+    SysTick->LOAD = clocks - 1U;
+    SysTick->VAL = 0U;
+    while (SysTick->VAL == 0U) {
+        // At most one SysTick clock (8 CPU cycles)
+    }
+    SysTick->LOAD = period - 1U;
+}
+
+void BSP_ticklessInit(void) {
+    // HCLK/8 lets a single 24-bit period span ~800 ticks at 168 MHz
+    SysTick->CTRL &= ~SysTick_CTRL_CLKSOURCE_Msk;
+    SysTick->LOAD = (SystemCoreClock / 8U / BSP_TICKS_PER_SEC) - 1U;
+    SysTick->VAL = 0U;
+}
+
+void BSP_ticklessSleep(uint32_t nTicks) {
+    uint32_t const period = SysTick->LOAD + 1U;
+    uint32_t const maxTicks = ((SysTick_LOAD_RELOAD_Msk + 1U) / period) - 1U;
+    if (nTicks > maxTicks) {
+        nTicks = maxTicks;
+    }
+    
+    // PRIMASK holds interrupts pending while the sleep is set up and
+    // unwound; BASEPRI is released so they can still wake up the core
+    __disable_irq();
+    QF_INT_ENABLE();
+    
+    uint32_t const val = SysTick->VAL;
+    bool const longSleep = (nTicks > 1U) && (val != 0U)
+        && ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) == 0U);
+    if (longSleep) {
+        // Rest of the current tick plus nTicks - 1 whole ticks
+        BSP_sysTickOneShot_(val + ((nTicks - 1U) * period), period);
+        l_periodTicks = nTicks;
+    }
+    
+    __DSB();
+    __WFI();
     
-    // Convert to microseconds
-    uint32_t ticks_us = (systick_load + 1U - systick_val) * 1000U / (systick_load + 1U);
+    if (longSleep && ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) == 0U)) {
+        // Woken early by another interrupt: end the period at the next
+        // tick boundary so new timeouts armed by that ISR are not missed
+        uint32_t const now = SysTick->VAL;
+        uint32_t const left = (now + period - 1U) / period;
+        if (left > 1U) {
+            BSP_sysTickOneShot_(now - ((left - 1U) * period), period);
+            l_periodTicks = nTicks - left + 1U;
+        }
+    }
     
-    return (l_tickCtr * 1000U) + ticks_us;
+    __enable_irq();
+}
+
+#endif // TICKLESS_IDLE_ENABLE
+
+uint32_t BSP_cycles(void) {
+    // Free-running CPU clock counter, wraps every ~25.6 s at 168 MHz
+    return DWT->CYCCNT;
 }
 
+#ifdef BENCH_ENABLE
+
+static void BSP_stackPaint_(void) {
+    uint32_t *p = (uint32_t *)((uint32_t)&_estack - (uint32_t)&_Min_Stack_Size);
+    uint32_t const * const end =
+        (uint32_t const *)(__get_MSP() - BSP_STACK_PAINT_GAP);
+    while (p < end) {
+        *p++ = BSP_STACK_PAINT;
+    }
+}
+
+uint32_t BSP_stackPeak(void) {
+    // Deepest word overwritten since BSP_stackPaint_(), scanning upwards
+    uint32_t const *p =
+        (uint32_t const *)((uint32_t)&_estack - (uint32_t)&_Min_Stack_Size);
+    while ((p < &_estack) && (*p == BSP_STACK_PAINT)) {
+        ++p;
+    }
+    return (uint32_t)&_estack - (uint32_t)p;
+}
+
+#endif // BENCH_ENABLE
+
 //============================================================================
 // RANDOM NUMBER GENERATION
 //============================================================================
@@ -253,6 +526,153 @@ void BSP_randomSeed(uint32_t seed) {
     l_rndSeed = seed;
 }
 
+//============================================================================
+// LATENCY PROBE EDGE GENERATOR
+//============================================================================
+
+#ifdef LAT_PROBE_ENABLE
+
+static void BSP_latGenSchedule_(uint32_t us) {
+    TIM7->ARR = (us > 1U) ? (us - 1U) : 1U;
+    TIM7->CNT = 0U;
+    TIM7->CR1 = TIM_CR1_OPM | TIM_CR1_CEN;
+}
+
+void BSP_latGenStart(uint32_t meanUs) {
+    l_latGenMeanUs = meanUs;
+    if (meanUs == 0U) {
+        TIM7->CR1 = 0U;
+        return;
+    }
+    
+    __HAL_RCC_TIM7_CLK_ENABLE();
+    TIM7->CR1 = 0U;
+    // APB1 is divided, so its timers run at 2 x PCLK1 (84 MHz)
+    TIM7->PSC = ((2U * HAL_RCC_GetPCLK1Freq()) / 1000000U) - 1U;
+    TIM7->EGR = TIM_EGR_UG;             // Load the prescaler
+    TIM7->SR = 0U;
+    TIM7->DIER = TIM_DIER_UIE;
+    
+#ifdef LAT_PROBE_GEN_PIN
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+    GPIO_InitStruct.Pin = LAT_PROBE_GEN_PIN;
+    GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+    HAL_GPIO_Init(LAT_PROBE_GEN_PORT, &GPIO_InitStruct);
+    LAT_PROBE_GEN_PORT->BSRR = (uint32_t)LAT_PROBE_GEN_PIN << 16;
+    l_latGenHigh = false;
+#endif
+    
+    // Kernel-unaware priority: QF critical sections do not delay the edge,
+    // so the IRQ stage sees them as the interrupt latency they cause
+    NVIC_SetPriority(TIM7_IRQn, 0U);
+    NVIC_EnableIRQ(TIM7_IRQn);
+    BSP_latGenSchedule_(meanUs);
+}
+
+#endif // LAT_PROBE_ENABLE
+
+//============================================================================
+// EVENT BRIDGE LINK DRIVER
+//============================================================================
+
+#ifdef BRIDGE_ENABLE
+
+static void BSP_bridgeRxArm_(uint8_t * const buf) {
+    // One transfer per frame: ends on the idle line or a full block
+    if (HAL_UARTEx_ReceiveToIdle_DMA(&l_bridgeUart, buf,
+                                     BRIDGE_FRAME_SIZE) == HAL_OK) {
+        __HAL_DMA_DISABLE_IT(&l_bridgeDmaRx, DMA_IT_HT);
+    }
+}
+
+static void BSP_bridgeStart_(uint_fast8_t link, BufStream * const rx) {
+    (void)link;
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+    
+    BRIDGE_UART_CLK_ENABLE();
+    BRIDGE_UART_GPIO_CLK_ENABLE();
+    BRIDGE_DMA_CLK_ENABLE();
+    
+    GPIO_InitStruct.Pin = BRIDGE_UART_TX_PIN | BRIDGE_UART_RX_PIN;
+    GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+    GPIO_InitStruct.Pull = GPIO_PULLUP;     // Idle high if the peer is off
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+    GPIO_InitStruct.Alternate = BRIDGE_UART_AF;
+    HAL_GPIO_Init(BRIDGE_UART_GPIO_PORT, &GPIO_InitStruct);
+    
+    l_bridgeUart.Instance = BRIDGE_UART;
+    l_bridgeUart.Init.BaudRate = BRIDGE_UART_BAUDRATE;
+    l_bridgeUart.Init.WordLength = UART_WORDLENGTH_8B;
+    l_bridgeUart.Init.StopBits = UART_STOPBITS_1;
+    l_bridgeUart.Init.Parity = UART_PARITY_NONE;
+    l_bridgeUart.Init.Mode = UART_MODE_TX_RX;
+    l_bridgeUart.Init.HwFlowCtl = UART_HWCONTROL_NONE;
+    l_bridgeUart.Init.OverSampling = UART_OVERSAMPLING_16;
+    if (HAL_UART_Init(&l_bridgeUart) != HAL_OK) {
+        Error_Handler();
+    }
+    
+    // Both directions in normal mode: one transfer per frame
+    l_bridgeDmaRx.Instance = BRIDGE_DMA_RX_STREAM;
+    l_bridgeDmaRx.Init.Channel = BRIDGE_DMA_CHANNEL;
+    l_bridgeDmaRx.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    l_bridgeDmaRx.Init.PeriphInc = DMA_PINC_DISABLE;
+    l_bridgeDmaRx.Init.MemInc = DMA_MINC_ENABLE;
+    l_bridgeDmaRx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    l_bridgeDmaRx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    l_bridgeDmaRx.Init.Mode = DMA_NORMAL;
+    l_bridgeDmaRx.Init.Priority = DMA_PRIORITY_HIGH;
+    l_bridgeDmaRx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(&l_bridgeDmaRx) != HAL_OK) {
+        Error_Handler();
+    }
+    __HAL_LINKDMA(&l_bridgeUart, hdmarx, l_bridgeDmaRx);
+    
+    l_bridgeDmaTx.Instance = BRIDGE_DMA_TX_STREAM;
+    l_bridgeDmaTx.Init = l_bridgeDmaRx.Init;
+    l_bridgeDmaTx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    l_bridgeDmaTx.Init.Priority = DMA_PRIORITY_MEDIUM;
+    if (HAL_DMA_Init(&l_bridgeDmaTx) != HAL_OK) {
+        Error_Handler();
+    }
+    __HAL_LINKDMA(&l_bridgeUart, hdmatx, l_bridgeDmaTx);
+    
+    // The frame-complete ISRs post to the bridge AO: kernel-aware
+    HAL_NVIC_SetPriority(BRIDGE_DMA_RX_IRQn, QF_AWARE_ISR_CMSIS_PRI + 2U, 0);
+    HAL_NVIC_EnableIRQ(BRIDGE_DMA_RX_IRQn);
+    HAL_NVIC_SetPriority(BRIDGE_DMA_TX_IRQn, QF_AWARE_ISR_CMSIS_PRI + 2U, 0);
+    HAL_NVIC_EnableIRQ(BRIDGE_DMA_TX_IRQn);
+    HAL_NVIC_SetPriority(BRIDGE_UART_IRQn, QF_AWARE_ISR_CMSIS_PRI + 2U, 0);
+    HAL_NVIC_EnableIRQ(BRIDGE_UART_IRQn);
+    
+    QS_OBJ_DICTIONARY(&l_bridgeUart);
+    l_bridgeRx = rx;
+    uint8_t * const buf = BufStream_start(rx);
+    Q_ASSERT(buf != (uint8_t *)0);      // BufPool too small for the bridge
+    BSP_bridgeRxArm_(buf);
+}
+
+static bool BSP_bridgeSend_(uint_fast8_t link, uint8_t const * const frame,
+                            uint16_t len)
+{
+    (void)link;
+    return HAL_UART_Transmit_DMA(&l_bridgeUart, (uint8_t *)frame, len)
+           == HAL_OK;
+}
+
+static BridgeDriver const l_bridgeUartDriver = {
+    &BSP_bridgeStart_,
+    &BSP_bridgeSend_
+};
+
+BridgeDriver const *BSP_bridgeDriver(uint_fast8_t const link) {
+    return (link == 0U) ? &l_bridgeUartDriver : (BridgeDriver const *)0;
+}
+
+#endif // BRIDGE_ENABLE
+
 //============================================================================
 // HARDWARE ABSTRACTION FUNCTIONS
 //============================================================================
@@ -404,7 +824,120 @@ static void UART_Init(void) {
     if (HAL_UART_Init(&l_uartHandle) != HAL_OK) {
         Error_Handler();
     }
+    
+    // Attach DMA streams and start continuous QS-RX reception
+    QS_DMA_Init();
+    if (HAL_UART_Receive_DMA(&l_uartHandle, l_qsRxDmaBuf,
+                             sizeof(l_qsRxDmaBuf)) != HAL_OK) {
+        Error_Handler();
+    }
+    // RX is polled from idle, so half/full transfer interrupts are not needed
+    __HAL_DMA_DISABLE_IT(&l_dmaRxHandle, DMA_IT_HT | DMA_IT_TC);
+    
+#if (QS_TRANSPORT == QS_TRANSPORT_SWO)
+    SWO_Init();
+#endif
+#endif
+}
+
+#ifdef Q_SPY
+static void QS_DMA_Init(void) {
+    QS_DMA_CLK_ENABLE();
+    
+    // RX: circular peripheral-to-memory, never stops
+    l_dmaRxHandle.Instance = QS_DMA_RX_STREAM;
+    l_dmaRxHandle.Init.Channel = QS_DMA_CHANNEL;
+    l_dmaRxHandle.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    l_dmaRxHandle.Init.PeriphInc = DMA_PINC_DISABLE;
+    l_dmaRxHandle.Init.MemInc = DMA_MINC_ENABLE;
+    l_dmaRxHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    l_dmaRxHandle.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    l_dmaRxHandle.Init.Mode = DMA_CIRCULAR;
+    l_dmaRxHandle.Init.Priority = DMA_PRIORITY_MEDIUM;
+    l_dmaRxHandle.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    
+    if (HAL_DMA_Init(&l_dmaRxHandle) != HAL_OK) {
+        Error_Handler();
+    }
+    __HAL_LINKDMA(&l_uartHandle, hdmarx, l_dmaRxHandle);
+    
+#if (QS_TRANSPORT == QS_TRANSPORT_UART_DMA)
+    // TX: one normal-mode transfer per QS block
+    l_dmaTxHandle.Instance = QS_DMA_TX_STREAM;
+    l_dmaTxHandle.Init.Channel = QS_DMA_CHANNEL;
+    l_dmaTxHandle.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    l_dmaTxHandle.Init.PeriphInc = DMA_PINC_DISABLE;
+    l_dmaTxHandle.Init.MemInc = DMA_MINC_ENABLE;
+    l_dmaTxHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    l_dmaTxHandle.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    l_dmaTxHandle.Init.Mode = DMA_NORMAL;
+    l_dmaTxHandle.Init.Priority = DMA_PRIORITY_LOW;
+    l_dmaTxHandle.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    
+    if (HAL_DMA_Init(&l_dmaTxHandle) != HAL_OK) {
+        Error_Handler();
+    }
+    __HAL_LINKDMA(&l_uartHandle, hdmatx, l_dmaTxHandle);
+    
+    // TX-complete ISRs touch the double buffer, so they must be masked by
+    // QF critical sections (kernel-aware priority); they post no events
+    HAL_NVIC_SetPriority(QS_DMA_TX_IRQn, QF_AWARE_ISR_CMSIS_PRI + 3U, 0);
+    HAL_NVIC_EnableIRQ(QS_DMA_TX_IRQn);
 #endif
+    
+    // USART IRQ completes DMA TX (TC flag) and reports RX overruns
+    HAL_NVIC_SetPriority(QS_UART_IRQn, QF_AWARE_ISR_CMSIS_PRI + 3U, 0);
+    HAL_NVIC_EnableIRQ(QS_UART_IRQn);
+}
+
+#if (QS_TRANSPORT == QS_TRANSPORT_SWO)
+static void SWO_Init(void) {
+    // Route ITM stimulus port 0 to the TRACESWO pin (PB3) in NRZ mode
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DBGMCU->CR |= DBGMCU_CR_TRACE_IOEN;
+    TPI->SPPR = 2U;                                         // NRZ/UART
+    TPI->ACPR = (BSP_SYSTEM_CLOCK_HZ / QS_SWO_BAUDRATE) - 1U;
+    TPI->FFCR = 0x100U;                                     // Formatter off
+    ITM->LAR = 0xC5ACCE55U;
+    ITM->TCR = (1U << ITM_TCR_TraceBusID_Pos) | ITM_TCR_SWOENA_Msk
+             | ITM_TCR_ITMENA_Msk;
+    ITM->TER |= 1U;
+}
+#endif
+#endif // Q_SPY
+
+static void TimeBase_Init(void) {
+    Q_ASSERT_STATIC((TIMEBASE_CLK_HZ % 1000000U) == 0U);
+    
+    __HAL_RCC_TIM2_CLK_ENABLE();
+    __HAL_RCC_TIM5_CLK_ENABLE();
+    
+    // Low word: 1 MHz, TRGO on update (every 2^32 us). The update that
+    // loads the prescaler happens before TIM5 counts.
+    TIMEBASE_LO->CR1 = 0U;
+    TIMEBASE_LO->PSC = (TIMEBASE_CLK_HZ / 1000000U) - 1U;
+    TIMEBASE_LO->ARR = 0xFFFFFFFFU;
+    TIMEBASE_LO->CR2 = TIM_TRGO_UPDATE;
+    TIMEBASE_LO->EGR = TIM_EGR_UG;
+    TIMEBASE_LO->CNT = 0U;
+    TIMEBASE_LO->SR = 0U;
+    
+    // High word: external clock mode 1 on ITR0 (TIM2 TRGO)
+    TIMEBASE_HI->CR1 = 0U;
+    TIMEBASE_HI->PSC = 0U;
+    TIMEBASE_HI->ARR = 0xFFFFFFFFU;
+    TIMEBASE_HI->SMCR = TIM_TS_ITR0 | TIM_SLAVEMODE_EXTERNAL1;
+    TIMEBASE_HI->CNT = 0U;
+    TIMEBASE_HI->CR1 = TIM_CR1_CEN;
+    
+    TIMEBASE_LO->CR1 = TIM_CR1_CEN;
+}
+
+static void DWT_Init(void) {
+    // Enable trace block and start the cycle counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0U;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 }
 
 static void Error_Handler(void) {
@@ -424,16 +957,58 @@ static void Error_Handler(void) {
 // INTERRUPT SERVICE ROUTINES
 //============================================================================
 
+#ifdef Q_SPY
+#if (QS_TRANSPORT == QS_TRANSPORT_UART_DMA)
+void DMA1_Stream6_IRQHandler(void) {
+    // QS TX DMA stream (no events posted, no BSP_ISR_ENTRY/EXIT needed)
+    HAL_DMA_IRQHandler(&l_dmaTxHandle);
+}
+#endif
+
+void USART2_IRQHandler(void) {
+    // QS UART: end of DMA TX and RX error recovery
+    HAL_UART_IRQHandler(&l_uartHandle);
+}
+#endif // Q_SPY
+
+#ifdef BRIDGE_ENABLE
+void USART6_IRQHandler(void) {
+    // Bridge UART: idle line ends a received frame, TC ends a sent one
+    BSP_ISR_ENTRY();
+    HAL_UART_IRQHandler(&l_bridgeUart);
+    BSP_ISR_EXIT();
+}
+
+void DMA2_Stream1_IRQHandler(void) {
+    // Bridge RX DMA: a full block ends the frame
+    BSP_ISR_ENTRY();
+    HAL_DMA_IRQHandler(&l_bridgeDmaRx);
+    BSP_ISR_EXIT();
+}
+
+void DMA2_Stream6_IRQHandler(void) {
+    // Bridge TX DMA (enables the UART TC interrupt)
+    BSP_ISR_ENTRY();
+    HAL_DMA_IRQHandler(&l_bridgeDmaTx);
+    BSP_ISR_EXIT();
+}
+#endif // BRIDGE_ENABLE
+
 void EXTI0_IRQHandler(void) {
-    // QK-aware interrupt entry
-    QK_ISR_ENTRY();
+    // Latency probe entry stamp (no-op unless LAT_PROBE_ENABLE)
+    LAT_PROBE_ISR_ENTRY(0U);
+    
+    // Kernel-aware interrupt entry
+    BSP_ISR_ENTRY();
     
     // Handle button interrupt
     if (__HAL_GPIO_EXTI_GET_IT(BUTTON_PIN) != 0x00U) {
         __HAL_GPIO_EXTI_CLEAR_IT(BUTTON_PIN);
         
-        // Post button event to system
+        // Post button event to system (never shed: ticks are, see
+        // TickDiv_tick())
         static QEvt const buttonEvt = QEVT_INITIALIZER(GPIO_SIG);
+        LAT_PROBE_POSTED(0U);
         QACTIVE_PUBLISH(&buttonEvt, &l_EXTI0_IRQHandler);
         
         // QS trace
@@ -443,10 +1018,46 @@ void EXTI0_IRQHandler(void) {
         QS_END_()
     }
     
-    // QK-aware interrupt exit
-    QK_ISR_EXIT();
+    // Kernel-aware interrupt exit
+    BSP_ISR_EXIT();
 }
 
+#ifdef LAT_PROBE_ENABLE
+void TIM7_IRQHandler(void) {
+    // Kernel-unaware: no BSP_ISR_ENTRY/EXIT and no QF calls
+    TIM7->SR = 0U;
+    uint32_t const mean = l_latGenMeanUs;
+    if (mean == 0U) {
+        return;
+    }
+    
+#ifdef LAT_PROBE_GEN_PIN
+    // Loopback pin: a short low phase before every rising edge
+    if (l_latGenHigh) {
+        LAT_PROBE_GEN_PORT->BSRR = (uint32_t)LAT_PROBE_GEN_PIN << 16;
+        l_latGenHigh = false;
+        BSP_latGenSchedule_(2U);
+        return;
+    }
+#endif
+    
+    // Stamp, then make the edge (EXTI pends as soon as this ISR returns)
+    if (LatProbe_trigger(LAT_PROBE_GEN_CH)) {
+#ifdef LAT_PROBE_GEN_PIN
+        LAT_PROBE_GEN_PORT->BSRR = LAT_PROBE_GEN_PIN;
+        l_latGenHigh = true;
+#else
+        EXTI->SWIER = LAT_PROBE_GEN_LINE;
+#endif
+    }
+    
+    // Next edge uniformly in [mean/2, 3*mean/2): not phase-locked to SysTick
+    l_latGenRnd = (l_latGenRnd * 1664525U) + 1013904223U;
+    BSP_latGenSchedule_((mean / 2U)
+        + (uint32_t)(((uint64_t)(l_latGenRnd >> 8) * mean) >> 24));
+}
+#endif // LAT_PROBE_ENABLE
+
 void BSP_systick_handler(void) {
     // This function is called from SysTick_Handler
     // which is already QK-aware in main.c
@@ -470,24 +1081,110 @@ void QS_onCleanup(void) {
     // QS cleanup
 }
 
+void BSP_qsPoll(void) {
+    // Feed bytes written by the circular RX DMA since the last poll
+    uint16_t head = (uint16_t)(QS_RX_DMA_SIZE
+                               - __HAL_DMA_GET_COUNTER(&l_dmaRxHandle));
+    while (l_qsRxDmaPos != head) {
+        QS_rxPut(l_qsRxDmaBuf[l_qsRxDmaPos]);
+        if (++l_qsRxDmaPos == QS_RX_DMA_SIZE) {
+            l_qsRxDmaPos = 0U;
+        }
+    }
+    
+#if (QS_TRANSPORT == QS_TRANSPORT_UART_DMA)
+    // Refill the buffer the DMA does not own; start DMA if it is idle.
+    // The copy stays inside the critical section because QS_getBlock()
+    // releases the bytes back to producers as soon as it returns.
+    QF_INT_DISABLE();
+    uint8_t idx = l_qsTxDmaBusy ? (uint8_t)(l_qsTxDmaIdx ^ 1U) : l_qsTxDmaIdx;
+    if (l_qsTxDmaLen[idx] == 0U) {
+        uint16_t nBytes = QS_DMA_BLOCK_SIZE;
+        uint8_t const *block = QS_getBlock(&nBytes);
+        if (block != (uint8_t *)0) {
+            memcpy(l_qsTxDmaBuf[idx], block, nBytes);
+            l_qsTxDmaLen[idx] = nBytes;
+        }
+    }
+    if (!l_qsTxDmaBusy && (l_qsTxDmaLen[idx] != 0U)) {
+        QS_txStart(idx);
+    }
+    QF_INT_ENABLE();
+#elif (QS_TRANSPORT == QS_TRANSPORT_SWO)
+    // Write to ITM only while its FIFO has room, so idle never spins
+    while (ITM->PORT[0U].u32 != 0UL) {
+        QF_INT_DISABLE();
+        uint16_t b = QS_getByte();
+        QF_INT_ENABLE();
+        if (b == QS_EOD) {
+            break;
+        }
+        ITM->PORT[0U].u8 = (uint8_t)b;
+    }
+#endif
+}
+
+#if (QS_TRANSPORT == QS_TRANSPORT_UART_DMA)
+static void QS_txStart(uint8_t idx) {
+    // Called with interrupts disabled or from the TX-complete ISR
+    l_qsTxDmaIdx = idx;
+    l_qsTxDmaBusy = true;
+    if (HAL_UART_Transmit_DMA(&l_uartHandle, l_qsTxDmaBuf[idx],
+                              l_qsTxDmaLen[idx]) != HAL_OK) {
+        l_qsTxDmaLen[idx] = 0U;   // Drop the block rather than stall QS
+        l_qsTxDmaBusy = false;
+    }
+}
+#endif
+
 void QS_onFlush(void) {
-    // Flush QS transmit buffer via UART
-    uint16_t nBytes = QS_TX_BUFFER_SIZE;
-    uint8_t const *data = QS_getBlock(&nBytes);
+    // Blocking drain, used at startup and from Q_onAssert(). It polls the
+    // hardware flags, so it also works with interrupts disabled.
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
     
-    while (nBytes != 0U) {
-        // Transmit data via UART
-        HAL_UART_Transmit(&l_uartHandle, (uint8_t *)data, nBytes, 100);
-        
-        // Get next block
-        nBytes = QS_TX_BUFFER_SIZE;
-        data = QS_getBlock(&nBytes);
+#if (QS_TRANSPORT == QS_TRANSPORT_UART_DMA)
+    if (l_qsTxDmaBusy) {
+        // Let the in-flight block finish, then return the UART to polling
+        while (__HAL_UART_GET_FLAG(&l_uartHandle, UART_FLAG_TC) == RESET) {
+        }
+        (void)HAL_UART_AbortTransmit(&l_uartHandle);
+        l_qsTxDmaLen[l_qsTxDmaIdx] = 0U;
+        l_qsTxDmaBusy = false;
+    }
+    
+    // Send the block that was queued behind the DMA, preserving order
+    uint8_t next = (uint8_t)(l_qsTxDmaIdx ^ 1U);
+    if (l_qsTxDmaLen[next] != 0U) {
+        HAL_UART_Transmit(&l_uartHandle, l_qsTxDmaBuf[next],
+                          l_qsTxDmaLen[next], HAL_MAX_DELAY);
+        l_qsTxDmaLen[next] = 0U;
+    }
+    
+    uint16_t nBytes = QS_DMA_BLOCK_SIZE;
+    uint8_t const *block = QS_getBlock(&nBytes);
+    while (block != (uint8_t *)0) {
+        HAL_UART_Transmit(&l_uartHandle, (uint8_t *)block, nBytes,
+                          HAL_MAX_DELAY);
+        nBytes = QS_DMA_BLOCK_SIZE;
+        block = QS_getBlock(&nBytes);
+    }
+#elif (QS_TRANSPORT == QS_TRANSPORT_SWO)
+    uint16_t b = QS_getByte();
+    while (b != QS_EOD) {
+        while (ITM->PORT[0U].u32 == 0UL) {
+        }
+        ITM->PORT[0U].u8 = (uint8_t)b;
+        b = QS_getByte();
     }
+#endif
+    
+    __set_PRIMASK(primask);
 }
 
 QSTimeCtr QS_onGetTime(void) {
-    // Return current timestamp for QS
-    return (QSTimeCtr)BSP_getTimeUs();
+    // Microseconds: one register read per trace record
+    return (QSTimeCtr)TIMEBASE_LO->CNT;
 }
 
 void QS_onCommand(uint8_t cmdId, uint32_t param1, 
@@ -522,6 +1219,35 @@ void QS_onCommand(uint8_t cmdId, uint32_t param1,
             break;
         }
         
+        case 4U: {
+            // Command 4: Report RTC profile (param1 = AO prio, 0 = all)
+            RTC_PROF_REPORT((uint_fast8_t)param1);
+            break;
+        }
+        
+        case 5U: {
+            // Command 5: Reset RTC profile statistics
+            RTC_PROF_RESET();
+            break;
+        }
+        
+        case 6U: {
+            // Command 6: Report event pool usage
+            POOL_MON_REPORT();
+            break;
+        }
+        
+        case 7U: {
+            // Command 7: Report AO queue usage (param1 = AO prio, 0 = all)
+            QUEUE_MON_REPORT((uint_fast8_t)param1);
+            break;
+        }
+        case 8U: {
+            // Command 8: Re-send the compact QS string dictionary
+            QS_COMPACT_DUMP();
+            break;
+        }
+        
         // {{CUSTOM_QS_COMMANDS}}
         
         default: {
@@ -542,6 +1268,65 @@ void QS_RX_PUT(uint8_t b) {
 // HAL CALLBACK FUNCTIONS
 //============================================================================
 
+#if (defined(Q_SPY) && (QS_TRANSPORT == QS_TRANSPORT_UART_DMA)) \
+    || defined(BRIDGE_ENABLE)
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+#if defined(Q_SPY) && (QS_TRANSPORT == QS_TRANSPORT_UART_DMA)
+    // QS block sent: chain the refilled buffer straight away, so the link
+    // stays busy even when idle time is scarce
+    if (huart == &l_uartHandle) {
+        uint8_t done = l_qsTxDmaIdx;
+        l_qsTxDmaLen[done] = 0U;
+        if (l_qsTxDmaLen[done ^ 1U] != 0U) {
+            QS_txStart((uint8_t)(done ^ 1U));
+        } else {
+            l_qsTxDmaBusy = false;
+        }
+    }
+#endif
+#ifdef BRIDGE_ENABLE
+    // Bridge frame sent: the AO releases its block and sends the next
+    if (huart == &l_bridgeUart) {
+        Bridge_txDone(0U);
+    }
+#endif
+}
+#endif
+
+#ifdef BRIDGE_ENABLE
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size) {
+    // Bridge frame received (idle line or full block): hand it over and
+    // receive the next one into a fresh block. Framing errors are caught
+    // by the frame CRC.
+    if ((huart == &l_bridgeUart) && (Size != 0U)) {
+        BSP_bridgeRxArm_(BufStream_swapN(l_bridgeRx, Size, &l_bridgeUart));
+    }
+}
+#endif
+
+#if defined(Q_SPY) || defined(BRIDGE_ENABLE)
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
+#ifdef Q_SPY
+    // An RX overrun aborts the circular DMA; restart it so QS-RX keeps working
+    if ((huart == &l_uartHandle)
+        && (huart->RxState == HAL_UART_STATE_READY)) {
+        l_qsRxDmaPos = 0U;
+        if (HAL_UART_Receive_DMA(huart, l_qsRxDmaBuf,
+                                 sizeof(l_qsRxDmaBuf)) == HAL_OK) {
+            __HAL_DMA_DISABLE_IT(&l_dmaRxHandle, DMA_IT_HT | DMA_IT_TC);
+        }
+    }
+#endif
+#ifdef BRIDGE_ENABLE
+    // Aborted reception: drop the partial frame, receive into the same block
+    if ((huart == &l_bridgeUart)
+        && (huart->RxState == HAL_UART_STATE_READY)) {
+        BSP_bridgeRxArm_(&l_bridgeRx->fill->data[0]);
+    }
+#endif
+}
+#endif
+
 void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) {
     // GPIO interrupt callback
     if (GPIO_Pin == BUTTON_PIN) {
@@ -567,7 +1352,7 @@ void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) {
  * 1. Complete STM32F4 hardware initialization
  * 2. LED control functions for status indication
  * 3. System timing and random number generation
- * 4. QS software tracing integration
+ * 4. QS software tracing integration (DMA UART or SWO transport)
  * 5. QK-aware interrupt handling
  * 6. Error handling and recovery
  * 
@@ -580,7 +1365,7 @@ void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) {
  * 5. Extend error handling for application needs
  * 
  * QK Integration Points:
- * - All IRQ handlers use QK_ISR_ENTRY()/QK_ISR_EXIT()
+ * - All IRQ handlers use BSP_ISR_ENTRY()/BSP_ISR_EXIT() (QK or QV)
  * - Event posting from ISRs follows QK patterns
  * - Timing functions support real-time constraints
  * - Hardware abstraction maintains non-blocking semantics
@@ -7,9 +7,32 @@
  * Template main.c for STM32F4 projects using QP/C with QK kernel
  * This file serves as a template for AI agents to generate
  * platform-specific main application files.
+ *
+ * The same file builds for the cooperative QV kernel (build.py --kernel
+ * qv): the QP port on the include path selects QK_onIdle() or
+ * QV_onIdle(), and the ISRs use BSP_ISR_ENTRY()/BSP_ISR_EXIT().
  */
 
 #include "project_template.h"
+#include "rtc_profiler.h"
+#include "pool_monitor.h"
+#include "queue_monitor.h"
+#include "tick_divider.h"
+#include "tickless.h"
+#include "qs_compact.h"
+#include "buf_pool.h"
+#include "coalesce.h"
+#include "multicast.h"
+#include "work_chunk.h"
+#include "dsp_block.h"
+#include "latency_probe.h"
+#include "bench_stats.h"
+#include "trace_replay.h"
+#include "bridge.h"
+#include "time_wheel.h"
+#include "qs_dict.h"
+#include "qs_filter.h"
+#include "flow_bench.h"
 
 Q_DEFINE_THIS_FILE
 
@@ -29,8 +52,9 @@ QF_MPOOL_EL(BaseEvt) l_smlPoolSto[SMALL_EVENT_POOL_SIZE];
 // Medium event pool (sensor data, GPIO events)
 QF_MPOOL_EL(SensorDataEvt) l_medPoolSto[MEDIUM_EVENT_POOL_SIZE];
 
-// Large event pool (configuration events)
-QF_MPOOL_EL(ConfigEvt) l_lrgPoolSto[LARGE_EVENT_POOL_SIZE];
+// Large event pool (configuration events, reduced sample blocks)
+// Bulk data (ADC/SPI/UART blocks) travels in BufEvt from buf_pool.c instead
+QF_MPOOL_EL(SensorResultEvt) l_lrgPoolSto[LARGE_EVENT_POOL_SIZE];
 
 //============================================================================
 // PUBLISH-SUBSCRIBE STORAGE
@@ -60,6 +84,31 @@ static uint8_t l_qsRxBuf[QS_RX_BUFFER_SIZE];
     #error "QS timestamp size not supported"
 #endif
 
+// QS dictionaries of this module, sent as one const table (qs_dict.h)
+static QS_DICT_TABLE(main) = {
+    // User-defined trace records
+    QS_DICT_USR(QS_SENSOR_DATA),
+    QS_DICT_USR(QS_GPIO_CHANGE),
+    QS_DICT_USR(QS_TIMING_INFO),
+    QS_DICT_USR(QS_ERROR_INFO),
+
+    // Signal dictionary for readable trace output
+    QS_DICT_SIG(TICK_SIG, (void *)0),
+    QS_DICT_SIG(SENSOR_DATA_SIG, (void *)0),
+    QS_DICT_SIG(SENSOR_BLOCK_SIG, (void *)0),
+    QS_DICT_SIG(SENSOR_RESULT_SIG, (void *)0),
+    QS_DICT_SIG(FAULT_SIG, (void *)0),
+    QS_DICT_SIG(MODE_CHANGE_SIG, (void *)0),
+    QS_DICT_SIG(START_SIG, (void *)0),
+    QS_DICT_SIG(STOP_SIG, (void *)0),
+    QS_DICT_SIG(RESET_SIG, (void *)0),
+    QS_DICT_SIG(CONFIG_SIG, (void *)0),
+    QS_DICT_SIG(GPIO_SIG, (void *)0),
+    QS_DICT_SIG(TIMER_SIG, (void *)0),
+    QS_DICT_SIG(UART_RX_SIG, (void *)0),
+    QS_DICT_SIG(SPI_COMPLETE_SIG, (void *)0),
+};
+
 #endif // Q_SPY
 
 //============================================================================
@@ -73,15 +122,46 @@ int main(void) {
     
     // Initialize Board Support Package
     BSP_init();
+    FLOW_BENCH_INIT(BSP_SYSTEM_CLOCK_HZ / 1000000U); // Boot time from here
+    
+    // Start RTC profiler time base (no-op unless RTC_PROF_ENABLE)
+    RTC_PROF_INIT(BSP_SYSTEM_CLOCK_HZ / 1000000U);
+    LAT_PROBE_INIT(BSP_SYSTEM_CLOCK_HZ / 1000000U);
+    BENCH_INIT(BSP_SYSTEM_CLOCK_HZ / 1000000U,
+               BSP_SYSTEM_CLOCK_HZ / BSP_TICKS_PER_SEC);
+    WORK_CHUNK_INIT(BSP_SYSTEM_CLOCK_HZ / 1000000U);
     
     // Initialize event pools
     QF_poolInit(l_smlPoolSto, sizeof(l_smlPoolSto), sizeof(l_smlPoolSto[0]));
     QF_poolInit(l_medPoolSto, sizeof(l_medPoolSto), sizeof(l_medPoolSto[0]));
     QF_poolInit(l_lrgPoolSto, sizeof(l_lrgPoolSto), sizeof(l_lrgPoolSto[0]));
     
+    // Monitor the pools in QF pool ID order (no-op unless POOL_MON_ENABLE)
+    POOL_MON_INIT(BSP_TICKS_PER_SEC);
+    QUEUE_MON_INIT(BSP_TICKS_PER_SEC);
+    POOL_MON_REGISTER(l_smlPoolSto, sizeof(l_smlPoolSto), sizeof(l_smlPoolSto[0]));
+    POOL_MON_REGISTER(l_medPoolSto, sizeof(l_medPoolSto), sizeof(l_medPoolSto[0]));
+    POOL_MON_REGISTER(l_lrgPoolSto, sizeof(l_lrgPoolSto), sizeof(l_lrgPoolSto[0]));
+    
+    // Zero-copy buffer pool for streamed data (largest blocks, so last;
+    // no-op unless BUF_POOL_ENABLE, which needs QF_MAX_EPOOL >= 4)
+    BUF_POOL_INIT();
+    
     // Initialize publish-subscribe mechanism
     QActive_psInit(l_subscrSto, Q_DIM(l_subscrSto));
     
+    // Bitmask multicast for FAULT_SIG/MODE_CHANGE_SIG (Mcast_subscribe())
+    Mcast_init();
+    
+    // TICK_SIG fan-out (AOs call TickDiv_subscribe() with their period)
+    TickDiv_init(TICK_SIG);
+    
+    // Last-value-wins sensor samples: one pending event per sensor_id
+    COALESCE_ADD(SENSOR_DATA_SIG, SensorDataEvt, sensor_id);
+
+    // Captured events with parameters (same list as the host's main.c)
+    REPLAY_EVT(SENSOR_DATA_SIG, SensorDataEvt);
+    
 #ifdef Q_SPY
     // Initialize QS software tracing
     if (!QS_INIT(l_qsTxBuf, sizeof(l_qsTxBuf), 
@@ -89,32 +169,21 @@ int main(void) {
         Q_ERROR();
     }
     
+    // Compact trace mode: string dictionary + SYNC (no-op unless enabled)
+    QS_COMPACT_INIT();
+    
     // Setup QS filters
     QS_GLB_FILTER(QS_ALL_RECORDS);   // Enable all QS records
     QS_GLB_FILTER(-QS_QF_TICK);      // Disable tick records (too frequent)
     
+    // Per-AO filters start from this setting (no-op unless QS_FILT_ENABLE)
+    QS_FILT_INIT(BSP_SYSTEM_CLOCK_HZ / 1000000U);
+    
     // Enable local filters for specific Active Objects
     // QS_LOC_FILTER(QS_AO_OBJ, AO_MyActiveObject);
     
-    // User-defined trace records
-    QS_USR_DICTIONARY(QS_SENSOR_DATA);
-    QS_USR_DICTIONARY(QS_GPIO_CHANGE);
-    QS_USR_DICTIONARY(QS_TIMING_INFO);
-    QS_USR_DICTIONARY(QS_ERROR_INFO);
-    
-    // Signal dictionary for readable trace output
-    QS_SIG_DICTIONARY(TICK_SIG, (void *)0);
-    QS_SIG_DICTIONARY(SENSOR_DATA_SIG, (void *)0);
-    QS_SIG_DICTIONARY(FAULT_SIG, (void *)0);
-    QS_SIG_DICTIONARY(MODE_CHANGE_SIG, (void *)0);
-    QS_SIG_DICTIONARY(START_SIG, (void *)0);
-    QS_SIG_DICTIONARY(STOP_SIG, (void *)0);
-    QS_SIG_DICTIONARY(RESET_SIG, (void *)0);
-    QS_SIG_DICTIONARY(CONFIG_SIG, (void *)0);
-    QS_SIG_DICTIONARY(GPIO_SIG, (void *)0);
-    QS_SIG_DICTIONARY(TIMER_SIG, (void *)0);
-    QS_SIG_DICTIONARY(UART_RX_SIG, (void *)0);
-    QS_SIG_DICTIONARY(SPI_COMPLETE_SIG, (void *)0);
+    // Dictionaries (only their build IDs with QS_DICT_ROM_ENABLE)
+    QS_DICT_SEND(main);
     
     // {{QS_SIGNAL_DICTIONARY_ENTRIES}}
     
@@ -136,9 +205,28 @@ int main(void) {
                   myAO_queueSto, Q_DIM(myAO_queueSto), // Event queue
                   myAO_stackSto, sizeof(myAO_stackSto), // Stack (QXK only)
                   (void *)0);                      // Initialization parameter
+    RTC_PROF_ATTACH(AO_MyAO, AO_MYAO_MAX_RTC_TIME_US); // After start (prio set)
+    QUEUE_MON_ATTACH(AO_MyAO);                          // After start (queue set)
+    QS_FILT_ATTACH(AO_MyAO);                            // After RTC_PROF_ATTACH
     */
     
-    // Transfer control to QK kernel
+    // Event bridge to the peer node (no-op unless BRIDGE_ENABLE). The peer
+    // imports what this node exports; -DBRIDGE_NODE_CONTROLLER builds the
+    // controller side of the pair.
+    BRIDGE_START(0U, AO_COMM_PRIO, BSP_bridgeDriver(0U));
+#ifdef BRIDGE_NODE_CONTROLLER
+    BRIDGE_EXPORT(0U, CONFIG_SIG, ConfigEvt);
+    BRIDGE_IMPORT(0U, SENSOR_DATA_SIG, SensorDataEvt);
+#else
+    BRIDGE_EXPORT(0U, SENSOR_DATA_SIG, SensorDataEvt);
+    BRIDGE_IMPORT(0U, CONFIG_SIG, ConfigEvt);
+#endif
+    
+    // Event-flow benchmark AOs above the application (no-op unless
+    // FLOW_BENCH_ENABLE): source and FLOW_BENCH_SINKS sinks, run by command 24
+    FLOW_BENCH_START(AO_CRITICAL_PRIO + 1U, FLOW_BENCH_SIG);
+    
+    // Transfer control to the kernel (QK or QV)
     return QF_run();
 }
 
@@ -147,11 +235,14 @@ int main(void) {
 //============================================================================
 
 void QF_onStartup(void) {
+    FLOW_BENCH_BOOTED();   // End of the boot time measurement
+    
     // Enable interrupts that are used by the application
     
     // Configure system tick for QF
     SystemCoreClockUpdate();
     SysTick_Config(SystemCoreClock / BSP_TICKS_PER_SEC);
+    TICKLESS_INIT();   // SysTick from HCLK/8 for long tickless periods
     
     // Set interrupt priorities for QK kernel
     // SysTick has the lowest priority among kernel-aware interrupts
@@ -163,6 +254,9 @@ void QF_onStartup(void) {
     // NVIC_EnableIRQ(USART2_IRQn);
     
     // {{INTERRUPT_CONFIGURATION}}
+
+    // Trace external events for host replay (no-op unless enabled)
+    REPLAY_CAPTURE_START(&l_SysTick_Handler);
 }
 
 void QF_onCleanup(void) {
@@ -170,10 +264,8 @@ void QF_onCleanup(void) {
     BSP_terminate(0);
 }
 
-void QK_onIdle(void) {
-    // Called when no Active Objects are ready to run
-    // This is an ideal place for power management
-    
+// Idle work of both kernels (interrupts enabled)
+static void idleWork(void) {
     // Toggle heartbeat LED to show system is alive
     static uint32_t idle_counter = 0;
     if ((++idle_counter % 10000U) == 0U) {
@@ -185,31 +277,65 @@ void QK_onIdle(void) {
     
     // QS trace output during idle time
 #ifdef Q_SPY
+    BSP_qsPoll();  // Move RX DMA bytes to QS-RX, hand next TX block to DMA
     QS_rxParse();  // Parse QS-RX input
-    QS_doOutput(); // Perform QS-TX output
 #endif
 }
 
+#ifdef QK_ISR_ENTRY
+
+void QK_onIdle(void) {
+    // Called when no Active Objects are ready to run
+    // This is an ideal place for power management
+    idleWork();
+    
+    // Tickless idle: sleep until the nearest time event instead of
+    // waking up every tick (no-op unless TICKLESS_IDLE_ENABLE)
+    TICKLESS_IDLE();
+}
+
+#else // QV
+
+void QV_onIdle(void) {
+    // Called with interrupts disabled and no AO ready to run. Sleep
+    // first: an ISR that posts wakes the CPU, and QV dispatches the event
+    // when this returns. Sleeping after the idle work could miss a post
+    // made in between.
+#ifdef TICKLESS_IDLE_ENABLE
+    TICKLESS_IDLE();       // Returns with interrupts enabled
+#else
+    QF_INT_ENABLE();
+#endif
+    idleWork();
+}
+
+#endif // QK_ISR_ENTRY
+
 //============================================================================
 // QK KERNEL HOOKS
 //============================================================================
 
+#ifdef QK_ISR_ENTRY
+
 void QK_onContextSw(QActive *prev, QActive *next) {
-    // Called on every context switch in QK
-    // Useful for profiling and debugging
+    // Called on every context switch in QK (with interrupts disabled)
+    // prev or next is NULL when switching from/to the idle loop
     
 #ifdef Q_SPY
     QS_BEGIN_ID(QS_SCHED_PREEMPT, 0U)
         QS_TIME_();                           // Timestamp
-        QS_2U8_((uint8_t)prev->prio,          // Previous AO priority
-                (uint8_t)next->prio);         // Next AO priority
+        QS_2U8_((uint8_t)((prev != (QActive *)0) ? prev->prio : 0U),
+                (uint8_t)((next != (QActive *)0) ? next->prio : 0U));
     QS_END_()
 #endif
     
-    // Performance monitoring
-    // Can be used to measure context switch overhead
+    // Performance monitoring: exclude preemption time from RTC steps
+    RTC_PROF_CONTEXT_SW(prev, next);
+    BENCH_CONTEXT_SW();
 }
 
+#endif // QK_ISR_ENTRY (QV has no context switches: AOs run to completion)
+
 //============================================================================
 // ASSERTION AND ERROR HANDLING
 //============================================================================
@@ -243,20 +369,35 @@ void Q_onAssert(char const *module, int loc) {
 //============================================================================
 
 void SysTick_Handler(void) {
-    // Kernel-aware interrupt handling for QK
-    QK_ISR_ENTRY();   // Inform QK kernel about ISR entry
-    
-    // Publish system tick event to all subscribers
-    static QEvt const tick_evt = QEVT_INITIALIZER(TICK_SIG);
-    QACTIVE_PUBLISH(&tick_evt, &l_SysTick_Handler);
-    
-    // Process QF time events
-    QTIMEEVT_TICK_X(0U, &l_SysTick_Handler);
-    
-    // Call BSP tick hook for application-specific processing
-    BSP_tickHook();
+    // Kernel-aware interrupt handling (QK; nothing to do for QV)
+    BSP_ISR_ENTRY();  // Inform the kernel about ISR entry
+    FLOW_BENCH_TICK_BEGIN();
+    
+    // Ticks covered by this interrupt (more than one after tickless sleep)
+    uint32_t nTicks = BSP_tickAdvance();
+    while (nTicks != 0U) {
+        --nTicks;
+        REPLAY_CAPTURE_TICK();   // Replay tick count (no-op unless enabled)
+        
+        // Benchmark clock: releases are due at the tick (no-op unless enabled)
+        BENCH_TICK();
+        
+        // Post TICK_SIG only to subscribers whose period has elapsed
+        // (ticks are coalescible: dropped rather than filling a queue)
+        TickDiv_tick(&l_SysTick_Handler);
+        
+        // Process QF time events (and the time wheel, if enabled)
+        TIME_WHEEL_TICK(&l_SysTick_Handler);
+        
+        // Call BSP tick hook for application-specific processing
+        BSP_tickHook();
+        POOL_MON_TICK();
+        QUEUE_MON_TICK();
+        QS_COMPACT_TICK();
+    }
     
-    QK_ISR_EXIT();    // Inform QK kernel about ISR exit
+    FLOW_BENCH_TICK_END();
+    BSP_ISR_EXIT();   // Inform the kernel about ISR exit
 }
 
 //============================================================================
@@ -290,7 +431,7 @@ void QS_onFlush(void) {
 
 QSTimeCtr QS_onGetTime(void) {
     // Return current timestamp for QS
-    return (QSTimeCtr)BSP_getTime();
+    return (QSTimeCtr)BSP_getTimeUs();
 }
 
 void QS_onCommand(uint8_t cmdId, uint32_t param1, 
@@ -308,6 +449,115 @@ void QS_onCommand(uint8_t cmdId, uint32_t param1,
             NVIC_SystemReset();
             break;
         }
+        case 4U: {
+            // Command 4: Report RTC profile (param1 = AO prio, 0 = all)
+            RTC_PROF_REPORT((uint_fast8_t)param1);
+            WORK_CHUNK_REPORT();            // Chunk sizes of long operations
+            break;
+        }
+        case 5U: {
+            // Command 5: Reset RTC profile statistics
+            RTC_PROF_RESET();
+            WORK_CHUNK_RESET();
+            break;
+        }
+        case 6U: {
+            // Command 6: Report event pool usage
+            POOL_MON_REPORT();
+            break;
+        }
+        case 7U: {
+            // Command 7: Report AO queue usage (param1 = AO prio, 0 = all)
+            QUEUE_MON_REPORT((uint_fast8_t)param1);
+            break;
+        }
+        case 8U: {
+            // Command 8: Re-send the compact QS string dictionary
+            QS_COMPACT_DUMP();
+            break;
+        }
+        case 9U: {
+            // Command 9: Report latency probe (param1 = channel + 1, 0 = all)
+            LAT_PROBE_REPORT((uint_fast8_t)param1);
+            break;
+        }
+        case 10U: {
+            // Command 10: Reset latency probe statistics
+            LAT_PROBE_RESET();
+            break;
+        }
+        case 11U: {
+            // Command 11: Load AO param1: busy param3 us every param2 ticks
+            LAT_PROBE_LOAD((uint_fast8_t)param1, param2, param3);
+            break;
+        }
+        case 12U: {
+            // Command 12: Latency edge generator, param1 = mean us (0 = off)
+            LAT_PROBE_GEN(param1);
+            break;
+        }
+        case 13U: {
+            // Command 13: Report scheduling benchmark statistics
+            BENCH_REPORT();
+            break;
+        }
+        case 14U: {
+            // Command 14: Reset benchmark statistics (start a new window)
+            BENCH_RESET();
+            break;
+        }
+        case 15U: {
+            // Command 15: Report coalesced posts per signal
+            COALESCE_REPORT();
+            break;
+        }
+        case 16U: {
+            // Command 16: Benchmark block DSP vs per-sample events
+            DSP_BENCH_RUN(BSP_SYSTEM_CLOCK_HZ / 1000000U,
+                          SensorDataEvt, SENSOR_DATA_SIG);
+            break;
+        }
+        case 17U: {
+            // Command 17: Report event bridge link counters
+            BRIDGE_REPORT();
+            break;
+        }
+        case 18U: {
+            // Command 18: Reset event bridge counters (start a new window)
+            BRIDGE_RESET();
+            break;
+        }
+        case 19U: {
+            // Command 19: Time wheel vs QF list tick (param1 timers, param2 ticks)
+            TIME_WHEEL_BENCH_RUN(BSP_SYSTEM_CLOCK_HZ / 1000000U, param1, param2);
+            break;
+        }
+        case 20U: {
+            // Command 20: Send the QS dictionary tables again
+            QS_DICT_RESEND();
+            break;
+        }
+        case 21U: {
+            // Command 21: Per-AO QS filter (param1 prio, 0 = all, 0xFF = non-AO;
+            // param2 group mask, 0xFFFF = global; param3 0 set, 1 add, 2 remove)
+            QS_FILT_SET(param1, param2, param3);
+            break;
+        }
+        case 22U: {
+            // Command 22: Report the QS filters and trace cost (param1 prio, 0 = all)
+            QS_FILT_REPORT(param1);
+            break;
+        }
+        case 23U: {
+            // Command 23: Reset the trace cost counters (start a new window)
+            QS_FILT_RESET();
+            break;
+        }
+        case 24U: {
+            // Command 24: Event-flow benchmark (param1 rounds, 0 = default)
+            FLOW_BENCH_RUN(param1);
+            break;
+        }
         // Add more commands as needed
         // {{QS_COMMAND_HANDLERS}}
         default: {
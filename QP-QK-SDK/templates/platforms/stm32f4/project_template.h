@@ -31,7 +31,20 @@ extern "C" {
 // QK kernel configuration
 #define QK_PREEMPTION_PRIO   64U  // Maximum priority levels
 
-// Memory pools configuration
+// Kernel: the QP port on the include path decides (build.py --kernel,
+// make KERNEL=qv). The QK port defines QK_ISR_ENTRY(); under the
+// cooperative QV kernel an ISR needs no entry/exit, the event loop picks
+// up the posted events once the ISR returns.
+#ifdef QK_ISR_ENTRY
+#define BSP_ISR_ENTRY()      QK_ISR_ENTRY()
+#define BSP_ISR_EXIT()       QK_ISR_EXIT()
+#else
+#define BSP_ISR_ENTRY()      ((void)0)
+#define BSP_ISR_EXIT()       ((void)0)
+#endif
+
+// Memory pools configuration (resized by tools/analyzers/pool_sizer.py)
+// The zero-copy buffer pool (buf_pool.h, BUF_POOL_ENABLE) is a fourth pool
 #define SMALL_EVENT_POOL_SIZE   16U
 #define MEDIUM_EVENT_POOL_SIZE  8U  
 #define LARGE_EVENT_POOL_SIZE   4U
@@ -72,6 +85,8 @@ enum ProjectSignals {
     // Published signals (one-to-many)
     TICK_SIG = Q_USER_SIG,    // System tick event
     SENSOR_DATA_SIG,          // Sensor data available
+    SENSOR_BLOCK_SIG,         // Sample block (BufEvt, zero-copy)
+    SENSOR_RESULT_SIG,        // Reduced sample block (SensorResultEvt)
     FAULT_SIG,                // System fault detected
     MODE_CHANGE_SIG,          // Operating mode change
     
@@ -87,6 +102,9 @@ enum ProjectSignals {
     UART_RX_SIG,             // UART receive
     SPI_COMPLETE_SIG,        // SPI transaction complete
     
+    // Service signals
+    FLOW_BENCH_SIG,           // Flow benchmark fan-out (flow_bench.h)
+
     // Add project-specific signals here
     // {{PROJECT_SIGNALS}}
     
@@ -102,7 +120,8 @@ typedef struct {
     QEvt super;
 } BaseEvt;
 
-// Sensor data event
+// Sensor data event (single sample; stream sample blocks as BufEvt from
+// templates/services/buf_pool.h instead of enlarging this event)
 typedef struct {
     QEvt super;
     uint16_t sensor_id;
@@ -111,6 +130,21 @@ typedef struct {
     uint8_t status;
 } SensorDataEvt;
 
+// Reduced sample block, published by the sensor pipeline AO template
+// (templates/active_objects/sensor_pipeline_template.c)
+typedef struct {
+    QEvt super;
+    uint16_t sensor_id;
+    uint16_t seq;             // BufEvt.seq of the last block folded in
+    uint32_t timestamp;
+    float mean;
+    float rms;
+    float min;
+    float max;
+    float peak_hz;            // Strongest non-DC frequency (0 = none)
+    float peak_amp;
+} SensorResultEvt;
+
 // Configuration event
 typedef struct {
     QEvt super;
@@ -147,7 +181,11 @@ void BSP_ledToggle(uint8_t led);
 
 // System timing
 void BSP_tickHook(void);
+uint32_t BSP_tickAdvance(void);  // Ticks covered by this SysTick IRQ
 uint32_t BSP_getTime(void);
+uint32_t BSP_getTimeUs(void);     // TIM2, 1 us, wraps every ~71 min
+uint64_t BSP_getTimeUs64(void);   // TIM5:TIM2, lock-free 64-bit read
+uint32_t BSP_cycles(void);   // DWT cycle counter (profiling time base)
 
 // Hardware abstraction
 void BSP_gpio_init(void);
@@ -166,7 +204,22 @@ void BSP_systick_handler(void);
     // QS buffer sizes
     #define QS_TX_BUFFER_SIZE   2048U
     #define QS_RX_BUFFER_SIZE   256U
+    #ifdef QS_COMPACT_ENABLE
+    #define QS_TSTAMP_SIZE      2U    // Unrolled on the host via SYNC records
+    #else
     #define QS_TSTAMP_SIZE      4U
+    #endif
+    
+    // QS trace transport
+    // UART_DMA: USART2 with double-buffered TX DMA and circular RX DMA
+    // SWO:      ITM stimulus port 0 for TX (needs SWO probe), UART RX DMA
+    #define QS_TRANSPORT_UART_DMA   1U
+    #define QS_TRANSPORT_SWO        2U
+    #define QS_TRANSPORT        QS_TRANSPORT_UART_DMA
+    #define QS_UART_BAUDRATE    921600U   // Up to 2.6 Mbaud on APB1 (42 MHz)
+    #define QS_SWO_BAUDRATE     2000000U  // Must divide BSP_SYSTEM_CLOCK_HZ
+    #define QS_DMA_BLOCK_SIZE   256U      // Bytes per TX DMA transfer (x2)
+    #define QS_RX_DMA_SIZE      64U       // Circular RX DMA buffer
     
     // QS trace records
     enum QSUserRecords {
@@ -177,6 +230,7 @@ void BSP_systick_handler(void);
         QS_ERROR_INFO,            // Error information
         // Add project-specific trace records
         // {{QS_USER_RECORDS}}
+        // NOTE: QS_USER + 15..24 are reserved for templates/services
     };
     
     // QS initialization
@@ -185,6 +239,9 @@ void BSP_systick_handler(void);
     void QS_onFlush(void);
     QSTimeCtr QS_onGetTime(void);
     
+    // Non-blocking QS transport service, called from the idle callback
+    void BSP_qsPoll(void);
+    
 #endif // Q_SPY
 
 //============================================================================
@@ -214,7 +271,7 @@ void BSP_error_handler(ErrorCode_t error, const char* file, int line);
 // Memory pool storage declarations
 extern QF_MPOOL_EL(BaseEvt) l_smlPoolSto[SMALL_EVENT_POOL_SIZE];
 extern QF_MPOOL_EL(SensorDataEvt) l_medPoolSto[MEDIUM_EVENT_POOL_SIZE];
-extern QF_MPOOL_EL(ConfigEvt) l_lrgPoolSto[LARGE_EVENT_POOL_SIZE];
+extern QF_MPOOL_EL(SensorResultEvt) l_lrgPoolSto[LARGE_EVENT_POOL_SIZE];
 
 //============================================================================
 // PROJECT-SPECIFIC CONFIGURATION
@@ -0,0 +1,230 @@
+/**
+ * @file bench_stats.c
+ * @brief Multi-Rate Scheduling Benchmark Statistics
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * Time model: Bench_tick() counts clock ticks and stamps the cycle counter
+ * at each tick. A release due at tick n that completes at cycle c, with the
+ * last tick m stamped at cycle s, took (m - n) ticks plus (c - s) cycles.
+ * Both the response time and the measurement window are thus exact to the
+ * cycle without a 64-bit cycle counter.
+ *
+ * CPU utilization is the time at least one benchmarked handler was on the
+ * stack. Shared data is accessed under QF_CRIT_ENTRY(), which also covers
+ * the ticker thread of the POSIX port (QF_INT_DISABLE() is empty there).
+ */
+
+#include "bench_stats.h"
+#include <string.h>
+
+#ifdef BENCH_ENABLE
+
+Q_DEFINE_THIS_MODULE("bench_stats")
+
+//============================================================================
+// LOCAL VARIABLES
+//============================================================================
+
+static BenchAoStats l_ao[BENCH_MAX_AOS];
+
+static uint32_t l_cyclesPerUs;
+static uint32_t l_cyclesPerTick;
+
+static uint32_t l_ticks;            // Clock ticks since Bench_init()
+static uint32_t l_tickStamp;        // Cycle counter at the last tick
+static uint32_t l_windowStart;      // Tick of the last Bench_reset()
+
+static uint_fast8_t l_depth;        // Benchmarked handlers on the stack
+static uint8_t l_maxDepth;
+static uint32_t l_busyStart;        // Cycle counter when l_depth left 0
+static uint64_t l_busy;             // Cycles with l_depth > 0
+
+static uint32_t l_ctxSw;            // QK_onContextSw() calls
+static uint32_t l_aoSw;             // Handler starts/resumes of another AO
+static uint_fast8_t l_lastIdx;      // AO of the last handler started
+
+//============================================================================
+// PUBLIC FUNCTIONS
+//============================================================================
+
+void Bench_init(uint32_t cyclesPerUs, uint32_t cyclesPerTick) {
+    memset(l_ao, 0, sizeof(l_ao));
+    l_cyclesPerUs = cyclesPerUs;
+    l_cyclesPerTick = cyclesPerTick;
+    l_ticks = 0U;
+    l_tickStamp = BSP_cycles();
+    l_lastIdx = BENCH_MAX_AOS;
+    Bench_reset();
+}
+
+void Bench_attach(uint_fast8_t idx, QActive const * const ao,
+                  uint32_t periodTicks, uint32_t deadlineUs)
+{
+    Q_REQUIRE((idx < BENCH_MAX_AOS) && (ao->prio != 0U)   // After start
+              && (periodTicks != 0U));
+
+    BenchAoStats * const s = &l_ao[idx];
+    s->prio = (uint8_t)ao->prio;
+    s->periodTicks = periodTicks;
+    s->deadline = deadlineUs * l_cyclesPerUs;
+}
+
+void Bench_arm(uint_fast8_t idx) {
+    QF_CRIT_ENTRY(dummy);
+    // The time event fires on the periodTicks-th tick from now
+    l_ao[idx].nextRelease = l_ticks + l_ao[idx].periodTicks;
+    QF_CRIT_EXIT(dummy);
+}
+
+void Bench_begin(uint_fast8_t idx) {
+    QF_CRIT_ENTRY(dummy);
+    if (l_depth == 0U) {
+        l_busyStart = BSP_cycles();
+    }
+    ++l_depth;
+    if (l_depth > l_maxDepth) {
+        l_maxDepth = (uint8_t)l_depth;
+    }
+    if (idx != l_lastIdx) {
+        ++l_aoSw;
+        l_lastIdx = idx;
+    }
+    QF_CRIT_EXIT(dummy);
+}
+
+void Bench_end(void) {
+    QF_CRIT_ENTRY(dummy);
+    Q_ASSERT(l_depth != 0U);
+    --l_depth;
+    if (l_depth == 0U) {
+        l_busy += BSP_cycles() - l_busyStart;
+    } else {
+        ++l_aoSw;                       // The preempted handler resumes
+        l_lastIdx = BENCH_MAX_AOS;
+    }
+    QF_CRIT_EXIT(dummy);
+}
+
+void Bench_released(uint_fast8_t idx) {
+    BenchAoStats * const s = &l_ao[idx];
+
+    QF_CRIT_ENTRY(dummy);
+    uint32_t const now = BSP_cycles();
+    uint32_t const late = l_ticks - s->nextRelease;
+    uint32_t resp;
+    if ((int32_t)late < 0) {
+        resp = 0U;                      // Fired early (armed mid-tick)
+    } else if (late >= (0xFFFFFFFFU / l_cyclesPerTick) - 1U) {
+        resp = 0xFFFFFFFFU;
+    } else {
+        resp = (late * l_cyclesPerTick) + (now - l_tickStamp);
+    }
+    s->nextRelease += s->periodTicks;
+
+    ++s->releases;
+    if (resp > s->deadline) {
+        ++s->misses;
+    }
+    if (resp > s->respMax) {
+        s->respMax = resp;
+    }
+    s->respSum += resp;
+    QF_CRIT_EXIT(dummy);
+}
+
+void Bench_received(uint_fast8_t idx) {
+    ++l_ao[idx].received;               // Only the AO itself writes this
+}
+
+void Bench_spin(uint32_t us) {
+    uint32_t const busy = us * l_cyclesPerUs;
+    uint32_t const start = BSP_cycles();
+    while ((BSP_cycles() - start) < busy) {
+    }
+}
+
+void Bench_tick(void) {
+    QF_CRIT_ENTRY(dummy);
+    ++l_ticks;
+    l_tickStamp = BSP_cycles();
+    QF_CRIT_EXIT(dummy);
+}
+
+void Bench_onContextSw(void) {
+    ++l_ctxSw;                          // Interrupts are disabled here
+}
+
+BenchAoStats const *Bench_getAoStats(uint_fast8_t idx) {
+    return (idx < BENCH_MAX_AOS) ? &l_ao[idx] : (BenchAoStats const *)0;
+}
+
+void Bench_report(void) {
+    uint_fast8_t n = 0U;
+    for (uint_fast8_t idx = 0U; idx < BENCH_MAX_AOS; ++idx) {
+        n += (l_ao[idx].prio != 0U) ? 1U : 0U;
+    }
+
+    QF_CRIT_ENTRY(dummy);
+    uint32_t const ticks = l_ticks - l_windowStart;
+    uint64_t busy = l_busy;
+    if (l_depth != 0U) {
+        busy += BSP_cycles() - l_busyStart;
+    }
+    uint32_t const ctxSw = l_ctxSw;
+    uint32_t const aoSw = l_aoSw;
+    uint8_t const maxDepth = l_maxDepth;
+    QF_CRIT_EXIT(dummy);
+
+    QS_BEGIN_ID(BENCH_QS_REC, 0U)
+        QS_2U8_((uint8_t)BENCH_QS_SUMMARY, (uint8_t)n);
+        QS_U8_(maxDepth);
+        QS_U32_(l_cyclesPerUs);
+        QS_U32_(l_cyclesPerTick);
+        QS_U32_(ticks);
+        QS_U32_((uint32_t)(busy / l_cyclesPerUs));
+        QS_U32_(ctxSw);
+        QS_U32_(aoSw);
+        QS_U32_(BSP_stackPeak());
+    QS_END_()
+
+    for (uint_fast8_t idx = 0U; idx < BENCH_MAX_AOS; ++idx) {
+        BenchAoStats const * const s = &l_ao[idx];
+        if (s->prio == 0U) {
+            continue;
+        }
+        QS_BEGIN_ID(BENCH_QS_REC, 0U)
+            QS_2U8_((uint8_t)BENCH_QS_AO, (uint8_t)idx);
+            QS_U8_(s->prio);
+            QS_U32_(s->periodTicks);
+            QS_U32_(s->deadline);
+            QS_U32_(s->releases);
+            QS_U32_(s->misses);
+            QS_U32_(s->respMax);
+            QS_U32_((s->releases != 0U)
+                    ? (uint32_t)(s->respSum / s->releases) : 0U);
+            QS_U32_(s->received);
+        QS_END_()
+    }
+}
+
+void Bench_reset(void) {
+    QF_CRIT_ENTRY(dummy);
+    for (uint_fast8_t idx = 0U; idx < BENCH_MAX_AOS; ++idx) {
+        BenchAoStats * const s = &l_ao[idx];
+        s->releases = 0U;
+        s->misses = 0U;
+        s->respMax = 0U;
+        s->respSum = 0U;
+        s->received = 0U;
+    }
+    l_windowStart = l_ticks;
+    l_busy = 0U;
+    l_busyStart = BSP_cycles();         // A running handler counts from now
+    l_maxDepth = (uint8_t)l_depth;
+    l_ctxSw = 0U;
+    l_aoSw = 0U;
+    QF_CRIT_EXIT(dummy);
+}
+
+#endif // BENCH_ENABLE
@@ -0,0 +1,197 @@
+/**
+ * @file bench_stats.h
+ * @brief Multi-Rate Scheduling Benchmark Statistics
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * Measures how the kernel schedules a set of periodic Active Objects:
+ * CPU utilization, context switches, preemption depth, stack peak and,
+ * per AO, release response times and deadline misses.
+ *
+ * The synthetic AOs generated by tools/generators/bench_gen.py bracket
+ * every event handler with BENCH_BEGIN()/BENCH_END() and close each
+ * periodic release with BENCH_RELEASED(). A release is due at the tick its
+ * periodic time event fires, so the response time of a release is measured
+ * from that tick, including the time the AO waited behind higher
+ * priorities. tools/analyzers/qk_bench.py reads the results and writes
+ * them in a format that can be compared across SDK versions.
+ */
+
+#ifndef BENCH_STATS_H
+#define BENCH_STATS_H
+
+#include "qpc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//============================================================================
+// CONFIGURATION
+//============================================================================
+
+#ifndef BENCH_MAX_AOS
+#define BENCH_MAX_AOS           16U     // Benchmarked Active Objects
+#endif
+
+// QS user record reserved for this service (see project_template.h)
+#define BENCH_QS_REC            (QS_USER + 19)
+
+// Sub-record types carried in the first byte of BENCH_QS_REC
+enum BenchQSType {
+    BENCH_QS_SUMMARY = 1U,      /**< ticks, busy, switches, depth, stack */
+    BENCH_QS_AO,                /**< idx, prio, releases, misses, response */
+    BENCH_QS_DSP,               /**< Block vs per-sample cost (dsp_block.h) */
+    BENCH_QS_TIMER,             /**< Wheel vs QF list tick (time_wheel.h) */
+    BENCH_QS_FLOW               /**< Post, publish, tick, boot (flow_bench.h) */
+};
+
+//============================================================================
+// STATISTICS
+//============================================================================
+
+/**
+ * @brief Statistics of one benchmarked AO
+ */
+typedef struct {
+    uint8_t prio;               /**< QF priority (0 = not attached) */
+    uint32_t periodTicks;       /**< Release period */
+    uint32_t deadline;          /**< Relative deadline in cycles */
+    uint32_t nextRelease;       /**< Tick of the next due release */
+    uint32_t releases;          /**< Releases completed */
+    uint32_t misses;            /**< Releases completed after the deadline */
+    uint32_t respMax;           /**< Longest response time in cycles */
+    uint64_t respSum;           /**< Sum of response times (for mean) */
+    uint32_t received;          /**< Published events handled */
+} BenchAoStats;
+
+//============================================================================
+// PUBLIC INTERFACE
+//============================================================================
+
+/**
+ * @brief Free-running 32-bit CPU cycle counter (provided by the BSP)
+ */
+uint32_t BSP_cycles(void);
+
+/**
+ * @brief Peak use of the stack the AOs run on, in bytes (0 = unknown)
+ *
+ * Provided by the BSP: the STM32F4 BSP paints the main stack in
+ * BSP_init(), the POSIX BSP reads the main thread's stack size.
+ */
+uint32_t BSP_stackPeak(void);
+
+/**
+ * @brief Initialize the benchmark
+ *
+ * @param cyclesPerUs   CPU cycles per microsecond (BSP_SYSTEM_CLOCK_HZ / 1e6)
+ * @param cyclesPerTick CPU cycles per clock tick
+ */
+void Bench_init(uint32_t cyclesPerUs, uint32_t cyclesPerTick);
+
+/**
+ * @brief Register a benchmarked AO (after QACTIVE_START())
+ *
+ * @param idx         AO index (< BENCH_MAX_AOS)
+ * @param ao          The Active Object (for its priority)
+ * @param periodTicks Release period in clock ticks
+ * @param deadlineUs  Relative deadline in microseconds
+ */
+void Bench_attach(uint_fast8_t idx, QActive const * const ao,
+                  uint32_t periodTicks, uint32_t deadlineUs);
+
+/**
+ * @brief The AO armed its periodic time event (first release in one period)
+ */
+void Bench_arm(uint_fast8_t idx);
+
+/**
+ * @brief Start of an event handler (any event, any benchmarked AO)
+ */
+void Bench_begin(uint_fast8_t idx);
+
+/**
+ * @brief End of an event handler started with Bench_begin()
+ */
+void Bench_end(void);
+
+/**
+ * @brief The work of the current periodic release is done
+ */
+void Bench_released(uint_fast8_t idx);
+
+/**
+ * @brief A published event was handled
+ */
+void Bench_received(uint_fast8_t idx);
+
+/**
+ * @brief Busy-wait: the synthetic RTC cost of a handler
+ */
+void Bench_spin(uint32_t us);
+
+/**
+ * @brief Advance the benchmark clock (tick ISR, before QTIMEEVT_TICK_X())
+ */
+void Bench_tick(void);
+
+/**
+ * @brief Count a QK context switch (call from QK_onContextSw())
+ */
+void Bench_onContextSw(void);
+
+/**
+ * @brief Statistics for one AO (NULL if out of range)
+ */
+BenchAoStats const *Bench_getAoStats(uint_fast8_t idx);
+
+/**
+ * @brief Emit the summary and per-AO statistics as QS records
+ */
+void Bench_report(void);
+
+/**
+ * @brief Clear all statistics and restart the measurement window
+ */
+void Bench_reset(void);
+
+//============================================================================
+// INTEGRATION MACROS
+//============================================================================
+
+#ifdef BENCH_ENABLE
+#define BENCH_INIT(cyclesPerUs_, cyclesPerTick_) \
+    Bench_init((cyclesPerUs_), (cyclesPerTick_))
+#define BENCH_ATTACH(idx_, ao_, periodTicks_, deadlineUs_) \
+    Bench_attach((idx_), (ao_), (periodTicks_), (deadlineUs_))
+#define BENCH_ARM(idx_)                 Bench_arm(idx_)
+#define BENCH_BEGIN(idx_)               Bench_begin(idx_)
+#define BENCH_END()                     Bench_end()
+#define BENCH_RELEASED(idx_)            Bench_released(idx_)
+#define BENCH_RECEIVED(idx_)            Bench_received(idx_)
+#define BENCH_SPIN(us_)                 Bench_spin(us_)
+#define BENCH_TICK()                    Bench_tick()
+#define BENCH_CONTEXT_SW()              Bench_onContextSw()
+#define BENCH_REPORT()                  Bench_report()
+#define BENCH_RESET()                   Bench_reset()
+#else
+#define BENCH_INIT(cyclesPerUs_, cyclesPerTick_)            ((void)0)
+#define BENCH_ATTACH(idx_, ao_, periodTicks_, deadlineUs_)  ((void)0)
+#define BENCH_ARM(idx_)                 ((void)0)
+#define BENCH_BEGIN(idx_)               ((void)0)
+#define BENCH_END()                     ((void)0)
+#define BENCH_RELEASED(idx_)            ((void)0)
+#define BENCH_RECEIVED(idx_)            ((void)0)
+#define BENCH_SPIN(us_)                 ((void)0)
+#define BENCH_TICK()                    ((void)0)
+#define BENCH_CONTEXT_SW()              ((void)0)
+#define BENCH_REPORT()                  ((void)0)
+#define BENCH_RESET()                   ((void)0)
+#endif // BENCH_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BENCH_STATS_H
@@ -0,0 +1,610 @@
+/**
+ * @file bridge.c
+ * @brief Event Bridge Between QP Nodes
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * Frame (little-endian):
+ *
+ *   0 magic  1 flags  2 seq  3 credit  4 len U16  6 count U16
+ *   8 txUs U32  12 echoUs U32  16 holdUs U32
+ *   20 records: sig U16, n U8, n parameter bytes ...   CRC U16
+ *
+ * seq numbers the data frames (control frames carry the next one). credit
+ * is the first seq the peer may not send yet: each node may send the data
+ * frames from its txSeq up to, but not including, the last credit it got.
+ * The receiver frees a frame once its events are published, or when a
+ * sequence gap shows the frame is lost.
+ *
+ * Every frame echoes the txUs of the last frame received, with the time it
+ * was held before the reply (holdUs), so each side measures the RTT from
+ * the normal traffic.
+ */
+
+#include "bridge.h"
+#include <string.h>
+
+#ifdef BRIDGE_ENABLE
+
+#ifndef BUF_POOL_ENABLE
+#error "BRIDGE_ENABLE needs BUF_POOL_ENABLE (frames are BufEvt blocks)"
+#endif
+
+Q_DEFINE_THIS_MODULE("bridge")
+
+Q_ASSERT_STATIC(BRIDGE_FRAME_SIZE <= BUF_POOL_BLOCK_SIZE);
+Q_ASSERT_STATIC((BRIDGE_RX_CREDITS > 0U) && (BRIDGE_RX_CREDITS < 128U));
+Q_ASSERT_STATIC(BRIDGE_TX_PENDING > 0U);
+
+#define BRIDGE_REC_HDR          3U      // sig U16, n U8
+
+//============================================================================
+// LOCAL TYPES AND VARIABLES
+//============================================================================
+
+typedef struct {
+    QSignal sig;
+    uint16_t evtSize;                   /**< sizeof() of the event type */
+    bool exported;                      /**< false = imported */
+} BridgeRoute;
+
+typedef struct {
+    QActive super;
+    QTimeEvt flushEvt;                  /**< Batching delay (one-shot) */
+    QTimeEvt pollEvt;                   /**< Sync and credit poll */
+    BridgeDriver const *drv;
+    BufStream rx;                       /**< Received frames, to this AO */
+    uint8_t link;
+
+    BridgeRoute route[BRIDGE_MAX_ROUTES];
+    uint8_t nRoutes;
+
+    bool up;                            /**< SYNC seen from the peer */
+    bool txBusy;                        /**< Driver is sending a frame */
+    bool syncDue;
+    bool ackDue;                        /**< Reply to the peer's SYNC */
+    bool creditDue;                     /**< Frames freed since the last send */
+    bool pollDue;
+    bool fillExpired;                   /**< Flush timeout of the fill is over */
+    uint8_t txSeq;                      /**< Next data frame to send */
+    uint8_t txCredit;                   /**< Last credit from the peer */
+    uint8_t rxSeq;                      /**< Next data frame expected */
+    uint8_t rxFreed;                    /**< Frames freed (credit - CREDITS) */
+
+    bool echoValid;                     /**< A txUs is waiting to be echoed */
+    uint32_t echoUs;                    /**< txUs of the last frame received */
+    uint32_t echoAt;                    /**< When it was received */
+
+    BufEvt *fill;                       /**< Frame being filled (owned) */
+    uint16_t fillCount;
+    uint32_t fillUs;                    /**< Time of its first event */
+    BufEvt *pend[BRIDGE_TX_PENDING];    /**< Closed frames, oldest first */
+    uint8_t pendHead;
+    uint8_t pendN;
+    BufEvt *inFlight;                   /**< Data frame the driver sends */
+    uint8_t ctrl[BRIDGE_HDR_SIZE + BRIDGE_CRC_SIZE];
+
+    BridgeLinkStats stats;
+} BridgeLink;
+
+static BridgeLink l_link[BRIDGE_MAX_LINKS];
+static QEvt const *l_queueSto[BRIDGE_MAX_LINKS][BRIDGE_QUEUE_LEN];
+
+//============================================================================
+// LOCAL FUNCTIONS
+//============================================================================
+
+static void Bridge_put16_(uint8_t * const p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void Bridge_put32_(uint8_t * const p, uint32_t v) {
+    Bridge_put16_(&p[0], (uint16_t)v);
+    Bridge_put16_(&p[2], (uint16_t)(v >> 16));
+}
+
+static uint16_t Bridge_get16_(uint8_t const * const p) {
+    return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+}
+
+static uint32_t Bridge_get32_(uint8_t const * const p) {
+    return Bridge_get16_(&p[0]) | ((uint32_t)Bridge_get16_(&p[2]) << 16);
+}
+
+static uint16_t Bridge_crc_(uint8_t const *p, uint16_t n) {
+    // CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF), a nibble at a time
+    static uint16_t const tbl[16] = {
+        0x0000U, 0x1021U, 0x2042U, 0x3063U, 0x4084U, 0x50A5U, 0x60C6U, 0x70E7U,
+        0x8108U, 0x9129U, 0xA14AU, 0xB16BU, 0xC18CU, 0xD1ADU, 0xE1CEU, 0xF1EFU
+    };
+    uint16_t crc = 0xFFFFU;
+    while (n-- != 0U) {
+        uint8_t const b = *p++;
+        crc = (uint16_t)((crc << 4) ^ tbl[((crc >> 12) ^ (b >> 4)) & 0x0FU]);
+        crc = (uint16_t)((crc << 4) ^ tbl[((crc >> 12) ^ b) & 0x0FU]);
+    }
+    return crc;
+}
+
+static BridgeRoute const *Bridge_route_(BridgeLink const * const me,
+                                        QSignal sig, bool exported)
+{
+    for (uint_fast8_t n = 0U; n < me->nRoutes; ++n) {
+        if ((me->route[n].sig == sig) && (me->route[n].exported == exported)) {
+            return &me->route[n];
+        }
+    }
+    return (BridgeRoute const *)0;
+}
+
+static void Bridge_addRoute_(uint_fast8_t const link, enum_t const sig,
+                             uint16_t const evtSize, bool exported)
+{
+    Q_REQUIRE(link < BRIDGE_MAX_LINKS);
+    BridgeLink * const me = &l_link[link];
+    Q_REQUIRE((me->drv != (BridgeDriver const *)0)   // Bridge_start() first
+              && (me->nRoutes < BRIDGE_MAX_ROUTES)
+              && (sig >= Q_USER_SIG) && (sig < (enum_t)BRIDGE_SIG_BASE)
+              && (evtSize >= sizeof(QEvt))
+              && ((evtSize - sizeof(QEvt)) <= 0xFFU)
+              && ((BRIDGE_HDR_SIZE + BRIDGE_REC_HDR + evtSize - sizeof(QEvt)
+                   + BRIDGE_CRC_SIZE) <= BRIDGE_FRAME_SIZE));
+
+    BridgeRoute * const r = &me->route[me->nRoutes];
+    r->sig = (QSignal)sig;
+    r->evtSize = evtSize;
+    r->exported = exported;
+    ++me->nRoutes;
+}
+
+static void Bridge_resetTx_(BridgeLink * const me) {
+    me->txSeq = 0U;
+    me->txCredit = (uint8_t)BRIDGE_RX_CREDITS;
+}
+
+static void Bridge_resetRx_(BridgeLink * const me, uint8_t seq) {
+    me->rxSeq = seq;
+    me->rxFreed = seq;
+    me->echoValid = false;
+}
+
+/** Free RX frames gap..seq-1 (lost) and expect seq next */
+static void Bridge_skip_(BridgeLink * const me, uint8_t seq) {
+    uint8_t const gap = (uint8_t)(seq - me->rxSeq);
+    me->stats.lostFrames += gap;
+    me->rxFreed = (uint8_t)(me->rxFreed + gap);
+    me->rxSeq = seq;
+    if (gap != 0U) {
+        me->creditDue = true;
+    }
+}
+
+/** Fill in the header fields known at send time and the CRC */
+static void Bridge_seal_(BridgeLink * const me, uint8_t * const f,
+                         uint8_t flags, uint16_t len, uint32_t now)
+{
+    if (me->echoValid) {
+        flags |= (uint8_t)BRIDGE_F_ECHO;
+        Bridge_put32_(&f[12], me->echoUs);
+        Bridge_put32_(&f[16], now - me->echoAt);
+        me->echoValid = false;
+    } else {
+        Bridge_put32_(&f[12], 0U);
+        Bridge_put32_(&f[16], 0U);
+    }
+    f[0] = (uint8_t)BRIDGE_MAGIC;
+    f[1] = flags;
+    f[2] = me->txSeq;
+    f[3] = (uint8_t)(me->rxFreed + BRIDGE_RX_CREDITS);
+    Bridge_put16_(&f[4], len);
+    Bridge_put32_(&f[8], now);
+    Bridge_put16_(&f[len - BRIDGE_CRC_SIZE],
+                  Bridge_crc_(f, (uint16_t)(len - BRIDGE_CRC_SIZE)));
+
+    me->creditDue = false;
+    me->stats.txBytes += len;
+}
+
+static void Bridge_sendCtrl_(BridgeLink * const me, uint8_t flags) {
+    uint16_t const len = BRIDGE_HDR_SIZE + BRIDGE_CRC_SIZE;
+    Bridge_put16_(&me->ctrl[6], 0U);
+    Bridge_seal_(me, &me->ctrl[0], flags, len, BSP_getTimeUs());
+    me->txBusy = me->drv->send(me->link, &me->ctrl[0], len);
+}
+
+/** Move the fill to the pending frames (requires a free pending slot) */
+static void Bridge_close_(BridgeLink * const me) {
+    BufEvt * const b = me->fill;
+    b->len += BRIDGE_CRC_SIZE;
+    Bridge_put16_(&b->data[6], me->fillCount);
+    Bridge_put32_(&b->data[8], me->fillUs);    // Until the send: batch start
+    me->pend[(me->pendHead + me->pendN) % BRIDGE_TX_PENDING] = b;
+    ++me->pendN;
+    me->fill = (BufEvt *)0;
+    me->fillExpired = false;
+    (void)QTimeEvt_disarm(&me->flushEvt);
+}
+
+static void Bridge_append_(BridgeLink * const me, QEvt const * const e,
+                           uint16_t evtSize)
+{
+    uint8_t const n = (uint8_t)(evtSize - sizeof(QEvt));
+    uint16_t const need = (uint16_t)(BRIDGE_REC_HDR + n);
+
+    if (!me->up) {
+        ++me->stats.dropped;            // No peer yet
+        return;
+    }
+    if ((me->fill != (BufEvt *)0)
+        && ((me->fill->len + need + BRIDGE_CRC_SIZE) > BRIDGE_FRAME_SIZE))
+    {
+        if (me->pendN == BRIDGE_TX_PENDING) {
+            ++me->stats.dropped;        // Frame full, nowhere to close it
+            return;
+        }
+        Bridge_close_(me);
+    }
+    if (me->fill == (BufEvt *)0) {
+        me->fill = BufPool_alloc(BRIDGE_RX_SIG, BRIDGE_POOL_MARGIN);
+        if (me->fill == (BufEvt *)0) {
+            ++me->stats.dropped;
+            return;
+        }
+        me->fill->len = BRIDGE_HDR_SIZE;
+        me->fillCount = 0U;
+        me->fillUs = BSP_getTimeUs();
+        if (BRIDGE_FLUSH_TICKS != 0U) {
+            QTimeEvt_armX(&me->flushEvt, BRIDGE_FLUSH_TICKS, 0U);
+        }
+    }
+
+    uint8_t * const p = &me->fill->data[me->fill->len];
+    Bridge_put16_(&p[0], (uint16_t)e->sig);
+    p[2] = n;
+    memcpy(&p[BRIDGE_REC_HDR], (uint8_t const *)e + sizeof(QEvt), n);
+    me->fill->len += need;
+    ++me->fillCount;
+}
+
+/** Start the next send if the driver is idle */
+static void Bridge_kick_(BridgeLink * const me) {
+    if (me->txBusy) {
+        return;
+    }
+    if (!me->up) {
+        if (me->syncDue) {
+            me->syncDue = false;
+            Bridge_sendCtrl_(me, (uint8_t)BRIDGE_F_SYNC);
+        }
+        return;
+    }
+    if (me->ackDue) {
+        me->ackDue = false;
+        Bridge_sendCtrl_(me, (uint8_t)(BRIDGE_F_SYNC | BRIDGE_F_ACK));
+        return;
+    }
+
+    // No batching delay: send what has collected behind the last frame
+    if ((me->fill != (BufEvt *)0) && (me->pendN < BRIDGE_TX_PENDING)
+        && (((BRIDGE_FLUSH_TICKS == 0U) && (me->pendN == 0U))
+            || me->fillExpired))
+    {
+        Bridge_close_(me);
+    }
+
+    uint8_t const window = (uint8_t)(me->txCredit - me->txSeq);
+    if ((me->pendN != 0U) && (window != 0U)
+        && (window <= BRIDGE_RX_CREDITS))
+    {
+        BufEvt * const b = me->pend[me->pendHead];
+        me->pendHead = (uint8_t)((me->pendHead + 1U) % BRIDGE_TX_PENDING);
+        --me->pendN;
+
+        uint32_t const now = BSP_getTimeUs();
+        uint32_t const batch = now - Bridge_get32_(&b->data[8]);
+        BridgeLinkStats * const s = &me->stats;
+        ++s->batchCount;
+        s->batchSumUs += batch;
+        if (batch > s->batchMaxUs) {
+            s->batchMaxUs = batch;
+        }
+        ++s->txFrames;
+        s->txEvents += Bridge_get16_(&b->data[6]);
+
+        Bridge_seal_(me, &b->data[0], (uint8_t)BRIDGE_F_DATA, b->len, now);
+        ++me->txSeq;
+        me->pollDue = false;
+        if (me->drv->send(me->link, &b->data[0], b->len)) {
+            me->inFlight = b;
+            me->txBusy = true;
+        } else {
+            QF_gc(&b->super);           // The peer sees a sequence gap
+        }
+        return;
+    }
+
+    if (me->creditDue || me->pollDue) {
+        uint8_t const flags = me->pollDue ? (uint8_t)BRIDGE_F_POLL : 0U;
+        me->pollDue = false;
+        Bridge_sendCtrl_(me, flags);
+    }
+}
+
+static void Bridge_publish_(BridgeLink * const me, uint8_t const * const f,
+                            uint16_t len)
+{
+    uint16_t const end = (uint16_t)(len - BRIDGE_CRC_SIZE);
+    uint16_t const count = Bridge_get16_(&f[6]);
+    uint16_t pos = BRIDGE_HDR_SIZE;
+
+    for (uint_fast16_t k = 0U; k < count; ++k) {
+        if (((pos + BRIDGE_REC_HDR) > end)
+            || ((pos + BRIDGE_REC_HDR + f[pos + 2U]) > end))
+        {
+            me->stats.rejected += count - k;
+            break;                      // Record runs past the frame
+        }
+        QSignal const sig = (QSignal)Bridge_get16_(&f[pos]);
+        uint8_t const n = f[pos + 2U];
+        BridgeRoute const * const r = Bridge_route_(me, sig, false);
+        QEvt * const e = ((r != (BridgeRoute const *)0)
+                          && (r->evtSize == (sizeof(QEvt) + n)))
+                         ? QF_newX_(r->evtSize, BRIDGE_POOL_MARGIN, (enum_t)sig)
+                         : (QEvt *)0;
+        if (e != (QEvt *)0) {
+            memcpy((uint8_t *)e + sizeof(QEvt), &f[pos + BRIDGE_REC_HDR], n);
+            QACTIVE_PUBLISH(e, &me->super);
+            ++me->stats.rxEvents;
+        } else {
+            ++me->stats.rejected;       // Unknown, wrong size, or no event
+        }
+        pos = (uint16_t)(pos + BRIDGE_REC_HDR + n);
+    }
+}
+
+static void Bridge_receive_(BridgeLink * const me, BufEvt const * const b) {
+    uint8_t const * const f = &b->data[0];
+    uint16_t const len = (b->len >= BRIDGE_HDR_SIZE)
+                         ? Bridge_get16_(&f[4]) : 0U;
+    if ((f[0] != (uint8_t)BRIDGE_MAGIC)
+        || (len < (BRIDGE_HDR_SIZE + BRIDGE_CRC_SIZE)) || (len > b->len)
+        || (Bridge_crc_(f, (uint16_t)(len - BRIDGE_CRC_SIZE))
+            != Bridge_get16_(&f[len - BRIDGE_CRC_SIZE])))
+    {
+        ++me->stats.badFrames;
+        return;
+    }
+    uint32_t const now = BSP_getTimeUs();
+    uint8_t const flags = f[1];
+    uint8_t const seq = f[2];
+    BridgeLinkStats * const s = &me->stats;
+
+    if ((flags & (uint8_t)BRIDGE_F_SYNC) != 0U) {
+        // Peer (re)started: follow its numbering; reply unless this is the reply
+        Bridge_resetRx_(me, seq);
+        if ((flags & (uint8_t)BRIDGE_F_ACK) == 0U) {
+            Bridge_resetTx_(me);
+            me->ackDue = true;
+        }
+        me->up = true;
+        ++s->syncs;
+    } else if (!me->up) {
+        return;                         // Wait for the handshake
+    }
+
+    // Credits behind txSeq are stale (sent before the peer saw our frames)
+    if ((uint8_t)(f[3] - me->txSeq) <= BRIDGE_RX_CREDITS) {
+        me->txCredit = f[3];
+    }
+    if ((flags & (uint8_t)BRIDGE_F_ECHO) != 0U) {
+        uint32_t const rtt = now - Bridge_get32_(&f[12]) - Bridge_get32_(&f[16]);
+        if ((s->rttCount == 0U) || (rtt < s->rttMinUs)) {
+            s->rttMinUs = rtt;
+        }
+        if (rtt > s->rttMaxUs) {
+            s->rttMaxUs = rtt;
+        }
+        s->rttSumUs += rtt;
+        ++s->rttCount;
+    }
+    me->echoUs = Bridge_get32_(&f[8]);
+    me->echoAt = now;
+    me->echoValid = true;
+    s->rxBytes += len;
+
+    uint8_t const gap = (uint8_t)(seq - me->rxSeq);
+    if ((flags & (uint8_t)BRIDGE_F_DATA) != 0U) {
+        if (gap >= BRIDGE_RX_CREDITS) {
+            ++s->badFrames;             // Outside the credit we gave
+            return;
+        }
+        Bridge_skip_(me, seq);
+        Bridge_publish_(me, f, len);
+        ++s->rxFrames;
+        ++me->rxSeq;
+        ++me->rxFreed;
+        me->creditDue = true;
+    } else {
+        if (gap <= BRIDGE_RX_CREDITS) {
+            Bridge_skip_(me, seq);      // Data frames before it were lost
+        }
+        if ((flags & (uint8_t)BRIDGE_F_POLL) != 0U) {
+            me->creditDue = true;
+        }
+    }
+}
+
+static QState Bridge_initial(BridgeLink * const me, QEvt const * const e);
+static QState Bridge_active(BridgeLink * const me, QEvt const * const e);
+
+static QState Bridge_initial(BridgeLink * const me, QEvt const * const e) {
+    (void)e;
+    QS_OBJ_DICTIONARY(me);
+    QS_OBJ_DICTIONARY(&me->flushEvt);
+    QS_OBJ_DICTIONARY(&me->pollEvt);
+    QS_FUN_DICTIONARY(&Bridge_active);
+
+    me->drv->start(me->link, &me->rx);
+    me->syncDue = true;                 // First SYNC on the next tick
+    QTimeEvt_armX(&me->pollEvt, 1U, BRIDGE_POLL_TICKS);
+    return Q_TRAN(&Bridge_active);
+}
+
+static QState Bridge_active(BridgeLink * const me, QEvt const * const e) {
+    QState status_;
+    switch (e->sig) {
+        case BRIDGE_RX_SIG: {
+            Bridge_receive_(me, (BufEvt const *)e);
+            Bridge_kick_(me);
+            status_ = Q_HANDLED();
+            break;
+        }
+        case BRIDGE_TX_DONE_SIG: {
+            if (me->inFlight != (BufEvt *)0) {
+                QF_gc(&me->inFlight->super);
+                me->inFlight = (BufEvt *)0;
+            }
+            me->txBusy = false;
+            Bridge_kick_(me);
+            status_ = Q_HANDLED();
+            break;
+        }
+        case BRIDGE_FLUSH_SIG: {
+            me->fillExpired = (me->fill != (BufEvt *)0);
+            Bridge_kick_(me);
+            status_ = Q_HANDLED();
+            break;
+        }
+        case BRIDGE_POLL_SIG: {
+            uint8_t const window = (uint8_t)(me->txCredit - me->txSeq);
+            if (!me->up) {
+                me->syncDue = true;
+            } else if ((me->pendN != 0U)
+                       && ((window == 0U) || (window > BRIDGE_RX_CREDITS)))
+            {
+                me->pollDue = true;     // Credit update may have been lost
+                ++me->stats.stalls;
+            }
+            Bridge_kick_(me);
+            status_ = Q_HANDLED();
+            break;
+        }
+        default: {
+            BridgeRoute const * const r = Bridge_route_(me, e->sig, true);
+            if (r != (BridgeRoute const *)0) {
+                Bridge_append_(me, e, r->evtSize);
+                Bridge_kick_(me);
+                status_ = Q_HANDLED();
+            } else {
+                status_ = Q_SUPER(&QHsm_top);
+            }
+            break;
+        }
+    }
+    return status_;
+}
+
+//============================================================================
+// PUBLIC FUNCTIONS
+//============================================================================
+
+void Bridge_start(uint_fast8_t const link, uint_fast8_t const prio,
+                  BridgeDriver const * const drv)
+{
+    Q_REQUIRE((link < BRIDGE_MAX_LINKS) && (drv != (BridgeDriver const *)0)
+              && (l_link[link].drv == (BridgeDriver const *)0));
+
+    BridgeLink * const me = &l_link[link];
+    QActive_ctor(&me->super, Q_STATE_CAST(&Bridge_initial));
+    QTimeEvt_ctorX(&me->flushEvt, &me->super, BRIDGE_FLUSH_SIG, 0U);
+    QTimeEvt_ctorX(&me->pollEvt, &me->super, BRIDGE_POLL_SIG, 0U);
+    me->drv = drv;
+    me->link = (uint8_t)link;
+    BufStream_init(&me->rx, &me->super, BRIDGE_RX_SIG, BRIDGE_FRAME_SIZE);
+    Bridge_resetTx_(me);
+    Bridge_resetRx_(me, 0U);
+    memset(&me->stats, 0, sizeof(me->stats));
+    me->stats.startUs = BSP_getTimeUs();
+
+    QACTIVE_START(&me->super, prio,
+                  l_queueSto[link], Q_DIM(l_queueSto[link]),
+                  (void *)0, 0U, (void *)0);
+}
+
+void Bridge_export(uint_fast8_t const link, enum_t const sig,
+                   uint16_t const evtSize)
+{
+    Bridge_addRoute_(link, sig, evtSize, true);
+    QActive_subscribe(&l_link[link].super, sig);
+}
+
+void Bridge_import(uint_fast8_t const link, enum_t const sig,
+                   uint16_t const evtSize)
+{
+    Bridge_addRoute_(link, sig, evtSize, false);
+}
+
+void Bridge_txDone(uint_fast8_t const link) {
+    static QEvt const txDoneEvt = QEVT_INITIALIZER(BRIDGE_TX_DONE_SIG);
+    Q_REQUIRE(link < BRIDGE_MAX_LINKS);
+    QACTIVE_POST(&l_link[link].super, &txDoneEvt, &l_link[link]);
+}
+
+BridgeLinkStats const *Bridge_getStats(uint_fast8_t const link) {
+    return ((link < BRIDGE_MAX_LINKS)
+            && (l_link[link].drv != (BridgeDriver const *)0))
+           ? &l_link[link].stats
+           : (BridgeLinkStats const *)0;
+}
+
+void Bridge_report(void) {
+    uint32_t const now = BSP_getTimeUs();
+    for (uint_fast8_t n = 0U; n < BRIDGE_MAX_LINKS; ++n) {
+        BridgeLink const * const me = &l_link[n];
+        if (me->drv == (BridgeDriver const *)0) {
+            continue;
+        }
+        BridgeLinkStats const * const s = &me->stats;
+        QS_BEGIN_ID(BRIDGE_QS_REC, 0U)
+            QS_2U8_((uint8_t)BRIDGE_QS_LINK, (uint8_t)n);
+            QS_2U8_((uint8_t)me->super.prio, (uint8_t)(me->up ? 1U : 0U));
+            QS_2U8_((uint8_t)(me->txCredit - me->txSeq), me->pendN);
+            QS_U32_(now - s->startUs);
+            QS_U32_(s->txFrames);
+            QS_U32_(s->txEvents);
+            QS_U32_(s->txBytes);
+            QS_U32_(s->rxFrames);
+            QS_U32_(s->rxEvents);
+            QS_U32_(s->rxBytes);
+            QS_U32_(s->dropped);
+            QS_U32_(s->rejected);
+            QS_U32_(s->badFrames);
+            QS_U32_(s->lostFrames);
+            QS_U32_(s->stalls);
+            QS_U32_(s->syncs);
+            QS_U32_(s->rttCount);
+            QS_U32_(s->rttMinUs);
+            QS_U32_(s->rttMaxUs);
+            QS_U32_((s->rttCount != 0U)
+                    ? (uint32_t)(s->rttSumUs / s->rttCount) : 0U);
+            QS_U32_(s->batchCount);
+            QS_U32_(s->batchMaxUs);
+            QS_U32_((s->batchCount != 0U)
+                    ? (uint32_t)(s->batchSumUs / s->batchCount) : 0U);
+            QS_U32_(me->rx.dropped);
+        QS_END_()
+    }
+}
+
+void Bridge_reset(void) {
+    uint32_t const now = BSP_getTimeUs();
+    for (uint_fast8_t n = 0U; n < BRIDGE_MAX_LINKS; ++n) {
+        QF_INT_DISABLE();
+        memset(&l_link[n].stats, 0, sizeof(l_link[n].stats));
+        l_link[n].stats.startUs = now;
+        QF_INT_ENABLE();
+    }
+}
+
+#endif // BRIDGE_ENABLE
@@ -0,0 +1,254 @@
+/**
+ * @file bridge.h
+ * @brief Event Bridge Between QP Nodes
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * Carries selected published signals between MCUs (or between cores of a
+ * dual-core part) so that AOs on different nodes work with one another
+ * through their local publish-subscribe. Each link is one bridge AO:
+ *
+ *   AO ──publish──> Bridge (link 0) ══frames══> Bridge (link 0) ──publish──> AO
+ *        exported    batching, credits          CRC, seq, re-publish  imported
+ *
+ * Exported signals are subscribed by the bridge AO, and their parameters
+ * are appended to the frame being filled. A frame is built in place in a
+ * BufEvt block (buf_pool.h) and sent by the link driver straight from
+ * that block. It goes out when it is full, after BRIDGE_FLUSH_TICKS, or
+ * at once when BRIDGE_FLUSH_TICKS is 0 and the link is idle. Under load,
+ * events batch up behind the frame in flight.
+ *
+ * The receiver checks each frame and re-publishes its events as new
+ * dynamic events on the local node. Flow control is credit based: a node
+ * sends at most BRIDGE_RX_CREDITS frames the peer has not freed yet, and
+ * each frame returns the credits of the frames it freed. A sender with
+ * no credit polls for it every BRIDGE_POLL_TICKS, so a lost credit
+ * update cannot stall the link.
+ *
+ * Events are copied as raw bytes after the QEvt header. Bridged signals
+ * must use plain-data events with the same layout on both nodes: no
+ * pointers, so no BufEvt. The signal numbers must be the same on both
+ * nodes too. A signal may be exported on several links but imported on
+ * only one, and the links must not form a loop for any signal.
+ */
+
+#ifndef BRIDGE_H
+#define BRIDGE_H
+
+#include "qpc.h"
+#include "buf_pool.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//============================================================================
+// CONFIGURATION
+//============================================================================
+// Both ends of a link must use the same BRIDGE_RX_CREDITS and a
+// BRIDGE_FRAME_SIZE the peer can receive.
+
+#ifndef BRIDGE_MAX_LINKS
+#define BRIDGE_MAX_LINKS        2U      // Bridge AOs (one per peer node)
+#endif
+
+#ifndef BRIDGE_MAX_ROUTES
+#define BRIDGE_MAX_ROUTES       8U      // Exported + imported signals per link
+#endif
+
+#ifndef BRIDGE_FRAME_SIZE
+#define BRIDGE_FRAME_SIZE       BUF_POOL_BLOCK_SIZE  // Bytes per frame
+#endif
+
+#ifndef BRIDGE_RX_CREDITS
+#define BRIDGE_RX_CREDITS       2U      // Unfreed frames the peer may send
+#endif
+
+#ifndef BRIDGE_TX_PENDING
+#define BRIDGE_TX_PENDING       2U      // Full frames waiting for the link
+#endif
+
+#ifndef BRIDGE_FLUSH_TICKS
+#define BRIDGE_FLUSH_TICKS      1U      // Longest batching delay (0 = none)
+#endif
+
+#ifndef BRIDGE_POLL_TICKS
+#define BRIDGE_POLL_TICKS       20U     // Sync and credit poll period
+#endif
+
+#ifndef BRIDGE_QUEUE_LEN
+#define BRIDGE_QUEUE_LEN        16U     // Bridge AO event queue
+#endif
+
+#ifndef BRIDGE_POOL_MARGIN
+#define BRIDGE_POOL_MARGIN      1U      // Blocks kept free by imports and frames
+#endif
+
+#ifndef BRIDGE_SIG_BASE
+#define BRIDGE_SIG_BASE         (Q_USER_SIG + 0xE0U) // Private signals (4)
+#endif
+
+// Private signals of the bridge AOs (exported signals must be below)
+#define BRIDGE_RX_SIG           (BRIDGE_SIG_BASE + 0U)  // BufEvt frame in
+#define BRIDGE_TX_DONE_SIG      (BRIDGE_SIG_BASE + 1U)  // Driver sent a frame
+#define BRIDGE_FLUSH_SIG        (BRIDGE_SIG_BASE + 2U)  // Batching delay over
+#define BRIDGE_POLL_SIG         (BRIDGE_SIG_BASE + 3U)  // Sync/credit poll
+
+// Frame layout (little-endian, byte-packed)
+#define BRIDGE_HDR_SIZE         20U     // magic..holdUs
+#define BRIDGE_CRC_SIZE         2U      // CRC-16/CCITT of all bytes before
+#define BRIDGE_MAGIC            0xB5U
+
+// QS user record reserved for this service (see project_template.h)
+#define BRIDGE_QS_REC           (QS_USER + 16)
+
+// Sub-record types carried in the first byte of BRIDGE_QS_REC
+enum BridgeQSType {
+    BRIDGE_QS_LINK = 1U         /**< link, prio, up, credit, counters */
+};
+
+/**
+ * @brief Header flags
+ */
+enum BridgeFlags {
+    BRIDGE_F_DATA = 0x01U,      /**< Carries events, uses one credit */
+    BRIDGE_F_ECHO = 0x02U,      /**< echoUs/holdUs are valid (RTT sample) */
+    BRIDGE_F_POLL = 0x04U,      /**< Sender has no credit: send yours */
+    BRIDGE_F_SYNC = 0x08U,      /**< Sender (re)started its link state */
+    BRIDGE_F_ACK = 0x10U        /**< With SYNC: reply to the peer's SYNC */
+};
+
+//============================================================================
+// TYPES
+//============================================================================
+
+/**
+ * @brief Link driver (UART-DMA, SPI, shared memory, UDP on the host)
+ *
+ * Both calls may come from the bridge AO only. The driver hands each
+ * received frame over with BufStream_swapN() on the stream it got from
+ * start(). It reports the end of each send() with Bridge_txDone().
+ */
+typedef struct {
+    /** Start receiving into rx (BRIDGE_FRAME_SIZE bytes per block) */
+    void (*start)(uint_fast8_t link, BufStream * const rx);
+    /** Send one frame; false = not sent (no Bridge_txDone() follows) */
+    bool (*send)(uint_fast8_t link, uint8_t const * const frame,
+                 uint16_t len);
+} BridgeDriver;
+
+/**
+ * @brief Counters of one link since Bridge_reset()
+ */
+typedef struct {
+    uint32_t txFrames;          /**< Data frames sent */
+    uint32_t txEvents;
+    uint32_t txBytes;           /**< All frames, headers included */
+    uint32_t rxFrames;          /**< Data frames received */
+    uint32_t rxEvents;
+    uint32_t rxBytes;
+    uint32_t dropped;           /**< Exported events with no frame space */
+    uint32_t rejected;          /**< Imported events not published */
+    uint32_t badFrames;         /**< Bad CRC, format, or out of window */
+    uint32_t lostFrames;        /**< Sequence gaps */
+    uint32_t stalls;            /**< Credit polls sent */
+    uint32_t syncs;             /**< Link state resets */
+    uint32_t rttCount;          /**< Round trips, peer hold time excluded */
+    uint32_t rttMinUs;
+    uint32_t rttMaxUs;
+    uint64_t rttSumUs;
+    uint32_t batchCount;        /**< First event to send, per data frame */
+    uint32_t batchMaxUs;
+    uint64_t batchSumUs;
+    uint32_t startUs;           /**< BSP_getTimeUs() at Bridge_reset() */
+} BridgeLinkStats;
+
+//============================================================================
+// PUBLIC INTERFACE
+//============================================================================
+
+/**
+ * @brief Microsecond time base (provided by the BSP)
+ */
+uint32_t BSP_getTimeUs(void);
+
+/**
+ * @brief Driver of a link (provided by the BSP, NULL if none)
+ */
+BridgeDriver const *BSP_bridgeDriver(uint_fast8_t const link);
+
+/**
+ * @brief Start the bridge AO of a link
+ *
+ * Call after BUF_POOL_INIT() and QActive_psInit(). The AO starts the
+ * driver's reception and sends SYNC until the peer answers. Exported
+ * events are dropped until then.
+ *
+ * @param link Link index (< BRIDGE_MAX_LINKS)
+ * @param prio QF priority of the bridge AO
+ * @param drv  Link driver
+ */
+void Bridge_start(uint_fast8_t const link, uint_fast8_t const prio,
+                  BridgeDriver const * const drv);
+
+/**
+ * @brief Send a published signal to the peer (after Bridge_start())
+ *
+ * @param evtSize sizeof() of the event type carrying the signal
+ */
+void Bridge_export(uint_fast8_t const link, enum_t const sig,
+                   uint16_t const evtSize);
+
+/**
+ * @brief Re-publish a signal received from the peer
+ *
+ * Records of other signals, or of another size, are rejected.
+ */
+void Bridge_import(uint_fast8_t const link, enum_t const sig,
+                   uint16_t const evtSize);
+
+/**
+ * @brief End of a driver send() (ISR or driver thread)
+ */
+void Bridge_txDone(uint_fast8_t const link);
+
+/**
+ * @brief Counters of one link (NULL if not started)
+ */
+BridgeLinkStats const *Bridge_getStats(uint_fast8_t const link);
+
+/**
+ * @brief Emit the counters of all links as QS records
+ */
+void Bridge_report(void);
+
+/**
+ * @brief Clear the counters of all links (start a measurement window)
+ */
+void Bridge_reset(void);
+
+//============================================================================
+// INTEGRATION MACROS
+//============================================================================
+
+#ifdef BRIDGE_ENABLE
+#define BRIDGE_START(link_, prio_, drv_)    Bridge_start((link_), (prio_), (drv_))
+#define BRIDGE_EXPORT(link_, sig_, evtType_) \
+    Bridge_export((link_), (sig_), (uint16_t)sizeof(evtType_))
+#define BRIDGE_IMPORT(link_, sig_, evtType_) \
+    Bridge_import((link_), (sig_), (uint16_t)sizeof(evtType_))
+#define BRIDGE_REPORT()                     Bridge_report()
+#define BRIDGE_RESET()                      Bridge_reset()
+#else
+#define BRIDGE_START(link_, prio_, drv_)    ((void)0)
+#define BRIDGE_EXPORT(link_, sig_, evtType_) ((void)0)
+#define BRIDGE_IMPORT(link_, sig_, evtType_) ((void)0)
+#define BRIDGE_REPORT()                     ((void)0)
+#define BRIDGE_RESET()                      ((void)0)
+#endif // BRIDGE_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BRIDGE_H
@@ -0,0 +1,107 @@
+/**
+ * @file bridge_shm.c
+ * @brief Shared-Memory Link Driver for the Event Bridge (dual-core parts)
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * Single producer, single consumer per ring: head is written only by the
+ * sending core, tail only by the receiving one. The fences order the slot
+ * data against these indices; no lock is shared between the cores.
+ */
+
+#include "bridge_shm.h"
+#include <string.h>
+
+#ifdef BRIDGE_ENABLE
+
+Q_DEFINE_THIS_MODULE("bridge_shm")
+
+//============================================================================
+// LOCAL VARIABLES
+//============================================================================
+
+typedef struct {
+    BridgeShmRing *tx;
+    BridgeShmRing *rx;
+    BufStream *stream;
+} BridgeShmLink;
+
+static BridgeShmLink l_shm[BRIDGE_MAX_LINKS];
+
+//============================================================================
+// LOCAL FUNCTIONS
+//============================================================================
+
+static void BridgeShm_start_(uint_fast8_t link, BufStream * const rx) {
+    Q_REQUIRE((link < BRIDGE_MAX_LINKS)
+              && (l_shm[link].tx != (BridgeShmRing *)0)); // BridgeShm_init()
+    (void)BufStream_start(rx);
+    l_shm[link].stream = rx;            // Frames before it wait in the ring
+}
+
+static bool BridgeShm_send_(uint_fast8_t link, uint8_t const * const frame,
+                            uint16_t len)
+{
+    BridgeShmRing * const r = l_shm[link].tx;
+    uint32_t const head = r->head;
+    if ((head - r->tail) >= BRIDGE_SHM_SLOTS) {
+        return false;                   // Peer has not drained the ring
+    }
+    uint32_t const n = head % BRIDGE_SHM_SLOTS;
+    memcpy(&r->slot[n][0], frame, len);
+    r->len[n] = len;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    r->head = head + 1U;
+    BSP_bridgeShmNotify(link);
+
+    // The frame is in shared memory: its block can go at once
+    Bridge_txDone(link);
+    return true;
+}
+
+//============================================================================
+// PUBLIC FUNCTIONS
+//============================================================================
+
+BridgeDriver const BridgeShm_driver = {
+    &BridgeShm_start_,
+    &BridgeShm_send_
+};
+
+void BridgeShm_init(uint_fast8_t const link, BridgeShmRegion * const region,
+                    uint_fast8_t const side)
+{
+    Q_REQUIRE((link < BRIDGE_MAX_LINKS) && (side < 2U));
+    if (side == 0U) {
+        memset(region, 0, sizeof(*region));
+    }
+    l_shm[link].tx = &region->ring[side];
+    l_shm[link].rx = &region->ring[side ^ 1U];
+    l_shm[link].stream = (BufStream *)0;
+}
+
+void BridgeShm_isr(uint_fast8_t const link) {
+    BridgeShmLink * const me = &l_shm[link];
+    if (me->stream == (BufStream *)0) {
+        return;                         // Bridge not started yet
+    }
+    BridgeShmRing * const r = me->rx;
+    uint32_t tail = r->tail;
+    while (tail != r->head) {
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        uint32_t const n = tail % BRIDGE_SHM_SLOTS;
+        uint16_t const len = r->len[n];
+        uint8_t * const buf = BufStream_start(me->stream);
+        if ((buf != (uint8_t *)0) && (len <= BRIDGE_FRAME_SIZE)) {
+            memcpy(buf, &r->slot[n][0], len);
+            (void)BufStream_swapN(me->stream, len, me);
+        } else {
+            ++me->stream->dropped;      // No block: the bridge sees a gap
+        }
+        ++tail;
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        r->tail = tail;
+    }
+}
+
+#endif // BRIDGE_ENABLE
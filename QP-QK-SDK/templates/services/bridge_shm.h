@@ -0,0 +1,92 @@
+/**
+ * @file bridge_shm.h
+ * @brief Shared-Memory Link Driver for the Event Bridge (dual-core parts)
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * Bridge link between the two cores of a part like the STM32H7 dual-core:
+ * one ring of frame slots per direction in a RAM region both cores can
+ * see, and an IPC doorbell (HSEM interrupt or SEV) that tells the peer a
+ * frame is ready. send() copies the frame into a slot and rings; the
+ * peer's doorbell ISR copies it out into a BufEvt block of its BufStream.
+ *
+ * The region must not be cached on either core (MPU attribute on a
+ * Cortex-M7), or both copies miss each other's writes. Each core calls
+ * BridgeShm_init() with the same region and its own side (0 or 1), and
+ * places it with the linker, e.g. in SRAM4 of the H7.
+ */
+
+#ifndef BRIDGE_SHM_H
+#define BRIDGE_SHM_H
+
+#include "bridge.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//============================================================================
+// CONFIGURATION
+//============================================================================
+
+#ifndef BRIDGE_SHM_SLOTS
+#define BRIDGE_SHM_SLOTS        (BRIDGE_RX_CREDITS + 2U) // Credits + control
+#endif
+
+//============================================================================
+// TYPES
+//============================================================================
+
+/**
+ * @brief One direction: written by one core, read by the other
+ */
+typedef struct {
+    uint32_t volatile head;             /**< Slots written (producer) */
+    uint32_t volatile tail;             /**< Slots read (consumer) */
+    uint16_t len[BRIDGE_SHM_SLOTS];
+    uint32_t slot[BRIDGE_SHM_SLOTS][(BRIDGE_FRAME_SIZE + 3U) / 4U];
+} BridgeShmRing;
+
+/**
+ * @brief Shared region of one link (ring[n] is sent by side n)
+ */
+typedef struct {
+    BridgeShmRing ring[2];
+} BridgeShmRegion;
+
+//============================================================================
+// PUBLIC INTERFACE
+//============================================================================
+
+/**
+ * @brief Ring the peer core's doorbell (provided by the BSP)
+ */
+void BSP_bridgeShmNotify(uint_fast8_t const link);
+
+/**
+ * @brief Attach a link to its shared region (before Bridge_start())
+ *
+ * Side 0 clears the region: start it before side 1 sends.
+ *
+ * @param side 0 or 1, different on the two cores
+ */
+void BridgeShm_init(uint_fast8_t const link, BridgeShmRegion * const region,
+                    uint_fast8_t const side);
+
+/**
+ * @brief Doorbell ISR of this core: hand over the frames the peer wrote
+ *
+ * Call from a kernel-aware ISR (BSP_ISR_ENTRY()/BSP_ISR_EXIT()).
+ */
+void BridgeShm_isr(uint_fast8_t const link);
+
+/**
+ * @brief Bridge driver of the shared-memory links (for BSP_bridgeDriver())
+ */
+extern BridgeDriver const BridgeShm_driver;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BRIDGE_SHM_H
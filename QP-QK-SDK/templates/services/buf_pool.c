@@ -0,0 +1,106 @@
+/**
+ * @file buf_pool.c
+ * @brief Zero-Copy Buffer Events
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * The buffer pool is an ordinary QF event pool whose blocks are BufEvt,
+ * so allocation, posting, publishing, deferral and garbage collection are
+ * all QF's own; this module only owns the storage and the DMA hand-over.
+ */
+
+#include "buf_pool.h"
+#include "pool_monitor.h"
+
+#ifdef BUF_POOL_ENABLE
+
+#if (QF_MAX_EPOOL < 4U)
+#error "BUF_POOL_ENABLE needs a fourth event pool: build with -DQF_MAX_EPOOL=4"
+#endif
+
+Q_DEFINE_THIS_MODULE("buf_pool")
+
+// DMA targets data[] directly, so it must stay word-aligned in the block
+Q_ASSERT_STATIC((offsetof(BufEvt, data) % 4U) == 0U);
+
+//============================================================================
+// LOCAL VARIABLES
+//============================================================================
+
+static QF_MPOOL_EL(BufEvt) l_bufPoolSto[BUF_POOL_BLOCKS];
+
+//============================================================================
+// PUBLIC FUNCTIONS
+//============================================================================
+
+void BufPool_init(void) {
+    QF_poolInit(l_bufPoolSto, sizeof(l_bufPoolSto), sizeof(l_bufPoolSto[0]));
+    POOL_MON_REGISTER(l_bufPoolSto, sizeof(l_bufPoolSto),
+                      sizeof(l_bufPoolSto[0]));
+}
+
+BufEvt *BufPool_alloc(enum_t const sig, uint_fast16_t const margin) {
+    BufEvt *e;
+    POOL_MON_NEW_X(e, BufEvt, margin, sig);
+    if (e != (BufEvt *)0) {
+        e->len = 0U;
+        e->seq = 0U;
+    }
+    return e;
+}
+
+void BufStream_init(BufStream * const me, QActive * const dst,
+                    enum_t const sig, uint16_t const len)
+{
+    Q_REQUIRE((len > 0U) && (len <= BUF_POOL_BLOCK_SIZE));
+
+    me->fill = (BufEvt *)0;
+    me->dst = dst;
+    me->sig = sig;
+    me->len = len;
+    me->seq = 0U;
+    me->dropped = 0U;
+}
+
+uint8_t *BufStream_start(BufStream * const me) {
+    if (me->fill == (BufEvt *)0) {
+        me->fill = BufPool_alloc(me->sig, BUF_POOL_MARGIN);
+    }
+    return (me->fill != (BufEvt *)0) ? &me->fill->data[0] : (uint8_t *)0;
+}
+
+uint8_t *BufStream_swap(BufStream * const me, void const * const sender) {
+    return BufStream_swapN(me, me->len, sender);
+}
+
+uint8_t *BufStream_swapN(BufStream * const me, uint16_t const nBytes,
+                         void const * const sender)
+{
+    Q_REQUIRE((me->fill != (BufEvt *)0) && (nBytes <= me->len));
+    (void)sender; // unused without Q_SPY
+
+    BufEvt * const next = BufPool_alloc(me->sig, BUF_POOL_MARGIN);
+    if (next == (BufEvt *)0) {
+        // No free block: keep filling the current one, leave a seq gap
+        ++me->seq;
+        ++me->dropped;
+        return &me->fill->data[0];
+    }
+
+    BufEvt * const full = me->fill;
+    full->len = nBytes;
+    full->seq = me->seq++;
+    me->fill = next;
+
+    if (me->dst != (QActive *)0) {
+        // A failed margin post recycles the block, so only count it
+        if (!QACTIVE_POST_X(me->dst, &full->super, 0U, sender)) {
+            ++me->dropped;
+        }
+    } else {
+        QACTIVE_PUBLISH(&full->super, sender);
+    }
+    return &next->data[0];
+}
+
+#endif // BUF_POOL_ENABLE
@@ -0,0 +1,151 @@
+/**
+ * @file buf_pool.h
+ * @brief Zero-Copy Buffer Events
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * Reference-counted buffer blocks for streaming ADC/SPI/UART data between
+ * Active Objects without copying. A block is a QF event (BufEvt) from a
+ * dedicated event pool registered after the regular pools: the producer
+ * (ISR or DMA) fills the block in place, posts or publishes it, and every
+ * consumer reads the same memory. QF reference counting returns the block
+ * to its pool when the last consumer is done, exactly like any other
+ * dynamic event, so no release call is needed.
+ */
+
+#ifndef BUF_POOL_H
+#define BUF_POOL_H
+
+#include "qpc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//============================================================================
+// CONFIGURATION
+//============================================================================
+// The buffer pool is the fourth QF event pool: build with
+// -DBUF_POOL_ENABLE -DQF_MAX_EPOOL=4.
+
+#ifndef BUF_POOL_BLOCK_SIZE
+#define BUF_POOL_BLOCK_SIZE     512U    // Payload bytes per block (x4)
+#endif
+
+#ifndef BUF_POOL_BLOCKS
+#define BUF_POOL_BLOCKS         8U      // Blocks in the buffer pool
+#endif
+
+#ifndef BUF_POOL_MARGIN
+#define BUF_POOL_MARGIN         1U      // Blocks kept free by BufStream
+#endif
+
+//============================================================================
+// BUFFER EVENT
+//============================================================================
+
+/**
+ * @brief Buffer descriptor and payload in one pool block
+ *
+ * The 8-byte header keeps data[] word-aligned, so DMA can target it
+ * directly. Consumers must treat a received BufEvt as read-only: it may
+ * be shared with other subscribers.
+ */
+typedef struct {
+    QEvt super;
+    uint16_t len;                       /**< Valid bytes in data[] */
+    uint16_t seq;                       /**< Producer sequence (gap check) */
+    uint8_t data[BUF_POOL_BLOCK_SIZE];  /**< Payload, filled in place */
+} BufEvt;
+
+/**
+ * @brief DMA double-buffering helper
+ *
+ * Keeps the block the DMA is currently filling; on each transfer-complete
+ * interrupt the full block is handed to the consumer and the DMA is
+ * re-armed on a fresh one.
+ */
+typedef struct {
+    BufEvt *fill;                       /**< Block being filled (owned) */
+    QActive *dst;                       /**< Consumer, NULL = publish */
+    enum_t sig;                         /**< Signal of posted blocks */
+    uint16_t len;                       /**< Bytes per transfer */
+    uint16_t seq;                       /**< Next sequence number */
+    uint32_t dropped;                   /**< Blocks overwritten (no block) */
+} BufStream;
+
+//============================================================================
+// PUBLIC INTERFACE
+//============================================================================
+
+/**
+ * @brief Create the buffer pool
+ *
+ * Call after the regular QF_poolInit() calls (pools must be registered in
+ * increasing block size) and before any AO is started.
+ */
+void BufPool_init(void);
+
+/**
+ * @brief Allocate an empty buffer event (task or ISR context)
+ *
+ * @param sig    Event signal
+ * @param margin Blocks that must stay free, QF_NO_MARGIN asserts instead
+ * @return       Block with len = 0, or NULL when the margin is not met
+ */
+BufEvt *BufPool_alloc(enum_t const sig, uint_fast16_t const margin);
+
+/**
+ * @brief Bind a stream to its consumer and signal
+ *
+ * @param dst Consumer AO, or NULL to publish each block
+ * @param len Bytes per block (<= BUF_POOL_BLOCK_SIZE)
+ */
+void BufStream_init(BufStream * const me, QActive * const dst,
+                    enum_t const sig, uint16_t const len);
+
+/**
+ * @brief First DMA target (call once before starting the transfer)
+ *
+ * @return Payload of the first block, NULL when the pool is exhausted
+ */
+uint8_t *BufStream_start(BufStream * const me);
+
+/**
+ * @brief Hand over the block the DMA just filled and return the next target
+ *
+ * Call from the transfer-complete ISR. When no block is free the current
+ * one is kept and overwritten by the next transfer, so the producer never
+ * blocks; the loss is counted in 'dropped' and visible as a gap in 'seq'.
+ *
+ * @param sender Sender for QS (the ISR), unused without Q_SPY
+ * @return       Payload of the block the DMA must fill next
+ */
+uint8_t *BufStream_swap(BufStream * const me, void const * const sender);
+
+/**
+ * @brief BufStream_swap() for a transfer of variable length
+ *
+ * For receivers that end a transfer early, e.g. a UART that stops the DMA
+ * on an idle line. The handed-over block has len = nBytes.
+ *
+ * @param nBytes Bytes the DMA wrote (<= the stream's len)
+ */
+uint8_t *BufStream_swapN(BufStream * const me, uint16_t const nBytes,
+                         void const * const sender);
+
+//============================================================================
+// INTEGRATION MACROS
+//============================================================================
+
+#ifdef BUF_POOL_ENABLE
+#define BUF_POOL_INIT()                 BufPool_init()
+#else
+#define BUF_POOL_INIT()                 ((void)0)
+#endif // BUF_POOL_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BUF_POOL_H
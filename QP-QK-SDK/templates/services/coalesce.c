@@ -0,0 +1,172 @@
+/**
+ * @file coalesce.c
+ * @brief Coalescing (Last-Value-Wins) Event Posting
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * The pending events are the queue's front event plus the ring entries
+ * from tail to head, in the order QActive_get_() takes them. The scan and
+ * the merge run in one critical section, so the consumer can't take the
+ * pending event in between. The scan costs one compare per pending event.
+ * Coalescing keeps those queues short, so the scan stays short too.
+ *
+ * When nothing is pending, the event is posted with QACTIVE_POST() after
+ * the critical section. Two producers racing on the same key can then both
+ * append. That costs one extra event and is never lost data.
+ */
+
+#include "coalesce.h"
+#include <string.h>
+
+Q_DEFINE_THIS_MODULE("coalesce")
+
+//============================================================================
+// LOCAL VARIABLES
+//============================================================================
+
+typedef struct {
+    QSignal sig;                /**< 0 = free slot */
+    uint16_t evtSize;
+    uint16_t keyOffset;
+    uint8_t keySize;
+    CoalesceStats stats;
+} CoalesceSig;
+
+static CoalesceSig l_sig[COALESCE_MAX_SIGS];
+
+//============================================================================
+// LOCAL FUNCTIONS
+//============================================================================
+
+static CoalesceSig *Coalesce_find_(QSignal const sig) {
+    for (uint_fast8_t i = 0U; i < COALESCE_MAX_SIGS; ++i) {
+        if (l_sig[i].sig == sig) {
+            return &l_sig[i];
+        }
+    }
+    return (CoalesceSig *)0;
+}
+
+static inline bool Coalesce_match_(CoalesceSig const * const c,
+                                   QEvt const * const a, QEvt const * const b)
+{
+    return (a->sig == b->sig)
+           && (memcmp((uint8_t const *)a + c->keyOffset,
+                      (uint8_t const *)b + c->keyOffset, c->keySize) == 0);
+}
+
+//============================================================================
+// PUBLIC FUNCTIONS
+//============================================================================
+
+void Coalesce_add(enum_t const sig, uint16_t const evtSize,
+                  uint16_t const keyOffset, uint8_t const keySize)
+{
+    Q_REQUIRE((sig >= Q_USER_SIG) && (evtSize >= sizeof(QEvt))
+              && (keySize <= COALESCE_MAX_KEY)
+              && ((keyOffset + keySize) <= evtSize)
+              && (Coalesce_find_((QSignal)sig) == (CoalesceSig *)0));
+
+    CoalesceSig * const c = Coalesce_find_(0U);
+    Q_ASSERT(c != (CoalesceSig *)0);    // COALESCE_MAX_SIGS too small
+    c->evtSize = evtSize;
+    c->keyOffset = keyOffset;
+    c->keySize = keySize;
+    memset(&c->stats, 0, sizeof(c->stats));
+    c->sig = (QSignal)sig;
+}
+
+void Coalesce_post(QActive * const ao, QEvt const * const e,
+                   void const * const sender)
+{
+    CoalesceSig * const c = Coalesce_find_(e->sig);
+    if (c == (CoalesceSig *)0) {
+        QACTIVE_POST(ao, e, sender);
+        return;
+    }
+
+    QEvt const *recycle = (QEvt const *)0;
+    bool merged = false;
+    QEQueue * const q = &ao->eQueue;
+
+    QF_CRIT_ENTRY(dummy);
+    ++c->stats.posts;
+
+    // Pending event of the same key: the front event, then tail..head
+    QEvt const * volatile *slot = (QEvt const * volatile *)0;
+    if (q->frontEvt != (QEvt *)0) {
+        if (Coalesce_match_(c, q->frontEvt, e)) {
+            slot = &q->frontEvt;
+        } else {
+            QEQueueCtr idx = q->tail;
+            for (QEQueueCtr n = q->end - q->nFree; n > 0U; --n) {
+                if (Coalesce_match_(c, q->ring[idx], e)) {
+                    slot = (QEvt const * volatile *)&q->ring[idx];
+                    break;
+                }
+                idx = (idx == 0U) ? q->end : idx;
+                --idx;
+            }
+        }
+    }
+
+    if (slot != (QEvt const * volatile *)0) {
+        QEvt * const pending = (QEvt *)*slot;
+        merged = true;
+        if (pending == e) {
+            ++c->stats.updated;         // The same event posted again
+        } else if ((pending->poolId_ != 0U) && (pending->refCtr_ == 1U)) {
+            // Only this queue holds it: take the new contents, keep the block
+            memcpy((uint8_t *)pending + sizeof(QEvt),
+                   (uint8_t const *)e + sizeof(QEvt),
+                   c->evtSize - sizeof(QEvt));
+            ++c->stats.updated;
+            recycle = e;
+        } else {
+            // Static or shared with other queues: swap the slot
+            if (e->poolId_ != 0U) {
+                ++((QEvt *)e)->refCtr_;
+            }
+            *slot = e;
+            ++c->stats.replaced;
+            recycle = pending;
+        }
+    } else {
+        ++c->stats.appended;
+    }
+    QF_CRIT_EXIT(dummy);
+
+    if (!merged) {
+        QACTIVE_POST(ao, e, sender);
+    } else if (recycle != (QEvt const *)0) {
+        QF_gc(recycle);         // Back to its pool (static: no-op)
+    }
+}
+
+CoalesceStats const *Coalesce_getStats(enum_t const sig) {
+    CoalesceSig const * const c = (sig >= Q_USER_SIG)
+                                  ? Coalesce_find_((QSignal)sig)
+                                  : (CoalesceSig *)0;
+    return (c != (CoalesceSig *)0) ? &c->stats : (CoalesceStats const *)0;
+}
+
+void Coalesce_report(void) {
+    for (uint_fast8_t i = 0U; i < COALESCE_MAX_SIGS; ++i) {
+        CoalesceSig const * const c = &l_sig[i];
+        if (c->sig == 0U) {
+            continue;
+        }
+        QF_CRIT_ENTRY(dummy);
+        CoalesceStats const s = c->stats;
+        QF_CRIT_EXIT(dummy);
+
+        QS_BEGIN_ID(COALESCE_QS_REC, 0U)
+            QS_U8_((uint8_t)COALESCE_QS_STATS);
+            QS_U16_((uint16_t)c->sig);
+            QS_U32_(s.posts);
+            QS_U32_(s.appended);
+            QS_U32_(s.updated);
+            QS_U32_(s.replaced);
+        QS_END_()
+    }
+}
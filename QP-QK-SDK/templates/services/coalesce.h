@@ -0,0 +1,128 @@
+/**
+ * @file coalesce.h
+ * @brief Coalescing (Last-Value-Wins) Event Posting
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * For high-rate signals where only the newest sample matters (sensor
+ * readings, positions, status snapshots). Coalesce_post() looks for an
+ * event of the same signal and key (e.g. SensorDataEvt.sensor_id) that is
+ * still waiting in the target AO's queue. If there is one, the waiting
+ * event takes the new contents instead of a new event being appended. A
+ * consumer that falls behind therefore holds at most one pending event per
+ * key, and the surplus samples go straight back to their pool.
+ *
+ * Only signals registered with COALESCE_ADD() are coalesced. Other
+ * signals, and registered signals with nothing pending, are posted
+ * normally with QACTIVE_POST().
+ */
+
+#ifndef COALESCE_H
+#define COALESCE_H
+
+#include "qpc.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//============================================================================
+// CONFIGURATION
+//============================================================================
+
+#ifndef COALESCE_MAX_SIGS
+#define COALESCE_MAX_SIGS       4U      // Signals that can be registered
+#endif
+
+#ifndef COALESCE_MAX_KEY
+#define COALESCE_MAX_KEY        4U      // Key bytes compared (0 = signal only)
+#endif
+
+// QS user record reserved for this service (see project_template.h)
+#define COALESCE_QS_REC         (QS_USER + 20)
+
+// Sub-record types carried in the first byte of COALESCE_QS_REC
+enum CoalesceQSType {
+    COALESCE_QS_STATS = 1U      /**< sig, posts, appended, updated, replaced */
+};
+
+//============================================================================
+// STATISTICS
+//============================================================================
+
+/**
+ * @brief Counters of one coalesced signal
+ */
+typedef struct {
+    uint32_t posts;             /**< Coalesce_post() calls */
+    uint32_t appended;          /**< Nothing pending: posted normally */
+    uint32_t updated;           /**< Pending event overwritten in place */
+    uint32_t replaced;          /**< Pending event swapped for the new one */
+} CoalesceStats;
+
+//============================================================================
+// PUBLIC INTERFACE
+//============================================================================
+
+/**
+ * @brief Make a signal coalescing
+ *
+ * Call during initialization, before any AO posts the signal. The key
+ * selects which pending events are "the same": two events coalesce when
+ * their key bytes are equal (keySize 0 = any event of the signal).
+ *
+ * @param sig       Signal to coalesce
+ * @param evtSize   sizeof() of the event type carrying the signal
+ * @param keyOffset offsetof() of the key member in the event
+ * @param keySize   sizeof() of the key member (<= COALESCE_MAX_KEY)
+ */
+void Coalesce_add(enum_t const sig, uint16_t const evtSize,
+                  uint16_t const keyOffset, uint8_t const keySize);
+
+/**
+ * @brief Post an event, merging it with a pending event of the same key
+ *
+ * Safe from AOs and kernel-aware ISRs, exactly where QACTIVE_POST() is.
+ * The event must not be used by the caller afterwards (it may have been
+ * recycled). A pending dynamic event that only this queue references is
+ * updated in place. Static or multicast events are replaced in their
+ * queue slot by the new event instead. Ordering is preserved: the merged
+ * event keeps the queue position of the pending one.
+ *
+ * @param ao     Target Active Object
+ * @param e      Event to post (normally fresh from Q_NEW())
+ * @param sender Sender for QS, unused without Q_SPY
+ */
+void Coalesce_post(QActive * const ao, QEvt const * const e,
+                   void const * const sender);
+
+/**
+ * @brief Counters for one registered signal (NULL if not registered)
+ */
+CoalesceStats const *Coalesce_getStats(enum_t const sig);
+
+/**
+ * @brief Emit the counters of all registered signals as QS records
+ */
+void Coalesce_report(void);
+
+//============================================================================
+// INTEGRATION MACROS
+//============================================================================
+
+#define COALESCE_ADD(sig_, evtType_, keyMember_) \
+    Coalesce_add((sig_), (uint16_t)sizeof(evtType_), \
+                 (uint16_t)offsetof(evtType_, keyMember_), \
+                 (uint8_t)sizeof(((evtType_ *)0)->keyMember_))
+#define COALESCE_ADD_SIG(sig_, evtType_) \
+    Coalesce_add((sig_), (uint16_t)sizeof(evtType_), 0U, 0U)
+#define COALESCE_POST(ao_, e_, sender_) \
+    Coalesce_post((ao_), (e_), (sender_))
+#define COALESCE_REPORT()               Coalesce_report()
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COALESCE_H
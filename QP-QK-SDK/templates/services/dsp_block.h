@@ -0,0 +1,182 @@
+/**
+ * @file dsp_block.h
+ * @brief Block Signal-Processing Kernels for Sensor Pipelines
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * Filter, statistics and spectrum stages for sample blocks that arrive
+ * as BufEvt (buf_pool.h), used by the sensor pipeline AO template. With
+ * DSP_USE_CMSIS the stages are CMSIS-DSP kernels. On the STM32F4 those
+ * use the Cortex-M4 DSP instructions and the single-precision FPU.
+ * Without it they are portable C with the same results, so the host
+ * build runs the same pipeline.
+ *
+ * The per-sample path (DspChain_sample()) runs the same filter one sample
+ * at a time. It exists for designs that cannot buffer, and for the
+ * benchmark that compares both paths (DSP_BENCH_ENABLE).
+ */
+
+#ifndef DSP_BLOCK_H
+#define DSP_BLOCK_H
+
+#include "qpc.h"
+
+#ifdef DSP_USE_CMSIS
+#include "arm_math.h"   // CMSIS-DSP, built with -DARM_MATH_CM4
+#else
+typedef float float32_t;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//============================================================================
+// CONFIGURATION
+//============================================================================
+
+#ifndef DSP_BLOCK_LEN
+#define DSP_BLOCK_LEN           256U    // Samples per block (2^n, FFT size)
+#endif
+
+#ifndef DSP_BIQUAD_STAGES
+#define DSP_BIQUAD_STAGES       2U      // Second-order filter sections
+#endif
+
+#ifndef DSP_BENCH_ITERATIONS
+#define DSP_BENCH_ITERATIONS    100U    // Benchmark runs per path (min kept)
+#endif
+
+//============================================================================
+// TYPES
+//============================================================================
+
+/**
+ * @brief Reduced result of one block (of the filtered signal)
+ */
+typedef struct {
+    float32_t mean;
+    float32_t rms;
+    float32_t min;
+    float32_t max;
+    float32_t peakHz;           /**< Strongest non-DC bin (0 = no spectrum) */
+    float32_t peakAmp;          /**< Amplitude of that bin */
+} DspResult;
+
+/**
+ * @brief Running statistics of the per-sample path
+ */
+typedef struct {
+    uint32_t n;
+    float32_t sum;
+    float32_t sumSq;
+    float32_t min;
+    float32_t max;
+} DspAccum;
+
+/**
+ * @brief Filter state and work buffers of one pipeline
+ *
+ * About 2 KB with the defaults (x[] and spec[]). Keep it in the AO, not
+ * on the stack.
+ */
+typedef struct {
+    float32_t coeffs[5U * DSP_BIQUAD_STAGES];   /**< b0 b1 b2 a1 a2 per stage */
+    float32_t state[2U * DSP_BIQUAD_STAGES];    /**< Direct form II transposed */
+    float32_t sampleRateHz;
+#ifdef DSP_USE_CMSIS
+    arm_biquad_cascade_df2T_instance_f32 biquad;
+    arm_rfft_fast_instance_f32 rfft;
+    float32_t spec[DSP_BLOCK_LEN];              /**< Packed real FFT */
+#else
+    float32_t spec[2U * DSP_BLOCK_LEN];         /**< Complex FFT */
+#endif
+    float32_t x[DSP_BLOCK_LEN];                 /**< Filtered block */
+} DspChain;
+
+//============================================================================
+// PUBLIC INTERFACE
+//============================================================================
+
+/**
+ * @brief Set up a pipeline
+ *
+ * The coefficients use the CMSIS-DSP sign convention for each stage:
+ * y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] + a1 y[n-1] + a2 y[n-2],
+ * i.e. a1 and a2 are the negated denominator coefficients.
+ *
+ * @param coeffs       5 * DSP_BIQUAD_STAGES coefficients (copied)
+ * @param sampleRateHz Sample rate of the input, for DspResult.peakHz
+ */
+void DspChain_init(DspChain * const me, float32_t const coeffs[],
+                   float32_t const sampleRateHz);
+
+/**
+ * @brief Clear the filter state (e.g. after a gap in the block sequence)
+ */
+void DspChain_reset(DspChain * const me);
+
+/**
+ * @brief Filter one block and reduce it to mean/RMS/min/max
+ *
+ * Full blocks (n == DSP_BLOCK_LEN) also get the spectral peak. The filter
+ * state carries over from the previous block.
+ *
+ * @param samples Q15 samples (signed 16-bit, full scale = 1.0)
+ * @param n       Number of samples, 1 .. DSP_BLOCK_LEN
+ */
+void DspChain_process(DspChain * const me, int16_t const * const samples,
+                      uint16_t const n, DspResult * const res);
+
+/**
+ * @brief Filter one sample and add it to the running statistics
+ *
+ * @return The filtered sample
+ */
+float32_t DspChain_sample(DspChain * const me, int16_t const sample,
+                          DspAccum * const acc);
+
+/**
+ * @brief Clear running statistics
+ */
+void DspAccum_clear(DspAccum * const acc);
+
+/**
+ * @brief Statistics of the samples accumulated so far (no spectrum)
+ */
+void DspAccum_result(DspAccum const * const acc, DspResult * const res);
+
+/**
+ * @brief Compare the block path with per-sample events (task context)
+ *
+ * Runs a synthetic block through DspChain_process() and through the
+ * per-sample path, where every sample is also allocated and recycled as
+ * an event of evtSize bytes the way a per-sample design would post it.
+ * Keeps the fastest of DSP_BENCH_ITERATIONS runs of each path and emits
+ * one BENCH_QS_DSP record (bench_stats.h). Queueing and dispatch of the
+ * per-sample events are not included, so the per-sample figure is a
+ * lower bound.
+ *
+ * @param cyclesPerUs BSP_cycles() ticks per microsecond
+ * @param evtSize     Size of the per-sample event (e.g. SensorDataEvt)
+ * @param sig         Signal of the per-sample event
+ */
+void DspBench_run(uint32_t const cyclesPerUs, uint_fast16_t const evtSize,
+                  enum_t const sig);
+
+//============================================================================
+// INTEGRATION MACROS
+//============================================================================
+
+#ifdef DSP_BENCH_ENABLE
+#define DSP_BENCH_RUN(cyclesPerUs_, evtType_, sig_) \
+    DspBench_run((cyclesPerUs_), (uint_fast16_t)sizeof(evtType_), (sig_))
+#else
+#define DSP_BENCH_RUN(cyclesPerUs_, evtType_, sig_)  ((void)0)
+#endif // DSP_BENCH_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DSP_BLOCK_H
@@ -0,0 +1,279 @@
+/**
+ * @file flow_bench.c
+ * @brief Event-Flow Throughput Benchmark
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * A round starts in the source with a BSP_cycles() stamp and ends in the
+ * sink that handles the last event of the round, which takes the end
+ * stamp and posts DONE back. The source priority is below the sinks, so
+ * DONE waits until all sinks are through with the round on both kernels,
+ * and the next round starts from the DONE handler.
+ */
+
+#include "flow_bench.h"
+#include "bench_stats.h"
+
+#ifdef FLOW_BENCH_ENABLE
+
+Q_DEFINE_THIS_MODULE("flow_bench")
+
+Q_ASSERT_STATIC((FLOW_BENCH_SINKS >= 1U) && (FLOW_BENCH_SINKS <= 255U));
+Q_ASSERT_STATIC((FLOW_BENCH_BURST >= 1U) && (FLOW_BENCH_BURST <= 0xFFFFU));
+
+//============================================================================
+// LOCAL TYPES AND VARIABLES
+//============================================================================
+
+#define FLOW_BENCH_RUN_SIG      (FLOW_BENCH_SIG_BASE + 0U)  // Start a run
+#define FLOW_BENCH_POST_SIG     (FLOW_BENCH_SIG_BASE + 1U)  // Burst event
+#define FLOW_BENCH_DONE_SIG     (FLOW_BENCH_SIG_BASE + 2U)  // Round complete
+
+enum FlowBenchPhase {
+    FLOW_BENCH_IDLE = 0U,
+    FLOW_BENCH_POST,
+    FLOW_BENCH_PUBLISH
+};
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+} FlowBenchStat;
+
+typedef struct {
+    QActive super;
+    uint8_t phase;                      /**< FlowBenchPhase */
+    uint32_t rounds;                    /**< Rounds of each measurement */
+    uint32_t round;                     /**< Rounds done in this phase */
+    uint32_t start;                     /**< BSP_cycles() at the round start */
+    FlowBenchStat post;                 /**< Burst post -> last dispatch */
+    FlowBenchStat pubCall;              /**< QACTIVE_PUBLISH() call */
+    FlowBenchStat pubDone;              /**< Publish -> last subscriber */
+} FlowSource;
+
+typedef struct {
+    QActive super;
+    uint16_t got;                       /**< Burst events of this round */
+} FlowSink;
+
+static FlowSource l_src;
+static FlowSink l_sink[FLOW_BENCH_SINKS];
+static QEvt const *l_srcQueueSto[4];
+static QEvt const *l_sinkQueueSto[FLOW_BENCH_SINKS][FLOW_BENCH_BURST];
+
+static QEvt const l_runEvt = QEVT_INITIALIZER(FLOW_BENCH_RUN_SIG);
+static QEvt const l_postEvt = QEVT_INITIALIZER(FLOW_BENCH_POST_SIG);
+static QEvt const l_doneEvt = QEVT_INITIALIZER(FLOW_BENCH_DONE_SIG);
+static QEvt l_pubEvt;                   // Immutable once FlowBench_start() ran
+
+static uint32_t l_cyclesPerUs;
+static uint32_t l_bootStart;
+static uint32_t l_bootCycles;
+static uint32_t l_runRounds;
+static bool l_running;
+static uint32_t l_pending;              // Subscribers still to handle the publish
+static uint32_t l_end;                  // BSP_cycles() at the end of a round
+
+static uint32_t l_tickStart;
+static FlowBenchStat l_tick;
+
+//============================================================================
+// LOCAL FUNCTIONS
+//============================================================================
+
+static void FlowBench_add_(FlowBenchStat * const s, uint32_t const cycles) {
+    if ((s->count == 0U) || (cycles < s->min)) {
+        s->min = cycles;
+    }
+    if (cycles > s->max) {
+        s->max = cycles;
+    }
+    s->sum += cycles;
+    ++s->count;
+}
+
+static uint32_t FlowBench_mean_(FlowBenchStat const * const s) {
+    return (s->count != 0U) ? (uint32_t)(s->sum / s->count) : 0U;
+}
+
+static void FlowBench_round_(FlowSource * const me) {
+    if (me->phase == FLOW_BENCH_POST) {
+        l_sink[0].got = 0U;
+        me->start = BSP_cycles();
+        for (uint_fast16_t i = 0U; i < FLOW_BENCH_BURST; ++i) {
+            QACTIVE_POST(&l_sink[0].super, &l_postEvt, &me->super);
+        }
+    } else {
+        l_pending = FLOW_BENCH_SINKS;
+        me->start = BSP_cycles();
+        QACTIVE_PUBLISH(&l_pubEvt, &me->super);
+        FlowBench_add_(&me->pubCall, BSP_cycles() - me->start);
+    }
+}
+
+static void FlowBench_report_(FlowSource const * const me) {
+    QF_CRIT_ENTRY(dummy);
+    FlowBenchStat const tick = l_tick;
+    l_tick = (FlowBenchStat){ 0U, 0U, 0U, 0U };
+    QF_CRIT_EXIT(dummy);
+
+    QS_BEGIN_ID(BENCH_QS_REC, 0U)
+        QS_2U8_((uint8_t)BENCH_QS_FLOW, (uint8_t)FLOW_BENCH_SINKS);
+        QS_U16_((uint16_t)FLOW_BENCH_BURST);
+        QS_U32_(me->rounds);
+        QS_U32_(l_cyclesPerUs);
+        QS_U32_(me->post.min);
+        QS_U32_(FlowBench_mean_(&me->post));
+        QS_U32_(me->post.max);
+        QS_U32_(FlowBench_mean_(&me->pubCall));
+        QS_U32_(FlowBench_mean_(&me->pubDone));
+        QS_U32_(me->pubDone.max);
+        QS_U32_(tick.count);
+        QS_U32_(FlowBench_mean_(&tick));
+        QS_U32_(tick.max);
+        QS_U32_(l_bootCycles);
+    QS_END_()
+}
+
+static QState FlowSource_initial(FlowSource * const me, QEvt const * const e);
+static QState FlowSource_active(FlowSource * const me, QEvt const * const e);
+static QState FlowSink_initial(FlowSink * const me, QEvt const * const e);
+static QState FlowSink_active(FlowSink * const me, QEvt const * const e);
+
+static QState FlowSource_initial(FlowSource * const me, QEvt const * const e) {
+    (void)e;
+    QS_OBJ_DICTIONARY(me);
+    QS_FUN_DICTIONARY(&FlowSource_active);
+    return Q_TRAN(&FlowSource_active);
+}
+
+static QState FlowSource_active(FlowSource * const me, QEvt const * const e) {
+    QState status_;
+    switch (e->sig) {
+        case FLOW_BENCH_RUN_SIG: {
+            me->rounds = l_runRounds;
+            me->round = 0U;
+            me->post = (FlowBenchStat){ 0U, 0U, 0U, 0U };
+            me->pubCall = me->post;
+            me->pubDone = me->post;
+            me->phase = FLOW_BENCH_POST;
+            FlowBench_round_(me);
+            status_ = Q_HANDLED();
+            break;
+        }
+        case FLOW_BENCH_DONE_SIG: {
+            FlowBench_add_((me->phase == FLOW_BENCH_POST) ? &me->post : &me->pubDone,
+                           l_end - me->start);
+            if (++me->round < me->rounds) {
+                FlowBench_round_(me);
+            } else if (me->phase == FLOW_BENCH_POST) {
+                me->phase = FLOW_BENCH_PUBLISH;
+                me->round = 0U;
+                FlowBench_round_(me);
+            } else {
+                me->phase = FLOW_BENCH_IDLE;
+                FlowBench_report_(me);
+                l_running = false;
+            }
+            status_ = Q_HANDLED();
+            break;
+        }
+        default: {
+            status_ = Q_SUPER(&QHsm_top);
+            break;
+        }
+    }
+    return status_;
+}
+
+static QState FlowSink_initial(FlowSink * const me, QEvt const * const e) {
+    (void)e;
+    QS_OBJ_DICTIONARY(me);
+    QS_FUN_DICTIONARY(&FlowSink_active);
+    QActive_subscribe(&me->super, l_pubEvt.sig);
+    return Q_TRAN(&FlowSink_active);
+}
+
+static QState FlowSink_active(FlowSink * const me, QEvt const * const e) {
+    QState status_;
+    if (e->sig == FLOW_BENCH_POST_SIG) {
+        if (++me->got == FLOW_BENCH_BURST) {
+            l_end = BSP_cycles();
+            QACTIVE_POST(&l_src.super, &l_doneEvt, &me->super);
+        }
+        status_ = Q_HANDLED();
+    } else if (e->sig == l_pubEvt.sig) {
+        // Sinks run one after the other (none has a second event queued)
+        if (--l_pending == 0U) {
+            l_end = BSP_cycles();
+            QACTIVE_POST(&l_src.super, &l_doneEvt, &me->super);
+        }
+        status_ = Q_HANDLED();
+    } else {
+        status_ = Q_SUPER(&QHsm_top);
+    }
+    return status_;
+}
+
+//============================================================================
+// PUBLIC FUNCTIONS
+//============================================================================
+
+void FlowBench_init(uint32_t cyclesPerUs) {
+    l_cyclesPerUs = cyclesPerUs;
+    l_bootStart = BSP_cycles();
+    l_bootCycles = 0U;
+}
+
+void FlowBench_booted(void) {
+    if (l_bootCycles == 0U) {
+        l_bootCycles = BSP_cycles() - l_bootStart;
+    }
+}
+
+void FlowBench_start(uint_fast8_t prio, enum_t pubSig) {
+    Q_REQUIRE((prio != 0U) && ((prio + FLOW_BENCH_SINKS) <= QF_MAX_ACTIVE));
+
+    l_pubEvt = (QEvt)QEVT_INITIALIZER(pubSig);
+    for (uint_fast8_t i = 0U; i < FLOW_BENCH_SINKS; ++i) {
+        FlowSink * const me = &l_sink[i];
+        QActive_ctor(&me->super, Q_STATE_CAST(&FlowSink_initial));
+        me->got = 0U;
+        QACTIVE_START(&me->super, prio + 1U + i,
+                      l_sinkQueueSto[i], Q_DIM(l_sinkQueueSto[i]),
+                      (void *)0, 0U, (void *)0);
+    }
+    QActive_ctor(&l_src.super, Q_STATE_CAST(&FlowSource_initial));
+    l_src.phase = FLOW_BENCH_IDLE;
+    QACTIVE_START(&l_src.super, prio,
+                  l_srcQueueSto, Q_DIM(l_srcQueueSto),
+                  (void *)0, 0U, (void *)0);
+}
+
+void FlowBench_run(uint32_t rounds) {
+    Q_REQUIRE(l_src.super.prio != 0U);  // FlowBench_start() first
+
+    QF_CRIT_ENTRY(dummy);
+    bool const busy = l_running;
+    l_running = true;
+    QF_CRIT_EXIT(dummy);
+    if (!busy) {
+        l_runRounds = (rounds != 0U) ? rounds : FLOW_BENCH_ROUNDS;
+        QACTIVE_POST(&l_src.super, &l_runEvt, (void *)0);
+    }
+}
+
+void FlowBench_tickBegin(void) {
+    l_tickStart = BSP_cycles();
+}
+
+void FlowBench_tickEnd(void) {
+    uint32_t const cycles = BSP_cycles() - l_tickStart;
+    QF_CRIT_ENTRY(dummy);
+    FlowBench_add_(&l_tick, cycles);
+    QF_CRIT_EXIT(dummy);
+}
+
+#endif // FLOW_BENCH_ENABLE
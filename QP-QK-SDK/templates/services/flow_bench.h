@@ -0,0 +1,131 @@
+/**
+ * @file flow_bench.h
+ * @brief Event-Flow Throughput Benchmark
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * Measures the hot paths every application pays for, on the kernel and
+ * port the project is built with: posting an event to an AO and having it
+ * dispatched, publishing to several subscribers, the tick ISR, and the
+ * boot from BSP_init() to QF_onStartup(). tools/analyzers/flow_bench.py
+ * adds the code and RAM size of the ELF and checks the whole set against
+ * a stored baseline, so a template or code generation change that slows
+ * these paths fails the pipeline.
+ *
+ * The benchmark brings its own AOs: a source at the given priority and
+ * FLOW_BENCH_SINKS sinks right above it. A run (FlowBench_run()) posts
+ * bursts of FLOW_BENCH_BURST events to the first sink, then publishes
+ * one event to all sinks, for the given number of rounds each. Under QK
+ * every post and the end of a publish preempt the source, so the figures
+ * include the context switches; under QV the events queue up and are
+ * dispatched after the source's step. The events are immutable: event
+ * pool cost is not part of the figures (see pool_monitor.h for it).
+ */
+
+#ifndef FLOW_BENCH_H
+#define FLOW_BENCH_H
+
+#include "qpc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//============================================================================
+// CONFIGURATION
+//============================================================================
+
+#ifndef FLOW_BENCH_SINKS
+#define FLOW_BENCH_SINKS        4U      // Subscribers of the published event
+#endif
+
+#ifndef FLOW_BENCH_BURST
+#define FLOW_BENCH_BURST        16U     // Events posted per round (queue depth)
+#endif
+
+#ifndef FLOW_BENCH_ROUNDS
+#define FLOW_BENCH_ROUNDS       100U    // Default rounds of each measurement
+#endif
+
+#ifndef FLOW_BENCH_SIG_BASE
+#define FLOW_BENCH_SIG_BASE     (Q_USER_SIG + 0xD0U) // Private signals (3)
+#endif
+
+//============================================================================
+// PUBLIC INTERFACE
+//============================================================================
+
+/**
+ * @brief Free-running 32-bit CPU cycle counter (provided by the BSP)
+ */
+uint32_t BSP_cycles(void);
+
+/**
+ * @brief Start the boot time measurement
+ *
+ * Call right after BSP_init(), once BSP_cycles() counts at the final
+ * clock.
+ *
+ * @param cyclesPerUs CPU cycles per microsecond (BSP_SYSTEM_CLOCK_HZ / 1e6)
+ */
+void FlowBench_init(uint32_t cyclesPerUs);
+
+/**
+ * @brief The system is up (call first thing in QF_onStartup())
+ */
+void FlowBench_booted(void);
+
+/**
+ * @brief Start the benchmark AOs
+ *
+ * The source runs at prio, the sinks at prio + 1 .. prio + FLOW_BENCH_SINKS.
+ * Call after QActive_psInit(); pubSig must be below its table size.
+ *
+ * @param prio   Priority of the source AO
+ * @param pubSig Signal the source publishes to the sinks
+ */
+void FlowBench_start(uint_fast8_t prio, enum_t pubSig);
+
+/**
+ * @brief Run the benchmark and emit one BENCH_QS_FLOW record at the end
+ *
+ * Ignored while a run is in progress.
+ *
+ * @param rounds Rounds of each measurement (0 = FLOW_BENCH_ROUNDS)
+ */
+void FlowBench_run(uint32_t rounds);
+
+/**
+ * @brief Bracket the tick ISR (after BSP_ISR_ENTRY(), before BSP_ISR_EXIT())
+ *
+ * The tick figures cover the ticks since the previous report.
+ */
+void FlowBench_tickBegin(void);
+void FlowBench_tickEnd(void);
+
+//============================================================================
+// INTEGRATION MACROS
+//============================================================================
+
+#ifdef FLOW_BENCH_ENABLE
+#define FLOW_BENCH_INIT(cyclesPerUs_)       FlowBench_init(cyclesPerUs_)
+#define FLOW_BENCH_BOOTED()                 FlowBench_booted()
+#define FLOW_BENCH_START(prio_, pubSig_) \
+    FlowBench_start((prio_), (enum_t)(pubSig_))
+#define FLOW_BENCH_RUN(rounds_)             FlowBench_run((uint32_t)(rounds_))
+#define FLOW_BENCH_TICK_BEGIN()             FlowBench_tickBegin()
+#define FLOW_BENCH_TICK_END()               FlowBench_tickEnd()
+#else
+#define FLOW_BENCH_INIT(cyclesPerUs_)       ((void)0)
+#define FLOW_BENCH_BOOTED()                 ((void)0)
+#define FLOW_BENCH_START(prio_, pubSig_)    ((void)0)
+#define FLOW_BENCH_RUN(rounds_)             ((void)0)
+#define FLOW_BENCH_TICK_BEGIN()             ((void)0)
+#define FLOW_BENCH_TICK_END()               ((void)0)
+#endif // FLOW_BENCH_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FLOW_BENCH_H
@@ -0,0 +1,311 @@
+/**
+ * @file latency_probe.c
+ * @brief Interrupt and ISR-to-AO Dispatch Latency Probe
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * Pairing model: the ISR queues its entry stamp (and the edge time, if the
+ * generator made the edge) in a small per-channel FIFO right before it posts
+ * the event; the AO pops one stamp per handled event. Events are delivered
+ * in order, so every handled event meets its own stamp, including events
+ * that waited in the queue behind others. An event posted while the FIFO
+ * is full gets no stamp; it is counted against the newest stamp, and the
+ * AO skips that many handled events after popping it, so the pairing
+ * stays in step.
+ */
+
+#include "latency_probe.h"
+#include <string.h>
+
+#ifdef LAT_PROBE_ENABLE
+
+Q_DEFINE_THIS_MODULE("latency_probe")
+
+// 'generated' is a uint8_t bitmask and slots wrap with a mask
+Q_ASSERT_STATIC((LAT_PROBE_DEPTH <= 8U)
+                && ((LAT_PROBE_DEPTH & (LAT_PROBE_DEPTH - 1U)) == 0U));
+
+//============================================================================
+// LOCAL TYPES AND VARIABLES
+//============================================================================
+
+typedef struct {
+    uint32_t edge[LAT_PROBE_DEPTH];     /**< Generated edge time */
+    uint32_t entry[LAT_PROBE_DEPTH];    /**< ISR entry time */
+    uint16_t after[LAT_PROBE_DEPTH];    /**< Unstamped events posted next */
+    uint8_t generated;                  /**< Bit n: edge[n] is valid */
+    uint8_t head;                       /**< Next slot the ISR fills */
+    uint8_t tail;                       /**< Next slot the AO takes */
+    uint16_t skip;                      /**< Unstamped events at the front */
+
+    volatile bool armed;                /**< Generator edge not yet taken */
+    uint32_t trigger;                   /**< Time of the armed edge */
+    uint32_t isrEdge;                   /**< Edge taken by the current ISR */
+    uint32_t isrEntry;                  /**< Entry stamp of the current ISR */
+    bool isrGenerated;
+
+    uint32_t lost;                      /**< Stamps dropped (FIFO full) */
+    uint32_t unpaired;                  /**< Handled events without a stamp */
+    LatProbeStats stats[LAT_PROBE_STAGES];
+} LatProbeCh;
+
+typedef struct {
+    QActive super;
+    QTimeEvt timeEvt;
+    uint32_t period;                    /**< Ticks between bursts (0 = off) */
+    uint32_t busyUs;                    /**< Busy time per burst */
+    uint32_t runs;                      /**< Bursts executed */
+} LatLoad;
+
+static LatProbeCh l_ch[LAT_PROBE_MAX_CH];
+static LatLoad l_load[LAT_PROBE_LOAD_AOS];
+static QEvt const *l_loadQueueSto[LAT_PROBE_LOAD_AOS][2];
+static uint32_t l_cyclesPerUs;
+
+//============================================================================
+// LOCAL FUNCTIONS
+//============================================================================
+
+static void LatProbe_record_(LatProbeStats * const s, uint32_t cycles) {
+    uint32_t const e = 31U - (uint32_t)__builtin_clz(cycles | 1U);
+    uint32_t bin;
+    if (e <= LAT_PROBE_SUB_BITS) {
+        bin = cycles;                   // Exact below 2^(SUB_BITS+1)
+    } else {
+        uint32_t const shift = e - LAT_PROBE_SUB_BITS;
+        bin = (shift << LAT_PROBE_SUB_BITS) + (cycles >> shift);
+    }
+    if (bin >= LAT_PROBE_BINS) {
+        bin = LAT_PROBE_BINS - 1U;
+    }
+    if (s->hist[bin] != 0xFFFFU) {
+        ++s->hist[bin];
+    }
+
+    if ((s->count == 0U) || (cycles < s->min)) {
+        s->min = cycles;
+    }
+    if (cycles > s->max) {
+        s->max = cycles;
+    }
+    s->sum += cycles;
+    ++s->count;
+}
+
+static QState LatLoad_initial(LatLoad * const me, QEvt const * const e);
+static QState LatLoad_active(LatLoad * const me, QEvt const * const e);
+
+static QState LatLoad_initial(LatLoad * const me, QEvt const * const e) {
+    (void)e;
+    QS_OBJ_DICTIONARY(me);
+    QS_OBJ_DICTIONARY(&me->timeEvt);
+    QS_FUN_DICTIONARY(&LatLoad_active);
+    return Q_TRAN(&LatLoad_active);
+}
+
+static QState LatLoad_active(LatLoad * const me, QEvt const * const e) {
+    QState status_;
+    switch (e->sig) {
+        case LAT_PROBE_LOAD_SIG: {
+            // One burst of CPU load: the whole RTC step is busy time
+            uint32_t const busy = me->busyUs * l_cyclesPerUs;
+            uint32_t const start = BSP_cycles();
+            while ((BSP_cycles() - start) < busy) {
+            }
+            ++me->runs;
+            status_ = Q_HANDLED();
+            break;
+        }
+        default: {
+            status_ = Q_SUPER(&QHsm_top);
+            break;
+        }
+    }
+    return status_;
+}
+
+//============================================================================
+// PUBLIC FUNCTIONS
+//============================================================================
+
+void LatProbe_init(uint32_t cyclesPerUs) {
+    l_cyclesPerUs = cyclesPerUs;
+    memset(l_ch, 0, sizeof(l_ch));
+}
+
+void LatProbe_loadStart(uint_fast8_t idx, uint_fast8_t prio) {
+    Q_REQUIRE(idx < LAT_PROBE_LOAD_AOS);
+
+    LatLoad * const me = &l_load[idx];
+    QActive_ctor(&me->super, Q_STATE_CAST(&LatLoad_initial));
+    QTimeEvt_ctorX(&me->timeEvt, &me->super, LAT_PROBE_LOAD_SIG, 0U);
+    me->period = 0U;
+    me->busyUs = 0U;
+    me->runs = 0U;
+    QACTIVE_START(&me->super, prio,
+                  l_loadQueueSto[idx], Q_DIM(l_loadQueueSto[idx]),
+                  (void *)0, 0U, (void *)0);
+}
+
+void LatProbe_setLoad(uint_fast8_t idx, uint32_t periodTicks,
+                      uint32_t busyUs)
+{
+    if (idx >= LAT_PROBE_LOAD_AOS) {
+        return;
+    }
+    LatLoad * const me = &l_load[idx];
+    Q_REQUIRE(me->super.prio != 0U);   // LatProbe_loadStart() first
+
+    (void)QTimeEvt_disarm(&me->timeEvt);
+    me->period = periodTicks;
+    me->busyUs = busyUs;
+    me->runs = 0U;
+    if ((periodTicks != 0U) && (busyUs != 0U)) {
+        QTimeEvt_armX(&me->timeEvt, periodTicks, periodTicks);
+    }
+}
+
+bool LatProbe_trigger(uint_fast8_t ch) {
+    LatProbeCh * const c = &l_ch[ch];
+    if (c->armed) {
+        return false;                   // ISR has not taken the last edge
+    }
+    c->trigger = BSP_cycles();
+    c->armed = true;
+    return true;
+}
+
+void LatProbe_isrEntry(uint_fast8_t ch) {
+    uint32_t const now = BSP_cycles();
+    LatProbeCh * const c = &l_ch[ch];
+
+    // The generator only re-arms after this read (see LatProbe_trigger())
+    c->isrGenerated = c->armed;
+    c->isrEdge = c->trigger;
+    c->isrEntry = now;
+    c->armed = false;
+}
+
+void LatProbe_posted(uint_fast8_t ch) {
+    // Single producer (this ISR); the AO side pops with interrupts disabled
+    LatProbeCh * const c = &l_ch[ch];
+    uint8_t const head = c->head;
+    if ((uint8_t)(head - c->tail) >= LAT_PROBE_DEPTH) {
+        ++c->after[(uint8_t)(head - 1U) & (LAT_PROBE_DEPTH - 1U)];
+        ++c->lost;
+        return;
+    }
+    uint_fast8_t const slot = head & (LAT_PROBE_DEPTH - 1U);
+    c->after[slot] = 0U;
+    c->edge[slot] = c->isrEdge;
+    c->entry[slot] = c->isrEntry;
+    if (c->isrGenerated) {
+        c->generated |= (uint8_t)(1U << slot);
+    } else {
+        c->generated &= (uint8_t)~(1U << slot);
+    }
+    c->head = head + 1U;
+}
+
+void LatProbe_dispatch(uint_fast8_t ch) {
+    uint32_t const now = BSP_cycles();
+    LatProbeCh * const c = &l_ch[ch];
+
+    QF_INT_DISABLE();
+    if (c->skip != 0U) {
+        --c->skip;                      // Its stamp was lost (FIFO full)
+        QF_INT_ENABLE();
+        return;
+    }
+    if (c->head == c->tail) {
+        ++c->unpaired;                  // Posted without LAT_PROBE_POSTED()
+        QF_INT_ENABLE();
+        return;
+    }
+    uint_fast8_t const slot = c->tail & (LAT_PROBE_DEPTH - 1U);
+    uint32_t const entry = c->entry[slot];
+    uint32_t const edge = c->edge[slot];
+    bool const generated = (c->generated & (1U << slot)) != 0U;
+    c->skip = c->after[slot];
+    ++c->tail;
+
+    LatProbe_record_(&c->stats[LAT_PROBE_DISPATCH], now - entry);
+    if (generated) {
+        LatProbe_record_(&c->stats[LAT_PROBE_IRQ], entry - edge);
+        LatProbe_record_(&c->stats[LAT_PROBE_TOTAL], now - edge);
+    }
+    QF_INT_ENABLE();
+}
+
+LatProbeStats const *LatProbe_getStats(uint_fast8_t ch, uint_fast8_t stage) {
+    return ((ch < LAT_PROBE_MAX_CH) && (stage < LAT_PROBE_STAGES))
+           ? &l_ch[ch].stats[stage]
+           : (LatProbeStats const *)0;
+}
+
+void LatProbe_report(uint_fast8_t ch) {
+    for (uint_fast8_t n = 0U; n < LAT_PROBE_MAX_CH; ++n) {
+        if ((ch != 0U) && (n != (ch - 1U))) {
+            continue;
+        }
+        LatProbeCh const * const c = &l_ch[n];
+        for (uint_fast8_t stage = 0U; stage < LAT_PROBE_STAGES; ++stage) {
+            LatProbeStats const * const s = &c->stats[stage];
+            if (s->count == 0U) {
+                continue;
+            }
+            uint_fast8_t used = 0U;
+            for (uint_fast16_t b = 0U; b < LAT_PROBE_BINS; ++b) {
+                used += (s->hist[b] != 0U) ? 1U : 0U;
+            }
+
+            // Sparse histogram: (bin U8, count U16) for non-empty bins
+            QS_BEGIN_ID(LAT_PROBE_QS_REC, 0U)
+                QS_2U8_((uint8_t)LAT_PROBE_QS_STATS, (uint8_t)n);
+                QS_2U8_((uint8_t)stage, (uint8_t)LAT_PROBE_SUB_BITS);
+                QS_U32_(l_cyclesPerUs);
+                QS_U32_(s->count);
+                QS_U32_(s->min);
+                QS_U32_(s->max);
+                QS_U32_((uint32_t)(s->sum / s->count));
+                QS_U32_(c->lost);
+                QS_U32_(c->unpaired);
+                QS_U8_((uint8_t)used);
+                for (uint_fast16_t b = 0U; b < LAT_PROBE_BINS; ++b) {
+                    if (s->hist[b] != 0U) {
+                        QS_U8_((uint8_t)b);
+                        QS_U16_(s->hist[b]);
+                    }
+                }
+            QS_END_()
+        }
+    }
+
+    if (ch == 0U) {
+        for (uint_fast8_t idx = 0U; idx < LAT_PROBE_LOAD_AOS; ++idx) {
+            LatLoad const * const me = &l_load[idx];
+            if (me->super.prio == 0U) {
+                continue;
+            }
+            QS_BEGIN_ID(LAT_PROBE_QS_REC, 0U)
+                QS_2U8_((uint8_t)LAT_PROBE_QS_LOAD, (uint8_t)idx);
+                QS_U8_((uint8_t)me->super.prio);
+                QS_U32_(me->period);
+                QS_U32_(me->busyUs);
+                QS_U32_(me->runs);
+            QS_END_()
+        }
+    }
+}
+
+void LatProbe_reset(void) {
+    QF_INT_DISABLE();
+    for (uint_fast8_t n = 0U; n < LAT_PROBE_MAX_CH; ++n) {
+        memset(l_ch[n].stats, 0, sizeof(l_ch[n].stats));
+        l_ch[n].lost = 0U;
+        l_ch[n].unpaired = 0U;
+    }
+    QF_INT_ENABLE();
+}
+
+#endif // LAT_PROBE_ENABLE
@@ -0,0 +1,221 @@
+/**
+ * @file latency_probe.h
+ * @brief Interrupt and ISR-to-AO Dispatch Latency Probe
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * Measures the hard real-time response path of a QK application with the
+ * DWT cycle counter, in up to three stages per sample:
+ *
+ *   edge ──IRQ──> ISR entry ──DISPATCH──> AO handler
+ *   └───────────────TOTAL──────────────────┘
+ *
+ * The ISR stamps its entry, the AO stamps the start of the handler for the
+ * event the ISR posted, and the difference goes into a log-linear histogram
+ * per channel and stage. The edge time is only known when the BSP's loopback
+ * generator made the edge (BSP_latGenStart()); for real inputs only the
+ * DISPATCH stage is recorded.
+ *
+ * Background load comes from LAT_PROBE_LOAD_AOS built-in load AOs that
+ * busy-wait a configurable time every N ticks, at priorities above and
+ * below the AO under test. Histograms are kept on the target so the probe
+ * adds no trace traffic to the path it measures; tools/analyzers/
+ * latency_probe.py drives the test and computes the percentiles.
+ */
+
+#ifndef LATENCY_PROBE_H
+#define LATENCY_PROBE_H
+
+#include "qpc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//============================================================================
+// CONFIGURATION
+//============================================================================
+
+#ifndef LAT_PROBE_MAX_CH
+#define LAT_PROBE_MAX_CH        2U      // Measured ISR -> AO paths
+#endif
+
+#ifndef LAT_PROBE_DEPTH
+#define LAT_PROBE_DEPTH         4U      // Samples in flight per channel (2^n, <= 8)
+#endif
+
+#ifndef LAT_PROBE_SUB_BITS
+#define LAT_PROBE_SUB_BITS      3U      // 2^3 histogram bins per octave
+#endif
+
+#ifndef LAT_PROBE_BINS
+#define LAT_PROBE_BINS          136U    // Up to 2^19 cycles (3.1 ms at 168 MHz)
+#endif
+
+#ifndef LAT_PROBE_LOAD_AOS
+#define LAT_PROBE_LOAD_AOS      2U      // Built-in background load AOs
+#endif
+
+#ifndef LAT_PROBE_LOAD_SIG
+#define LAT_PROBE_LOAD_SIG      Q_USER_SIG  // Private to the load AOs
+#endif
+
+#ifndef LAT_PROBE_GEN_CH
+#define LAT_PROBE_GEN_CH        0U      // Channel the loopback generator drives
+#endif
+
+// QS user record reserved for this service (see project_template.h)
+#define LAT_PROBE_QS_REC        (QS_USER + 21)
+
+// Sub-record types carried in the first byte of LAT_PROBE_QS_REC
+enum LatProbeQSType {
+    LAT_PROBE_QS_STATS = 1U,        /**< ch, stage, count, min, max, ... */
+    LAT_PROBE_QS_LOAD               /**< idx, prio, period, busyUs, runs */
+};
+
+/**
+ * @brief Measured stages of one sample
+ */
+enum LatProbeStage {
+    LAT_PROBE_IRQ = 0U,             /**< Edge to ISR entry (generator only) */
+    LAT_PROBE_DISPATCH,             /**< ISR entry to AO handler */
+    LAT_PROBE_TOTAL,                /**< Edge to AO handler (generator only) */
+    LAT_PROBE_STAGES
+};
+
+//============================================================================
+// STATISTICS
+//============================================================================
+
+/**
+ * @brief Latency statistics of one stage, in CPU cycles
+ *
+ * Bin n < 2^(SUB_BITS+1) holds exactly n cycles. Above that, each octave
+ * [2^e, 2^(e+1)) is split into 2^SUB_BITS bins; the last bin also holds
+ * everything longer.
+ */
+typedef struct {
+    uint32_t count;                 /**< Samples measured */
+    uint32_t min;                   /**< Shortest latency */
+    uint32_t max;                   /**< Longest latency */
+    uint64_t sum;                   /**< Sum of all latencies (for mean) */
+    uint16_t hist[LAT_PROBE_BINS];  /**< Saturating log-linear histogram */
+} LatProbeStats;
+
+//============================================================================
+// PUBLIC INTERFACE
+//============================================================================
+
+/**
+ * @brief Free-running 32-bit CPU cycle counter (provided by the BSP)
+ */
+uint32_t BSP_cycles(void);
+
+/**
+ * @brief Start/stop the BSP loopback edge generator
+ *
+ * The BSP fires the measured interrupt at random intervals from a
+ * kernel-unaware timer ISR and calls LatProbe_trigger() right before
+ * each edge.
+ *
+ * @param meanUs Mean interval between edges in microseconds (0 = stop)
+ */
+void BSP_latGenStart(uint32_t meanUs);
+
+/**
+ * @brief Initialize the probe
+ *
+ * @param cyclesPerUs CPU cycles per microsecond (BSP_SYSTEM_CLOCK_HZ / 1e6)
+ */
+void LatProbe_init(uint32_t cyclesPerUs);
+
+/**
+ * @brief Start one background load AO (idle until LatProbe_setLoad())
+ *
+ * @param idx  Load AO index (< LAT_PROBE_LOAD_AOS)
+ * @param prio QF priority, above or below the AO under test
+ */
+void LatProbe_loadStart(uint_fast8_t idx, uint_fast8_t prio);
+
+/**
+ * @brief Configure a load AO: busy-wait busyUs every periodTicks ticks
+ *
+ * @param periodTicks Period in system ticks (0 = stop)
+ */
+void LatProbe_setLoad(uint_fast8_t idx, uint32_t periodTicks,
+                      uint32_t busyUs);
+
+/**
+ * @brief Record the time of the next edge (generator, before the edge)
+ *
+ * @return false while the previous generated sample is still in flight
+ */
+bool LatProbe_trigger(uint_fast8_t ch);
+
+/**
+ * @brief Stamp ISR entry (first statement of the ISR)
+ */
+void LatProbe_isrEntry(uint_fast8_t ch);
+
+/**
+ * @brief Queue the stamp for the AO (right before the post/publish)
+ *
+ * Call only when the event is actually posted, so that the AO pairs every
+ * handled event with its own ISR stamp.
+ */
+void LatProbe_posted(uint_fast8_t ch);
+
+/**
+ * @brief Close the sample (first statement of the AO's event handler)
+ */
+void LatProbe_dispatch(uint_fast8_t ch);
+
+/**
+ * @brief Statistics for one channel and stage (NULL if out of range)
+ */
+LatProbeStats const *LatProbe_getStats(uint_fast8_t ch, uint_fast8_t stage);
+
+/**
+ * @brief Emit statistics as QS records
+ *
+ * @param ch Channel + 1 to report, or 0 for all channels and load AOs
+ */
+void LatProbe_report(uint_fast8_t ch);
+
+/**
+ * @brief Clear all statistics
+ */
+void LatProbe_reset(void);
+
+//============================================================================
+// INTEGRATION MACROS
+//============================================================================
+
+#ifdef LAT_PROBE_ENABLE
+#define LAT_PROBE_INIT(cyclesPerUs_)        LatProbe_init(cyclesPerUs_)
+#define LAT_PROBE_LOAD_START(idx_, prio_)   LatProbe_loadStart((idx_), (prio_))
+#define LAT_PROBE_LOAD(idx_, period_, busyUs_) \
+    LatProbe_setLoad((idx_), (period_), (busyUs_))
+#define LAT_PROBE_GEN(meanUs_)              BSP_latGenStart(meanUs_)
+#define LAT_PROBE_ISR_ENTRY(ch_)            LatProbe_isrEntry(ch_)
+#define LAT_PROBE_POSTED(ch_)               LatProbe_posted(ch_)
+#define LAT_PROBE_DISPATCH(ch_)             LatProbe_dispatch(ch_)
+#define LAT_PROBE_REPORT(ch_)               LatProbe_report(ch_)
+#define LAT_PROBE_RESET()                   LatProbe_reset()
+#else
+#define LAT_PROBE_INIT(cyclesPerUs_)        ((void)0)
+#define LAT_PROBE_LOAD_START(idx_, prio_)   ((void)0)
+#define LAT_PROBE_LOAD(idx_, period_, busyUs_) ((void)0)
+#define LAT_PROBE_GEN(meanUs_)              ((void)0)
+#define LAT_PROBE_ISR_ENTRY(ch_)            ((void)0)
+#define LAT_PROBE_POSTED(ch_)               ((void)0)
+#define LAT_PROBE_DISPATCH(ch_)             ((void)0)
+#define LAT_PROBE_REPORT(ch_)               ((void)0)
+#define LAT_PROBE_RESET()                   ((void)0)
+#endif // LAT_PROBE_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LATENCY_PROBE_H
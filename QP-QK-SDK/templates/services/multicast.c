@@ -0,0 +1,156 @@
+/**
+ * @file multicast.c
+ * @brief Batched Multicast Publish
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * Mirrors QF_publish_() for a whole batch. Each dynamic event gets one
+ * extra reference while it is being delivered, so an event with no
+ * subscribers is still recycled. The subscriber sets are copied under a
+ * critical section, the batch is posted under one scheduler lock, and the
+ * extra references are dropped at the end.
+ *
+ * The lock needs QK (QK_schedLock()). On the cooperative ports no AO can
+ * run before the publisher returns, so the batch is posted as is. In an
+ * ISR the lock is skipped: QK_schedLock() asserts there, and the
+ * scheduler does not run before QK_ISR_EXIT().
+ */
+
+#include "multicast.h"
+
+Q_DEFINE_THIS_MODULE("multicast")
+
+#ifdef QK_ISR_ENTRY     // Preemptive QK port: one scheduler run per batch
+#define MCAST_SCHED_LOCK_(ceiling_) \
+    bool const locked_ = !QK_ISR_CONTEXT_(); \
+    QSchedStatus const lockStat_ = locked_ ? QK_schedLock(ceiling_) : 0U
+#define MCAST_SCHED_UNLOCK_() do { \
+    if (locked_) { QK_schedUnlock(lockStat_); } \
+} while (false)
+#else
+#define MCAST_SCHED_LOCK_(ceiling_) ((void)(ceiling_))
+#define MCAST_SCHED_UNLOCK_()   ((void)0)
+#endif
+
+//============================================================================
+// LOCAL VARIABLES
+//============================================================================
+
+static QPSet l_subscr[MCAST_MAX_SIG];   // Subscriber priorities per signal
+static uint_fast16_t l_maxPosts;
+
+//============================================================================
+// LOCAL FUNCTIONS
+//============================================================================
+
+static uint_fast16_t Mcast_deliver_(QEvt const * const e, QPSet * const set,
+                                    void const * const sender)
+{
+    uint_fast16_t posts = 0U;
+    while (QPSet_notEmpty(set)) {
+        uint_fast8_t const p = QPSet_findMax(set);
+        QPSet_remove(set, p);
+        QActive * const a = QActive_registry_[p];
+        Q_ASSERT(a != (QActive *)0);    // Subscribed AO must be started
+        QACTIVE_POST(a, e, sender);
+        ++posts;
+    }
+    return posts;
+}
+
+//============================================================================
+// PUBLIC FUNCTIONS
+//============================================================================
+
+void Mcast_init(void) {
+    for (uint_fast8_t sig = 0U; sig < MCAST_MAX_SIG; ++sig) {
+        QPSet_setEmpty(&l_subscr[sig]);
+    }
+    l_maxPosts = 0U;
+}
+
+void Mcast_subscribe(QActive const * const ao, enum_t const sig) {
+    Q_REQUIRE((sig >= Q_USER_SIG) && ((uint_fast16_t)sig < MCAST_MAX_SIG)
+              && (ao->prio != 0U) && (ao->prio <= QF_MAX_ACTIVE)
+              && (QActive_registry_[ao->prio] == ao));
+
+    QF_CRIT_ENTRY(dummy);
+    QPSet_insert(&l_subscr[sig], ao->prio);
+    QF_CRIT_EXIT(dummy);
+}
+
+void Mcast_unsubscribe(QActive const * const ao, enum_t const sig) {
+    Q_REQUIRE((sig >= Q_USER_SIG) && ((uint_fast16_t)sig < MCAST_MAX_SIG)
+              && (ao->prio != 0U) && (ao->prio <= QF_MAX_ACTIVE));
+
+    QF_CRIT_ENTRY(dummy);
+    QPSet_remove(&l_subscr[sig], ao->prio);
+    QF_CRIT_EXIT(dummy);
+}
+
+void Mcast_publish(QEvt const * const e, void const * const sender) {
+    QEvt const * const evts[1] = { e };
+    Mcast_publishBatch(evts, 1U, sender);
+}
+
+void Mcast_publishBatch(QEvt const * const evts[], uint_fast8_t const n,
+                        void const * const sender)
+{
+    QPSet all;
+    QPSet_setEmpty(&all);
+
+    QF_CRIT_ENTRY(dummy);
+    for (uint_fast8_t i = 0U; i < n; ++i) {
+        QEvt * const e = (QEvt *)evts[i];
+        Q_REQUIRE((uint_fast16_t)e->sig < MCAST_MAX_SIG);
+        if (e->poolId_ != 0U) {
+            ++e->refCtr_;               // Held until the batch is delivered
+        }
+        QPSet const * const s = &l_subscr[e->sig];
+        for (uint_fast8_t w = 0U; w < Q_DIM(all.bits); ++w) {
+            all.bits[w] |= s->bits[w];
+        }
+    }
+    QF_CRIT_EXIT(dummy);
+
+    uint_fast16_t posts = 0U;
+    if (QPSet_notEmpty(&all)) {
+        MCAST_SCHED_LOCK_(QPSet_findMax(&all));
+        for (uint_fast8_t i = 0U; i < n; ++i) {
+            QF_CRIT_ENTRY(dummy);
+            QPSet set = l_subscr[evts[i]->sig];
+            QF_CRIT_EXIT(dummy);
+            posts += Mcast_deliver_(evts[i], &set, sender);
+        }
+        MCAST_SCHED_UNLOCK_();
+    }
+
+    // Drop the batch references: recycles events nobody subscribed to
+    for (uint_fast8_t i = 0U; i < n; ++i) {
+        QF_gc(evts[i]);
+    }
+
+    QF_CRIT_ENTRY(dummy);
+    if (posts > l_maxPosts) {
+        l_maxPosts = posts;
+    }
+    QF_CRIT_EXIT(dummy);
+}
+
+uint_fast8_t Mcast_fanout(enum_t const sig) {
+    Q_REQUIRE((uint_fast16_t)sig < MCAST_MAX_SIG);
+
+    uint_fast8_t count = 0U;
+    QF_CRIT_ENTRY(dummy);
+    QPSet set = l_subscr[sig];
+    QF_CRIT_EXIT(dummy);
+    while (QPSet_notEmpty(&set)) {
+        QPSet_remove(&set, QPSet_findMax(&set));
+        ++count;
+    }
+    return count;
+}
+
+uint_fast16_t Mcast_getMaxPosts(void) {
+    return l_maxPosts;
+}
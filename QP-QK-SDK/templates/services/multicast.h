@@ -0,0 +1,109 @@
+/**
+ * @file multicast.h
+ * @brief Batched Multicast Publish
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * A publish layer for high fan-out signals (FAULT_SIG, MODE_CHANGE_SIG)
+ * and for ISRs that publish several events at once. Subscribers are kept
+ * as one precomputed QPSet bitmask per signal. A publish walks the set
+ * from the highest priority down, so delivery is in priority order and
+ * costs one post per subscriber with no list scan.
+ *
+ * A batch of events runs under a single QK scheduler lock at the ceiling
+ * of all its subscribers. The scheduler then runs once, after the last
+ * post, instead of after every post that readies a higher-priority AO. In
+ * an ISR no lock is taken (QK_schedLock() is task-level only): the
+ * scheduler runs at QK_ISR_EXIT() anyway. There the bound is the post
+ * count, Mcast_fanout() per event.
+ *
+ * Signals published through this layer are subscribed with
+ * Mcast_subscribe(), not QActive_subscribe(). QACTIVE_PUBLISH() keeps
+ * working for all other signals.
+ */
+
+#ifndef MULTICAST_H
+#define MULTICAST_H
+
+#include "qpc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//============================================================================
+// CONFIGURATION
+//============================================================================
+
+#ifndef MCAST_MAX_SIG
+#define MCAST_MAX_SIG           32U     // Signals < this can be multicast
+#endif
+
+//============================================================================
+// PUBLIC INTERFACE
+//============================================================================
+
+/**
+ * @brief Clear all subscriber sets (call once before any subscription)
+ */
+void Mcast_init(void);
+
+/**
+ * @brief Receive multicast events of a signal (after QACTIVE_START())
+ */
+void Mcast_subscribe(QActive const * const ao, enum_t const sig);
+
+/**
+ * @brief Stop receiving multicast events of a signal
+ */
+void Mcast_unsubscribe(QActive const * const ao, enum_t const sig);
+
+/**
+ * @brief Publish one event to all subscribers of its signal
+ *
+ * Safe from AOs and kernel-aware ISRs. Like QACTIVE_PUBLISH(), a dynamic
+ * event is recycled once the last subscriber is done with it, and a full
+ * subscriber queue asserts.
+ *
+ * @param e      Event to publish
+ * @param sender Sender for QS, unused without Q_SPY
+ */
+void Mcast_publish(QEvt const * const e, void const * const sender);
+
+/**
+ * @brief Publish several events with one scheduler decision
+ *
+ * Events are delivered in array order. Each event goes to its
+ * subscribers from the highest priority down. No subscriber runs before
+ * the whole batch is queued.
+ *
+ * @param evts   Events to publish
+ * @param n      Number of events
+ * @param sender Sender for QS, unused without Q_SPY
+ */
+void Mcast_publishBatch(QEvt const * const evts[], uint_fast8_t const n,
+                        void const * const sender);
+
+/**
+ * @brief Number of subscribers of a signal (posts per publish)
+ */
+uint_fast8_t Mcast_fanout(enum_t const sig);
+
+/**
+ * @brief Most posts done by one Mcast_publish()/Mcast_publishBatch() call
+ */
+uint_fast16_t Mcast_getMaxPosts(void);
+
+//============================================================================
+// INTEGRATION MACROS
+//============================================================================
+
+#define MCAST_PUBLISH(e_, sender_)      Mcast_publish((e_), (sender_))
+#define MCAST_PUBLISH_BATCH(evts_, n_, sender_) \
+    Mcast_publishBatch((evts_), (n_), (sender_))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MULTICAST_H
@@ -0,0 +1,180 @@
+/**
+ * @file pool_monitor.c
+ * @brief Event Pool Monitor (high-water mark, failures, allocation cost)
+ * @version 1.0.0
+ * @date 2026-10-14
+ * 
+ * The low-water mark comes from QF itself (QF_getPoolMin()); everything
+ * else is counted in PoolMon_new_(). Block ownership is the signal of the
+ * last allocation of each block, so at the moment a pool runs dry the
+ * owner table is exactly the set of events holding it.
+ */
+
+#include "pool_monitor.h"
+
+#ifdef POOL_MON_ENABLE
+
+Q_DEFINE_THIS_MODULE("pool_monitor")
+
+//============================================================================
+// LOCAL TYPES AND VARIABLES
+//============================================================================
+
+typedef struct {
+    uint8_t const *start;           /**< First block */
+    uint8_t const *end;             /**< One past the last block */
+    uint16_t ownerBase;             /**< First slot in l_owner[] */
+    uint32_t winAllocs;             /**< Allocations in the current second */
+    PoolMonStats stats;
+} PoolMonPool;
+
+static PoolMonPool l_pool[POOL_MON_MAX_POOLS];
+static uint_fast8_t l_nPools;
+
+static QSignal l_owner[POOL_MON_MAX_BLOCKS];
+static uint16_t l_nOwners;
+
+static uint32_t l_ticksPerSec;
+static uint32_t l_tickCtr;
+
+//============================================================================
+// LOCAL FUNCTIONS
+//============================================================================
+
+// Pool QF will use for an event of this size (first one that fits)
+static PoolMonPool *PoolMon_poolFor_(uint_fast16_t evtSize) {
+    for (uint_fast8_t i = 0U; i < l_nPools; ++i) {
+        if (evtSize <= l_pool[i].stats.blockSize) {
+            return &l_pool[i];
+        }
+    }
+    return (PoolMonPool *)0;
+}
+
+static void PoolMon_emitExhausted_(PoolMonPool const * const p,
+                                   uint_fast16_t evtSize, enum_t sig)
+{
+    QS_BEGIN_ID(POOL_MON_QS_REC, 0U)
+        QS_2U8_((uint8_t)POOL_MON_QS_EXHAUSTED,
+                (uint8_t)((p - &l_pool[0]) + 1));
+        QS_U16_((uint16_t)sig);
+        QS_U16_((uint16_t)evtSize);
+        QS_U16_(p->stats.nTot);
+        for (uint_fast16_t i = 0U; i < p->stats.nTot; ++i) {
+            QS_U16_((uint16_t)l_owner[p->ownerBase + i]);
+        }
+    QS_END_()
+}
+
+//============================================================================
+// PUBLIC FUNCTIONS
+//============================================================================
+
+void PoolMon_init(uint32_t ticksPerSec) {
+    l_ticksPerSec = ticksPerSec;
+    l_tickCtr = 0U;
+}
+
+void PoolMon_register(void const * const poolSto, uint_fast32_t poolSize,
+                      uint_fast16_t evtSize)
+{
+    uint_fast16_t const nTot = (uint_fast16_t)(poolSize / evtSize);
+    Q_REQUIRE((l_nPools < POOL_MON_MAX_POOLS)
+              && ((l_nOwners + nTot) <= POOL_MON_MAX_BLOCKS));
+    
+    PoolMonPool * const p = &l_pool[l_nPools];
+    p->start = (uint8_t const *)poolSto;
+    p->end = p->start + (nTot * evtSize);
+    p->ownerBase = l_nOwners;
+    p->stats.blockSize = (uint16_t)evtSize;
+    p->stats.nTot = (uint16_t)nTot;
+    p->stats.nMin = (uint16_t)nTot;
+    
+    l_nOwners += (uint16_t)nTot;
+    ++l_nPools;
+}
+
+QEvt *PoolMon_new_(uint_fast16_t const evtSize, uint_fast16_t const margin,
+                   enum_t const sig)
+{
+    // Margin 0 returns NULL when empty instead of asserting inside QF
+    uint_fast16_t const m = (margin == QF_NO_MARGIN) ? 0U : margin;
+    
+    uint32_t const t0 = BSP_cycles();
+    QEvt * const e = QF_newX_(evtSize, m, sig);
+    uint32_t const cycles = BSP_cycles() - t0;
+    
+    PoolMonPool * const p = PoolMon_poolFor_(evtSize);
+    if (p != (PoolMonPool *)0) {
+        QF_INT_DISABLE();
+        if (cycles > p->stats.maxCycles) {
+            p->stats.maxCycles = cycles;
+        }
+        if (e != (QEvt *)0) {
+            ++p->stats.allocs;
+            ++p->winAllocs;
+            uint8_t const *blk = (uint8_t const *)e;
+            if ((blk >= p->start) && (blk < p->end)) {
+                l_owner[p->ownerBase
+                        + ((blk - p->start) / p->stats.blockSize)]
+                    = (QSignal)sig;
+            }
+        } else {
+            ++p->stats.failures;
+        }
+        QF_INT_ENABLE();
+        
+        if (e == (QEvt *)0) {
+            PoolMon_emitExhausted_(p, evtSize, sig);
+        }
+    }
+    
+    // Same contract as Q_NEW(): running out without a margin is fatal
+    Q_ASSERT_ID(10, (e != (QEvt *)0) || (margin != QF_NO_MARGIN));
+    
+    return e;
+}
+
+void PoolMon_tick(void) {
+    if (++l_tickCtr < l_ticksPerSec) {
+        return;
+    }
+    l_tickCtr = 0U;
+    
+    QF_INT_DISABLE();
+    for (uint_fast8_t i = 0U; i < l_nPools; ++i) {
+        PoolMonPool * const p = &l_pool[i];
+        if (p->winAllocs > p->stats.peakRate) {
+            p->stats.peakRate = p->winAllocs;
+        }
+        p->winAllocs = 0U;
+    }
+    QF_INT_ENABLE();
+}
+
+PoolMonStats const *PoolMon_getStats(uint_fast8_t poolId) {
+    if ((poolId == 0U) || (poolId > l_nPools)) {
+        return (PoolMonStats const *)0;
+    }
+    PoolMonPool * const p = &l_pool[poolId - 1U];
+    p->stats.nMin = (uint16_t)QF_getPoolMin(poolId);
+    return &p->stats;
+}
+
+void PoolMon_report(void) {
+    for (uint_fast8_t id = 1U; id <= l_nPools; ++id) {
+        PoolMonStats const * const s = PoolMon_getStats(id);
+        QS_BEGIN_ID(POOL_MON_QS_REC, 0U)
+            QS_2U8_((uint8_t)POOL_MON_QS_STATS, (uint8_t)id);
+            QS_U16_(s->blockSize);
+            QS_U16_(s->nTot);
+            QS_U16_(s->nMin);
+            QS_U32_(s->allocs);
+            QS_U32_(s->failures);
+            QS_U32_(s->peakRate);
+            QS_U32_(s->maxCycles);
+        QS_END_()
+    }
+}
+
+#endif // POOL_MON_ENABLE
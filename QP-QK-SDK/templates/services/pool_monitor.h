@@ -0,0 +1,143 @@
+/**
+ * @file pool_monitor.h
+ * @brief Event Pool Monitor (high-water mark, failures, allocation cost)
+ * @version 1.0.0
+ * @date 2026-10-14
+ * 
+ * Runtime instrumentation of the QF event pools: minimum free blocks,
+ * allocation failures, allocation rate and cost, and the signal that last
+ * allocated each block. Results are reported over QS and consumed by
+ * tools/analyzers/pool_sizer.py, which writes recommended pool sizes back
+ * into the project configuration header.
+ * 
+ * Allocate events with POOL_MON_NEW()/POOL_MON_NEW_X() instead of
+ * Q_NEW()/Q_NEW_X(); with POOL_MON_ENABLE undefined they are identical.
+ */
+
+#ifndef POOL_MONITOR_H
+#define POOL_MONITOR_H
+
+#include "qpc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//============================================================================
+// CONFIGURATION
+//============================================================================
+
+#ifndef POOL_MON_MAX_POOLS
+#define POOL_MON_MAX_POOLS      QF_MAX_EPOOL    // Pools that can be registered
+#endif
+
+#ifndef POOL_MON_MAX_BLOCKS
+#define POOL_MON_MAX_BLOCKS     64U     // Owner slots shared by all pools
+#endif
+
+// QS user record reserved for this service (see project_template.h)
+#define POOL_MON_QS_REC         (QS_USER + 23)
+
+// Sub-record types carried in the first byte of POOL_MON_QS_REC
+enum PoolMonQSType {
+    POOL_MON_QS_STATS = 1U,         /**< pool, blockSize, nTot, nMin, ... */
+    POOL_MON_QS_EXHAUSTED           /**< pool, sig, evtSize, owners[] */
+};
+
+//============================================================================
+// STATISTICS
+//============================================================================
+
+/**
+ * @brief Per-pool statistics
+ */
+typedef struct {
+    uint16_t blockSize;             /**< Block size in bytes */
+    uint16_t nTot;                  /**< Number of blocks */
+    uint16_t nMin;                  /**< Minimum free blocks ever (low-water) */
+    uint32_t allocs;                /**< Successful allocations */
+    uint32_t failures;              /**< Failed allocations (pool empty/margin) */
+    uint32_t peakRate;              /**< Highest allocations per second */
+    uint32_t maxCycles;             /**< Slowest QF_newX_() in CPU cycles */
+} PoolMonStats;
+
+//============================================================================
+// PUBLIC INTERFACE
+//============================================================================
+
+/**
+ * @brief Free-running 32-bit CPU cycle counter (provided by the BSP)
+ */
+uint32_t BSP_cycles(void);
+
+/**
+ * @brief Initialize the monitor
+ * 
+ * @param ticksPerSec Rate of PoolMon_tick() calls (BSP_TICKS_PER_SEC)
+ */
+void PoolMon_init(uint32_t ticksPerSec);
+
+/**
+ * @brief Register a pool for monitoring
+ * 
+ * Call right after the matching QF_poolInit(), in the same order, so the
+ * monitor pool IDs match the QF pool IDs (1-based).
+ */
+void PoolMon_register(void const * const poolSto, uint_fast32_t poolSize,
+                      uint_fast16_t evtSize);
+
+/**
+ * @brief Instrumented QF_newX_() (use through POOL_MON_NEW/POOL_MON_NEW_X)
+ * 
+ * Keeps QF semantics: with margin == QF_NO_MARGIN an empty pool is an
+ * assertion, but only after the exhaustion record has been emitted.
+ */
+QEvt *PoolMon_new_(uint_fast16_t const evtSize, uint_fast16_t const margin,
+                   enum_t const sig);
+
+/**
+ * @brief Advance the allocation rate window (call from the clock tick)
+ */
+void PoolMon_tick(void);
+
+/**
+ * @brief Statistics for one pool (poolId 1-based, NULL if not registered)
+ */
+PoolMonStats const *PoolMon_getStats(uint_fast8_t poolId);
+
+/**
+ * @brief Emit the statistics of all pools as QS records
+ */
+void PoolMon_report(void);
+
+//============================================================================
+// INTEGRATION MACROS
+//============================================================================
+
+#ifdef POOL_MON_ENABLE
+#define POOL_MON_INIT(ticksPerSec_)         PoolMon_init(ticksPerSec_)
+#define POOL_MON_REGISTER(sto_, size_, evtSize_) \
+    PoolMon_register((sto_), (size_), (evtSize_))
+#define POOL_MON_TICK()                     PoolMon_tick()
+#define POOL_MON_REPORT()                   PoolMon_report()
+#define POOL_MON_NEW(evtT_, sig_) \
+    ((evtT_ *)PoolMon_new_((uint_fast16_t)sizeof(evtT_), \
+                           QF_NO_MARGIN, (enum_t)(sig_)))
+#define POOL_MON_NEW_X(e_, evtT_, margin_, sig_) \
+    ((e_) = (evtT_ *)PoolMon_new_((uint_fast16_t)sizeof(evtT_), \
+                                  (margin_), (enum_t)(sig_)))
+#else
+#define POOL_MON_INIT(ticksPerSec_)         ((void)0)
+#define POOL_MON_REGISTER(sto_, size_, evtSize_) ((void)0)
+#define POOL_MON_TICK()                     ((void)0)
+#define POOL_MON_REPORT()                   ((void)0)
+#define POOL_MON_NEW(evtT_, sig_)           Q_NEW(evtT_, (sig_))
+#define POOL_MON_NEW_X(e_, evtT_, margin_, sig_) \
+    Q_NEW_X((e_), evtT_, (margin_), (sig_))
+#endif // POOL_MON_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POOL_MONITOR_H
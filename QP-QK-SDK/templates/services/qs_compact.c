@@ -0,0 +1,88 @@
+/**
+ * @file qs_compact.c
+ * @brief Compact QS Trace Mode (string dictionary, 16-bit time stamps)
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * Strings are keyed by address in a small open-addressing hash, so the
+ * per-call cost is a hash and usually one compare. QsCompact_str_() runs
+ * inside the QS record's critical section, which also protects the table.
+ */
+
+#include "qs_compact.h"
+
+#ifdef QS_COMPACT_ENABLE
+
+#if (QS_COMPACT_MAX_STRS > 127U)
+#error "QS_COMPACT_MAX_STRS must not exceed 127 (7-bit IDs)"
+#endif
+
+//============================================================================
+// LOCAL VARIABLES
+//============================================================================
+
+#define QS_COMPACT_HASH_SIZE    (2U * 128U)     // Power of 2, > 2 x max
+
+static char const *l_str[QS_COMPACT_MAX_STRS];  // Interned strings by ID
+static uint8_t l_hash[QS_COMPACT_HASH_SIZE];    // ID + 1, 0 = empty
+static uint_fast8_t l_nStr;
+static uint32_t l_syncCtr;
+
+//============================================================================
+// PUBLIC FUNCTIONS
+//============================================================================
+
+void QsCompact_init(void) {
+    QF_INT_DISABLE();
+    for (uint_fast16_t i = 0U; i < QS_COMPACT_HASH_SIZE; ++i) {
+        l_hash[i] = 0U;
+    }
+    l_nStr = 0U;
+    l_syncCtr = QS_COMPACT_SYNC_TICKS;
+    QF_INT_ENABLE();
+}
+
+void QsCompact_str_(char const * const str) {
+    uint_fast16_t h = ((uint_fast16_t)((uintptr_t)str >> 2))
+                      & (QS_COMPACT_HASH_SIZE - 1U);
+    while (l_hash[h] != 0U) {
+        uint_fast8_t const id = (uint_fast8_t)(l_hash[h] - 1U);
+        if (l_str[id] == str) {
+            QS_U8_((uint8_t)id);
+            return;
+        }
+        h = (h + 1U) & (QS_COMPACT_HASH_SIZE - 1U);
+    }
+
+    if (l_nStr < QS_COMPACT_MAX_STRS) {
+        // First occurrence: intern it and send the definition inline
+        uint_fast8_t const id = l_nStr++;
+        l_str[id] = str;
+        l_hash[h] = (uint8_t)(id + 1U);
+        QS_U8_((uint8_t)(QS_COMPACT_DEF_FLAG | id));
+    } else {
+        QS_U8_((uint8_t)QS_COMPACT_INLINE);
+    }
+    QS_STR_(str);
+}
+
+void QsCompact_tick(void) {
+    if (--l_syncCtr == 0U) {
+        l_syncCtr = QS_COMPACT_SYNC_TICKS;
+        QS_BEGIN_ID(QS_COMPACT_QS_REC, 0U)
+            QS_U8_((uint8_t)QS_COMPACT_QS_SYNC);
+            QS_U32_(BSP_getTimeUs());   // Not QS_onGetTime(): 16 bits
+        QS_END_()
+    }
+}
+
+void QsCompact_dump(void) {
+    for (uint_fast8_t id = 0U; id < l_nStr; ++id) {
+        QS_BEGIN_ID(QS_COMPACT_QS_REC, 0U)
+            QS_2U8_((uint8_t)QS_COMPACT_QS_STR_DEF, (uint8_t)id);
+            QS_STR_(l_str[id]);
+        QS_END_()
+    }
+}
+
+#endif // QS_COMPACT_ENABLE
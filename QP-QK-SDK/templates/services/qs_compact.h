@@ -0,0 +1,112 @@
+/**
+ * @file qs_compact.h
+ * @brief Compact QS Trace Mode (string dictionary, 16-bit time stamps)
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * Cuts QS bandwidth for string-heavy application records. Strings traced
+ * with QS_STR_ID_() are interned on first use and sent as a one-byte ID
+ * afterwards; the first occurrence carries the text, so the host builds
+ * the dictionary as it goes (QS-RX command 8 re-sends it). Record time
+ * stamps shrink to 16 bits (QS_TSTAMP_SIZE 2) and a periodic SYNC record
+ * with the full 32-bit microsecond time lets the host unroll them into
+ * absolute time.
+ * Decode with tools/analyzers/qs_decode.py.
+ */
+
+#ifndef QS_COMPACT_H
+#define QS_COMPACT_H
+
+#include "qpc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//============================================================================
+// CONFIGURATION
+//============================================================================
+
+#ifndef QS_COMPACT_MAX_STRS
+#define QS_COMPACT_MAX_STRS     64U     // Interned strings (max 127)
+#endif
+
+#ifndef QS_COMPACT_SYNC_TICKS
+#define QS_COMPACT_SYNC_TICKS   30U     // Clock ticks between SYNC records
+#endif
+
+#ifndef QS_COMPACT_QS_REC
+#define QS_COMPACT_QS_REC       (QS_USER + 18)  // QS user record ID
+#endif
+
+// Wire format of one QS_STR_ID_() field (first byte):
+//   0x00..0x7E  ID of a string already sent
+//   0x80 | ID   definition: ID followed by the zero-terminated string
+//   0xFF        not interned (table full): zero-terminated string follows
+#define QS_COMPACT_DEF_FLAG     0x80U
+#define QS_COMPACT_INLINE       0xFFU
+
+// Sub-types of QS_COMPACT_QS_REC (first payload byte)
+enum QsCompactQSType {
+    QS_COMPACT_QS_STR_DEF = 1U,     /**< id, string */
+    QS_COMPACT_QS_SYNC              /**< time U32 (BSP_getTimeUs()) */
+};
+
+//============================================================================
+// PUBLIC INTERFACE
+//============================================================================
+
+/**
+ * @brief Free-running microsecond time (provided by the BSP)
+ *
+ * SYNC carries it untruncated. QS_onGetTime() must return its low bits,
+ * so the 16-bit record stamps count in the same microseconds.
+ */
+uint32_t BSP_getTimeUs(void);
+
+/**
+ * @brief Clear the dictionary and start the SYNC countdown
+ */
+void QsCompact_init(void);
+
+/**
+ * @brief Output an interned string (use through QS_STR_ID_())
+ *
+ * Must be called inside a QS record, i.e. between QS_BEGIN_ID() and
+ * QS_END_(). Strings are identified by address, so pass string literals.
+ */
+void QsCompact_str_(char const * const str);
+
+/**
+ * @brief Advance the SYNC countdown by one clock tick (tick ISR)
+ */
+void QsCompact_tick(void);
+
+/**
+ * @brief Re-send every interned string as a STR_DEF record
+ *
+ * For hosts that attached after the first occurrences (QS-RX command 8).
+ */
+void QsCompact_dump(void);
+
+//============================================================================
+// INTEGRATION MACROS
+//============================================================================
+
+#ifdef QS_COMPACT_ENABLE
+#define QS_STR_ID_(str_)        QsCompact_str_(str_)
+#define QS_COMPACT_INIT()       QsCompact_init()
+#define QS_COMPACT_TICK()       QsCompact_tick()
+#define QS_COMPACT_DUMP()       QsCompact_dump()
+#else
+#define QS_STR_ID_(str_)        QS_STR_(str_)
+#define QS_COMPACT_INIT()       ((void)0)
+#define QS_COMPACT_TICK()       ((void)0)
+#define QS_COMPACT_DUMP()       ((void)0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // QS_COMPACT_H
@@ -0,0 +1,123 @@
+/**
+ * @file qs_dict.c
+ * @brief Const QS Dictionary Tables with Build-ID Hashes
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * The tables stay in ROM; only their addresses are kept here. The hash is
+ * recomputed on every send: it reads a few hundred bytes of flash and
+ * costs far less than one dictionary record on the UART.
+ */
+
+#include "qs_dict.h"
+
+#ifdef Q_SPY
+
+Q_DEFINE_THIS_MODULE("qs_dict")
+
+//============================================================================
+// LOCAL VARIABLES
+//============================================================================
+
+typedef struct {
+    QSDictEntry const *tbl;
+    uint16_t n;
+} QSDictTable;
+
+static QSDictTable l_tables[QS_DICT_MAX_TABLES];
+static uint_fast8_t l_nTables;
+
+#define QS_DICT_FNV_BASIS       2166136261U
+#define QS_DICT_FNV_PRIME       16777619U
+
+//============================================================================
+// LOCAL FUNCTIONS
+//============================================================================
+
+static uint32_t QSDict_fnv_(uint32_t h, uintptr_t v, uint_fast8_t nBytes) {
+    for (uint_fast8_t i = 0U; i < nBytes; ++i) {
+        h = (h ^ (uint32_t)(v & 0xFFU)) * QS_DICT_FNV_PRIME;
+        v >>= 8;
+    }
+    return h;
+}
+
+static void QSDict_emit_(QSDictEntry const * const tbl, uint_fast16_t const n) {
+#ifdef QS_DICT_ROM_ENABLE
+    QS_BEGIN_ID(QS_DICT_QS_REC, 0U)
+        QS_2U8_((uint8_t)QS_DICT_QS_TABLE, (uint8_t)sizeof(void const *));
+        QS_U16_((uint16_t)n);
+        QS_U32_(QSDict_hash(tbl, n));
+    QS_END_()
+#else
+    for (uint_fast16_t i = 0U; i < n; ++i) {
+        QSDictEntry const * const e = &tbl[i];
+        switch (e->kind) {
+            case QS_DICT_K_OBJ: {
+                QS_obj_dict_pre_(e->obj, e->name);
+                break;
+            }
+            case QS_DICT_K_SIG: {
+                QS_sig_dict_pre_((enum_t)e->id, e->obj, e->name);
+                break;
+            }
+            case QS_DICT_K_FUN: {
+                QS_fun_dict_pre_(e->fun, e->name);
+                break;
+            }
+            case QS_DICT_K_USR: {
+                QS_usr_dict_pre_((enum_t)e->id, e->name);
+                break;
+            }
+            default: {
+                Q_ERROR();
+                break;
+            }
+        }
+    }
+#endif // QS_DICT_ROM_ENABLE
+}
+
+//============================================================================
+// PUBLIC FUNCTIONS
+//============================================================================
+
+uint32_t QSDict_hash(QSDictEntry const * const tbl, uint_fast16_t const n) {
+    uint32_t h = QS_DICT_FNV_BASIS;
+    for (uint_fast16_t i = 0U; i < n; ++i) {
+        QSDictEntry const * const e = &tbl[i];
+        h = QSDict_fnv_(h, (uintptr_t)e->kind, 1U);
+        h = QSDict_fnv_(h, (uintptr_t)e->id, 2U);
+        h = QSDict_fnv_(h, (uintptr_t)e->obj, (uint_fast8_t)sizeof(void const *));
+        h = QSDict_fnv_(h, (uintptr_t)e->fun, (uint_fast8_t)sizeof(void const *));
+        char const *s = e->name;
+        do {
+            h = QSDict_fnv_(h, (uintptr_t)(uint8_t)*s, 1U);
+        } while (*s++ != '\0');
+    }
+    return h;
+}
+
+void QSDict_send(QSDictEntry const * const tbl, uint_fast16_t const n) {
+    Q_REQUIRE(n <= 0xFFFFU);
+
+    // Remember it once (modules may send again, e.g. on re-init)
+    uint_fast8_t t = 0U;
+    while ((t < l_nTables) && (l_tables[t].tbl != tbl)) {
+        ++t;
+    }
+    if ((t == l_nTables) && (l_nTables < QS_DICT_MAX_TABLES)) {
+        l_tables[t].tbl = tbl;
+        l_tables[t].n = (uint16_t)n;
+        ++l_nTables;
+    }
+    QSDict_emit_(tbl, n);
+}
+
+void QSDict_resend(void) {
+    for (uint_fast8_t t = 0U; t < l_nTables; ++t) {
+        QSDict_emit_(l_tables[t].tbl, l_tables[t].n);
+    }
+}
+
+#endif // Q_SPY
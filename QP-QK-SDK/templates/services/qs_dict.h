@@ -0,0 +1,137 @@
+/**
+ * @file qs_dict.h
+ * @brief Const QS Dictionary Tables with Build-ID Hashes
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * Replaces runs of QS_OBJ/SIG/FUN/USR_DICTIONARY() calls with one const
+ * table per module, kept in ROM. QSDict_send() either emits the table as
+ * the usual dictionary records (default, QSPY reads them as before) or,
+ * with QS_DICT_ROM_ENABLE, only one record with the number of entries and
+ * a hash of the table. The host then takes the names from the ELF, or
+ * from a sidecar file written from it (tools/analyzers/qs_dict.py), and
+ * the hash proves that the file belongs to the running firmware.
+ *
+ * The hash is FNV-1a over every entry: kind, id (2 bytes), object and
+ * function address (pointer size, little-endian) and the name with its
+ * terminating zero. It covers the linked addresses, so any rebuild that
+ * moves an object changes it.
+ */
+
+#ifndef QS_DICT_H
+#define QS_DICT_H
+
+#include "qpc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//============================================================================
+// CONFIGURATION
+//============================================================================
+
+#ifndef QS_DICT_MAX_TABLES
+#define QS_DICT_MAX_TABLES      16U     // Tables QSDict_resend() can repeat
+#endif
+
+// QS user record reserved for this service (see project_template.h)
+#define QS_DICT_QS_REC          (QS_USER + 15)
+
+// Sub-record types carried in the first byte of QS_DICT_QS_REC
+enum QSDictQSType {
+    QS_DICT_QS_TABLE = 1U       /**< pointer size, entries, hash */
+};
+
+/**
+ * @brief Kind of a dictionary entry
+ */
+enum QSDictKind {
+    QS_DICT_K_OBJ = 1U,         /**< QS_OBJ_DICTIONARY(obj) */
+    QS_DICT_K_SIG,              /**< QS_SIG_DICTIONARY(id, obj) */
+    QS_DICT_K_FUN,              /**< QS_FUN_DICTIONARY(fun) */
+    QS_DICT_K_USR               /**< QS_USR_DICTIONARY(id) */
+};
+
+//============================================================================
+// TYPES
+//============================================================================
+
+/**
+ * @brief One dictionary entry (layout read by qs_dict.py)
+ */
+typedef struct {
+    void const *obj;            /**< Object, or receiver of a signal (NULL = all) */
+    void (*fun)(void);          /**< State handler (FUN entries) */
+    char const *name;
+    uint16_t id;                /**< Signal or user record (SIG, USR entries) */
+    uint8_t kind;               /**< QSDictKind */
+} QSDictEntry;
+
+//============================================================================
+// PUBLIC INTERFACE
+//============================================================================
+
+/**
+ * @brief Hash of a dictionary table (its build ID)
+ */
+uint32_t QSDict_hash(QSDictEntry const * const tbl, uint_fast16_t const n);
+
+/**
+ * @brief Send a dictionary table and remember it for QSDict_resend()
+ *
+ * Call after QS_INIT(), where the QS_*_DICTIONARY() calls were.
+ */
+void QSDict_send(QSDictEntry const * const tbl, uint_fast16_t const n);
+
+/**
+ * @brief Send all tables again (e.g. after the host tool attached)
+ */
+void QSDict_resend(void);
+
+//============================================================================
+// TABLE MACROS
+//============================================================================
+// Tables are defined under #ifdef Q_SPY. The names are stringized as in
+// the QS_*_DICTIONARY() macros, so the host sees the same text:
+//
+//   #ifdef Q_SPY
+//   static QS_DICT_TABLE(Blinky) = {
+//       QS_DICT_OBJ(&AO_Blinky),
+//       QS_DICT_SIG(TIMEOUT_SIG, &AO_Blinky),
+//       QS_DICT_FUN(&Blinky_on),
+//   };
+//   #endif
+//   ...
+//   QS_DICT_SEND(Blinky);
+//
+// The symbol is <name>_qsDict, which qs_dict.py looks for in the ELF.
+
+#define QS_DICT_TABLE(name_)    QSDictEntry const name_##_qsDict[]
+#define QS_DICT_OBJ(obj_) \
+    { (void const *)(obj_), (void (*)(void))0, #obj_, 0U, (uint8_t)QS_DICT_K_OBJ }
+#define QS_DICT_SIG(sig_, obj_) \
+    { (void const *)(obj_), (void (*)(void))0, #sig_, (uint16_t)(sig_), (uint8_t)QS_DICT_K_SIG }
+#define QS_DICT_FUN(fun_) \
+    { (void const *)0, (void (*)(void))(fun_), #fun_, 0U, (uint8_t)QS_DICT_K_FUN }
+#define QS_DICT_USR(rec_) \
+    { (void const *)0, (void (*)(void))0, #rec_, (uint16_t)(rec_), (uint8_t)QS_DICT_K_USR }
+
+//============================================================================
+// INTEGRATION MACROS
+//============================================================================
+
+#ifdef Q_SPY
+#define QS_DICT_SEND(name_) \
+    QSDict_send(&name_##_qsDict[0], (uint_fast16_t)Q_DIM(name_##_qsDict))
+#define QS_DICT_RESEND()                    QSDict_resend()
+#else
+#define QS_DICT_SEND(name_)                 ((void)0)
+#define QS_DICT_RESEND()                    ((void)0)
+#endif // Q_SPY
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // QS_DICT_H
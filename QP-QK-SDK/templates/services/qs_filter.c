@@ -0,0 +1,302 @@
+/**
+ * @file qs_filter.c
+ * @brief Per-AO QS Filters with Trace Cost Accounting
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * Accounting model as in rtc_profiler.c: the QS buffer head and record
+ * sequence number at the last accounting point, charged to whichever
+ * context was running. Dispatch entry and exit are the accounting points;
+ * a preempting AO saves and restores the filter and context of the step
+ * it preempted, so nesting needs no QK_onContextSw() hook. The filters
+ * are only swapped while at least one context has its own.
+ *
+ * Shared data is accessed under QF_CRIT_ENTRY(), which also covers the
+ * ticker thread of the POSIX port. QS records are never emitted inside it.
+ */
+
+#include "qs_filter.h"
+#include "rtc_profiler.h"
+#include <string.h>
+
+#if defined(QS_FILT_ENABLE) && defined(Q_SPY)
+
+Q_DEFINE_THIS_MODULE("qs_filter")
+
+//============================================================================
+// LOCAL TYPES AND VARIABLES
+//============================================================================
+
+#define QS_FILT_GLB_SIZE        sizeof(QS_filt_.glb)
+#define QS_FILT_SVC_FIRST       (QS_USER + 15)  // First service record
+
+// Record count deltas wrap with the QS sequence number (see qs_filter.h)
+#define QS_FILT_SEQ_MASK \
+    ((uint32_t)((1ULL << (8U * sizeof(QS_priv_.seq))) - 1U))
+
+typedef struct {
+    QActiveVtable vtable;           /**< Copy of the AO vtable, dispatch wrapped */
+    QActiveVtable const *orig;      /**< Original vtable (NULL = not attached) */
+    uint8_t glb[QS_FILT_GLB_SIZE];  /**< Global filter during its steps */
+    uint16_t groups;                /**< QSFiltGroup mask or QS_FILT_GLOBAL */
+    uint32_t steps;
+    uint32_t records;
+    uint32_t bytes;
+} QSFiltAo;
+
+// Index 0 stands for the non-AO context (ISRs, idle, startup)
+static QSFiltAo l_ao[QS_FILT_MAX_PRIO + 1U];
+
+// QP record group of each QSFiltGroup bit
+static uint8_t const l_groupRec[] = {
+    (uint8_t)QS_SM_RECORDS, (uint8_t)QS_AO_RECORDS, (uint8_t)QS_EQ_RECORDS,
+    (uint8_t)QS_MP_RECORDS, (uint8_t)QS_TE_RECORDS, (uint8_t)QS_QF_RECORDS,
+    (uint8_t)QS_SC_RECORDS, (uint8_t)QS_U0_RECORDS, (uint8_t)QS_U1_RECORDS,
+    (uint8_t)QS_U2_RECORDS, (uint8_t)QS_U3_RECORDS, (uint8_t)QS_U4_RECORDS
+};
+
+static uint8_t l_base[QS_FILT_GLB_SIZE]; // Global filter at the first set
+static uint_fast8_t l_nCustom;      // Contexts with their own filter
+static uint_fast8_t l_curPrio;      // Context the QS output belongs to
+
+static QSCtr l_head;                // QS buffer head at the last accounting point
+static uint32_t l_seq;              // QS record sequence number there
+
+static uint32_t l_cyclesPerUs;
+static uint32_t l_startUs;          // BSP_getTimeUs() at QSFilt_reset()
+static uint16_t l_recCycles;        // Cost of one record...
+static uint16_t l_byteCycles16;     // ...plus per byte, in 1/16 cycles
+
+//============================================================================
+// LOCAL FUNCTIONS
+//============================================================================
+
+static QSCtr QSFilt_used_(QSCtr const from, QSCtr const to) {
+    return (to >= from) ? (QSCtr)(to - from) : (QSCtr)(QS_priv_.end - from + to);
+}
+
+static void QSFilt_charge_(void) {
+    QSCtr const head = QS_priv_.head;
+    uint32_t const seq = (uint32_t)QS_priv_.seq;
+    QSFiltAo * const a = &l_ao[l_curPrio];
+    a->bytes += QSFilt_used_(l_head, head);
+    a->records += (seq - l_seq) & QS_FILT_SEQ_MASK;
+    l_head = head;
+    l_seq = seq;
+}
+
+static inline void QSFilt_apply_(uint_fast8_t const prio) {
+    if (l_nCustom != 0U) {
+        memcpy(QS_filt_.glb, l_ao[prio].glb, QS_FILT_GLB_SIZE);
+    }
+}
+
+static void QSFilt_dispatch_(QHsm * const me, QEvt const * const e,
+                             uint_fast8_t const qs_id)
+{
+    uint_fast8_t const prio = ((QActive *)me)->prio;
+    QSFiltAo * const a = &l_ao[prio];
+
+    QF_CRIT_ENTRY(dummy);
+    QSFilt_charge_();
+    uint_fast8_t const prev = l_curPrio;
+    l_curPrio = prio;
+    ++a->steps;
+    QSFilt_apply_(prio);
+    QF_CRIT_EXIT(dummy);
+
+    (*a->orig->super.dispatch)(me, e, qs_id);
+
+    QF_CRIT_ENTRY(dummy);
+    QSFilt_charge_();
+    l_curPrio = prev;
+    QSFilt_apply_(prev);
+    QF_CRIT_EXIT(dummy);
+}
+
+// Filter image of a group mask, built with QS_GLB_FILTER() in the live
+// filter, which is restored (called in a critical section)
+static void QSFilt_build_(uint8_t * const img, uint16_t const groups) {
+    uint8_t live[QS_FILT_GLB_SIZE];
+    memcpy(live, QS_filt_.glb, sizeof(live));
+
+    QS_GLB_FILTER(-QS_ALL_RECORDS);
+    for (uint_fast8_t i = 0U; i < Q_DIM(l_groupRec); ++i) {
+        if ((groups & (1U << i)) != 0U) {
+            QS_GLB_FILTER(l_groupRec[i]);
+        }
+    }
+    memcpy(img, QS_filt_.glb, QS_FILT_GLB_SIZE);
+    memcpy(QS_filt_.glb, live, sizeof(live));
+
+    // Service records as in the base filter (command replies)
+    for (uint_fast16_t rec = QS_FILT_SVC_FIRST; rec < (8U * QS_FILT_GLB_SIZE); ++rec) {
+        uint8_t const bit = (uint8_t)(1U << (rec & 7U));
+        img[rec >> 3] = (uint8_t)((img[rec >> 3] & ~bit) | (l_base[rec >> 3] & bit));
+    }
+}
+
+static bool QSFilt_selected_(uint_fast8_t const p, uint_fast8_t const prio) {
+    if (p == 0U) {
+        return (prio == 0U) || (prio == QS_FILT_OTHER);
+    }
+    return (l_ao[p].orig != (QActiveVtable const *)0)
+           && ((prio == 0U) || (prio == p));
+}
+
+// Times records of two sizes into the QS buffer: the difference gives the
+// cost per byte, the rest of the short record the cost per record
+static void QSFilt_calibrate_(void) {
+    uint32_t cycles[2];
+    uint32_t bytes[2];
+
+    for (uint_fast8_t k = 0U; k < 2U; ++k) {
+        QSCtr const head = QS_priv_.head;
+        uint32_t const start = BSP_cycles();
+        for (uint_fast8_t i = 0U; i < QS_FILT_CAL_RECORDS; ++i) {
+            QS_BEGIN_ID(RTC_PROF_QS_REC, 0U)
+                QS_U8_((uint8_t)RTC_PROF_QS_TRACE_CAL);
+                if (k != 0U) {
+                    for (uint_fast8_t j = 0U; j < 8U; ++j) {
+                        QS_U32_(0U);
+                    }
+                }
+            QS_END_()
+        }
+        cycles[k] = BSP_cycles() - start;
+        bytes[k] = QSFilt_used_(head, QS_priv_.head);
+    }
+
+    l_recCycles = 0U;
+    l_byteCycles16 = 0U;
+    if ((bytes[1] > bytes[0]) && (cycles[1] > cycles[0])) {
+        uint32_t const perByte16 = ((cycles[1] - cycles[0]) * 16U)
+                                   / (bytes[1] - bytes[0]);
+        uint32_t const bytesCost = (bytes[0] * perByte16) / 16U;
+        uint32_t const perRec = (cycles[0] > bytesCost)
+                                ? ((cycles[0] - bytesCost) / QS_FILT_CAL_RECORDS)
+                                : 0U;
+        l_byteCycles16 = (uint16_t)((perByte16 < 0xFFFFU) ? perByte16 : 0xFFFFU);
+        l_recCycles = (uint16_t)((perRec < 0xFFFFU) ? perRec : 0xFFFFU);
+    }
+}
+
+//============================================================================
+// PUBLIC FUNCTIONS
+//============================================================================
+
+void QSFilt_init(uint32_t cyclesPerUs) {
+    l_cyclesPerUs = cyclesPerUs;
+    l_nCustom = 0U;
+    l_curPrio = 0U;
+    for (uint_fast8_t p = 0U; p <= QS_FILT_MAX_PRIO; ++p) {
+        l_ao[p].groups = QS_FILT_GLOBAL;
+    }
+    QSFilt_calibrate_();
+    QSFilt_reset();
+}
+
+void QSFilt_attach(QActive * const ao) {
+    uint_fast8_t const prio = ao->prio;
+    Q_REQUIRE((prio != 0U) && (prio <= QS_FILT_MAX_PRIO)
+              && (l_ao[prio].orig == (QActiveVtable const *)0));
+
+    QSFiltAo * const a = &l_ao[prio];
+    a->orig = (QActiveVtable const *)ao->super.vptr;
+    a->vtable = *a->orig;
+    a->vtable.super.dispatch = &QSFilt_dispatch_;
+    memcpy(a->glb, (l_nCustom != 0U) ? l_base : QS_filt_.glb, QS_FILT_GLB_SIZE);
+
+    ao->super.vptr = &a->vtable.super;
+}
+
+void QSFilt_set(uint_fast8_t const prio, uint16_t const groups,
+                uint_fast8_t const op)
+{
+    QF_CRIT_ENTRY(dummy);
+    if (l_nCustom == 0U) {
+        // Nothing swapped yet: the live filter is what the others follow
+        memcpy(l_base, QS_filt_.glb, QS_FILT_GLB_SIZE);
+    }
+
+    l_nCustom = 0U;
+    for (uint_fast8_t p = 0U; p <= QS_FILT_MAX_PRIO; ++p) {
+        QSFiltAo * const a = &l_ao[p];
+        if (QSFilt_selected_(p, prio)) {
+            uint16_t g = (a->groups == QS_FILT_GLOBAL) ? QS_FILT_ALL : a->groups;
+            if (op == QS_FILT_OP_SET) {
+                g = groups;
+            } else if (op == QS_FILT_OP_ADD) {
+                g |= groups;
+            } else if (op == QS_FILT_OP_REMOVE) {
+                g &= (uint16_t)~groups;
+            } else {
+                g = a->groups;              // Unknown op: keep it
+            }
+            a->groups = (g == QS_FILT_GLOBAL) ? g : (uint16_t)(g & QS_FILT_ALL);
+        }
+        if (a->groups == QS_FILT_GLOBAL) {
+            memcpy(a->glb, l_base, QS_FILT_GLB_SIZE);
+        } else {
+            QSFilt_build_(a->glb, a->groups);
+            ++l_nCustom;
+        }
+    }
+
+    if (l_nCustom != 0U) {
+        QSFilt_apply_(l_curPrio);
+    } else {
+        memcpy(QS_filt_.glb, l_base, QS_FILT_GLB_SIZE);
+    }
+    QF_CRIT_EXIT(dummy);
+}
+
+void QSFilt_report(uint_fast8_t const prio) {
+    for (uint_fast8_t p = 0U; p <= QS_FILT_MAX_PRIO; ++p) {
+        if ((p != 0U) && (l_ao[p].orig == (QActiveVtable const *)0)) {
+            continue;
+        }
+        if ((prio != 0U) && (p != ((prio == QS_FILT_OTHER) ? 0U : prio))) {
+            continue;
+        }
+
+        QF_CRIT_ENTRY(dummy);
+        QSFilt_charge_();
+        QSFiltAo const a = l_ao[p];
+        uint32_t const windowUs = BSP_getTimeUs() - l_startUs;
+        QF_CRIT_EXIT(dummy);
+
+        uint64_t cycles = ((uint64_t)a.records * l_recCycles)
+                          + (((uint64_t)a.bytes * l_byteCycles16) / 16U);
+        if (cycles > 0xFFFFFFFFU) {
+            cycles = 0xFFFFFFFFU;
+        }
+
+        QS_BEGIN_ID(RTC_PROF_QS_REC, p)
+            QS_2U8_((uint8_t)RTC_PROF_QS_TRACE, (uint8_t)p);
+            QS_U16_(a.groups);
+            QS_U32_(a.steps);
+            QS_U32_(a.records);
+            QS_U32_(a.bytes);
+            QS_U32_((uint32_t)cycles);
+            QS_U32_(windowUs);
+            QS_U16_((uint16_t)l_cyclesPerUs);
+            QS_U16_(l_recCycles);
+            QS_U16_(l_byteCycles16);
+        QS_END_()
+    }
+}
+
+void QSFilt_reset(void) {
+    QF_CRIT_ENTRY(dummy);
+    QSFilt_charge_();
+    for (uint_fast8_t p = 0U; p <= QS_FILT_MAX_PRIO; ++p) {
+        l_ao[p].steps = 0U;
+        l_ao[p].records = 0U;
+        l_ao[p].bytes = 0U;
+    }
+    l_startUs = BSP_getTimeUs();
+    QF_CRIT_EXIT(dummy);
+}
+
+#endif // QS_FILT_ENABLE && Q_SPY
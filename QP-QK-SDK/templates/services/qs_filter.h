@@ -0,0 +1,164 @@
+/**
+ * @file qs_filter.h
+ * @brief Per-AO QS Filters with Trace Cost Accounting
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * The QS global filter decides per record type, for the whole system, and
+ * the local filter per QS-ID with no regard to the record type. This
+ * service gives every attached AO its own global filter instead: the
+ * dispatch() entry of its virtual table is wrapped (as in rtc_profiler.h)
+ * and swaps the filter for the RTC step, so the records of one AO can be
+ * traced in full while the others send nothing or only a few groups.
+ * The filters are set from QS-RX commands at run time.
+ *
+ * The same wrapper counts the records and bytes each AO puts into the QS
+ * buffer, and QSFilt_init() times QS records of two sizes to turn them
+ * into CPU cycles. A report thus shows what tracing costs per AO, in
+ * cycles and in link bandwidth, before and after a filter change.
+ *
+ * Records emitted outside an AO step (ISRs, idle, startup) use the filter
+ * of the non-AO context (QS_FILT_OTHER); ISRs that preempt a step use the
+ * filter of that AO and are charged to it. The service records (QS_USER +
+ * 15 and up) keep the setting they had when the first filter was set, so
+ * command replies always get through.
+ *
+ * Records are counted from the QS sequence number (QS_priv_.seq, 8 bits
+ * in QP/C 7.2) at every step boundary, so one accounting interval (an RTC
+ * step, or the non-AO time between two steps) must put fewer than 256
+ * records into the buffer; more are undercounted by a multiple of 256.
+ */
+
+#ifndef QS_FILTER_H
+#define QS_FILTER_H
+
+#include "qpc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//============================================================================
+// CONFIGURATION
+//============================================================================
+
+#ifndef QS_FILT_MAX_PRIO
+#define QS_FILT_MAX_PRIO        QF_MAX_ACTIVE   // Highest attachable AO prio
+#endif
+
+#ifndef QS_FILT_CAL_RECORDS
+#define QS_FILT_CAL_RECORDS     8U      // Records of each size timed at init
+#endif
+
+#define QS_FILT_OTHER           0xFFU   // "prio" of the non-AO context
+#define QS_FILT_GLOBAL          0xFFFFU // Groups: follow the global filter
+
+/**
+ * @brief Record groups (bits of a group mask)
+ */
+enum QSFiltGroup {
+    QS_FILT_SM = (1U << 0),     /**< QS_SM_RECORDS: state machine */
+    QS_FILT_AO = (1U << 1),     /**< QS_AO_RECORDS: AO posts, queues */
+    QS_FILT_EQ = (1U << 2),     /**< QS_EQ_RECORDS: raw queues */
+    QS_FILT_MP = (1U << 3),     /**< QS_MP_RECORDS: memory pools */
+    QS_FILT_TE = (1U << 4),     /**< QS_TE_RECORDS: time events */
+    QS_FILT_QF = (1U << 5),     /**< QS_QF_RECORDS: QF (new, publish, gc) */
+    QS_FILT_SC = (1U << 6),     /**< QS_SC_RECORDS: scheduler */
+    QS_FILT_U0 = (1U << 7),     /**< QS_U0_RECORDS .. QS_U4_RECORDS */
+    QS_FILT_U1 = (1U << 8),
+    QS_FILT_U2 = (1U << 9),
+    QS_FILT_U3 = (1U << 10),
+    QS_FILT_U4 = (1U << 11),
+    QS_FILT_ALL = 0x0FFFU
+};
+
+/**
+ * @brief How QSFilt_set() combines the groups with the current ones
+ */
+enum QSFiltOp {
+    QS_FILT_OP_SET = 0U,
+    QS_FILT_OP_ADD,
+    QS_FILT_OP_REMOVE
+};
+
+//============================================================================
+// PUBLIC INTERFACE
+//============================================================================
+
+/**
+ * @brief Free-running 32-bit CPU cycle counter (provided by the BSP)
+ */
+uint32_t BSP_cycles(void);
+
+/**
+ * @brief Free-running microsecond time (provided by the BSP)
+ */
+uint32_t BSP_getTimeUs(void);
+
+/**
+ * @brief Initialize the service and time the QS record cost
+ *
+ * Call after QS_INIT() and the QS_GLB_FILTER() setup. Emits
+ * 2 * QS_FILT_CAL_RECORDS short CAL records (RTC_PROF_QS_REC) to time.
+ *
+ * @param cyclesPerUs CPU cycles per microsecond (BSP_SYSTEM_CLOCK_HZ / 1e6)
+ */
+void QSFilt_init(uint32_t cyclesPerUs);
+
+/**
+ * @brief Give an Active Object its own filter and cost accounting
+ *
+ * Must be called after QACTIVE_START(), once the AO priority is known.
+ * The AO follows the global filter until QSFilt_set() selects it.
+ */
+void QSFilt_attach(QActive * const ao);
+
+/**
+ * @brief Select the record groups of an AO
+ *
+ * Requests for AOs that are not attached are ignored.
+ *
+ * @param prio   AO priority, QS_FILT_OTHER, or 0 for all of them
+ * @param groups QSFiltGroup mask, or QS_FILT_GLOBAL to follow the global
+ *               filter again (with QS_FILT_OP_SET)
+ * @param op     QSFiltOp
+ */
+void QSFilt_set(uint_fast8_t const prio, uint16_t const groups,
+                uint_fast8_t const op);
+
+/**
+ * @brief Emit the groups and the trace cost as QS records
+ *
+ * @param prio AO priority to report, or 0 for all AOs and QS_FILT_OTHER
+ */
+void QSFilt_report(uint_fast8_t const prio);
+
+/**
+ * @brief Clear the counters (start a new window, filters are kept)
+ */
+void QSFilt_reset(void);
+
+//============================================================================
+// INTEGRATION MACROS
+//============================================================================
+
+#if defined(QS_FILT_ENABLE) && defined(Q_SPY)
+#define QS_FILT_INIT(cyclesPerUs_)          QSFilt_init(cyclesPerUs_)
+#define QS_FILT_ATTACH(ao_)                 QSFilt_attach(ao_)
+#define QS_FILT_SET(prio_, groups_, op_) \
+    QSFilt_set((uint_fast8_t)(prio_), (uint16_t)(groups_), (uint_fast8_t)(op_))
+#define QS_FILT_REPORT(prio_)               QSFilt_report((uint_fast8_t)(prio_))
+#define QS_FILT_RESET()                     QSFilt_reset()
+#else
+#define QS_FILT_INIT(cyclesPerUs_)          ((void)0)
+#define QS_FILT_ATTACH(ao_)                 ((void)0)
+#define QS_FILT_SET(prio_, groups_, op_)    ((void)0)
+#define QS_FILT_REPORT(prio_)               ((void)0)
+#define QS_FILT_RESET()                     ((void)0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // QS_FILTER_H
@@ -0,0 +1,230 @@
+/**
+ * @file queue_monitor.c
+ * @brief Active Object Event Queue Monitor with Back-Pressure
+ * @version 1.0.0
+ * @date 2026-10-14
+ * 
+ * The high-water mark comes from QF itself (eQueue.nMin). Arrivals are
+ * counted in the wrapped post(); the overload flag is raised there, on the
+ * post that crosses the high threshold, and released from QueueMon_tick()
+ * once the AO has drained its queue below the low threshold.
+ */
+
+#include "queue_monitor.h"
+
+#ifdef QUEUE_MON_ENABLE
+
+Q_DEFINE_THIS_MODULE("queue_monitor")
+
+//============================================================================
+// LOCAL TYPES AND VARIABLES
+//============================================================================
+
+#define QUEUE_MON_NO_SLOT   0xFFU
+
+typedef struct {
+    QActiveVtable vtable;           /**< Copy of the AO vtable, post wrapped */
+    QActiveVtable const *orig;      /**< Original vtable */
+    QActive *ao;
+    uint16_t high;                  /**< Overload threshold (queue depth) */
+    uint16_t low;                   /**< Overload release (queue depth) */
+    bool volatile overloaded;
+    uint16_t win[QUEUE_MON_MAX_SIG]; /**< Arrivals in the current second */
+    QueueMonStats stats;
+} QueueMonAo;
+
+static QueueMonAo l_ao[QUEUE_MON_MAX_AO];
+static uint_fast8_t l_nAo;
+static uint8_t l_slotOf[QF_MAX_ACTIVE + 1U];
+
+static uint32_t l_ticksPerSec;
+static uint32_t l_tickCtr;
+
+//============================================================================
+// LOCAL FUNCTIONS
+//============================================================================
+
+static inline uint_fast16_t QueueMon_depth_(QueueMonAo const * const q) {
+    return (uint_fast16_t)(q->stats.capacity - q->ao->eQueue.nFree);
+}
+
+static QueueMonAo *QueueMon_slot_(QActive const * const ao) {
+    uint8_t const slot = l_slotOf[ao->prio];
+    return (slot != QUEUE_MON_NO_SLOT) ? &l_ao[slot] : (QueueMonAo *)0;
+}
+
+static bool QueueMon_post_(QActive * const me, QEvt const * const e,
+                           uint_fast16_t const margin,
+                           void const * const sender)
+{
+    QueueMonAo * const q = &l_ao[l_slotOf[me->prio]];
+    QSignal const sig = e->sig;     // e may be recycled if the post fails
+    
+    bool const posted = (*q->orig->post)(me, e, margin, sender);
+    if (!posted) {
+        return false;
+    }
+    
+    QF_INT_DISABLE();
+    ++q->stats.posts;
+    if (sig < QUEUE_MON_MAX_SIG) {
+        ++q->win[sig];
+    }
+    uint_fast16_t const depth = QueueMon_depth_(q);
+    bool const entering = (!q->overloaded) && (depth >= q->high);
+    if (entering) {
+        q->overloaded = true;
+        ++q->stats.overloads;
+    }
+    QF_INT_ENABLE();
+    
+    if (entering) {
+        QS_BEGIN_ID(QUEUE_MON_QS_REC, me->prio)
+            QS_2U8_((uint8_t)QUEUE_MON_QS_OVERLOAD, (uint8_t)me->prio);
+            QS_U16_((uint16_t)depth);
+            QS_U16_(sig);
+        QS_END_()
+    }
+    return true;
+}
+
+//============================================================================
+// PUBLIC FUNCTIONS
+//============================================================================
+
+void QueueMon_init(uint32_t ticksPerSec) {
+    l_ticksPerSec = ticksPerSec;
+    l_tickCtr = 0U;
+    for (uint_fast8_t p = 0U; p < Q_DIM(l_slotOf); ++p) {
+        l_slotOf[p] = QUEUE_MON_NO_SLOT;
+    }
+}
+
+void QueueMon_attach(QActive * const ao, uint_fast8_t highPct,
+                     uint_fast8_t lowPct)
+{
+    Q_REQUIRE((l_nAo < QUEUE_MON_MAX_AO)
+              && (ao->prio <= QF_MAX_ACTIVE)
+              && (l_slotOf[ao->prio] == QUEUE_MON_NO_SLOT)
+              && (lowPct < highPct) && (highPct <= 100U));
+    
+    QueueMonAo * const q = &l_ao[l_nAo];
+    q->ao = ao;
+    q->stats.capacity = (uint16_t)(ao->eQueue.end + 1U); // +1 front event
+    q->high = (uint16_t)((q->stats.capacity * highPct) / 100U);
+    q->low = (uint16_t)((q->stats.capacity * lowPct) / 100U);
+    if (q->high == 0U) {
+        q->high = 1U;
+    }
+    
+    q->orig = (QActiveVtable const *)ao->super.vptr;
+    q->vtable = *q->orig;
+    q->vtable.post = &QueueMon_post_;
+    
+    // Slot must be valid before the first wrapped post() can happen
+    l_slotOf[ao->prio] = (uint8_t)l_nAo;
+    ++l_nAo;
+    ao->super.vptr = &q->vtable.super;
+}
+
+bool QueueMon_isOverloaded(QActive const * const ao) {
+    if (ao != (QActive const *)0) {
+        QueueMonAo const * const q = QueueMon_slot_(ao);
+        return (q != (QueueMonAo const *)0) && q->overloaded;
+    }
+    for (uint_fast8_t i = 0U; i < l_nAo; ++i) {
+        if (l_ao[i].overloaded) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool QueueMon_postLossy(QActive * const ao, QEvt const * const e,
+                        void const * const sender)
+{
+    QueueMonAo * const q = QueueMon_slot_(ao);
+    
+    // Margin 1U: QF recycles the event instead of asserting when full
+    bool const posted = ((q == (QueueMonAo *)0) || !q->overloaded)
+                        && QACTIVE_POST_X(ao, e, 1U, sender);
+    if (!posted && (q != (QueueMonAo *)0)) {
+        QF_INT_DISABLE();
+        ++q->stats.drops;
+        QF_INT_ENABLE();
+        if (q->overloaded) {
+            QF_gc(e);   // Not handed to QF, recycle here
+        }
+    }
+    return posted;
+}
+
+void QueueMon_tick(void) {
+    bool const closeWindow = (++l_tickCtr >= l_ticksPerSec);
+    if (closeWindow) {
+        l_tickCtr = 0U;
+    }
+    
+    QF_INT_DISABLE();
+    for (uint_fast8_t i = 0U; i < l_nAo; ++i) {
+        QueueMonAo * const q = &l_ao[i];
+        if (q->overloaded && (QueueMon_depth_(q) <= q->low)) {
+            q->overloaded = false;
+        }
+        if (closeWindow) {
+            for (uint_fast16_t sig = 0U; sig < QUEUE_MON_MAX_SIG; ++sig) {
+                q->stats.rate[sig] = q->win[sig];
+                if (q->win[sig] > q->stats.peakRate[sig]) {
+                    q->stats.peakRate[sig] = q->win[sig];
+                }
+                q->win[sig] = 0U;
+            }
+        }
+    }
+    QF_INT_ENABLE();
+}
+
+QueueMonStats const *QueueMon_getStats(uint_fast8_t prio) {
+    if ((prio > QF_MAX_ACTIVE) || (l_slotOf[prio] == QUEUE_MON_NO_SLOT)) {
+        return (QueueMonStats const *)0;
+    }
+    QueueMonAo * const q = &l_ao[l_slotOf[prio]];
+    q->stats.hwm = (uint16_t)(q->stats.capacity - q->ao->eQueue.nMin);
+    return &q->stats;
+}
+
+void QueueMon_report(uint_fast8_t prio) {
+    for (uint_fast8_t i = 0U; i < l_nAo; ++i) {
+        QueueMonAo const * const q = &l_ao[i];
+        uint_fast8_t const p = q->ao->prio;
+        if ((prio != 0U) && (p != prio)) {
+            continue;
+        }
+        QueueMonStats const * const s = QueueMon_getStats(p);
+        
+        QS_BEGIN_ID(QUEUE_MON_QS_REC, p)
+            QS_2U8_((uint8_t)QUEUE_MON_QS_STATS, (uint8_t)p);
+            QS_U16_(s->capacity);
+            QS_U16_((uint16_t)QueueMon_depth_(q));
+            QS_U16_(s->hwm);
+            QS_U32_(s->posts);
+            QS_U32_(s->overloads);
+            QS_U32_(s->drops);
+            QS_U8_((uint8_t)(q->overloaded ? 1U : 0U));
+        QS_END_()
+        
+        for (uint_fast16_t sig = 0U; sig < QUEUE_MON_MAX_SIG; ++sig) {
+            if (s->peakRate[sig] == 0U) {
+                continue;
+            }
+            QS_BEGIN_ID(QUEUE_MON_QS_REC, p)
+                QS_2U8_((uint8_t)QUEUE_MON_QS_SIG_RATE, (uint8_t)p);
+                QS_U16_((uint16_t)sig);
+                QS_U16_(s->rate[sig]);
+                QS_U16_(s->peakRate[sig]);
+            QS_END_()
+        }
+    }
+}
+
+#endif // QUEUE_MON_ENABLE
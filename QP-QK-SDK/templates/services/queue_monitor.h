@@ -0,0 +1,158 @@
+/**
+ * @file queue_monitor.h
+ * @brief Active Object Event Queue Monitor with Back-Pressure
+ * @version 1.0.0
+ * @date 2026-10-14
+ * 
+ * Per-AO queue depth, high-water mark and per-signal arrival rates, plus
+ * an overload flag with hysteresis that producers (ISRs, other AOs) can
+ * check to coalesce or drop low-value events before the queue overflows
+ * and QF asserts.
+ * 
+ * The monitor wraps the post() entry of each attached AO's virtual table,
+ * so it sees every QACTIVE_POST()/QACTIVE_PUBLISH() delivery.
+ */
+
+#ifndef QUEUE_MONITOR_H
+#define QUEUE_MONITOR_H
+
+#include "qpc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//============================================================================
+// CONFIGURATION
+//============================================================================
+
+#ifndef QUEUE_MON_MAX_AO
+#define QUEUE_MON_MAX_AO        4U      // Number of AOs that can be attached
+#endif
+
+#ifndef QUEUE_MON_MAX_SIG
+#define QUEUE_MON_MAX_SIG       32U     // Signals >= this are not rate-tracked
+#endif
+
+#ifndef QUEUE_MON_HIGH_PCT
+#define QUEUE_MON_HIGH_PCT      75U     // Default overload threshold (% full)
+#endif
+
+#ifndef QUEUE_MON_LOW_PCT
+#define QUEUE_MON_LOW_PCT       50U     // Default overload release (% full)
+#endif
+
+// QS user record reserved for this service (see project_template.h)
+#define QUEUE_MON_QS_REC        (QS_USER + 22)
+
+// Sub-record types carried in the first byte of QUEUE_MON_QS_REC
+enum QueueMonQSType {
+    QUEUE_MON_QS_OVERLOAD = 1U,     /**< prio, depth, sig (on entering) */
+    QUEUE_MON_QS_STATS,             /**< prio, capacity, depth, hwm, ... */
+    QUEUE_MON_QS_SIG_RATE           /**< prio, sig, rate, peakRate */
+};
+
+//============================================================================
+// STATISTICS
+//============================================================================
+
+/**
+ * @brief Per-AO queue statistics
+ */
+typedef struct {
+    uint16_t capacity;              /**< Queue length incl. the front event */
+    uint16_t hwm;                   /**< Deepest queue ever (from QF nMin) */
+    uint32_t posts;                 /**< Events delivered to this AO */
+    uint32_t overloads;             /**< Times the high threshold was crossed */
+    uint32_t drops;                 /**< Events dropped by QueueMon_postLossy() */
+    uint16_t rate[QUEUE_MON_MAX_SIG];     /**< Arrivals in the last second */
+    uint16_t peakRate[QUEUE_MON_MAX_SIG]; /**< Highest arrivals per second */
+} QueueMonStats;
+
+//============================================================================
+// PUBLIC INTERFACE
+//============================================================================
+
+/**
+ * @brief Initialize the monitor
+ * 
+ * @param ticksPerSec Rate of QueueMon_tick() calls (BSP_TICKS_PER_SEC)
+ */
+void QueueMon_init(uint32_t ticksPerSec);
+
+/**
+ * @brief Start monitoring an Active Object's event queue
+ * 
+ * Must be called after QACTIVE_START(), once the queue is initialized.
+ * 
+ * @param ao      Active Object to monitor
+ * @param highPct Queue fill (%) at which the AO becomes overloaded
+ * @param lowPct  Queue fill (%) at which the overload is released
+ */
+void QueueMon_attach(QActive * const ao, uint_fast8_t highPct,
+                     uint_fast8_t lowPct);
+
+/**
+ * @brief Back-pressure signal for producers
+ * 
+ * Safe to call from ISRs. Returns false for AOs that are not attached.
+ * 
+ * @param ao Active Object to check, or NULL for any attached AO
+ */
+bool QueueMon_isOverloaded(QActive const * const ao);
+
+/**
+ * @brief Post a low-value event, dropping it while the AO is overloaded
+ * 
+ * Never asserts: a dropped event is counted and garbage-collected.
+ * 
+ * @return true if the event was posted
+ */
+bool QueueMon_postLossy(QActive * const ao, QEvt const * const e,
+                        void const * const sender);
+
+/**
+ * @brief Sample queue depths and close the rate window (call from tick)
+ */
+void QueueMon_tick(void);
+
+/**
+ * @brief Statistics for one AO priority (NULL if not attached)
+ */
+QueueMonStats const *QueueMon_getStats(uint_fast8_t prio);
+
+/**
+ * @brief Emit statistics as QS records
+ * 
+ * @param prio AO priority to report, or 0 for all attached AOs
+ */
+void QueueMon_report(uint_fast8_t prio);
+
+//============================================================================
+// INTEGRATION MACROS
+//============================================================================
+
+#ifdef QUEUE_MON_ENABLE
+#define QUEUE_MON_INIT(ticksPerSec_)        QueueMon_init(ticksPerSec_)
+#define QUEUE_MON_ATTACH(ao_) \
+    QueueMon_attach((ao_), QUEUE_MON_HIGH_PCT, QUEUE_MON_LOW_PCT)
+#define QUEUE_MON_TICK()                    QueueMon_tick()
+#define QUEUE_MON_REPORT(prio_)             QueueMon_report(prio_)
+#define QUEUE_MON_OVERLOADED(ao_)           QueueMon_isOverloaded(ao_)
+#define QUEUE_MON_POST_LOSSY(ao_, e_, sender_) \
+    ((void)QueueMon_postLossy((ao_), (e_), (sender_)))
+#else
+#define QUEUE_MON_INIT(ticksPerSec_)        ((void)0)
+#define QUEUE_MON_ATTACH(ao_)               ((void)0)
+#define QUEUE_MON_TICK()                    ((void)0)
+#define QUEUE_MON_REPORT(prio_)             ((void)0)
+#define QUEUE_MON_OVERLOADED(ao_)           false
+#define QUEUE_MON_POST_LOSSY(ao_, e_, sender_) \
+    ((void)QACTIVE_POST_X((ao_), (e_), 1U, (sender_)))
+#endif // QUEUE_MON_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // QUEUE_MONITOR_H
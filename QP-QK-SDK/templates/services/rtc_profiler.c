@@ -0,0 +1,205 @@
+/**
+ * @file rtc_profiler.c
+ * @brief Run-to-Completion (RTC) Profiler for QK Active Objects
+ * @version 1.0.0
+ * @date 2026-10-14
+ * 
+ * Accounting model: a single timestamp marks the last accounting point and
+ * the elapsed cycles are charged to whichever priority was running. Dispatch
+ * entry/exit (via the wrapped virtual table) and QK context switches are the
+ * only accounting points, so each RTC step gets exactly its own cycles.
+ */
+
+#include "rtc_profiler.h"
+#include <string.h>
+
+#ifdef RTC_PROF_ENABLE
+
+Q_DEFINE_THIS_MODULE("rtc_profiler")
+
+//============================================================================
+// LOCAL TYPES AND VARIABLES
+//============================================================================
+
+typedef struct {
+    QActiveVtable vtable;           /**< Copy of the AO vtable, dispatch wrapped */
+    QActiveVtable const *orig;      /**< Original vtable (NULL = not attached) */
+    uint32_t net;                   /**< Cycles charged to the current RTC step */
+    RtcProfStats stats;
+} RtcProfAo;
+
+// Index 0 stands for idle/ISR level (no AO running)
+static RtcProfAo l_ao[RTC_PROF_MAX_PRIO + 1U];
+static RtcProfStats l_sig[RTC_PROF_MAX_SIG];
+
+static uint32_t l_cyclesPerUs;
+static uint32_t l_stamp;            // Cycle count at the last accounting point
+static uint_fast8_t l_curPrio;      // Priority the elapsed cycles belong to
+
+//============================================================================
+// LOCAL FUNCTIONS
+//============================================================================
+
+static inline void RtcProf_charge_(uint32_t now) {
+    l_ao[l_curPrio].net += now - l_stamp;
+    l_stamp = now;
+}
+
+static void RtcProf_record_(RtcProfStats * const s, uint32_t cycles) {
+    uint32_t bin = 31U - (uint32_t)__builtin_clz(cycles | 1U);
+    bin = (bin > RTC_PROF_HIST_SHIFT) ? (bin - RTC_PROF_HIST_SHIFT) : 0U;
+    if (bin >= RTC_PROF_HIST_BINS) {
+        bin = RTC_PROF_HIST_BINS - 1U;
+    }
+    if (s->hist[bin] != 0xFFFFU) {
+        ++s->hist[bin];
+    }
+    
+    if ((s->count == 0U) || (cycles < s->min)) {
+        s->min = cycles;
+    }
+    if (cycles > s->max) {
+        s->max = cycles;
+    }
+    s->sum += cycles;
+    ++s->count;
+}
+
+static void RtcProf_dispatch_(QHsm * const me, QEvt const * const e,
+                              uint_fast8_t const qs_id)
+{
+    uint_fast8_t const prio = ((QActive *)me)->prio;
+    QSignal const sig = e->sig;
+    RtcProfAo * const ao = &l_ao[prio];
+    
+    // Dispatch entry: close the previous interval, open this RTC step
+    QF_INT_DISABLE();
+    RtcProf_charge_(BSP_cycles());
+    ao->net = 0U;
+    l_curPrio = prio;
+    QF_INT_ENABLE();
+    
+    (*ao->orig->super.dispatch)(me, e, qs_id);
+    
+    // Dispatch exit: everything charged to this prio since entry is ours
+    QF_INT_DISABLE();
+    RtcProf_charge_(BSP_cycles());
+    uint32_t const cycles = ao->net;
+    RtcProf_record_(&ao->stats, cycles);
+    if (sig < RTC_PROF_MAX_SIG) {
+        RtcProf_record_(&l_sig[sig], cycles);
+    }
+    bool const violated = (ao->stats.budget != 0U)
+                          && (cycles > ao->stats.budget);
+    if (violated) {
+        ++ao->stats.violations;
+    }
+    QF_INT_ENABLE();
+    
+    if (violated) {
+        QS_BEGIN_ID(RTC_PROF_QS_REC, prio)
+            QS_2U8_((uint8_t)RTC_PROF_QS_VIOLATION, (uint8_t)prio);
+            QS_U16_(sig);
+            QS_U32_(cycles);
+            QS_U32_(ao->stats.budget);
+        QS_END_()
+    }
+}
+
+static uint32_t RtcProf_mean_(RtcProfStats const * const s) {
+    return (s->count != 0U) ? (uint32_t)(s->sum / s->count) : 0U;
+}
+
+//============================================================================
+// PUBLIC FUNCTIONS
+//============================================================================
+
+void RtcProf_init(uint32_t cyclesPerUs) {
+    l_cyclesPerUs = cyclesPerUs;
+    l_curPrio = 0U;
+    l_stamp = BSP_cycles();
+}
+
+void RtcProf_attach(QActive * const ao, uint32_t budgetUs) {
+    uint_fast8_t const prio = ao->prio;
+    Q_REQUIRE((prio != 0U) && (prio <= RTC_PROF_MAX_PRIO)
+              && (l_ao[prio].orig == (QActiveVtable const *)0));
+    
+    RtcProfAo * const p = &l_ao[prio];
+    p->orig = (QActiveVtable const *)ao->super.vptr;
+    p->vtable = *p->orig;
+    p->vtable.super.dispatch = &RtcProf_dispatch_;
+    p->stats.budget = budgetUs * l_cyclesPerUs;
+    
+    ao->super.vptr = &p->vtable.super;
+}
+
+void RtcProf_onContextSw(QActive const * const prev,
+                         QActive const * const next)
+{
+    (void)prev;
+    // Already inside the QK critical section
+    RtcProf_charge_(BSP_cycles());
+    l_curPrio = (next != (QActive const *)0) ? next->prio : 0U;
+}
+
+RtcProfStats const *RtcProf_getAoStats(uint_fast8_t prio) {
+    return ((prio <= RTC_PROF_MAX_PRIO)
+            && (l_ao[prio].orig != (QActiveVtable const *)0))
+           ? &l_ao[prio].stats
+           : (RtcProfStats const *)0;
+}
+
+RtcProfStats const *RtcProf_getSigStats(QSignal sig) {
+    return (sig < RTC_PROF_MAX_SIG) ? &l_sig[sig] : (RtcProfStats const *)0;
+}
+
+void RtcProf_report(uint_fast8_t prio) {
+    for (uint_fast8_t p = 1U; p <= RTC_PROF_MAX_PRIO; ++p) {
+        RtcProfStats const *s = RtcProf_getAoStats(p);
+        if ((s == (RtcProfStats const *)0) || ((prio != 0U) && (p != prio))) {
+            continue;
+        }
+        QS_BEGIN_ID(RTC_PROF_QS_REC, p)
+            QS_2U8_((uint8_t)RTC_PROF_QS_AO_STATS, (uint8_t)p);
+            QS_U32_(s->count);
+            QS_U32_(s->min);
+            QS_U32_(s->max);
+            QS_U32_(RtcProf_mean_(s));
+            QS_U32_(s->violations);
+            for (uint_fast8_t b = 0U; b < RTC_PROF_HIST_BINS; ++b) {
+                QS_U16_(s->hist[b]);
+            }
+        QS_END_()
+    }
+    
+    if (prio == 0U) {
+        for (QSignal sig = 0U; sig < RTC_PROF_MAX_SIG; ++sig) {
+            RtcProfStats const *s = &l_sig[sig];
+            if (s->count == 0U) {
+                continue;
+            }
+            QS_BEGIN_ID(RTC_PROF_QS_REC, 0U)
+                QS_U8_((uint8_t)RTC_PROF_QS_SIG_STATS);
+                QS_U16_(sig);
+                QS_U32_(s->count);
+                QS_U32_(s->min);
+                QS_U32_(s->max);
+                QS_U32_(RtcProf_mean_(s));
+            QS_END_()
+        }
+    }
+}
+
+void RtcProf_reset(void) {
+    QF_INT_DISABLE();
+    for (uint_fast8_t p = 0U; p <= RTC_PROF_MAX_PRIO; ++p) {
+        uint32_t const budget = l_ao[p].stats.budget;
+        memset(&l_ao[p].stats, 0, sizeof(l_ao[p].stats));
+        l_ao[p].stats.budget = budget;
+    }
+    memset(l_sig, 0, sizeof(l_sig));
+    QF_INT_ENABLE();
+}
+
+#endif // RTC_PROF_ENABLE
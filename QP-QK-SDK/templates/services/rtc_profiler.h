@@ -0,0 +1,153 @@
+/**
+ * @file rtc_profiler.h
+ * @brief Run-to-Completion (RTC) Profiler for QK Active Objects
+ * @version 1.0.0
+ * @date 2026-10-14
+ * 
+ * Cycle-accurate measurement of every RTC step (one event dispatch) per
+ * Active Object and per signal, with budget enforcement against each AO's
+ * MAX_RTC_TIME_US. Time spent in higher-priority AOs that preempt a step is
+ * excluded via QK_onContextSw(); time spent in ISRs is included.
+ * 
+ * The profiler wraps the dispatch() entry of each attached AO's virtual
+ * table, so application state handlers need no changes.
+ */
+
+#ifndef RTC_PROFILER_H
+#define RTC_PROFILER_H
+
+#include "qpc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//============================================================================
+// CONFIGURATION
+//============================================================================
+
+#ifndef RTC_PROF_MAX_PRIO
+#define RTC_PROF_MAX_PRIO       QF_MAX_ACTIVE   // Highest profiled AO prio
+#endif
+
+#ifndef RTC_PROF_MAX_SIG
+#define RTC_PROF_MAX_SIG        32U     // Signals >= this are not tracked
+#endif
+
+#ifndef RTC_PROF_HIST_BINS
+#define RTC_PROF_HIST_BINS      16U     // log2 histogram bins
+#endif
+
+#ifndef RTC_PROF_HIST_SHIFT
+#define RTC_PROF_HIST_SHIFT     6U      // Bin 0 holds RTC steps < 2^(6+1) cycles
+#endif
+
+// QS user record reserved for this service (see project_template.h)
+#define RTC_PROF_QS_REC         (QS_USER + 24)
+
+// Sub-record types carried in the first byte of RTC_PROF_QS_REC
+enum RtcProfQSType {
+    RTC_PROF_QS_VIOLATION = 1U,     /**< prio, sig, cycles, budget */
+    RTC_PROF_QS_AO_STATS,           /**< prio, count, min, max, mean, viol, hist */
+    RTC_PROF_QS_SIG_STATS,          /**< sig, count, min, max, mean */
+    RTC_PROF_QS_CHUNK,              /**< prio, sig, chunk sizes (work_chunk.h) */
+    RTC_PROF_QS_TRACE,              /**< prio, groups, trace cost (qs_filter.h) */
+    RTC_PROF_QS_TRACE_CAL           /**< Timing filler of QSFilt_init() */
+};
+
+//============================================================================
+// STATISTICS
+//============================================================================
+
+/**
+ * @brief RTC statistics, in CPU cycles
+ */
+typedef struct {
+    uint32_t count;                 /**< Number of RTC steps measured */
+    uint32_t min;                   /**< Shortest RTC step */
+    uint32_t max;                   /**< Longest RTC step */
+    uint64_t sum;                   /**< Sum of all RTC steps (for mean) */
+    uint32_t budget;                /**< Budget in cycles (0 = none) */
+    uint32_t violations;            /**< RTC steps longer than budget */
+    uint16_t hist[RTC_PROF_HIST_BINS]; /**< Saturating log2 histogram */
+} RtcProfStats;
+
+//============================================================================
+// PUBLIC INTERFACE
+//============================================================================
+
+/**
+ * @brief Free-running 32-bit CPU cycle counter (provided by the BSP)
+ */
+uint32_t BSP_cycles(void);
+
+/**
+ * @brief Initialize the profiler
+ * 
+ * @param cyclesPerUs CPU cycles per microsecond (BSP_SYSTEM_CLOCK_HZ / 1e6)
+ */
+void RtcProf_init(uint32_t cyclesPerUs);
+
+/**
+ * @brief Start profiling an Active Object
+ * 
+ * Must be called after QACTIVE_START(), once the AO priority is known.
+ * 
+ * @param ao       Active Object to profile
+ * @param budgetUs Maximum RTC time in microseconds (0 = no budget)
+ */
+void RtcProf_attach(QActive * const ao, uint32_t budgetUs);
+
+/**
+ * @brief Account for a QK context switch (call from QK_onContextSw())
+ * 
+ * Called with interrupts disabled. Either pointer may be NULL (idle).
+ */
+void RtcProf_onContextSw(QActive const * const prev,
+                         QActive const * const next);
+
+/**
+ * @brief Statistics for one Active Object priority (NULL if not attached)
+ */
+RtcProfStats const *RtcProf_getAoStats(uint_fast8_t prio);
+
+/**
+ * @brief Statistics for one signal across all profiled AOs
+ */
+RtcProfStats const *RtcProf_getSigStats(QSignal sig);
+
+/**
+ * @brief Emit statistics as QS records
+ * 
+ * @param prio AO priority to report, or 0 for all AOs and all signals
+ */
+void RtcProf_report(uint_fast8_t prio);
+
+/**
+ * @brief Clear all statistics (budgets are kept)
+ */
+void RtcProf_reset(void);
+
+//============================================================================
+// INTEGRATION MACROS
+//============================================================================
+
+#ifdef RTC_PROF_ENABLE
+#define RTC_PROF_INIT(cyclesPerUs_)         RtcProf_init(cyclesPerUs_)
+#define RTC_PROF_ATTACH(ao_, budgetUs_)     RtcProf_attach((ao_), (budgetUs_))
+#define RTC_PROF_CONTEXT_SW(prev_, next_)   RtcProf_onContextSw((prev_), (next_))
+#define RTC_PROF_REPORT(prio_)              RtcProf_report(prio_)
+#define RTC_PROF_RESET()                    RtcProf_reset()
+#else
+#define RTC_PROF_INIT(cyclesPerUs_)         ((void)0)
+#define RTC_PROF_ATTACH(ao_, budgetUs_)     ((void)0)
+#define RTC_PROF_CONTEXT_SW(prev_, next_)   ((void)0)
+#define RTC_PROF_REPORT(prio_)              ((void)0)
+#define RTC_PROF_RESET()                    ((void)0)
+#endif // RTC_PROF_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RTC_PROFILER_H
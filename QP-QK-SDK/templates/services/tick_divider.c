@@ -0,0 +1,183 @@
+/**
+ * @file tick_divider.c
+ * @brief Decimating Tick Dispatcher
+ * @version 1.0.0
+ * @date 2026-10-14
+ * 
+ * Schedule table: subscriptions are kept sorted by period, so each
+ * distinct period is a contiguous group with its own countdown. The ISR
+ * only decrements l_countdown (ticks until the nearest group is due); when
+ * it expires, the elapsed span is charged to every group, the due groups
+ * are posted and the countdown is reloaded with the next nearest group.
+ */
+
+#include "tick_divider.h"
+#include "queue_monitor.h"
+
+Q_DEFINE_THIS_MODULE("tick_divider")
+
+//============================================================================
+// LOCAL TYPES AND VARIABLES
+//============================================================================
+
+typedef struct {
+    QActive *ao;
+    uint32_t period;
+} TickDivSub;
+
+typedef struct {
+    uint32_t period;                /**< Period in clock ticks */
+    uint32_t left;                  /**< Ticks left at the start of l_span */
+    uint8_t first;                  /**< First subscriber in l_sub[] */
+    uint8_t count;                  /**< Number of subscribers */
+} TickDivGroup;
+
+static TickDivSub l_sub[TICK_DIV_MAX_SUBS];     // Sorted by period
+static uint_fast8_t l_nSub;
+
+static TickDivGroup l_grp[TICK_DIV_MAX_RATES];
+static uint_fast8_t l_nGrp;
+
+static QEvt l_tickEvt;              // Static event, shared by all posts
+static uint32_t l_span;             // Length of the current countdown
+static uint32_t l_countdown;        // Ticks until the nearest group (0 = none)
+static uint32_t l_missed;
+
+//============================================================================
+// LOCAL FUNCTIONS
+//============================================================================
+
+// Charge the ticks elapsed in the current span, so 'left' is exact (crit.)
+static void TickDiv_sync_(void) {
+    uint32_t const elapsed = l_span - l_countdown;
+    for (uint_fast8_t i = 0U; i < l_nGrp; ++i) {
+        l_grp[i].left -= elapsed;
+    }
+    l_span = l_countdown;
+}
+
+// Regroup the sorted subscriptions, keeping the phase of existing periods
+static void TickDiv_rebuild_(void) {
+    TickDivGroup old[TICK_DIV_MAX_RATES];
+    uint_fast8_t const nOld = l_nGrp;
+    for (uint_fast8_t i = 0U; i < nOld; ++i) {
+        old[i] = l_grp[i];
+    }
+    
+    l_nGrp = 0U;
+    for (uint_fast8_t s = 0U; s < l_nSub; ++s) {
+        if ((l_nGrp != 0U) && (l_grp[l_nGrp - 1U].period == l_sub[s].period)) {
+            ++l_grp[l_nGrp - 1U].count;
+            continue;
+        }
+        Q_ASSERT(l_nGrp < TICK_DIV_MAX_RATES);
+        TickDivGroup * const g = &l_grp[l_nGrp];
+        g->period = l_sub[s].period;
+        g->left = l_sub[s].period;
+        g->first = (uint8_t)s;
+        g->count = 1U;
+        for (uint_fast8_t i = 0U; i < nOld; ++i) {
+            if (old[i].period == g->period) {
+                g->left = old[i].left;
+            }
+        }
+        ++l_nGrp;
+    }
+    
+    uint32_t next = 0U;
+    for (uint_fast8_t i = 0U; i < l_nGrp; ++i) {
+        if ((next == 0U) || (l_grp[i].left < next)) {
+            next = l_grp[i].left;
+        }
+    }
+    l_span = next;
+    l_countdown = next;
+}
+
+//============================================================================
+// PUBLIC FUNCTIONS
+//============================================================================
+
+void TickDiv_init(enum_t const sig) {
+    l_tickEvt.sig = (QSignal)sig;   // poolId_ == 0: static, never recycled
+    l_nSub = 0U;
+    l_nGrp = 0U;
+    l_span = 0U;
+    l_countdown = 0U;
+    l_missed = 0U;
+    
+    QS_OBJ_DICTIONARY(&l_tickEvt);
+}
+
+void TickDiv_subscribe(QActive * const ao, uint32_t periodTicks) {
+    Q_REQUIRE((periodTicks != 0U) && (l_nSub < TICK_DIV_MAX_SUBS));
+    
+    QF_INT_DISABLE();
+    TickDiv_sync_();
+    
+    // Insertion sort keeps equal periods contiguous
+    uint_fast8_t s = l_nSub;
+    while ((s > 0U) && (l_sub[s - 1U].period > periodTicks)) {
+        l_sub[s] = l_sub[s - 1U];
+        --s;
+    }
+    l_sub[s].ao = ao;
+    l_sub[s].period = periodTicks;
+    ++l_nSub;
+    
+    TickDiv_rebuild_();
+    QF_INT_ENABLE();
+}
+
+void TickDiv_unsubscribe(QActive const * const ao) {
+    QF_INT_DISABLE();
+    TickDiv_sync_();
+    
+    uint_fast8_t n = 0U;
+    for (uint_fast8_t s = 0U; s < l_nSub; ++s) {
+        if (l_sub[s].ao != ao) {
+            l_sub[n] = l_sub[s];
+            ++n;
+        }
+    }
+    l_nSub = n;
+    
+    TickDiv_rebuild_();
+    QF_INT_ENABLE();
+}
+
+void TickDiv_tick(void const * const sender) {
+    // Fast path: nothing due (or no subscribers)
+    if ((l_countdown == 0U) || (--l_countdown != 0U)) {
+        return;
+    }
+    
+    uint32_t next = 0U;
+    for (uint_fast8_t i = 0U; i < l_nGrp; ++i) {
+        TickDivGroup * const g = &l_grp[i];
+        g->left -= l_span;
+        if (g->left == 0U) {
+            g->left = g->period;
+            for (uint_fast8_t s = g->first; s < (g->first + g->count); ++s) {
+                if (QUEUE_MON_OVERLOADED(l_sub[s].ao)
+                    || !QACTIVE_POST_X(l_sub[s].ao, &l_tickEvt,
+                                       TICK_DIV_MARGIN, sender)) {
+                    ++l_missed;
+                }
+            }
+        }
+        if ((next == 0U) || (g->left < next)) {
+            next = g->left;
+        }
+    }
+    l_span = next;
+    l_countdown = next;
+}
+
+uint32_t TickDiv_nextDue(void) {
+    return l_countdown;
+}
+
+uint32_t TickDiv_getMissed(void) {
+    return l_missed;
+}
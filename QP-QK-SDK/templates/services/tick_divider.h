@@ -0,0 +1,97 @@
+/**
+ * @file tick_divider.h
+ * @brief Decimating Tick Dispatcher
+ * @version 1.0.0
+ * @date 2026-10-14
+ * 
+ * Replaces the per-tick QACTIVE_PUBLISH(TICK_SIG) fan-out. Each AO
+ * subscribes with the tick period it needs and the clock tick ISR posts
+ * the tick event only to the AOs whose period has elapsed. Subscribers
+ * are grouped by period and the ISR keeps a single countdown to the next
+ * due group, so a tick with nothing due costs one decrement.
+ */
+
+#ifndef TICK_DIVIDER_H
+#define TICK_DIVIDER_H
+
+#include "qpc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//============================================================================
+// CONFIGURATION
+//============================================================================
+
+#ifndef TICK_DIV_MAX_SUBS
+#define TICK_DIV_MAX_SUBS       8U      // Total tick subscriptions
+#endif
+
+#ifndef TICK_DIV_MAX_RATES
+#define TICK_DIV_MAX_RATES      4U      // Distinct tick periods
+#endif
+
+#ifndef TICK_DIV_MARGIN
+#define TICK_DIV_MARGIN         1U      // Free queue slots kept for others
+#endif
+
+//============================================================================
+// PUBLIC INTERFACE
+//============================================================================
+
+/**
+ * @brief Initialize the divider
+ * 
+ * @param sig Signal of the tick event posted to subscribers (TICK_SIG)
+ */
+void TickDiv_init(enum_t const sig);
+
+/**
+ * @brief Receive the tick event every periodTicks clock ticks
+ * 
+ * Replaces QActive_subscribe(me, TICK_SIG). Safe to call at any time.
+ * Subscribers with the same period share one phase: joining an existing
+ * period group, the first tick arrives with the group's, 1..periodTicks
+ * after subscribing. Only the first subscriber of a period waits the full
+ * periodTicks.
+ * 
+ * @param ao          Subscribing Active Object
+ * @param periodTicks Period in clock ticks (BSP_TICKS_PER_SEC / rate_Hz)
+ */
+void TickDiv_subscribe(QActive * const ao, uint32_t periodTicks);
+
+/**
+ * @brief Stop receiving the tick event
+ */
+void TickDiv_unsubscribe(QActive const * const ao);
+
+/**
+ * @brief Advance the divider by one clock tick (call from the tick ISR)
+ * 
+ * Ticks are coalescible: a tick that would leave a subscriber with fewer
+ * than TICK_DIV_MARGIN free queue slots, or that is due while the queue
+ * monitor reports the subscriber overloaded, is dropped and counted
+ * instead of overflowing the queue.
+ * 
+ * @param sender Sender for QS (the ISR), unused without Q_SPY
+ */
+void TickDiv_tick(void const * const sender);
+
+/**
+ * @brief Clock ticks until the next post (0 = no subscribers)
+ * 
+ * Used by tickless idle to bound the sleep. Call with interrupts disabled.
+ */
+uint32_t TickDiv_nextDue(void);
+
+/**
+ * @brief Number of tick events dropped because a queue was nearly full
+ */
+uint32_t TickDiv_getMissed(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TICK_DIVIDER_H
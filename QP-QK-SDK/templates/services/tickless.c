@@ -0,0 +1,69 @@
+/**
+ * @file tickless.c
+ * @brief Tickless Idle for QK
+ * @version 1.0.0
+ * @date 2026-10-14
+ * 
+ * The nearest timeout is the smallest down-counter of the armed time
+ * events. QF keeps them in two lists per tick rate: the main list, and
+ * the 'act' list of events armed since the last tick, which the next tick
+ * merges into the main list before counting down.
+ */
+
+#include "tickless.h"
+#include "tick_divider.h"
+#include "time_wheel.h"
+
+#ifdef TICKLESS_IDLE_ENABLE
+
+//============================================================================
+// LOCAL FUNCTIONS
+//============================================================================
+
+static uint32_t Tickless_listMin_(QTimeEvt const *t, uint32_t n) {
+    for (; t != (QTimeEvt const *)0; t = t->next) {
+        // ctr == 0: disarmed, waiting for the next tick to unlink it
+        if ((t->ctr != 0U) && (t->ctr < n)) {
+            n = t->ctr;
+        }
+    }
+    return n;
+}
+
+//============================================================================
+// PUBLIC FUNCTIONS
+//============================================================================
+
+uint32_t Tickless_nextEvent(void) {
+    QTimeEvt const * const head = &QTimeEvt_timeEvtHead_[0];
+    
+    uint32_t n = Tickless_listMin_(head->next, TICKLESS_FOREVER);
+    n = Tickless_listMin_((QTimeEvt const *)head->act, n);
+    
+    uint32_t const div = TickDiv_nextDue();
+    if ((div != 0U) && (div < n)) {
+        n = div;
+    }
+
+#ifdef TIME_WHEEL_ENABLE
+    uint32_t const wheel = TimeWheel_nextDue();
+    if (wheel < n) {
+        n = wheel;
+    }
+#endif
+    return n;
+}
+
+void Tickless_idle(void) {
+    QF_INT_DISABLE();
+    uint32_t n = Tickless_nextEvent();
+    if (n > TICKLESS_MAX_TICKS) {
+        n = TICKLESS_MAX_TICKS;
+    }
+    if (n < TICKLESS_MIN_TICKS) {
+        n = 1U;     // BSP just waits for the next tick
+    }
+    BSP_ticklessSleep(n);
+}
+
+#endif // TICKLESS_IDLE_ENABLE
@@ -0,0 +1,92 @@
+/**
+ * @file tickless.h
+ * @brief Tickless Idle for QK
+ * @version 1.0.0
+ * @date 2026-10-14
+ * 
+ * When QK goes idle, finds the nearest armed QTimeEvt (and the next tick
+ * divider post) and asks the BSP to sleep until then with a single long
+ * clock tick period instead of waking up on every tick. On wakeup the BSP
+ * reports how many ticks the period covered and the clock tick ISR runs
+ * the QF time processing once per covered tick, so time events, the tick
+ * divider and BSP_getTime() stay exact and monotonic. BSP_getTimeUs()
+ * runs on its own timer and is not affected.
+ */
+
+#ifndef TICKLESS_H
+#define TICKLESS_H
+
+#include "qpc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//============================================================================
+// CONFIGURATION
+//============================================================================
+
+#ifndef TICKLESS_MIN_TICKS
+#define TICKLESS_MIN_TICKS      2U      // Shorter idle periods just WFI
+#endif
+
+#ifndef TICKLESS_MAX_TICKS
+#define TICKLESS_MAX_TICKS      0xFFFFFFFFU // Cap (e.g. watchdog refresh)
+#endif
+
+#define TICKLESS_FOREVER        0xFFFFFFFFU // Nothing armed
+
+//============================================================================
+// BSP INTERFACE
+//============================================================================
+
+/**
+ * @brief Switch the clock tick to a source that allows long periods
+ * 
+ * Called once from QF_onStartup(), after the tick has been configured.
+ */
+void BSP_ticklessInit(void);
+
+/**
+ * @brief Sleep for up to nTicks clock ticks
+ * 
+ * Called with interrupts disabled, returns with interrupts enabled. The
+ * BSP may sleep shorter (timer range, early wakeup by another interrupt);
+ * the covered ticks are reported to the tick ISR by BSP_tickAdvance().
+ */
+void BSP_ticklessSleep(uint32_t nTicks);
+
+//============================================================================
+// PUBLIC INTERFACE
+//============================================================================
+
+/**
+ * @brief Clock ticks until the nearest QF timeout (TICKLESS_FOREVER = none)
+ * 
+ * Covers tick rate 0 time events, the time wheel (time_wheel.h) and the
+ * tick divider. Call with interrupts disabled.
+ */
+uint32_t Tickless_nextEvent(void);
+
+/**
+ * @brief Sleep until the nearest timeout (call from QK_onIdle() or QV_onIdle())
+ */
+void Tickless_idle(void);
+
+//============================================================================
+// INTEGRATION MACROS
+//============================================================================
+
+#ifdef TICKLESS_IDLE_ENABLE
+#define TICKLESS_INIT()                     BSP_ticklessInit()
+#define TICKLESS_IDLE()                     Tickless_idle()
+#else
+#define TICKLESS_INIT()                     ((void)0)
+#define TICKLESS_IDLE()                     ((void)0)
+#endif // TICKLESS_IDLE_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TICKLESS_H
@@ -0,0 +1,380 @@
+/**
+ * @file time_wheel.c
+ * @brief Hierarchical Timing Wheel for Time Events
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * An event due in d ticks (d > 0) goes to the lowest level n with
+ * d < 32^(n+1), in the slot of bits 5n..5n+4 of its expiry tick. Every
+ * slot is a doubly linked list (pprev points at the link to the event),
+ * so both arm and disarm are a few stores. When the tick count crosses a
+ * multiple of 32^n, the level n slot of the new count holds the events due
+ * within the next 32^n ticks: they are filed again from their exact
+ * expiry, which puts them on a lower level (or in the level 0 slot being
+ * posted). Events beyond the range of the wheel wait in the top level and
+ * are filed again each time their slot comes round.
+ *
+ * The slots being moved down or posted are first spliced onto a private
+ * list under one critical section. Each event is then taken off it in its
+ * own critical section, so a disarm from a higher-priority ISR or AO
+ * still finds its event, and posting happens outside the critical
+ * section as QF does for QTimeEvt.
+ */
+
+#include "time_wheel.h"
+
+#ifdef TIME_WHEEL_ENABLE
+
+#ifdef TIME_WHEEL_BENCH_ENABLE
+#include "bench_stats.h"
+#endif
+
+Q_DEFINE_THIS_MODULE("time_wheel")
+
+Q_ASSERT_STATIC((TIME_WHEEL_LEVELS >= 2U) && (TIME_WHEEL_LEVELS <= 6U));
+
+//============================================================================
+// LOCAL TYPES AND VARIABLES
+//============================================================================
+
+#define TIME_WHEEL_MASK         (TIME_WHEEL_SLOTS - 1U)
+
+typedef struct {
+    TimeWheelEvt *slot[TIME_WHEEL_LEVELS * TIME_WHEEL_SLOTS];
+    uint32_t busy[TIME_WHEEL_LEVELS];   /**< Non-empty slots of each level */
+    TimeWheelEvt *work;                 /**< Events being moved or posted */
+    uint32_t now;                       /**< Ticks processed */
+    uint32_t moved;                     /**< Events filed again (cascades) */
+} TimeWheel;
+
+static TimeWheel l_wheel;
+
+//============================================================================
+// LOCAL FUNCTIONS
+//============================================================================
+
+// Link an event under its expiry (crit.)
+static void TimeWheel_insert_(TimeWheelEvt * const e) {
+    uint32_t delta = e->expiry - l_wheel.now;
+    uint32_t when = e->expiry;
+    uint_fast8_t level = 0U;
+    while ((level < (TIME_WHEEL_LEVELS - 1U))
+           && (delta >= (1UL << (TIME_WHEEL_SLOT_BITS * (level + 1U)))))
+    {
+        ++level;
+    }
+    if ((level == (TIME_WHEEL_LEVELS - 1U))
+        && (delta >= (1UL << (TIME_WHEEL_SLOT_BITS * TIME_WHEEL_LEVELS))))
+    {
+        // Out of range: park in the top level slot that comes round last
+        delta = (1UL << (TIME_WHEEL_SLOT_BITS * TIME_WHEEL_LEVELS)) - 1U;
+        when = l_wheel.now + delta;
+    }
+
+    uint_fast8_t const s = (uint_fast8_t)
+        ((when >> (TIME_WHEEL_SLOT_BITS * level)) & TIME_WHEEL_MASK);
+    uint_fast8_t const idx = (level * TIME_WHEEL_SLOTS) + s;
+    TimeWheelEvt ** const head = &l_wheel.slot[idx];
+
+    e->next = *head;
+    if (e->next != (TimeWheelEvt *)0) {
+        e->next->pprev = &e->next;
+    }
+    e->pprev = head;
+    *head = e;
+    e->slot = (uint8_t)idx;
+    l_wheel.busy[level] |= (1UL << s);
+}
+
+// Unlink an armed event (crit.)
+static void TimeWheel_unlink_(TimeWheelEvt * const e) {
+    *e->pprev = e->next;
+    if (e->next != (TimeWheelEvt *)0) {
+        e->next->pprev = e->pprev;
+    }
+    e->pprev = (TimeWheelEvt **)0;
+
+    // Still right if the slot was spliced onto the work list meanwhile
+    uint_fast8_t const idx = e->slot;
+    if (l_wheel.slot[idx] == (TimeWheelEvt *)0) {
+        l_wheel.busy[idx / TIME_WHEEL_SLOTS] &=
+            ~(1UL << (idx % TIME_WHEEL_SLOTS));
+    }
+}
+
+// Move a slot onto the work list (crit.)
+static void TimeWheel_splice_(uint_fast8_t const level, uint_fast8_t const s) {
+    uint_fast8_t const idx = (level * TIME_WHEEL_SLOTS) + s;
+    Q_ASSERT(l_wheel.work == (TimeWheelEvt *)0);
+    l_wheel.work = l_wheel.slot[idx];
+    if (l_wheel.work != (TimeWheelEvt *)0) {
+        l_wheel.work->pprev = &l_wheel.work;
+    }
+    l_wheel.slot[idx] = (TimeWheelEvt *)0;
+    l_wheel.busy[level] &= ~(1UL << s);
+}
+
+// Advance the wheel by one tick and post what expires
+static void TimeWheel_advance_(void const * const sender) {
+    QF_CRIT_ENTRY(dummy);
+    uint32_t const now = l_wheel.now + 1U;
+    l_wheel.now = now;
+
+    // Crossing a multiple of 32^n: move that level n slot down
+    for (uint_fast8_t level = 1U; level < TIME_WHEEL_LEVELS; ++level) {
+        uint_fast8_t const shift = TIME_WHEEL_SLOT_BITS * level;
+        if ((now & ((1UL << shift) - 1U)) != 0U) {
+            break;
+        }
+        TimeWheel_splice_(level, (uint_fast8_t)((now >> shift) & TIME_WHEEL_MASK));
+        while (l_wheel.work != (TimeWheelEvt *)0) {
+            TimeWheelEvt * const e = l_wheel.work;
+            TimeWheel_unlink_(e);
+            TimeWheel_insert_(e);
+            ++l_wheel.moved;
+            QF_CRIT_EXIT(dummy);        // Let others in between events
+            QF_CRIT_ENTRY(dummy);
+        }
+    }
+
+    // Post the events expiring now
+    TimeWheel_splice_(0U, (uint_fast8_t)(now & TIME_WHEEL_MASK));
+    while (l_wheel.work != (TimeWheelEvt *)0) {
+        TimeWheelEvt * const e = l_wheel.work;
+        TimeWheel_unlink_(e);
+        if (e->interval != 0U) {
+            e->expiry = now + e->interval;
+            TimeWheel_insert_(e);
+        }
+        QF_CRIT_EXIT(dummy);
+        QACTIVE_POST(e->act, &e->super, sender);
+        QF_CRIT_ENTRY(dummy);
+    }
+    QF_CRIT_EXIT(dummy);
+}
+
+//============================================================================
+// PUBLIC FUNCTIONS
+//============================================================================
+
+void TimeWheelEvt_ctor(TimeWheelEvt * const me, QActive * const act,
+                       enum_t const sig)
+{
+    Q_REQUIRE((act != (QActive *)0) && (sig >= Q_USER_SIG));
+    me->super.sig = (QSignal)sig;   // poolId_ == 0: static, never recycled
+    me->super.poolId_ = 0U;
+    me->super.refCtr_ = 0U;
+    me->next = (TimeWheelEvt *)0;
+    me->pprev = (TimeWheelEvt **)0;
+    me->act = act;
+    me->expiry = 0U;
+    me->interval = 0U;
+    me->slot = 0U;
+}
+
+void TimeWheelEvt_arm(TimeWheelEvt * const me, uint32_t const nTicks,
+                      uint32_t const interval)
+{
+    Q_REQUIRE((nTicks != 0U) && (me->act != (QActive *)0));
+
+    QF_CRIT_ENTRY(dummy);
+    Q_ASSERT(me->pprev == (TimeWheelEvt **)0);      // Must not be armed
+    me->expiry = l_wheel.now + nTicks;
+    me->interval = interval;
+    TimeWheel_insert_(me);
+    QF_CRIT_EXIT(dummy);
+}
+
+bool TimeWheelEvt_disarm(TimeWheelEvt * const me) {
+    QF_CRIT_ENTRY(dummy);
+    bool const wasArmed = (me->pprev != (TimeWheelEvt **)0);
+    if (wasArmed) {
+        TimeWheel_unlink_(me);
+    }
+    QF_CRIT_EXIT(dummy);
+    return wasArmed;
+}
+
+bool TimeWheelEvt_rearm(TimeWheelEvt * const me, uint32_t const nTicks) {
+    Q_REQUIRE(nTicks != 0U);
+
+    QF_CRIT_ENTRY(dummy);
+    bool const wasArmed = (me->pprev != (TimeWheelEvt **)0);
+    if (wasArmed) {
+        TimeWheel_unlink_(me);
+    }
+    me->expiry = l_wheel.now + nTicks;
+    TimeWheel_insert_(me);
+    QF_CRIT_EXIT(dummy);
+    return wasArmed;
+}
+
+uint32_t TimeWheel_nextDue(void) {
+    uint32_t n = TIME_WHEEL_FOREVER;
+    for (uint_fast8_t level = 0U; level < TIME_WHEEL_LEVELS; ++level) {
+        uint32_t const busy = l_wheel.busy[level];
+        if (busy == 0U) {
+            continue;
+        }
+        uint_fast8_t const shift = TIME_WHEEL_SLOT_BITS * level;
+        uint32_t const block = l_wheel.now >> shift;
+
+        // Nearest non-empty slot after the current one (1..32 slots on)
+        uint_fast8_t const from = (uint_fast8_t)((block + 1U) & TIME_WHEEL_MASK);
+        uint32_t const rot = (from == 0U) ? busy
+            : ((busy >> from) | (busy << (TIME_WHEEL_SLOTS - from)));
+        uint32_t const d = (uint32_t)__builtin_ctz(rot) + 1U;
+
+        // Level 0: the expiry; above: when the slot is moved down
+        uint32_t const due = ((block + d) << shift) - l_wheel.now;
+        if (due < n) {
+            n = due;
+        }
+    }
+    return n;
+}
+
+#ifndef TIME_WHEEL_BENCH_ENABLE
+
+void TimeWheel_tick(void const * const sender) {
+    QTIMEEVT_TICK_X(0U, sender);
+    TimeWheel_advance_(sender);
+}
+
+#else // TIME_WHEEL_BENCH_ENABLE
+
+//============================================================================
+// BENCHMARK
+//============================================================================
+
+typedef struct {
+    uint32_t cyclesPerUs;
+    uint32_t ticks;                     /**< Window length */
+    uint32_t left;                      /**< Ticks left (0 = idle) */
+    uint16_t timers;
+    bool ready;                         /**< Ballast constructed */
+    uint32_t listArm;                   /**< Arm cycles, all timers */
+    uint32_t wheelArm;
+    uint64_t listSum;                   /**< Tick cycles, whole window */
+    uint64_t wheelSum;
+    uint32_t listMax;
+    uint32_t wheelMax;
+    uint32_t moved;                     /**< l_wheel.moved at the start */
+} TimeWheelBench;
+
+static QTimeEvt l_benchList[TIME_WHEEL_BENCH_TIMERS];
+static TimeWheelEvt l_benchWheel[TIME_WHEEL_BENCH_TIMERS];
+static QActive l_benchAct;              // Never started: the ballast never expires
+static TimeWheelBench l_bench;
+
+static void TimeWheelBench_finish_(void) {
+    uint16_t const n = l_bench.timers;
+
+    uint32_t t0 = BSP_cycles();
+    for (uint_fast16_t i = 0U; i < n; ++i) {
+        (void)QTimeEvt_disarm(&l_benchList[i]);
+    }
+    uint32_t const listDisarm = BSP_cycles() - t0;
+
+    t0 = BSP_cycles();
+    for (uint_fast16_t i = 0U; i < n; ++i) {
+        (void)TimeWheelEvt_disarm(&l_benchWheel[i]);
+    }
+    uint32_t const wheelDisarm = BSP_cycles() - t0;
+
+    QS_BEGIN_ID(BENCH_QS_REC, 0U)
+        QS_2U8_((uint8_t)BENCH_QS_TIMER, (uint8_t)TIME_WHEEL_LEVELS);
+        QS_U16_(n);
+        QS_U32_(l_bench.cyclesPerUs);
+        QS_U32_(l_bench.ticks);
+        QS_U32_((uint32_t)(l_bench.listSum / l_bench.ticks));
+        QS_U32_(l_bench.listMax);
+        QS_U32_((uint32_t)(l_bench.wheelSum / l_bench.ticks));
+        QS_U32_(l_bench.wheelMax);
+        QS_U32_(l_bench.listArm / n);
+        QS_U32_(l_bench.wheelArm / n);
+        QS_U32_(listDisarm / n);
+        QS_U32_(wheelDisarm / n);
+        QS_U32_(l_wheel.moved - l_bench.moved);
+    QS_END_()
+}
+
+void TimeWheelBench_start(uint32_t const cyclesPerUs,
+                          uint_fast16_t const nTimers, uint32_t const nTicks)
+{
+    if (l_bench.left != 0U) {
+        return;                         // A run is in progress
+    }
+    uint_fast16_t const n = ((nTimers == 0U)
+                             || (nTimers > TIME_WHEEL_BENCH_TIMERS))
+                            ? TIME_WHEEL_BENCH_TIMERS : nTimers;
+    uint32_t const ticks = (nTicks == 0U) ? TIME_WHEEL_BENCH_TICKS : nTicks;
+
+    l_bench.cyclesPerUs = cyclesPerUs;
+    l_bench.ticks = ticks;
+    l_bench.timers = (uint16_t)n;
+    l_bench.listSum = 0U;
+    l_bench.wheelSum = 0U;
+    l_bench.listMax = 0U;
+    l_bench.wheelMax = 0U;
+
+    // Once only: QF unlinks a disarmed QTimeEvt lazily, at a later tick
+    if (!l_bench.ready) {
+        for (uint_fast16_t i = 0U; i < TIME_WHEEL_BENCH_TIMERS; ++i) {
+            QTimeEvt_ctorX(&l_benchList[i], &l_benchAct, Q_USER_SIG, 0U);
+            TimeWheelEvt_ctor(&l_benchWheel[i], &l_benchAct, Q_USER_SIG);
+        }
+        l_bench.ready = true;
+    }
+
+    // Same pseudo-random timeouts for both, all beyond the window
+    uint32_t lcg = 12345U;
+    uint32_t t0 = BSP_cycles();
+    for (uint_fast16_t i = 0U; i < n; ++i) {
+        lcg = (lcg * 1664525U) + 1013904223U;
+        QTimeEvt_armX(&l_benchList[i], ticks + 1U + (lcg >> 17), 0U);
+    }
+    l_bench.listArm = BSP_cycles() - t0;
+
+    lcg = 12345U;
+    t0 = BSP_cycles();
+    for (uint_fast16_t i = 0U; i < n; ++i) {
+        lcg = (lcg * 1664525U) + 1013904223U;
+        TimeWheelEvt_arm(&l_benchWheel[i], ticks + 1U + (lcg >> 17), 0U);
+    }
+    l_bench.wheelArm = BSP_cycles() - t0;
+
+    QF_CRIT_ENTRY(dummy);
+    l_bench.moved = l_wheel.moved;
+    l_bench.left = ticks;               // The tick ISR takes over
+    QF_CRIT_EXIT(dummy);
+}
+
+void TimeWheel_tick(void const * const sender) {
+    if (l_bench.left == 0U) {
+        QTIMEEVT_TICK_X(0U, sender);
+        TimeWheel_advance_(sender);
+        return;
+    }
+
+    uint32_t const t0 = BSP_cycles();
+    QTIMEEVT_TICK_X(0U, sender);
+    uint32_t const t1 = BSP_cycles();
+    TimeWheel_advance_(sender);
+    uint32_t const t2 = BSP_cycles();
+
+    uint32_t const list = t1 - t0;
+    uint32_t const wheel = t2 - t1;
+    l_bench.listSum += list;
+    l_bench.wheelSum += wheel;
+    l_bench.listMax = (list > l_bench.listMax) ? list : l_bench.listMax;
+    l_bench.wheelMax = (wheel > l_bench.wheelMax) ? wheel : l_bench.wheelMax;
+
+    if (--l_bench.left == 0U) {
+        TimeWheelBench_finish_();
+    }
+}
+
+#endif // TIME_WHEEL_BENCH_ENABLE
+
+#endif // TIME_WHEEL_ENABLE
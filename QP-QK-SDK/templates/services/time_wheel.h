@@ -0,0 +1,180 @@
+/**
+ * @file time_wheel.h
+ * @brief Hierarchical Timing Wheel for Time Events
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * Optional backend for the AO time events of tick rate 0. QF keeps its
+ * armed QTimeEvts in one list and QTIMEEVT_TICK_X() walks all of them on
+ * every tick, so the tick costs as much as there are armed timers. The
+ * wheel files each TimeWheelEvt under the tick it expires at instead:
+ *
+ *   level 0: 32 slots of 1 tick       (expires within 32 ticks)
+ *   level 1: 32 slots of 32 ticks     (within 1024 ticks)
+ *   level n: 32 slots of 32^n ticks   (TIME_WHEEL_LEVELS levels in all)
+ *
+ * Arming and disarming link or unlink one event, whatever is armed. A
+ * tick posts the events of one level 0 slot, and every 32^n ticks moves
+ * the events of one level n slot down to the levels below (each event is
+ * moved at most TIME_WHEEL_LEVELS - 1 times over its timeout). The tick
+ * cost thus follows the expiring events, not the armed ones.
+ *
+ * AOs use the APP_TIMEEVT_*() macros and the AppTimeEvt type, which map
+ * onto QTimeEvt unless TIME_WHEEL_ENABLE is defined, and the clock tick
+ * calls TIME_WHEEL_TICK() in place of QTIMEEVT_TICK_X(0U, ...). The QF
+ * list still runs for the time events of QF itself and of the services.
+ * Wheel events do not produce the QS_QF_TIMEEVT_* trace records.
+ */
+
+#ifndef TIME_WHEEL_H
+#define TIME_WHEEL_H
+
+#include "qpc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//============================================================================
+// CONFIGURATION
+//============================================================================
+
+#ifndef TIME_WHEEL_LEVELS
+#define TIME_WHEEL_LEVELS       5U      // 32^5 ticks: 9.3 hours at 1 kHz
+#endif
+
+#ifndef TIME_WHEEL_BENCH_TIMERS
+#define TIME_WHEEL_BENCH_TIMERS 256U    // Ballast per backend in the benchmark
+#endif
+
+#ifndef TIME_WHEEL_BENCH_TICKS
+#define TIME_WHEEL_BENCH_TICKS  1000U   // Default measurement window in ticks
+#endif
+
+#define TIME_WHEEL_SLOT_BITS    5U
+#define TIME_WHEEL_SLOTS        (1U << TIME_WHEEL_SLOT_BITS)
+#define TIME_WHEEL_FOREVER      0xFFFFFFFFU // Nothing armed
+
+//============================================================================
+// TYPES
+//============================================================================
+
+/**
+ * @brief Time event kept in the wheel (posted as its own QEvt)
+ */
+typedef struct TimeWheelEvt {
+    QEvt super;                         /**< Posted to act on expiry */
+    struct TimeWheelEvt *next;
+    struct TimeWheelEvt **pprev;        /**< Link to this one (NULL = disarmed) */
+    QActive *act;                       /**< Receiving Active Object */
+    uint32_t expiry;                    /**< Tick count it expires at */
+    uint32_t interval;                  /**< Re-arm period (0 = one-shot) */
+    uint8_t slot;                       /**< Last slot (level * 32 + slot) */
+} TimeWheelEvt;
+
+//============================================================================
+// PUBLIC INTERFACE
+//============================================================================
+
+/**
+ * @brief Construct a wheel time event (like QTimeEvt_ctorX() at rate 0)
+ */
+void TimeWheelEvt_ctor(TimeWheelEvt * const me, QActive * const act,
+                       enum_t const sig);
+
+/**
+ * @brief Arm a disarmed event (like QTimeEvt_armX())
+ *
+ * @param nTicks   Ticks to the first expiry (> 0)
+ * @param interval Period after that (0 = one-shot)
+ */
+void TimeWheelEvt_arm(TimeWheelEvt * const me, uint32_t const nTicks,
+                      uint32_t const interval);
+
+/**
+ * @brief Disarm the event
+ *
+ * @return false if it was not armed: it has expired (its event may still
+ *         be queued) or was never armed
+ */
+bool TimeWheelEvt_disarm(TimeWheelEvt * const me);
+
+/**
+ * @brief Restart the timeout from now, keeping the interval
+ *
+ * @return true if the event was armed, false if this armed it
+ */
+bool TimeWheelEvt_rearm(TimeWheelEvt * const me, uint32_t const nTicks);
+
+/**
+ * @brief Process one clock tick (call from the tick ISR)
+ *
+ * Runs QTIMEEVT_TICK_X(0U, sender) for the QF list, then advances the
+ * wheel and posts the expired events.
+ *
+ * @param sender Sender for QS (the ISR), unused without Q_SPY
+ */
+void TimeWheel_tick(void const * const sender);
+
+/**
+ * @brief Ticks until the nearest wheel expiry (TIME_WHEEL_FOREVER = none)
+ *
+ * The nearest level 0 expiry, or the earlier tick at which the wheel moves
+ * an event down a level (a lower bound: nothing expires before it). Call
+ * with interrupts disabled.
+ */
+uint32_t TimeWheel_nextDue(void);
+
+/**
+ * @brief Compare the wheel with the QF list over a window of ticks
+ *
+ * Arms nTimers QTimeEvts at rate 0 and as many wheel events, with the
+ * same timeouts beyond the window, and times QTIMEEVT_TICK_X() and the
+ * wheel separately in every tick of the window. Both sets are disarmed
+ * at the end and one BENCH_QS_TIMER record (bench_stats.h) is emitted.
+ * The application's own time events stay in both figures. Ignored while
+ * a run is in progress.
+ *
+ * @param cyclesPerUs BSP_cycles() ticks per microsecond
+ * @param nTimers     Timers per backend (0 or too many = TIME_WHEEL_BENCH_TIMERS)
+ * @param nTicks      Window (0 = TIME_WHEEL_BENCH_TICKS)
+ */
+void TimeWheelBench_start(uint32_t const cyclesPerUs,
+                          uint_fast16_t const nTimers, uint32_t const nTicks);
+
+//============================================================================
+// INTEGRATION MACROS
+//============================================================================
+
+#ifdef TIME_WHEEL_ENABLE
+typedef TimeWheelEvt AppTimeEvt;
+#define APP_TIMEEVT_CTOR(me_, act_, sig_) \
+    TimeWheelEvt_ctor((me_), (act_), (sig_))
+#define APP_TIMEEVT_ARM(me_, nTicks_, interval_) \
+    TimeWheelEvt_arm((me_), (nTicks_), (interval_))
+#define APP_TIMEEVT_DISARM(me_)             TimeWheelEvt_disarm(me_)
+#define APP_TIMEEVT_REARM(me_, nTicks_)     TimeWheelEvt_rearm((me_), (nTicks_))
+#define TIME_WHEEL_TICK(sender_)            TimeWheel_tick(sender_)
+#else
+typedef QTimeEvt AppTimeEvt;
+#define APP_TIMEEVT_CTOR(me_, act_, sig_) \
+    QTimeEvt_ctorX((me_), (act_), (sig_), 0U)
+#define APP_TIMEEVT_ARM(me_, nTicks_, interval_) \
+    QTimeEvt_armX((me_), (nTicks_), (interval_))
+#define APP_TIMEEVT_DISARM(me_)             QTimeEvt_disarm(me_)
+#define APP_TIMEEVT_REARM(me_, nTicks_)     QTimeEvt_rearm((me_), (nTicks_))
+#define TIME_WHEEL_TICK(sender_)            QTIMEEVT_TICK_X(0U, (sender_))
+#endif // TIME_WHEEL_ENABLE
+
+#if defined(TIME_WHEEL_ENABLE) && defined(TIME_WHEEL_BENCH_ENABLE)
+#define TIME_WHEEL_BENCH_RUN(cyclesPerUs_, nTimers_, nTicks_) \
+    TimeWheelBench_start((cyclesPerUs_), (uint_fast16_t)(nTimers_), (nTicks_))
+#else
+#define TIME_WHEEL_BENCH_RUN(cyclesPerUs_, nTimers_, nTicks_)  ((void)0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TIME_WHEEL_H
@@ -0,0 +1,397 @@
+/**
+ * @file trace_replay.c
+ * @brief Trace Capture on the Target, Deterministic Replay on the Host
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * Both halves wrap the AO virtual tables like the RTC profiler and the
+ * queue monitor do, and chain to whatever vtable was installed before.
+ *
+ * Idle detection for the replay counts events in flight. The wrapped
+ * post() counts up before the event is queued, so the count cannot drop
+ * to zero while the event waits. The wrapped dispatch() counts down after
+ * the handler returned. This catches everything that goes through the
+ * vtable: posts, publishes and time events.
+ */
+
+#include "trace_replay.h"
+#include <string.h>
+
+#if defined(REPLAY_CAPTURE_ENABLE) && defined(REPLAY_ENABLE)
+#error "Capture runs on the target, replay on the host: enable one of them"
+#endif
+
+#if defined(REPLAY_CAPTURE_ENABLE) || defined(REPLAY_ENABLE)
+
+Q_DEFINE_THIS_MODULE("trace_replay")
+
+//============================================================================
+// LOCAL TYPES AND VARIABLES
+//============================================================================
+
+typedef struct {
+    QActiveVtable vtable;           /**< Copy of the AO vtable, wrapped */
+    QActiveVtable const *orig;      /**< Original vtable (NULL = not wrapped) */
+} ReplayAo;
+
+typedef struct {
+    QSignal sig;                    /**< 0 = free slot */
+    uint16_t evtSize;
+} ReplaySig;
+
+static ReplayAo l_ao[QF_MAX_ACTIVE + 1U];
+static ReplaySig l_sig[REPLAY_MAX_SIGS];
+
+//============================================================================
+// LOCAL FUNCTIONS
+//============================================================================
+
+// Install the non-NULL entries of hooks in all started AOs
+static void Replay_wrapAll_(QActiveVtable const * const hooks) {
+    for (uint_fast8_t p = 1U; p <= QF_MAX_ACTIVE; ++p) {
+        QActive * const ao = QActive_registry_[p];
+        ReplayAo * const r = &l_ao[p];
+        if ((ao == (QActive *)0) || (r->orig != (QActiveVtable const *)0)) {
+            continue;
+        }
+        r->orig = (QActiveVtable const *)ao->super.vptr;
+        r->vtable = *r->orig;
+        r->vtable.post = hooks->post;
+        if (hooks->postLIFO != 0) {
+            r->vtable.postLIFO = hooks->postLIFO;
+        }
+        if (hooks->super.dispatch != 0) {
+            r->vtable.super.dispatch = hooks->super.dispatch;
+        }
+        ao->super.vptr = &r->vtable.super;
+    }
+}
+
+static ReplaySig const *Replay_findSig_(QSignal const sig) {
+    for (uint_fast8_t i = 0U; i < REPLAY_MAX_SIGS; ++i) {
+        if ((l_sig[i].sig == sig) && (sig != 0U)) {
+            return &l_sig[i];
+        }
+    }
+    return (ReplaySig const *)0;
+}
+
+//============================================================================
+// PUBLIC FUNCTIONS (CAPTURE AND REPLAY)
+//============================================================================
+
+void Replay_addEvt(enum_t const sig, uint16_t const evtSize) {
+    Q_REQUIRE((evtSize >= sizeof(QEvt))
+              && ((evtSize - sizeof(QEvt)) <= REPLAY_MAX_PAYLOAD)
+              && (Replay_findSig_((QSignal)sig) == (ReplaySig const *)0));
+
+    for (uint_fast8_t i = 0U; i < REPLAY_MAX_SIGS; ++i) {
+        if (l_sig[i].sig == 0U) {
+            l_sig[i].sig = (QSignal)sig;
+            l_sig[i].evtSize = evtSize;
+            return;
+        }
+    }
+    Q_ERROR();  // REPLAY_MAX_SIGS too small
+}
+
+#endif // REPLAY_CAPTURE_ENABLE || REPLAY_ENABLE
+
+//============================================================================
+// CAPTURE
+//============================================================================
+
+#ifdef REPLAY_CAPTURE_ENABLE
+
+static void const *l_tickSender;
+static uint32_t volatile l_ticks;
+
+static bool Replay_isExternal_(void const * const sender) {
+    if ((sender == l_tickSender) || (sender == (void const *)0)) {
+        return false;
+    }
+    for (uint_fast8_t p = 1U; p <= QF_MAX_ACTIVE; ++p) {
+        if ((void const *)QActive_registry_[p] == sender) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void Replay_emit_(QActive const * const me, QEvt const * const e) {
+    ReplaySig const * const s = Replay_findSig_(e->sig);
+    uint8_t const len = (s != (ReplaySig const *)0)
+                        ? (uint8_t)(s->evtSize - sizeof(QEvt)) : 0U;
+    uint8_t const * const params = (uint8_t const *)e + sizeof(QEvt);
+
+    QS_BEGIN_ID(REPLAY_QS_REC, me->prio)
+        QS_2U8_((uint8_t)REPLAY_QS_EVT, (uint8_t)me->prio);
+        QS_U32_((uint32_t)(uintptr_t)me);   // For the object dictionary
+        QS_U32_(l_ticks);
+        QS_U16_(e->sig);
+        QS_U8_(len);
+        for (uint_fast8_t i = 0U; i < len; ++i) {
+            QS_U8_(params[i]);
+        }
+    QS_END_()
+}
+
+static bool Replay_capturePost_(QActive * const me, QEvt const * const e,
+                                uint_fast16_t const margin,
+                                void const * const sender)
+{
+    ReplayAo const * const r = &l_ao[me->prio];
+    bool const external = Replay_isExternal_(sender);
+
+    // Traced before the post: after it the AO may already have consumed
+    // and recycled the event. A failed margin post is traced too; it
+    // fails the same way in the replay.
+    if (external) {
+        Replay_emit_(me, e);
+    }
+    return (*r->orig->post)(me, e, margin, sender);
+}
+
+void Replay_captureStart(void const * const tickSender) {
+    QActiveVtable hooks;
+    l_tickSender = tickSender;
+
+    // LIFO posts carry no sender and are how deferred events come back:
+    // they are left alone
+    memset(&hooks, 0, sizeof(hooks));
+    hooks.post = &Replay_capturePost_;
+    Replay_wrapAll_(&hooks);
+}
+
+void Replay_captureTick(void) {
+    ++l_ticks;
+}
+
+#endif // REPLAY_CAPTURE_ENABLE
+
+//============================================================================
+// REPLAY
+//============================================================================
+
+#ifdef REPLAY_ENABLE
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Row REPLAY_MAX_SIG collects all higher signals
+static ReplayHandlerStats l_stats[QF_MAX_ACTIVE + 1U][REPLAY_MAX_SIG + 1U];
+static QEvt l_staticEvt[REPLAY_MAX_SIG];    // Unregistered signals
+static int32_t l_inFlight;
+static uint64_t l_perfBias[2];              // Cost of the reads themselves
+static bool l_perf;
+static uint32_t l_injected;
+static uint32_t l_failed;
+
+static bool Replay_post_(QActive * const me, QEvt const * const e,
+                         uint_fast16_t const margin,
+                         void const * const sender)
+{
+    (void)__atomic_add_fetch(&l_inFlight, 1, __ATOMIC_SEQ_CST);
+    bool const posted = (*l_ao[me->prio].orig->post)(me, e, margin, sender);
+    if (!posted) {
+        (void)__atomic_sub_fetch(&l_inFlight, 1, __ATOMIC_SEQ_CST);
+    }
+    return posted;
+}
+
+static void Replay_postLIFO_(QActive * const me, QEvt const * const e) {
+    (void)__atomic_add_fetch(&l_inFlight, 1, __ATOMIC_SEQ_CST);
+    (*l_ao[me->prio].orig->postLIFO)(me, e);
+}
+
+static void Replay_dispatch_(QHsm * const me, QEvt const * const e,
+                             uint_fast8_t const qs_id)
+{
+    uint_fast8_t const prio = ((QActive *)me)->prio;
+    QSignal const sig = e->sig;
+    uint64_t c0[2] = { 0U, 0U };
+    uint64_t c1[2] = { 0U, 0U };
+
+    (void)BSP_perfRead(c0);
+    uint32_t const t0 = BSP_cycles();
+    (*l_ao[prio].orig->super.dispatch)(me, e, qs_id);
+    uint32_t const ns = BSP_cycles() - t0;
+    (void)BSP_perfRead(c1);
+
+    ReplayHandlerStats * const s =
+        &l_stats[prio][(sig < REPLAY_MAX_SIG) ? sig : REPLAY_MAX_SIG];
+    ++s->count;
+    if (l_perf) {
+        uint64_t instr = c1[0] - c0[0];
+        uint64_t cycles = c1[1] - c0[1];
+        instr = (instr > l_perfBias[0]) ? (instr - l_perfBias[0]) : 0U;
+        cycles = (cycles > l_perfBias[1]) ? (cycles - l_perfBias[1]) : 0U;
+        s->instrSum += instr;
+        s->instrMax = (instr > s->instrMax) ? instr : s->instrMax;
+        s->cyclesSum += cycles;
+        s->cyclesMax = (cycles > s->cyclesMax) ? cycles : s->cyclesMax;
+    }
+    s->nsSum += ns;
+    s->nsMax = (ns > s->nsMax) ? ns : s->nsMax;
+
+    // Events that bypassed the vtable were never counted in: stop at 0
+    int32_t n = __atomic_load_n(&l_inFlight, __ATOMIC_SEQ_CST);
+    while ((n > 0)
+           && !__atomic_compare_exchange_n(&l_inFlight, &n, n - 1, false,
+                                           __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+    {
+    }
+}
+
+void Replay_start(void) {
+    // Counter overhead: the cheapest back-to-back read of the pair
+    uint64_t c0[2];
+    uint64_t c1[2];
+    l_perf = BSP_perfRead(c0);
+    l_perfBias[0] = UINT64_MAX;
+    l_perfBias[1] = UINT64_MAX;
+    for (uint_fast8_t i = 0U; l_perf && (i < 64U); ++i) {
+        (void)BSP_perfRead(c0);
+        (void)BSP_perfRead(c1);
+        if ((c1[0] - c0[0]) < l_perfBias[0]) {
+            l_perfBias[0] = c1[0] - c0[0];
+        }
+        if ((c1[1] - c0[1]) < l_perfBias[1]) {
+            l_perfBias[1] = c1[1] - c0[1];
+        }
+    }
+
+    QActiveVtable hooks;
+    memset(&hooks, 0, sizeof(hooks));
+    hooks.post = &Replay_post_;
+    hooks.postLIFO = &Replay_postLIFO_;
+    hooks.super.dispatch = &Replay_dispatch_;
+    Replay_wrapAll_(&hooks);
+}
+
+bool Replay_parse(char const * const line, ReplayStep * const step) {
+    unsigned long tick;
+    unsigned long long us;
+    unsigned prio;
+    unsigned sig;
+    char hex[(2U * REPLAY_MAX_PAYLOAD) + 2U];
+
+    Q_ASSERT_STATIC(REPLAY_MAX_PAYLOAD == 48U);     // Field width below
+    if (sscanf(line, "%lu %llu %u %u %97s", &tick, &us, &prio, &sig, hex) != 5) {
+        return false;   // Comment, blank or malformed line
+    }
+    memset(step, 0, sizeof(*step));
+    step->tick = (uint32_t)tick;
+    step->timeUs = (uint64_t)us;
+    step->prio = (uint8_t)prio;
+    step->sig = (QSignal)sig;
+    if (strcmp(hex, "-") != 0) {
+        size_t const n = strlen(hex) / 2U;
+        for (size_t i = 0U; (i < n) && (i < REPLAY_MAX_PAYLOAD); ++i) {
+            char byte[3] = { hex[2U * i], hex[(2U * i) + 1U], '\0' };
+            step->params[i] = (uint8_t)strtoul(byte, (char **)0, 16);
+            step->len = (uint8_t)(i + 1U);
+        }
+    }
+    return true;
+}
+
+bool Replay_inject(ReplayStep const * const step) {
+    static uint8_t const sender = 0U;   // External: not an AO, not the tick
+    QActive * const ao = (step->prio <= QF_MAX_ACTIVE)
+                            ? QActive_registry_[step->prio] : (QActive *)0;
+    ReplaySig const * const s = Replay_findSig_(step->sig);
+    QEvt *e;
+
+    if (ao == (QActive *)0) {
+        ++l_failed;
+        return false;
+    }
+    if (s != (ReplaySig const *)0) {
+        e = QF_newX_(s->evtSize, QF_NO_MARGIN, (enum_t)step->sig);
+        size_t const room = s->evtSize - sizeof(QEvt);
+        memcpy((uint8_t *)e + sizeof(QEvt), step->params,
+               (step->len < room) ? step->len : room);
+    } else if (step->sig < REPLAY_MAX_SIG) {
+        e = &l_staticEvt[step->sig];    // poolId_ 0: static, never recycled
+        e->sig = step->sig;
+    } else {
+        ++l_failed;
+        return false;
+    }
+
+    // Margin 0: a post that overflowed on the target overflows here
+    ++l_injected;
+    (void)QACTIVE_POST_X(ao, e, 0U, &sender);
+    return true;
+}
+
+bool Replay_isIdle(void) {
+    return __atomic_load_n(&l_inFlight, __ATOMIC_SEQ_CST) == 0;
+}
+
+ReplayHandlerStats const *Replay_getStats(uint_fast8_t prio, QSignal sig) {
+    if (prio > QF_MAX_ACTIVE) {
+        return (ReplayHandlerStats const *)0;
+    }
+    ReplayHandlerStats const * const s =
+        &l_stats[prio][(sig < REPLAY_MAX_SIG) ? sig : REPLAY_MAX_SIG];
+    return (s->count != 0U) ? s : (ReplayHandlerStats const *)0;
+}
+
+bool Replay_report(char const * const path, uint32_t const ticks) {
+    FILE *f = (FILE *)0;
+    if (path != (char const *)0) {
+        f = fopen(path, "w");
+        if (f == (FILE *)0) {
+            return false;
+        }
+        fprintf(f, "{\n  \"format\": \"qk-replay/1\",\n"
+                   "  \"counters\": \"%s\",\n  \"ticks\": %u,\n"
+                   "  \"injected\": %u,\n  \"failed\": %u,\n"
+                   "  \"handlers\": [",
+                l_perf ? "perf" : "clock", (unsigned)ticks,
+                (unsigned)l_injected, (unsigned)l_failed);
+    }
+
+    printf("\nReplay Results (%u ticks, %u events injected, %u failed, %s)\n",
+           (unsigned)ticks, (unsigned)l_injected, (unsigned)l_failed,
+           l_perf ? "hardware counters" : "no counters, wall time only");
+    printf("%-5s %-5s %10s %12s %12s %12s %10s\n", "Prio", "Sig",
+           "Count", "Instr/evt", "Max instr", "Cycles/evt", "ns/evt");
+
+    char const *sep = "\n";
+    for (uint_fast8_t p = 1U; p <= QF_MAX_ACTIVE; ++p) {
+        for (uint_fast16_t sig = 0U; sig <= REPLAY_MAX_SIG; ++sig) {
+            ReplayHandlerStats const * const s = &l_stats[p][sig];
+            if (s->count == 0U) {
+                continue;
+            }
+            unsigned long long const instr = s->instrSum / s->count;
+            unsigned long long const cycles = s->cyclesSum / s->count;
+            unsigned long long const ns = s->nsSum / s->count;
+            printf("%-5u %-5u %10u %12llu %12llu %12llu %10llu\n",
+                   (unsigned)p, (unsigned)sig, (unsigned)s->count,
+                   instr, (unsigned long long)s->instrMax, cycles, ns);
+            if (f != (FILE *)0) {
+                fprintf(f, "%s    {\"prio\": %u, \"sig\": %u, \"count\": %u, "
+                           "\"instr_mean\": %llu, \"instr_max\": %llu, "
+                           "\"cycles_mean\": %llu, \"cycles_max\": %llu, "
+                           "\"ns_mean\": %llu, \"ns_max\": %u}",
+                        sep, (unsigned)p, (unsigned)sig, (unsigned)s->count,
+                        instr, (unsigned long long)s->instrMax,
+                        cycles, (unsigned long long)s->cyclesMax,
+                        ns, (unsigned)s->nsMax);
+                sep = ",\n";
+            }
+        }
+    }
+
+    if (f != (FILE *)0) {
+        fprintf(f, "\n  ]\n}\n");
+        return fclose(f) == 0;
+    }
+    return true;
+}
+
+#endif // REPLAY_ENABLE
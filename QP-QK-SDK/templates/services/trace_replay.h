@@ -0,0 +1,203 @@
+/**
+ * @file trace_replay.h
+ * @brief Trace Capture on the Target, Deterministic Replay on the Host
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * Turns a field trace into a reproducible benchmark. The capture half
+ * (REPLAY_CAPTURE_ENABLE, any platform) wraps the post() entries of all
+ * AOs and emits one QS record per external event it sees. An event is
+ * external when the sender is neither an AO nor the tick, e.g. one posted
+ * from an ISR or the BSP. The record holds the tick count, target AO,
+ * signal and the event parameters. tools/analyzers/qs_replay.py turns
+ * these records into a replay script.
+ *
+ * The replay half (REPLAY_ENABLE, posix build of the same AOs) re-injects
+ * the script. The replay owns the clock: it runs the tick chain itself,
+ * tick by tick, and injects each event at the tick it was captured at.
+ * Every tick and every event waits until all AOs are idle (no event in
+ * any queue, no dispatch running). Time events, TICK_SIG and the AO-to-AO
+ * traffic are then regenerated by the AOs, in the same order on every
+ * run. Each dispatch is measured with the BSP's hardware counters
+ * (instructions, cycles) and reported per AO and signal.
+ *
+ * Events carry their parameters only for signals registered with
+ * REPLAY_EVT(). Other signals replay as parameterless static events.
+ * Events that point to memory (BufEvt) cannot be replayed.
+ */
+
+#ifndef TRACE_REPLAY_H
+#define TRACE_REPLAY_H
+
+#include "qpc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//============================================================================
+// CONFIGURATION
+//============================================================================
+
+#ifndef REPLAY_MAX_SIGS
+#define REPLAY_MAX_SIGS         8U      // Signals registered with REPLAY_EVT()
+#endif
+
+#ifndef REPLAY_MAX_PAYLOAD
+#define REPLAY_MAX_PAYLOAD      48U     // Parameter bytes after the QEvt
+#endif
+
+#ifndef REPLAY_MAX_SIG
+#define REPLAY_MAX_SIG          64U     // Signals >= this share one stats row
+#endif
+
+// QS user record reserved for this service (see project_template.h)
+#define REPLAY_QS_REC           (QS_USER + 17)
+
+// Sub-record types carried in the first byte of REPLAY_QS_REC
+enum ReplayQSType {
+    REPLAY_QS_EVT = 1U          /**< prio, ao, tick, sig, len, params */
+};
+
+//============================================================================
+// TYPES
+//============================================================================
+
+/**
+ * @brief One captured external event (a line of the replay script)
+ */
+typedef struct {
+    uint32_t tick;              /**< Ticks processed before the post */
+    uint64_t timeUs;            /**< Trace time, for BSP_getTimeUs() */
+    uint8_t prio;               /**< Target AO */
+    QSignal sig;
+    uint8_t len;                /**< Parameter bytes in params[] */
+    uint8_t params[REPLAY_MAX_PAYLOAD];
+} ReplayStep;
+
+/**
+ * @brief Cost of one handler (AO and signal) over the replay
+ */
+typedef struct {
+    uint32_t count;             /**< Dispatches */
+    uint64_t instrSum;          /**< Retired instructions (0 = no counters) */
+    uint64_t instrMax;
+    uint64_t cyclesSum;         /**< CPU cycles (0 = no counters) */
+    uint64_t cyclesMax;
+    uint64_t nsSum;             /**< Wall time from BSP_cycles() */
+    uint32_t nsMax;
+} ReplayHandlerStats;
+
+//============================================================================
+// PUBLIC INTERFACE
+//============================================================================
+
+/**
+ * @brief Register the parameters of a signal (capture and replay)
+ *
+ * Call during initialization, with the same signals on the target and on
+ * the host.
+ *
+ * @param sig     Signal
+ * @param evtSize sizeof() of the event type carrying the signal
+ */
+void Replay_addEvt(enum_t const sig, uint16_t const evtSize);
+
+/**
+ * @brief Start capturing: wrap post() of all started AOs
+ *
+ * Call from QF_onStartup(), after all AOs and the other services that
+ * wrap the virtual table (RTC_PROF_ATTACH(), QUEUE_MON_ATTACH()) are set
+ * up. Requires Q_SPY.
+ *
+ * @param tickSender QS sender of the tick chain (its posts are not external)
+ */
+void Replay_captureStart(void const * const tickSender);
+
+/**
+ * @brief Count one tick (first in the tick chain, before its posts)
+ */
+void Replay_captureTick(void);
+
+/**
+ * @brief Free-running 32-bit CPU cycle counter (provided by the BSP)
+ */
+uint32_t BSP_cycles(void);
+
+/**
+ * @brief Hardware counters of the calling thread (provided by the BSP)
+ *
+ * @param counts Retired instructions and CPU cycles
+ * @return false if the host has no usable counters
+ */
+bool BSP_perfRead(uint64_t counts[2]);
+
+/**
+ * @brief Start replaying: wrap post(), postLIFO() and dispatch() of all AOs
+ *
+ * Call on the AO thread from QF_onStartup(), after all AOs are started.
+ */
+void Replay_start(void);
+
+/**
+ * @brief Parse one line of a replay script
+ *
+ * Format: "tick time_us prio sig params", params as hex or "-".
+ * Empty lines and '#' comments return false.
+ */
+bool Replay_parse(char const * const line, ReplayStep * const step);
+
+/**
+ * @brief Post the event of a step to its AO (replay thread)
+ *
+ * @return false if no AO runs at the step's priority, or if the signal
+ *         is unregistered and >= REPLAY_MAX_SIG
+ */
+bool Replay_inject(ReplayStep const * const step);
+
+/**
+ * @brief True when no event is queued or being dispatched
+ */
+bool Replay_isIdle(void);
+
+/**
+ * @brief Cost of one handler (NULL if never dispatched)
+ */
+ReplayHandlerStats const *Replay_getStats(uint_fast8_t prio, QSignal sig);
+
+/**
+ * @brief Print the handler costs, and write them as JSON to path
+ *
+ * @param path  JSON report file (NULL = table on stdout only)
+ * @param ticks Ticks replayed
+ * @return false if the file cannot be written
+ */
+bool Replay_report(char const * const path, uint32_t const ticks);
+
+//============================================================================
+// INTEGRATION MACROS
+//============================================================================
+
+#ifdef REPLAY_CAPTURE_ENABLE
+#ifndef Q_SPY
+#error "REPLAY_CAPTURE_ENABLE emits QS records and needs Q_SPY"
+#endif
+#define REPLAY_CAPTURE_START(tickSender_)   Replay_captureStart(tickSender_)
+#define REPLAY_CAPTURE_TICK()               Replay_captureTick()
+#else
+#define REPLAY_CAPTURE_START(tickSender_)   ((void)0)
+#define REPLAY_CAPTURE_TICK()               ((void)0)
+#endif // REPLAY_CAPTURE_ENABLE
+
+#if defined(REPLAY_CAPTURE_ENABLE) || defined(REPLAY_ENABLE)
+#define REPLAY_EVT(sig_, evtType_) \
+    Replay_addEvt((sig_), (uint16_t)sizeof(evtType_))
+#else
+#define REPLAY_EVT(sig_, evtType_)          ((void)0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TRACE_REPLAY_H
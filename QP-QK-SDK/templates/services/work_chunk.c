@@ -0,0 +1,178 @@
+/**
+ * @file work_chunk.c
+ * @brief Chunked (Resumable) Work for Long Operations
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * A chunk ends when the time used so far plus the longest unit seen so
+ * far would exceed the budget. The estimate only grows, so a chunk
+ * overruns its budget only on a unit longer than every earlier one. The
+ * time is wall-clock: preemption by ISRs and higher-priority AOs shortens
+ * the chunk they land in, which errs on the safe side.
+ *
+ * All calls for one WorkChunk come from the AO it is bound to, so the
+ * state needs no critical section. The continuation event is static
+ * (poolId_ == 0). WorkChunk_run() reposts it only while it is being
+ * dispatched, so at most one copy is queued. WorkChunk_start() looks for
+ * that copy in the queue instead of trusting a flag, because a state that
+ * does not handle the signal drops it.
+ */
+
+#include "work_chunk.h"
+
+Q_DEFINE_THIS_MODULE("work_chunk")
+
+//============================================================================
+// LOCAL VARIABLES
+//============================================================================
+
+static WorkChunk *l_chunk[WORK_CHUNK_MAX];
+static uint_fast8_t l_nChunk;
+static uint32_t l_cyclesPerUs = 1U;
+
+//============================================================================
+// LOCAL FUNCTIONS
+//============================================================================
+
+// Is the continuation event still waiting in the AO's queue?
+static bool WorkChunk_queued_(WorkChunk const * const me) {
+    QEQueue const * const q = &me->ao->eQueue;
+    bool found = false;
+
+    QF_CRIT_ENTRY(dummy);
+    if (q->frontEvt != (QEvt *)0) {
+        found = (q->frontEvt == &me->cont);
+        QEQueueCtr idx = q->tail;
+        for (QEQueueCtr n = q->end - q->nFree; (n > 0U) && !found; --n) {
+            found = (q->ring[idx] == &me->cont);
+            idx = (idx == 0U) ? q->end : idx;
+            --idx;
+        }
+    }
+    QF_CRIT_EXIT(dummy);
+    return found;
+}
+
+static void WorkChunk_record_(WorkChunkStats * const s, uint16_t units,
+                              uint32_t cycles)
+{
+    if ((s->chunks == 0U) || (units < s->minUnits)) {
+        s->minUnits = units;
+    }
+    if (units > s->maxUnits) {
+        s->maxUnits = units;
+    }
+    if (cycles > s->maxCycles) {
+        s->maxCycles = cycles;
+    }
+    s->units += units;
+    ++s->chunks;
+}
+
+//============================================================================
+// PUBLIC FUNCTIONS
+//============================================================================
+
+void WorkChunk_init(uint32_t cyclesPerUs) {
+    Q_REQUIRE(cyclesPerUs != 0U);
+    l_cyclesPerUs = cyclesPerUs;
+}
+
+void WorkChunk_ctor(WorkChunk * const me, QActive * const ao,
+                    enum_t const sig, uint32_t const budgetUs)
+{
+    Q_REQUIRE((ao != (QActive *)0) && (sig >= Q_USER_SIG));
+
+    me->cont.sig = (QSignal)sig;    // poolId_ == 0: static, never recycled
+    me->cont.poolId_ = 0U;
+    me->cont.refCtr_ = 0U;
+    me->ao = ao;
+    me->step = (WorkStepFn)0;
+    me->ctx = (void *)0;
+    me->budgetUs = budgetUs;
+    me->stats = (WorkChunkStats){ 0U };
+
+    if (l_nChunk < WORK_CHUNK_MAX) {    // Beyond that: works, not reported
+        l_chunk[l_nChunk] = me;
+        ++l_nChunk;
+    }
+}
+
+void WorkChunk_start(WorkChunk * const me, WorkStepFn const step,
+                     void * const ctx)
+{
+    Q_REQUIRE((step != (WorkStepFn)0) && !WorkChunk_busy(me));
+
+    me->step = step;
+    me->ctx = ctx;
+    if (!WorkChunk_queued_(me)) {
+        QACTIVE_POST(me->ao, &me->cont, me);
+    }
+}
+
+bool WorkChunk_run(WorkChunk * const me) {
+    if (!WorkChunk_busy(me)) {
+        return false;               // Stale event after WorkChunk_cancel()
+    }
+
+    WorkChunkStats * const s = &me->stats;
+    uint32_t const budget = me->budgetUs * l_cyclesPerUs;
+    uint32_t const start = BSP_cycles();
+    uint32_t prev = start;
+    uint32_t used;
+    uint16_t units = 0U;
+    bool done;
+    do {
+        done = (*me->step)(me->ctx);
+        uint32_t const now = BSP_cycles();
+        if ((now - prev) > s->unitMax) {
+            s->unitMax = now - prev;
+        }
+        prev = now;
+        used = now - start;
+        ++units;
+    } while (!done && (units != 0xFFFFU)
+             && (used <= budget) && (s->unitMax <= (budget - used)));
+
+    WorkChunk_record_(s, units, used);
+    if (done) {
+        me->step = (WorkStepFn)0;
+        ++s->ops;
+    } else {
+        QACTIVE_POST(me->ao, &me->cont, me);    // FIFO: queued events first
+    }
+    return done;
+}
+
+void WorkChunk_cancel(WorkChunk * const me) {
+    me->step = (WorkStepFn)0;       // A queued continuation is absorbed
+}
+
+void WorkChunk_report(void) {
+    for (uint_fast8_t i = 0U; i < l_nChunk; ++i) {
+        WorkChunk const * const wc = l_chunk[i];
+        QF_CRIT_ENTRY(dummy);
+        WorkChunkStats const s = wc->stats;
+        QF_CRIT_EXIT(dummy);
+
+        QS_BEGIN_ID(RTC_PROF_QS_REC, wc->ao->prio)
+            QS_2U8_((uint8_t)RTC_PROF_QS_CHUNK, (uint8_t)wc->ao->prio);
+            QS_U16_(wc->cont.sig);
+            QS_U32_(s.ops);
+            QS_U32_(s.chunks);
+            QS_U32_(s.units);
+            QS_U16_(s.minUnits);
+            QS_U16_(s.maxUnits);
+            QS_U32_(s.maxCycles);
+            QS_U32_(s.unitMax);
+        QS_END_()
+    }
+}
+
+void WorkChunk_reset(void) {
+    for (uint_fast8_t i = 0U; i < l_nChunk; ++i) {
+        QF_CRIT_ENTRY(dummy);
+        l_chunk[i]->stats = (WorkChunkStats){ 0U };
+        QF_CRIT_EXIT(dummy);
+    }
+}
@@ -0,0 +1,159 @@
+/**
+ * @file work_chunk.h
+ * @brief Chunked (Resumable) Work for Long Operations
+ * @version 1.0.0
+ * @date 2026-10-14
+ *
+ * Splits a long computation (checksum, filter pass, flash write) into RTC
+ * steps that each fit a cycle budget. The operation is a step function
+ * that does one small unit of work per call and returns true when
+ * finished. WorkChunk_run() calls it until the next unit would overrun
+ * the budget, then self-posts a static continuation event and returns.
+ * Events that arrived meanwhile are dispatched first, and higher-priority
+ * AOs preempt between chunks as usual. No QXK thread is needed.
+ *
+ * The continuation signal is an ordinary AO signal, so the RTC profiler
+ * shows the cycle distribution of the chunks under that signal. The unit
+ * counts per chunk are reported as RTC_PROF_QS_CHUNK records.
+ */
+
+#ifndef WORK_CHUNK_H
+#define WORK_CHUNK_H
+
+#include "qpc.h"
+#include "rtc_profiler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//============================================================================
+// CONFIGURATION
+//============================================================================
+
+#ifndef WORK_CHUNK_MAX
+#define WORK_CHUNK_MAX          8U      // WorkChunk objects that are reported
+#endif
+
+//============================================================================
+// TYPES
+//============================================================================
+
+/**
+ * @brief Do one unit of work
+ *
+ * @param ctx Operation state passed to WorkChunk_start()
+ * @return true when the operation is finished
+ */
+typedef bool (*WorkStepFn)(void * const ctx);
+
+/**
+ * @brief Counters of one WorkChunk, times in BSP_cycles() units
+ */
+typedef struct {
+    uint32_t ops;               /**< Operations finished */
+    uint32_t chunks;            /**< RTC steps run */
+    uint32_t units;             /**< Step function calls */
+    uint16_t minUnits;          /**< Fewest units in one chunk */
+    uint16_t maxUnits;          /**< Most units in one chunk */
+    uint32_t maxCycles;         /**< Longest chunk */
+    uint32_t unitMax;           /**< Longest unit (sizes the chunks) */
+} WorkChunkStats;
+
+/**
+ * @brief Resumable operation owned by one Active Object
+ */
+typedef struct {
+    QEvt cont;                  /**< Static continuation event */
+    QActive *ao;                /**< AO that runs the chunks */
+    WorkStepFn step;            /**< NULL = no operation */
+    void *ctx;
+    uint32_t budgetUs;          /**< Time budget per chunk, in us */
+    WorkChunkStats stats;
+} WorkChunk;
+
+//============================================================================
+// PUBLIC INTERFACE
+//============================================================================
+
+/**
+ * @brief Initialize the service (before the first WorkChunk_run())
+ *
+ * @param cyclesPerUs BSP_cycles() ticks per microsecond
+ */
+void WorkChunk_init(uint32_t cyclesPerUs);
+
+/**
+ * @brief Bind a WorkChunk to the AO that runs it
+ *
+ * The AO is usually the owner itself. A long operation that should not
+ * delay the owner's other events can be bound to a low-priority worker
+ * AO instead. The owner then posts requests to the worker, and the
+ * worker calls WorkChunk_start()/WorkChunk_run(). All calls for one
+ * WorkChunk come from the AO it is bound to.
+ *
+ * @param me       WorkChunk (normally a member of the AO)
+ * @param ao       AO whose queue receives the continuation events
+ * @param sig      Continuation signal, handled with WorkChunk_run()
+ * @param budgetUs Time per chunk, e.g. half of the AO's MAX_RTC_TIME_US
+ */
+void WorkChunk_ctor(WorkChunk * const me, QActive * const ao,
+                    enum_t const sig, uint32_t const budgetUs);
+
+/**
+ * @brief Start an operation (none may be in progress)
+ *
+ * Posts the first continuation event, unless one from a cancelled
+ * operation is still queued. The work starts in a later RTC step, not
+ * inside this call.
+ */
+void WorkChunk_start(WorkChunk * const me, WorkStepFn const step,
+                     void * const ctx);
+
+/**
+ * @brief Run one chunk (call on the continuation signal)
+ *
+ * Runs at least one unit. A continuation event that arrives after
+ * WorkChunk_cancel() is absorbed here, so the signal may be handled in a
+ * superstate without checking WorkChunk_busy() first. States that do
+ * not handle it may drop it; WorkChunk_start() then posts a new one.
+ *
+ * @return true if the operation finished in this chunk
+ */
+bool WorkChunk_run(WorkChunk * const me);
+
+/**
+ * @brief Abandon the operation (e.g. on exit from the state running it)
+ */
+void WorkChunk_cancel(WorkChunk * const me);
+
+/**
+ * @brief true while an operation is in progress
+ */
+static inline bool WorkChunk_busy(WorkChunk const * const me) {
+    return me->step != (WorkStepFn)0;
+}
+
+/**
+ * @brief Emit the counters of all WorkChunks as RTC_PROF_QS_CHUNK records
+ */
+void WorkChunk_report(void);
+
+/**
+ * @brief Clear all counters (the unit estimate starts over)
+ */
+void WorkChunk_reset(void);
+
+//============================================================================
+// INTEGRATION MACROS
+//============================================================================
+
+#define WORK_CHUNK_INIT(cyclesPerUs_)   WorkChunk_init(cyclesPerUs_)
+#define WORK_CHUNK_REPORT()             WorkChunk_report()
+#define WORK_CHUNK_RESET()              WorkChunk_reset()
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WORK_CHUNK_H
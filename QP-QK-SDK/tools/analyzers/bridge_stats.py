@@ -0,0 +1,175 @@
+#!/usr/bin/env python3
+"""
+QP-QK SDK Event Bridge Statistics
+Per-link throughput and latency of the event bridge between QP nodes
+
+Resets the bridge counters of one node over QS-RX (templates/services/
+bridge.c), lets the link run, and reads the counters back: frames, events
+and bytes per second each way, events per frame (batching), the frame
+round trip measured from the echoed time stamps, the batching delay, and
+the loss counters (dropped, rejected, bad, lost frames, credit stalls).
+"""
+
+import sys
+import json
+import argparse
+from typing import Dict, List, Optional
+
+from qs_stream import QSSource, QS_USER, user_records
+
+BRIDGE_QS_REC = QS_USER + 16        # Must match bridge.h
+BRIDGE_QS_LINK = 1
+BRIDGE_CMD_REPORT = 17              # QS_onCommand() cases in main.c
+BRIDGE_CMD_RESET = 18
+
+COUNTERS = ['tx_frames', 'tx_events', 'tx_bytes',
+            'rx_frames', 'rx_events', 'rx_bytes',
+            'dropped', 'rejected', 'bad_frames', 'lost_frames',
+            'stalls', 'syncs',
+            'rtt_count', 'rtt_min_us', 'rtt_max_us', 'rtt_mean_us',
+            'batch_count', 'batch_max_us', 'batch_mean_us', 'rx_overruns']
+
+
+def parse_link(p) -> Dict:
+    link = {'link': p.u8(), 'prio': p.u8(), 'up': bool(p.u8()),
+            'credit': p.u8(), 'pending': p.u8(), 'window_us': p.u32()}
+    for key in COUNTERS:
+        link[key] = p.u32()
+    return link
+
+
+def summarize(link: Dict) -> Dict:
+    """Rates over the measurement window"""
+    window = link['window_us'] / 1e6 or 1.0
+    s = dict(link)
+    for way in ('tx', 'rx'):
+        s[f'{way}_frames_per_s'] = round(link[f'{way}_frames'] / window, 1)
+        s[f'{way}_events_per_s'] = round(link[f'{way}_events'] / window, 1)
+        s[f'{way}_bytes_per_s'] = round(link[f'{way}_bytes'] / window, 1)
+        frames = link[f'{way}_frames']
+        s[f'{way}_events_per_frame'] = (round(link[f'{way}_events'] / frames, 2)
+                                        if frames else 0.0)
+    return s
+
+
+def collect(source: QSSource, tstamp_size: int, duration: float) -> List[Dict]:
+    links: Dict[int, Dict] = {}
+    records = []
+    if source.is_live():
+        source.command(BRIDGE_CMD_RESET)
+        print(f"Measuring for {duration:.0f} s...")
+        for _ in user_records(source, BRIDGE_QS_REC, tstamp_size, duration):
+            pass
+        source.command(BRIDGE_CMD_REPORT)
+        records = user_records(source, BRIDGE_QS_REC, tstamp_size, 1.5)
+    else:
+        records = user_records(source, BRIDGE_QS_REC, tstamp_size)
+
+    for _, p in records:
+        try:
+            if p.u8() == BRIDGE_QS_LINK:
+                link = parse_link(p)
+                links[link['link']] = summarize(link)  # Last report wins
+        except ValueError:
+            continue
+
+    if source.decoder.bad_frames or source.decoder.lost_frames:
+        print(f"Warning: {source.decoder.bad_frames} bad and "
+              f"{source.decoder.lost_frames} lost QS frames")
+    return [links[n] for n in sorted(links)]
+
+
+def print_report(links: List[Dict]):
+    for s in links:
+        state = 'up' if s['up'] else 'DOWN'
+        print(f"\nLink {s['link']} (AO prio {s['prio']}, {state}, "
+              f"{s['window_us'] / 1e6:.1f} s, credit {s['credit']}, "
+              f"{s['pending']} frames pending):")
+        print(f"  {'':<8}{'frames/s':>12}{'events/s':>12}{'bytes/s':>12}"
+              f"{'events/frame':>14}")
+        for way in ('tx', 'rx'):
+            print(f"  {way.upper():<8}{s[f'{way}_frames_per_s']:>12.1f}"
+                  f"{s[f'{way}_events_per_s']:>12.1f}"
+                  f"{s[f'{way}_bytes_per_s']:>12.1f}"
+                  f"{s[f'{way}_events_per_frame']:>14.2f}")
+        if s['rtt_count']:
+            print(f"  Round trip: {s['rtt_min_us']} / {s['rtt_mean_us']} / "
+                  f"{s['rtt_max_us']} us min/mean/max "
+                  f"({s['rtt_count']} samples)")
+        if s['batch_count']:
+            print(f"  Batching delay: {s['batch_mean_us']} us mean, "
+                  f"{s['batch_max_us']} us max")
+        print(f"  Dropped {s['dropped']}, rejected {s['rejected']}, "
+              f"bad {s['bad_frames']}, lost {s['lost_frames']}, "
+              f"RX overruns {s['rx_overruns']}, stalls {s['stalls']}, "
+              f"syncs {s['syncs']}")
+
+
+def check_bounds(links: List[Dict], max_rtt_us: Optional[float]) -> List[str]:
+    failures = []
+    for s in links:
+        if not s['up']:
+            failures.append(f"link {s['link']} is down")
+        elif (max_rtt_us is not None and s['rtt_count']
+              and s['rtt_max_us'] > max_rtt_us):
+            failures.append(f"link {s['link']} round trip {s['rtt_max_us']} us "
+                            f"> {max_rtt_us:g} us")
+    return failures
+
+
+def main():
+    parser = argparse.ArgumentParser(description='QP-QK SDK Event Bridge Statistics')
+    parser.add_argument('--port', help='Serial port of the QS output')
+    parser.add_argument('--baud', type=int, default=921600,
+                       help='QS baud rate (default: 921600)')
+    parser.add_argument('--input', '-i',
+                       help='Raw QS capture file instead of a serial port')
+    parser.add_argument('--listen', type=int, metavar='TCP_PORT',
+                       help='Wait for a host build on this port '
+                            '(run it with --qs 127.0.0.1:TCP_PORT)')
+    parser.add_argument('--duration', '-d', type=float, default=10.0,
+                       help='Measurement time in seconds (default: 10)')
+    parser.add_argument('--tstamp-size', type=int, default=4,
+                       choices=[1, 2, 4, 8],
+                       help='QS_TSTAMP_SIZE of the target (default: 4)')
+    parser.add_argument('--max-rtt-us', type=float,
+                       help='Fail if the max round trip exceeds this')
+    parser.add_argument('--json', action='store_true',
+                       help='Print the results as JSON')
+
+    args = parser.parse_args()
+
+    try:
+        source = QSSource(args.port, args.baud, args.input, args.listen)
+        if args.listen is not None:
+            print(f"Waiting for the host build on port {source.tcp_port}...")
+            source.accept(timeout=30.0)
+    except (ValueError, RuntimeError, OSError) as e:
+        print(f"Error: {e}")
+        sys.exit(1)
+
+    try:
+        links = collect(source, args.tstamp_size, args.duration)
+    except KeyboardInterrupt:
+        links = []
+    finally:
+        source.close()
+
+    if not links:
+        print("No bridge records received "
+              "(is the firmware built with BRIDGE_ENABLE?)")
+        sys.exit(1)
+
+    failures = check_bounds(links, args.max_rtt_us)
+    if args.json:
+        print(json.dumps({'links': links, 'failures': failures}, indent=2))
+    else:
+        print_report(links)
+        for failure in failures:
+            print(f"FAIL: {failure}")
+
+    sys.exit(1 if failures else 0)
+
+
+if __name__ == '__main__':
+    main()
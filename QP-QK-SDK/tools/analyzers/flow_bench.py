@@ -0,0 +1,331 @@
+#!/usr/bin/env python3
+"""
+QP-QK SDK Event-Flow Benchmark
+Measures the event hot paths of a build and gates them against a budget
+
+Runs the event-flow benchmark of templates/services/flow_bench.c over
+QS-RX on the target, or launches a host (posix) build and acts as its
+QSPY, and reads back: events/s and time per event from post to dispatch,
+the publish call and the publish fan-out to all subscribers, the tick ISR
+time and the boot time. With --elf the code (text + data) and RAM (data +
+bss) size of the image are added. The results are written as stable JSON;
+--budget checks them against the stored baseline of the platform with
+per-metric tolerances and against absolute limits, and the exit code is 1
+on any violation so a CI pipeline fails on a regression.
+
+Budget file (JSON, one entry per platform label):
+    {"platforms": {"stm32f4": {
+        "baseline": "baseline_stm32f4.json",    relative to the budget file
+        "tolerance_pct": 10,                     default for all metrics
+        "tolerances": {"boot_ms": 25},           per metric, in percent
+        "limits": {"flash_bytes": 524288}}}}     absolute, worse side only
+"""
+
+import sys
+import json
+import argparse
+import subprocess
+from pathlib import Path
+from typing import Dict, List, Optional
+
+from qs_stream import QSSource, QS_USER, user_records
+from qk_bench import sdk_version
+
+BENCH_QS_REC = QS_USER + 19         # Must match bench_stats.h
+BENCH_QS_FLOW = 5
+FLOW_BENCH_CMD_RUN = 24             # QS_onCommand() case in main.c
+
+RESULTS_FORMAT = 'flow-bench/1'
+
+# Metrics checked against the baseline and limits: (key, unit, higher is worse)
+METRICS = [
+    ('events_per_s', '/s', False),
+    ('post_dispatch_us', 'us', True),
+    ('publish_call_us', 'us', True),
+    ('publish_fanout_us', 'us', True),
+    ('publish_per_sub_us', 'us', True),
+    ('tick_isr_mean_us', 'us', True),
+    ('tick_isr_max_us', 'us', True),
+    ('boot_ms', 'ms', True),
+    ('flash_bytes', 'B', True),
+    ('ram_bytes', 'B', True),
+]
+
+
+def parse_flow(p) -> Dict:
+    return {'sinks': p.u8(), 'burst': p.u16(), 'rounds': p.u32(),
+            'cycles_per_us': p.u32(), 'post_min': p.u32(),
+            'post_mean': p.u32(), 'post_max': p.u32(),
+            'pub_call_mean': p.u32(), 'pub_done_mean': p.u32(),
+            'pub_done_max': p.u32(), 'ticks': p.u32(),
+            'tick_mean': p.u32(), 'tick_max': p.u32(), 'boot': p.u32()}
+
+
+def collect(source: QSSource, tstamp_size: int, warmup: float,
+            rounds: int, timeout: float) -> Optional[Dict]:
+    """Warm up (the tick figures cover this window), run, read the report"""
+    records = user_records(source, BENCH_QS_REC, tstamp_size)
+    if source.is_live():
+        print(f"Warming up for {warmup:.1f} s...")
+        for _ in user_records(source, BENCH_QS_REC, tstamp_size, warmup):
+            pass
+        source.command(FLOW_BENCH_CMD_RUN, rounds)
+        print(f"Running {rounds or 'the default'} rounds...")
+        records = user_records(source, BENCH_QS_REC, tstamp_size, timeout)
+
+    flow = None
+    for _, p in records:
+        try:
+            if p.u8() == BENCH_QS_FLOW:
+                flow = parse_flow(p)
+                if source.is_live():
+                    break               # One run, one report
+        except ValueError:
+            continue
+
+    if source.decoder.bad_frames or source.decoder.lost_frames:
+        print(f"Warning: {source.decoder.bad_frames} bad and "
+              f"{source.decoder.lost_frames} lost QS frames")
+    return flow
+
+
+def image_size(elf: str, size_tool: str) -> Dict:
+    """Code and RAM size from the Berkeley output of size(1)"""
+    result = subprocess.run([size_tool, elf], capture_output=True, text=True)
+    if result.returncode != 0:
+        raise RuntimeError(f"{size_tool} {elf}: {result.stderr.strip()}")
+    text, data, bss = (int(v) for v in result.stdout.splitlines()[1].split()[:3])
+    return {'flash_bytes': text + data, 'ram_bytes': data + bss}
+
+
+def results(flow: Dict, sizes: Dict, platform: str) -> Dict:
+    """Results in the comparable format (times in us)"""
+    cpu = flow['cycles_per_us'] or 1
+    burst = flow['burst'] or 1
+    post_us = flow['post_mean'] / burst / cpu
+    fanout_us = flow['pub_done_mean'] / cpu
+    metrics = {
+        'events_per_s': round(1e6 / post_us, 1) if post_us else 0.0,
+        'post_dispatch_us': round(post_us, 3),
+        'post_dispatch_min_us': round(flow['post_min'] / burst / cpu, 3),
+        'post_dispatch_max_us': round(flow['post_max'] / burst / cpu, 3),
+        'publish_call_us': round(flow['pub_call_mean'] / cpu, 3),
+        'publish_fanout_us': round(fanout_us, 3),
+        'publish_fanout_max_us': round(flow['pub_done_max'] / cpu, 3),
+        'publish_per_sub_us': round(fanout_us / (flow['sinks'] or 1), 3),
+        'ticks': flow['ticks'],
+        'tick_isr_mean_us': round(flow['tick_mean'] / cpu, 3),
+        'tick_isr_max_us': round(flow['tick_max'] / cpu, 3),
+        'boot_ms': round(flow['boot'] / cpu / 1000.0, 3),
+    }
+    metrics.update(sizes)
+    return {
+        'format': RESULTS_FORMAT,
+        'platform': platform,
+        'sdk': sdk_version(),
+        'config': {'sinks': flow['sinks'], 'burst': flow['burst'],
+                   'rounds': flow['rounds'],
+                   'cycles_per_us': flow['cycles_per_us']},
+        'metrics': metrics,
+    }
+
+
+def print_report(r: Dict):
+    c, m = r['config'], r['metrics']
+    print(f"\nEvent-flow benchmark on {r['platform']} (SDK {r['sdk']}, "
+          f"{c['rounds']} rounds, {c['cycles_per_us']} cycles/us):")
+    print(f"  Post -> dispatch:   {m['events_per_s']:,.0f} events/s, "
+          f"{m['post_dispatch_us']:.3f} us/event "
+          f"(min {m['post_dispatch_min_us']:.3f}, "
+          f"max {m['post_dispatch_max_us']:.3f}; bursts of {c['burst']})")
+    print(f"  Publish to {c['sinks']}:       call {m['publish_call_us']:.3f} us, "
+          f"all handled {m['publish_fanout_us']:.3f} us "
+          f"(max {m['publish_fanout_max_us']:.3f}, "
+          f"{m['publish_per_sub_us']:.3f} us/subscriber)")
+    print(f"  Tick ISR:           mean {m['tick_isr_mean_us']:.3f} us, "
+          f"max {m['tick_isr_max_us']:.3f} us ({m['ticks']} ticks)")
+    print(f"  Boot:               {m['boot_ms']:.3f} ms "
+          f"(BSP_init() -> QF_onStartup())")
+    if 'flash_bytes' in m:
+        print(f"  Image:              {m['flash_bytes']:,} bytes code, "
+              f"{m['ram_bytes']:,} bytes RAM")
+
+
+def compare(base: Dict, cur: Dict, tolerance: float,
+            tolerances: Dict[str, float]) -> List[str]:
+    """Print metric changes against a baseline, return the regressions"""
+    regressions = []
+    if base.get('config') != cur.get('config'):
+        print(f"Warning: baseline config {base.get('config')} "
+              f"differs from {cur.get('config')}")
+    print(f"\nChanges since SDK {base.get('sdk', '?')} "
+          f"(tolerance {tolerance:g}%):")
+    for key, unit, worse_up in METRICS:
+        old, new = base['metrics'].get(key), cur['metrics'].get(key)
+        if old is None or new is None:
+            continue
+        tol = tolerances.get(key, tolerance)
+        delta = new - old
+        rel = (100.0 * delta / old) if old else (0.0 if not delta else 100.0)
+        flag = ''
+        if delta and (delta > 0) == worse_up and abs(rel) > tol:
+            flag = '  REGRESSION'
+            regressions.append(f"{key}: {old} -> {new} ({rel:+.1f}%, "
+                               f"tolerance {tol:g}%)")
+        print(f"  {key:<20} {old:>12} {new:>12} {unit:<3}{rel:+8.1f}%{flag}")
+    return regressions
+
+
+def check_limits(cur: Dict, limits: Dict[str, float]) -> List[str]:
+    failures = []
+    for key, unit, worse_up in METRICS:
+        limit, value = limits.get(key), cur['metrics'].get(key)
+        if limit is None or value is None:
+            continue
+        if (value > limit) if worse_up else (value < limit):
+            failures.append(f"{key} {value} {unit} "
+                            f"{'>' if worse_up else '<'} limit {limit} {unit}")
+    return failures
+
+
+def main():
+    parser = argparse.ArgumentParser(description='QP-QK SDK Event-Flow Benchmark')
+    parser.add_argument('--port', help='Serial port of the target QS output')
+    parser.add_argument('--baud', type=int, default=921600,
+                       help='QS baud rate (default: 921600)')
+    parser.add_argument('--host', metavar='ELF',
+                       help='Run this host (posix) build and collect its QS')
+    parser.add_argument('--input', '-i',
+                       help='Raw QS capture file instead of a live run')
+    parser.add_argument('--elf',
+                       help='Target image for the code and RAM size '
+                            '(default: the --host build)')
+    parser.add_argument('--size-tool',
+                       help='size(1) of the toolchain '
+                            '(default: size with --host, else arm-none-eabi-size)')
+    parser.add_argument('--platform',
+                       help='Platform label of the results and budget '
+                            '(default: posix with --host, else stm32f4)')
+    parser.add_argument('--rounds', type=int, default=0,
+                       help='Rounds of each measurement (default: FLOW_BENCH_ROUNDS)')
+    parser.add_argument('--warmup', type=float, default=1.0,
+                       help='Seconds before the run, tick figures cover them '
+                            '(default: 1)')
+    parser.add_argument('--timeout', type=float, default=5.0,
+                       help='Seconds to wait for the report (default: 5)')
+    parser.add_argument('--tstamp-size', type=int, default=4,
+                       choices=[1, 2, 4, 8],
+                       help='QS_TSTAMP_SIZE of the target (default: 4)')
+    parser.add_argument('--output', '-o',
+                       help='Write the results as JSON to this file')
+    parser.add_argument('--budget', metavar='JSON',
+                       help='Baseline, tolerances and limits per platform')
+    parser.add_argument('--compare', metavar='BASELINE',
+                       help='Results to compare against (default: the '
+                            'baseline of the budget)')
+    parser.add_argument('--tolerance', type=float,
+                       help='Allowed regression in percent '
+                            '(default: tolerance_pct of the budget, else 10)')
+    parser.add_argument('--write-baseline', action='store_true',
+                       help='Store the results as the baseline of the budget')
+    parser.add_argument('--json', action='store_true',
+                       help='Print the results as JSON')
+
+    args = parser.parse_args()
+    platform = args.platform or ('posix' if args.host else 'stm32f4')
+
+    try:
+        budget: Dict = {}
+        baseline_path = Path(args.compare) if args.compare else None
+        if args.budget:
+            with open(args.budget, 'r') as f:
+                budget = json.load(f).get('platforms', {}).get(platform)
+            if budget is None:
+                raise ValueError(f"{args.budget}: no budget for '{platform}'")
+            if baseline_path is None and budget.get('baseline'):
+                baseline_path = Path(args.budget).parent / budget['baseline']
+        if args.write_baseline and baseline_path is None:
+            raise ValueError("--write-baseline needs a baseline in the budget "
+                             "or --compare")
+        baseline = None
+        if baseline_path is not None and not args.write_baseline:
+            if baseline_path.exists():
+                with open(baseline_path, 'r') as f:
+                    baseline = json.load(f)
+                if baseline.get('format') != RESULTS_FORMAT:
+                    raise ValueError(f"{baseline_path}: not {RESULTS_FORMAT} results")
+            elif args.compare:
+                raise ValueError(f"{baseline_path}: no such file")
+            else:
+                print(f"Warning: no baseline {baseline_path} yet "
+                      f"(make bench-baseline), checking the limits only")
+        elf = args.elf or args.host
+        sizes = {}
+        if elf:
+            sizes = image_size(elf, args.size_tool
+                               or ('size' if args.host else 'arm-none-eabi-size'))
+        if args.host:
+            source = QSSource(tcp_listen=0)
+        else:
+            source = QSSource(args.port, args.baud, args.input)
+    except (ValueError, RuntimeError, OSError) as e:
+        print(f"Error: {e}")
+        sys.exit(1)
+
+    proc = None
+    flow = None
+    try:
+        if args.host:
+            run_time = args.warmup + args.timeout + 5.0
+            proc = subprocess.Popen([args.host, '--duration', f'{run_time:g}',
+                                     '--qs', f'127.0.0.1:{source.tcp_port}'])
+            source.accept()
+        flow = collect(source, args.tstamp_size, args.warmup, args.rounds,
+                       args.timeout)
+    except KeyboardInterrupt:
+        pass
+    except (RuntimeError, OSError) as e:
+        print(f"Error: {e}")
+        sys.exit(1)
+    finally:
+        source.close()
+        if proc is not None:
+            proc.terminate()
+            proc.wait()
+
+    if flow is None:
+        print("No event-flow benchmark record received "
+              "(is the firmware built with FLOW_BENCH_ENABLE?)")
+        sys.exit(1)
+    r = results(flow, sizes, platform)
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump(r, f, indent=2, sort_keys=True)
+            f.write('\n')
+
+    if args.json:
+        print(json.dumps(r, indent=2, sort_keys=True))
+    else:
+        print_report(r)
+
+    failures = []
+    if baseline is not None:
+        tolerance = args.tolerance if args.tolerance is not None \
+            else budget.get('tolerance_pct', 10.0)
+        failures = compare(baseline, r, tolerance, budget.get('tolerances', {}))
+    failures += check_limits(r, budget.get('limits', {}))
+    for failure in failures:
+        print(f"FAIL: {failure}")
+
+    if args.write_baseline and not failures:
+        with open(baseline_path, 'w') as f:
+            json.dump(r, f, indent=2, sort_keys=True)
+            f.write('\n')
+        print(f"Baseline written to {baseline_path}")
+
+    sys.exit(1 if failures else 0)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,291 @@
+#!/usr/bin/env python3
+"""
+QP-QK SDK Kernel Comparison Benchmark
+Builds one generated benchmark project for the QK and QV kernels and
+reports them side by side
+
+Each kernel gets its own build directory (build.py --kernel K --build-dir
+build/K). Flash, static RAM and the worst-case stack come from the build
+(size -A and the footprint analysis). Unless --no-run is given, each
+firmware is then flashed and measured with the scheduling benchmark
+(qk_bench.py): CPU utilization, context and AO switches, the response of
+the top priority AO to its tick release (the ISR -> AO latency) and the
+event throughput. The results of both kernels are written as one JSON file
+that --compare checks against an earlier run.
+"""
+
+import sys
+import json
+import argparse
+import subprocess
+from pathlib import Path
+from typing import Dict, List, Optional
+
+from qs_stream import QSSource
+from qk_bench import SchedBench, compare as compare_bench, sdk_version
+
+TOOLS_DIR = Path(__file__).resolve().parents[1]
+BUILD_TOOL = TOOLS_DIR / 'builders' / 'build.py'
+FLASH_TOOL = TOOLS_DIR / 'deployers' / 'flash.py'
+
+RESULTS_FORMAT = 'qk-kernel-bench/1'
+KERNELS = ('qk', 'qv')
+
+# STM32F4 memory map: sections placed here are flash, .data is copied from it
+FLASH_BASE = 0x08000000
+FLASH_END = 0x10000000
+
+# Metrics compared by --compare: (key, unit, higher is worse)
+FOOTPRINT_METRICS = [
+    ('flash_bytes', 'B', True),
+    ('ram_bytes', 'B', True),
+    ('stack_bytes', 'B', True),
+]
+
+
+def flash_size(size_report: Path) -> Optional[int]:
+    """Flash use from a 'size -A' report (code, constants, .data image)"""
+    if not size_report.exists():
+        return None
+    total = 0
+    for line in size_report.read_text().splitlines():
+        fields = line.split()
+        if len(fields) != 3 or not fields[0].startswith('.'):
+            continue
+        try:
+            size, addr = int(fields[1]), int(fields[2])
+        except ValueError:
+            continue
+        if (FLASH_BASE <= addr < FLASH_END) or fields[0] == '.data':
+            total += size
+    return total
+
+
+def footprint(build_dir: Path) -> Dict:
+    """Sizes of one kernel's build"""
+    result = {'flash_bytes': flash_size(build_dir / 'size_report.txt'),
+              'ram_bytes': None, 'stack_bytes': None}
+    report = build_dir / 'footprint_report.json'
+    if report.exists():
+        with open(report, 'r') as f:
+            data = json.load(f)
+        result['ram_bytes'] = data.get('ram', {}).get('total')
+        result['stack_bytes'] = data.get('stack', {}).get('total')
+    return result
+
+
+class KernelBench:
+    """Builds, flashes and measures one kernel variant"""
+
+    def __init__(self, project: Path, kernel: str, args):
+        self.project = project
+        self.kernel = kernel
+        self.args = args
+        self.build_dir = project / 'build' / kernel
+
+    def build(self):
+        print(f"\n=== Building for {self.kernel.upper()} ===")
+        cmd = [sys.executable, str(BUILD_TOOL), '-p', str(self.project),
+               '--kernel', self.kernel, '--build-dir', str(self.build_dir)]
+        if self.args.clean:
+            cmd.append('--clean')
+        if subprocess.run(cmd).returncode != 0:
+            raise RuntimeError(f"{self.kernel.upper()} build failed")
+
+    def flash(self):
+        images = sorted(self.build_dir.glob('*.bin'))
+        if not images:
+            raise RuntimeError(f"No firmware image in {self.build_dir}")
+        print(f"\n=== Flashing the {self.kernel.upper()} build ===")
+        cmd = [sys.executable, str(FLASH_TOOL), '-p', str(self.project),
+               '-f', str(images[0]), '-i', self.args.interface]
+        if subprocess.run(cmd).returncode != 0:
+            raise RuntimeError(f"Flashing the {self.kernel.upper()} build failed")
+
+    def measure(self, scenario: Dict) -> Dict:
+        """One scheduling benchmark window on the freshly flashed target"""
+        source = QSSource(self.args.port, self.args.baud, None)
+        bench = SchedBench(scenario)
+        try:
+            bench.collect(source, self.args.tstamp_size,
+                          self.args.warmup, self.args.duration)
+        finally:
+            source.close()
+        results = bench.results(f'stm32f4-{self.kernel}')
+        if results is None:
+            raise RuntimeError(f"No benchmark records from the "
+                               f"{self.kernel.upper()} build")
+        return results
+
+
+def throughput(bench: Dict) -> float:
+    """Events dispatched per second by all benchmark AOs"""
+    window = bench['summary']['window_s'] or 1.0
+    return round(sum(a.get('received', 0) for a in bench['aos']) / window, 1)
+
+
+def top_ao(bench: Dict) -> Optional[Dict]:
+    return max(bench['aos'], key=lambda a: a['prio']) if bench['aos'] else None
+
+
+def print_report(r: Dict):
+    kernels = [k for k in KERNELS if k in r['kernels']]
+    print(f"\nKernel comparison '{r['scenario']}' (SDK {r['sdk']}):")
+    header = f"  {'':<28}" + ''.join(f"{k.upper():>14}" for k in kernels)
+    print(header)
+
+    def row(label, values, fmt='{}'):
+        cells = ''.join(f"{(fmt.format(v) if v is not None else 'n/a'):>14}"
+                        for v in values)
+        print(f"  {label:<28}{cells}")
+
+    fp = [r['kernels'][k]['footprint'] for k in kernels]
+    row('Flash (bytes)', [f['flash_bytes'] for f in fp])
+    row('Static RAM (bytes)', [f['ram_bytes'] for f in fp])
+    row('Worst-case stack (bytes)', [f['stack_bytes'] for f in fp])
+
+    benches = [r['kernels'][k].get('bench') for k in kernels]
+    if not any(benches):
+        return
+
+    def summary(key):
+        return [b['summary'][key] if b else None for b in benches]
+
+    def top(key):
+        return [(top_ao(b) or {}).get(key) if b else None for b in benches]
+
+    row('CPU utilization (%)', summary('cpu_util_pct'), '{:.2f}')
+    row('Context switches (/s)', summary('ctx_switches_per_s'), '{:.1f}')
+    row('AO switches (/s)', summary('ao_switches_per_s'), '{:.1f}')
+    row('Preemption depth', summary('max_preempt_depth'))
+    row('Tick -> top AO mean (us)', top('resp_mean_us'), '{:.1f}')
+    row('Tick -> top AO max (us)', top('resp_max_us'), '{:.1f}')
+    row('Throughput (events/s)',
+        [throughput(b) if b else None for b in benches], '{:.1f}')
+    row('Deadline misses', summary('deadline_misses'))
+    names = {b and (top_ao(b) or {}).get('name') for b in benches} - {None}
+    if names:
+        print(f"\n  Top AO: {', '.join(sorted(names))}. QV runs each handler to "
+              f"completion: no context\n  switches, and a release waits "
+              f"for the handler that is running.")
+
+
+def compare(base: Dict, cur: Dict, tolerance: float) -> List[str]:
+    """Print changes per kernel against a baseline, return the regressions"""
+    regressions = []
+    for kernel in KERNELS:
+        old = base['kernels'].get(kernel)
+        new = cur['kernels'].get(kernel)
+        if old is None or new is None:
+            continue
+        print(f"\n{kernel.upper()} footprint since SDK {base.get('sdk', '?')} "
+              f"(tolerance {tolerance:g}%):")
+        for key, unit, worse_up in FOOTPRINT_METRICS:
+            a, b = old['footprint'].get(key), new['footprint'].get(key)
+            if a is None or b is None:
+                continue
+            rel = (100.0 * (b - a) / a) if a else (0.0 if a == b else 100.0)
+            flag = ''
+            if (b > a) == worse_up and b != a and abs(rel) > tolerance:
+                flag = '  REGRESSION'
+                regressions.append(f"{kernel} {key}: {a} -> {b} ({rel:+.1f}%)")
+            print(f"  {'system':<12} {key:<20} {a:>12} {b:>12} {unit:<3}"
+                  f"{rel:+8.1f}%{flag}")
+        if old.get('bench') and new.get('bench'):
+            regressions += [f"{kernel} {r}" for r in
+                            compare_bench(old['bench'], new['bench'], tolerance)]
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description='QP-QK SDK Kernel Comparison Benchmark')
+    parser.add_argument('--project', '-p', required=True,
+                       help='Benchmark project from tools/generators/bench_gen.py')
+    parser.add_argument('--kernels', default=','.join(KERNELS),
+                       help='Kernels to compare (default: qk,qv)')
+    parser.add_argument('--no-run', action='store_true',
+                       help='Only build and compare the sizes')
+    parser.add_argument('--clean', action='store_true',
+                       help='Clean each build directory first')
+    parser.add_argument('--port', help='Serial port of the target QS output')
+    parser.add_argument('--baud', type=int, default=921600,
+                       help='QS baud rate (default: 921600)')
+    parser.add_argument('--interface', '-i', default='stlink',
+                       help='Programming interface for flash.py (default: stlink)')
+    parser.add_argument('--warmup', type=float, default=1.0,
+                       help='Seconds before the statistics are reset (default: 1)')
+    parser.add_argument('--duration', '-d', type=float, default=10.0,
+                       help='Measurement time per kernel in seconds (default: 10)')
+    parser.add_argument('--tstamp-size', type=int, default=4,
+                       choices=[1, 2, 4, 8],
+                       help='QS_TSTAMP_SIZE of the target (default: 4)')
+    parser.add_argument('--output', '-o',
+                       help='Write the results as JSON to this file')
+    parser.add_argument('--compare', metavar='BASELINE',
+                       help='Results of an earlier run to compare against')
+    parser.add_argument('--tolerance', type=float, default=10.0,
+                       help='Allowed regression in percent (default: 10)')
+
+    args = parser.parse_args()
+
+    try:
+        project = Path(args.project).resolve()
+        kernels = [k.strip() for k in args.kernels.split(',') if k.strip()]
+        unknown = [k for k in kernels if k not in KERNELS]
+        if unknown or not kernels:
+            raise ValueError(f"Unsupported kernels {unknown} "
+                             f"(supported: {', '.join(KERNELS)})")
+        scenario_file = project / 'bench_scenario.json'
+        with open(scenario_file, 'r') as f:
+            scenario = json.load(f)
+        if not args.no_run and not args.port:
+            raise ValueError("--port is required unless --no-run is given")
+        baseline = None
+        if args.compare:
+            with open(args.compare, 'r') as f:
+                baseline = json.load(f)
+            if baseline.get('format') != RESULTS_FORMAT:
+                raise ValueError(f"{args.compare}: not {RESULTS_FORMAT} results")
+    except (ValueError, OSError) as e:
+        print(f"Error: {e}")
+        sys.exit(1)
+
+    results = {
+        'format': RESULTS_FORMAT,
+        'scenario': scenario.get('name', 'unknown'),
+        'sdk': sdk_version(),
+        'kernels': {},
+    }
+    try:
+        for kernel in kernels:
+            kb = KernelBench(project, kernel, args)
+            kb.build()
+            entry = {'footprint': footprint(kb.build_dir), 'bench': None}
+            if not args.no_run:
+                kb.flash()
+                entry['bench'] = kb.measure(scenario)
+            results['kernels'][kernel] = entry
+    except KeyboardInterrupt:
+        sys.exit(1)
+    except (RuntimeError, OSError) as e:
+        print(f"Error: {e}")
+        sys.exit(1)
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump(results, f, indent=2, sort_keys=True)
+            f.write('\n')
+
+    print_report(results)
+
+    regressions = []
+    if baseline is not None:
+        regressions = compare(baseline, results, args.tolerance)
+        for r in regressions:
+            print(f"FAIL: {r}")
+
+    sys.exit(1 if regressions else 0)
+
+
+if __name__ == '__main__':
+    main()
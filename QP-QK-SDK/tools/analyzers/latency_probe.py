@@ -0,0 +1,246 @@
+#!/usr/bin/env python3
+"""
+QP-QK SDK Latency Probe
+Measures interrupt and ISR-to-AO dispatch latency distributions under load
+
+Drives the latency probe service (templates/services/latency_probe.c) over
+QS-RX: configures the background load AOs, starts the target's loopback
+edge generator, and after the run reads back the on-target histograms.
+Prints p50/p90/p99/p99.9/max per channel and stage, and can fail the run
+against a latency bound for hard real-time certification.
+"""
+
+import sys
+import json
+import argparse
+from typing import Dict, List, Optional, Tuple
+
+from qs_stream import QSSource, QS_USER, user_records
+
+LAT_PROBE_QS_REC = QS_USER + 21     # Must match latency_probe.h
+LAT_PROBE_QS_STATS = 1
+LAT_PROBE_QS_LOAD = 2
+LAT_PROBE_CMD_REPORT = 9            # QS_onCommand() cases in main.c
+LAT_PROBE_CMD_RESET = 10
+LAT_PROBE_CMD_LOAD = 11
+LAT_PROBE_CMD_GEN = 12
+
+STAGE_NAMES = ['IRQ', 'DISPATCH', 'TOTAL']
+PERCENTILES = [50.0, 90.0, 99.0, 99.9]
+
+
+def bin_range(b: int, sub_bits: int) -> Tuple[int, int]:
+    """Cycle range [lo, hi] of log-linear histogram bin b"""
+    if b < (2 << sub_bits):
+        return b, b
+    shift = (b >> sub_bits) - 1
+    lo = ((1 << sub_bits) + (b & ((1 << sub_bits) - 1))) << shift
+    return lo, lo + (1 << shift) - 1
+
+
+def percentile(hist: Dict[int, int], q: float, sub_bits: int,
+               max_cycles: int) -> int:
+    """Conservative percentile: upper edge of the bin holding the q-th sample"""
+    total = sum(hist.values())
+    need = total * q / 100.0
+    seen = 0
+    for b in sorted(hist):
+        seen += hist[b]
+        if seen >= need:
+            return min(bin_range(b, sub_bits)[1], max_cycles)
+    return max_cycles
+
+
+def parse_load(spec: str) -> Tuple[int, int, int]:
+    """--load IDX:PERIOD_TICKS:BUSY_US"""
+    parts = spec.split(':')
+    if len(parts) != 3:
+        raise ValueError(f"Bad --load '{spec}' (expected IDX:PERIOD_TICKS:BUSY_US)")
+    return int(parts[0]), int(parts[1]), int(parts[2])
+
+
+class LatencyProbe:
+    """Runs a latency test and collects the probe's histogram records"""
+
+    def __init__(self, cycles_per_us: Optional[float] = None):
+        self.cycles_per_us = cycles_per_us
+        self.stats: Dict[Tuple[int, int], Dict] = {}
+        self.loads: List[Dict] = []
+
+    def collect(self, source: QSSource, tstamp_size: int, duration: float,
+                gen_us: int, loads: List[Tuple[int, int, int]]):
+        """Configure load and generator, run, stop, then request the report"""
+        if source.is_live():
+            source.command(LAT_PROBE_CMD_RESET)
+            for idx, period, busy in loads:
+                source.command(LAT_PROBE_CMD_LOAD, idx, period, busy)
+            if gen_us:
+                source.command(LAT_PROBE_CMD_GEN, gen_us)
+            load_text = ', '.join(f"AO{i}: {b} us every {p} ticks"
+                                  for i, p, b in loads) or 'none'
+            edges = f"edges every ~{gen_us} us" if gen_us else "external edges"
+            print(f"Measuring for {duration:.0f} s ({edges}, load {load_text})...")
+            self._consume(user_records(source, LAT_PROBE_QS_REC,
+                                       tstamp_size, duration))
+
+            # Quiesce before reading the histograms back
+            if gen_us:
+                source.command(LAT_PROBE_CMD_GEN, 0)
+            source.command(LAT_PROBE_CMD_REPORT, 0)
+            self._consume(user_records(source, LAT_PROBE_QS_REC,
+                                       tstamp_size, 1.5))
+            for idx, _, _ in loads:
+                source.command(LAT_PROBE_CMD_LOAD, idx, 0, 0)
+        else:
+            self._consume(user_records(source, LAT_PROBE_QS_REC, tstamp_size))
+
+        if source.decoder.bad_frames or source.decoder.lost_frames:
+            print(f"Warning: {source.decoder.bad_frames} bad and "
+                  f"{source.decoder.lost_frames} lost QS frames")
+
+    def _consume(self, records):
+        for _, p in records:
+            try:
+                kind, idx = p.u8(), p.u8()
+                if kind == LAT_PROBE_QS_STATS:
+                    stage, sub_bits = p.u8(), p.u8()
+                    s = {
+                        'channel': idx,
+                        'stage': STAGE_NAMES[stage] if stage < len(STAGE_NAMES)
+                                 else str(stage),
+                        'sub_bits': sub_bits,
+                        'cycles_per_us': p.u32(),
+                        'count': p.u32(),
+                        'min': p.u32(),
+                        'max': p.u32(),
+                        'mean': p.u32(),
+                        'lost': p.u32(),
+                        'unpaired': p.u32(),
+                    }
+                    s['hist'] = {}
+                    for _ in range(p.u8()):
+                        b = p.u8()
+                        s['hist'][b] = p.u16()
+                    self.stats[(idx, stage)] = s
+                elif kind == LAT_PROBE_QS_LOAD:
+                    self.loads.append({'load': idx, 'prio': p.u8(),
+                                       'period': p.u32(), 'busy_us': p.u32(),
+                                       'runs': p.u32()})
+            except ValueError:
+                continue
+
+    def results(self) -> List[Dict]:
+        """Per channel and stage: counts and latencies in cycles and us"""
+        result = []
+        for key in sorted(self.stats):
+            s = self.stats[key]
+            cpu = self.cycles_per_us or s['cycles_per_us'] or 1
+            r = {k: v for k, v in s.items() if k != 'hist'}
+            for q in PERCENTILES:
+                cycles = percentile(s['hist'], q, s['sub_bits'], s['max'])
+                r[f'p{q:g}'] = cycles
+            r['us'] = {k: round(r[k] / cpu, 3) for k in
+                       ['min', 'mean', 'max'] + [f'p{q:g}' for q in PERCENTILES]}
+            result.append(r)
+        return result
+
+    def print_report(self, results: List[Dict]):
+        print("\nLatency (us, percentiles are bin upper bounds):")
+        cols = ['min', 'p50', 'p90', 'p99', 'p99.9', 'max']
+        print(f"  {'Ch':<3} {'Stage':<9} {'Samples':>8} "
+              + ' '.join(f"{c:>8}" for c in cols) + f" {'Lost':>5}")
+        for r in results:
+            print(f"  {r['channel']:<3} {r['stage']:<9} {r['count']:>8} "
+                  + ' '.join(f"{r['us'][c]:>8.2f}" for c in cols)
+                  + f" {r['lost']:>5}")
+        for load in self.loads:
+            print(f"  Load AO{load['load']} (prio {load['prio']}): "
+                  f"{load['busy_us']} us every {load['period']} ticks, "
+                  f"{load['runs']} bursts")
+
+
+def check_bounds(results: List[Dict], max_us: Optional[float],
+                 p99_us: Optional[float]) -> List[str]:
+    """Violations of the bounds on each channel's end-to-end stage"""
+    failures = []
+    for ch in sorted({r['channel'] for r in results}):
+        stages = {r['stage']: r for r in results if r['channel'] == ch}
+        r = stages.get('TOTAL') or stages.get('DISPATCH')
+        if r is None:
+            continue
+        if max_us is not None and r['us']['max'] > max_us:
+            failures.append(f"ch {ch} {r['stage']} max {r['us']['max']:.2f} us "
+                            f"> {max_us} us")
+        if p99_us is not None and r['us']['p99'] > p99_us:
+            failures.append(f"ch {ch} {r['stage']} p99 {r['us']['p99']:.2f} us "
+                            f"> {p99_us} us")
+        if r['lost']:
+            failures.append(f"ch {ch}: {r['lost']} samples lost (FIFO full)")
+    return failures
+
+
+def main():
+    parser = argparse.ArgumentParser(description='QP-QK SDK Latency Probe')
+    parser.add_argument('--port', help='Serial port of the QS output')
+    parser.add_argument('--baud', type=int, default=921600,
+                       help='QS baud rate (default: 921600)')
+    parser.add_argument('--input', '-i',
+                       help='Raw QS capture file instead of a serial port')
+    parser.add_argument('--duration', '-d', type=float, default=10.0,
+                       help='Measurement time in seconds (default: 10)')
+    parser.add_argument('--tstamp-size', type=int, default=4,
+                       choices=[1, 2, 4, 8],
+                       help='QS_TSTAMP_SIZE of the target (default: 4)')
+    parser.add_argument('--gen', type=int, default=0, metavar='US',
+                       help='Start the loopback edge generator with this mean '
+                            'interval (default: off, measure external edges)')
+    parser.add_argument('--load', action='append', default=[],
+                       metavar='IDX:PERIOD:BUSY',
+                       help='Load AO IDX busy-waits BUSY us every PERIOD ticks '
+                            '(repeatable)')
+    parser.add_argument('--cycles-per-us', type=float,
+                       help='CPU cycles per us (default: reported by the target)')
+    parser.add_argument('--max-us', type=float,
+                       help='Fail if the end-to-end max latency exceeds this')
+    parser.add_argument('--p99-us', type=float,
+                       help='Fail if the end-to-end p99 latency exceeds this')
+    parser.add_argument('--json', action='store_true',
+                       help='Print the results as JSON')
+
+    args = parser.parse_args()
+
+    try:
+        loads = [parse_load(spec) for spec in args.load]
+        source = QSSource(args.port, args.baud, args.input)
+    except (ValueError, RuntimeError, OSError) as e:
+        print(f"Error: {e}")
+        sys.exit(1)
+
+    probe = LatencyProbe(args.cycles_per_us)
+    try:
+        probe.collect(source, args.tstamp_size, args.duration, args.gen, loads)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        source.close()
+
+    results = probe.results()
+    if not results:
+        print("No latency probe records received "
+              "(is the firmware built with LAT_PROBE_ENABLE?)")
+        sys.exit(1)
+
+    failures = check_bounds(results, args.max_us, args.p99_us)
+    if args.json:
+        print(json.dumps({'latency': results, 'loads': probe.loads,
+                          'failures': failures}, indent=2))
+    else:
+        probe.print_report(results)
+        for failure in failures:
+            print(f"FAIL: {failure}")
+
+    sys.exit(1 if failures else 0)
+
+
+if __name__ == '__main__':
+    main()
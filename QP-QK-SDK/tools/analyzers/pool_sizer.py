@@ -0,0 +1,207 @@
+#!/usr/bin/env python3
+"""
+QP-QK SDK Event Pool Sizer
+Recommends event pool sizes from live pool usage and writes them back
+
+Reads the pool monitor records (templates/services/pool_monitor.c) from a
+target over QS, computes the number of blocks each pool really needs, and
+optionally rewrites the *_EVENT_POOL_SIZE defines in the project
+configuration header.
+"""
+
+import sys
+import re
+import math
+import json
+import argparse
+from pathlib import Path
+from typing import Dict, List, Optional
+
+from qs_stream import QSSource, QS_USER, user_records
+
+POOL_MON_QS_REC = QS_USER + 23      # Must match pool_monitor.h
+POOL_MON_QS_STATS = 1
+POOL_MON_QS_EXHAUSTED = 2
+POOL_MON_CMD_REPORT = 6             # QS_onCommand() case for POOL_MON_REPORT()
+
+
+class PoolSizer:
+    """Collects pool monitor records and derives recommended pool sizes"""
+    
+    def __init__(self, names: List[str], margin: float):
+        self.names = names
+        self.margin = margin
+        self.stats: Dict[int, Dict] = {}
+        self.exhausted: List[Dict] = []
+    
+    def pool_name(self, pool_id: int) -> str:
+        if 1 <= pool_id <= len(self.names):
+            return self.names[pool_id - 1]
+        return f"POOL{pool_id}"
+    
+    def collect(self, source: QSSource, tstamp_size: int, duration: float):
+        """Observe the target, then ask it for a final report"""
+        if source.is_live():
+            print(f"Observing pool usage for {duration:.0f} s...")
+            self._consume(user_records(source, POOL_MON_QS_REC,
+                                       tstamp_size, duration))
+            source.command(POOL_MON_CMD_REPORT)
+            self._consume(user_records(source, POOL_MON_QS_REC,
+                                       tstamp_size, 1.0))
+        else:
+            self._consume(user_records(source, POOL_MON_QS_REC, tstamp_size))
+        
+        if source.decoder.bad_frames or source.decoder.lost_frames:
+            print(f"Warning: {source.decoder.bad_frames} bad and "
+                  f"{source.decoder.lost_frames} lost QS frames")
+    
+    def _consume(self, records):
+        for tstamp, p in records:
+            try:
+                kind, pool_id = p.u8(), p.u8()
+                if kind == POOL_MON_QS_STATS:
+                    self.stats[pool_id] = {
+                        'block_size': p.u16(),
+                        'n_tot': p.u16(),
+                        'n_min': p.u16(),
+                        'allocs': p.u32(),
+                        'failures': p.u32(),
+                        'peak_rate': p.u32(),
+                        'max_cycles': p.u32(),
+                    }
+                elif kind == POOL_MON_QS_EXHAUSTED:
+                    sig, evt_size, n = p.u16(), p.u16(), p.u16()
+                    owners = [p.u16() for _ in range(n)]
+                    self.exhausted.append({
+                        'time': tstamp, 'pool': pool_id, 'sig': sig,
+                        'evt_size': evt_size, 'owners': owners
+                    })
+            except ValueError:
+                continue
+    
+    def recommend(self) -> List[Dict]:
+        """Blocks needed per pool: peak use plus margin, more if it ran dry"""
+        result = []
+        for pool_id in sorted(self.stats):
+            s = self.stats[pool_id]
+            peak = s['n_tot'] - s['n_min']
+            if s['failures'] > 0:
+                # Real demand is unknown once the pool ran dry
+                size = max(s['n_tot'] + 1,
+                           math.ceil(s['n_tot'] * (1.0 + self.margin)))
+            else:
+                size = max(peak + 1, math.ceil(peak * (1.0 + self.margin)))
+            result.append({
+                'pool': pool_id,
+                'name': self.pool_name(pool_id),
+                'current': s['n_tot'],
+                'peak': peak,
+                'recommended': size,
+                'ram_delta': (size - s['n_tot']) * s['block_size'],
+                **s
+            })
+        return result
+    
+    def print_report(self, recs: List[Dict]):
+        print("\nEvent Pool Usage:")
+        print(f"  {'Pool':<8} {'Block':>6} {'Size':>5} {'Peak':>5} "
+              f"{'Fail':>5} {'Alloc/s':>8} {'MaxCyc':>7} {'New':>5} {'RAM':>7}")
+        for r in recs:
+            print(f"  {r['name']:<8} {r['block_size']:>6} {r['current']:>5} "
+                  f"{r['peak']:>5} {r['failures']:>5} {r['peak_rate']:>8} "
+                  f"{r['max_cycles']:>7} {r['recommended']:>5} "
+                  f"{r['ram_delta']:>+7}")
+        
+        total = sum(r['ram_delta'] for r in recs)
+        print(f"  Total RAM change: {total:+d} bytes")
+        
+        for ex in self.exhausted[:5]:
+            owners: Dict[int, int] = {}
+            for sig in ex['owners']:
+                owners[sig] = owners.get(sig, 0) + 1
+            held = ', '.join(f"sig {k} x{v}" for k, v in
+                             sorted(owners.items(), key=lambda kv: -kv[1]))
+            print(f"  {self.pool_name(ex['pool'])} exhausted by sig "
+                  f"{ex['sig']} at t={ex['time']}: held by {held}")
+
+
+def write_config(config_file: Path, recs: List[Dict]) -> bool:
+    """Rewrite <NAME>_EVENT_POOL_SIZE defines in the project header"""
+    text = config_file.read_text()
+    updated = text
+    for r in recs:
+        pattern = re.compile(
+            rf"(#define\s+{re.escape(r['name'])}_EVENT_POOL_SIZE\s+)(\d+)(U?)")
+        updated, n = pattern.subn(
+            lambda m: f"{m.group(1)}{r['recommended']}{m.group(3)}", updated)
+        if n == 0:
+            print(f"Warning: {r['name']}_EVENT_POOL_SIZE not found "
+                  f"in {config_file}")
+    
+    if updated != text:
+        config_file.write_text(updated)
+        print(f"Updated {config_file}")
+        return True
+    print(f"{config_file} already up to date")
+    return False
+
+
+def main():
+    parser = argparse.ArgumentParser(description='QP-QK SDK Event Pool Sizer')
+    parser.add_argument('--port', help='Serial port of the QS output')
+    parser.add_argument('--baud', type=int, default=921600,
+                       help='QS baud rate (default: 921600)')
+    parser.add_argument('--input', '-i',
+                       help='Raw QS capture file instead of a serial port')
+    parser.add_argument('--duration', '-d', type=float, default=10.0,
+                       help='Observation time in seconds (default: 10)')
+    parser.add_argument('--tstamp-size', type=int, default=4,
+                       choices=[1, 2, 4, 8],
+                       help='QS_TSTAMP_SIZE of the target (default: 4)')
+    parser.add_argument('--names', default='SMALL,MEDIUM,LARGE',
+                       help='Pool names in pool ID order (default: SMALL,MEDIUM,LARGE)')
+    parser.add_argument('--margin', type=float, default=25.0,
+                       help='Headroom over the observed peak in percent (default: 25)')
+    parser.add_argument('--config', '-c',
+                       help='Project config header with *_EVENT_POOL_SIZE')
+    parser.add_argument('--write', '-w', action='store_true',
+                       help='Write recommended sizes into --config')
+    parser.add_argument('--json', action='store_true',
+                       help='Print the recommendation as JSON')
+    
+    args = parser.parse_args()
+    
+    sizer = PoolSizer([n.strip() for n in args.names.split(',')],
+                      args.margin / 100.0)
+    try:
+        source = QSSource(args.port, args.baud, args.input)
+    except Exception as e:
+        print(f"Error opening QS source: {e}")
+        sys.exit(1)
+    
+    try:
+        sizer.collect(source, args.tstamp_size, args.duration)
+    finally:
+        source.close()
+    
+    recs = sizer.recommend()
+    if not recs:
+        print("No pool monitor records received "
+              "(is the firmware built with POOL_MON_ENABLE?)")
+        sys.exit(1)
+    
+    if args.json:
+        print(json.dumps({'pools': recs, 'exhausted': sizer.exhausted},
+                         indent=2))
+    else:
+        sizer.print_report(recs)
+    
+    if args.write:
+        if not args.config:
+            print("--write requires --config")
+            sys.exit(1)
+        write_config(Path(args.config), recs)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,477 @@
+#!/usr/bin/env python3
+"""
+QP-QK SDK Scheduling Benchmark
+Runs a benchmark built from tools/generators/bench_gen.py and reports it
+
+Drives the benchmark statistics service (templates/services/bench_stats.c)
+over QS-RX on the target, or launches a host (posix) build and acts as its
+QSPY. After a warm-up the statistics are reset, the schedule runs for the
+measurement time, and the results are read back: CPU utilization, context
+switches/s, preemption depth, stack peak, and per AO response times and
+deadline misses. Results are written as stable JSON so runs of the same
+scenario can be compared across SDK versions with --compare.
+"""
+
+import sys
+import json
+import time
+import argparse
+import subprocess
+from pathlib import Path
+from typing import Dict, List, Optional
+
+from qs_stream import QSSource, QS_USER, user_records
+
+BENCH_QS_REC = QS_USER + 19         # Must match bench_stats.h
+BENCH_QS_SUMMARY = 1
+BENCH_QS_AO = 2
+BENCH_QS_DSP = 3
+BENCH_QS_TIMER = 4
+BENCH_CMD_REPORT = 13               # QS_onCommand() cases in main.c
+BENCH_CMD_RESET = 14
+BENCH_CMD_DSP = 16
+BENCH_CMD_TIMER = 19
+
+RESULTS_FORMAT = 'qk-bench/1'
+
+# Metrics compared by --compare: (key, unit, higher is worse)
+SUMMARY_METRICS = [
+    ('cpu_util_pct', '%', True),
+    ('ctx_switches_per_s', '/s', True),
+    ('ao_switches_per_s', '/s', True),
+    ('max_preempt_depth', '', True),
+    ('stack_peak_bytes', 'B', True),
+    ('deadline_misses', '', True),
+]
+DSP_METRICS = [
+    ('block_cyc_per_smp', 'cyc', True),
+    ('sample_cyc_per_smp', 'cyc', True),
+]
+TIMER_METRICS = [
+    ('list_tick_mean_cyc', 'cyc', True),
+    ('wheel_tick_mean_cyc', 'cyc', True),
+    ('wheel_tick_max_cyc', 'cyc', True),
+]
+AO_METRICS = [
+    ('resp_mean_us', 'us', True),
+    ('resp_max_us', 'us', True),
+    ('deadline_misses', '', True),
+    ('releases', '', False),
+]
+
+
+def sdk_version() -> str:
+    """git describe of the SDK tree, to label results"""
+    try:
+        result = subprocess.run(['git', 'describe', '--always', '--dirty'],
+                                cwd=Path(__file__).resolve().parent,
+                                capture_output=True, text=True, timeout=5)
+        return result.stdout.strip() or 'unknown'
+    except (OSError, subprocess.SubprocessError):
+        return 'unknown'
+
+
+class SchedBench:
+    """Runs one measurement window and collects the benchmark records"""
+
+    def __init__(self, scenario: Optional[Dict] = None):
+        self.scenario = scenario or {}
+        self.summary: Optional[Dict] = None
+        self.aos: Dict[int, Dict] = {}
+        self.dsp: Optional[Dict] = None
+        self.timers: Optional[Dict] = None
+
+    def collect(self, source: QSSource, tstamp_size: int,
+                warmup: float, duration: float, dsp: bool = False,
+                timers: Optional[List[int]] = None):
+        """Warm up, reset, measure, then request the report"""
+        if source.is_live():
+            print(f"Warming up for {warmup:.1f} s...")
+            self._consume(user_records(source, BENCH_QS_REC,
+                                       tstamp_size, warmup))
+            source.command(BENCH_CMD_RESET)
+            print(f"Measuring for {duration:.1f} s...")
+            self._consume(user_records(source, BENCH_QS_REC,
+                                       tstamp_size, duration))
+            source.command(BENCH_CMD_REPORT)
+            if dsp:
+                source.command(BENCH_CMD_DSP)
+            self._consume(user_records(source, BENCH_QS_REC,
+                                       tstamp_size, 1.5))
+            if timers:
+                # Runs in the tick ISR over the window (default 1000 ticks)
+                source.command(BENCH_CMD_TIMER, timers[0], timers[1])
+                self._consume(user_records(source, BENCH_QS_REC, tstamp_size,
+                                           2.5 + (timers[1] or 1000) / 1000.0))
+        else:
+            self._consume(user_records(source, BENCH_QS_REC, tstamp_size))
+
+        if source.decoder.bad_frames or source.decoder.lost_frames:
+            print(f"Warning: {source.decoder.bad_frames} bad and "
+                  f"{source.decoder.lost_frames} lost QS frames")
+
+    def _consume(self, records):
+        for _, p in records:
+            try:
+                kind, n = p.u8(), p.u8()
+                if kind == BENCH_QS_SUMMARY:
+                    self.summary = {
+                        'aos': n,
+                        'max_depth': p.u8(),
+                        'cycles_per_us': p.u32(),
+                        'cycles_per_tick': p.u32(),
+                        'ticks': p.u32(),
+                        'busy_us': p.u32(),
+                        'ctx_sw': p.u32(),
+                        'ao_sw': p.u32(),
+                        'stack_peak': p.u32(),
+                    }
+                    self.aos = {}       # A new report replaces the last one
+                elif kind == BENCH_QS_AO:
+                    self.aos[n] = {
+                        'prio': p.u8(),
+                        'period_ticks': p.u32(),
+                        'deadline': p.u32(),
+                        'releases': p.u32(),
+                        'misses': p.u32(),
+                        'resp_max': p.u32(),
+                        'resp_mean': p.u32(),
+                        'received': p.u32(),
+                    }
+                elif kind == BENCH_QS_DSP:
+                    self.dsp = {
+                        'stages': n,
+                        'block_len': p.u16(),
+                        'cmsis': bool(p.u8()),
+                        'match': bool(p.u8()),
+                        'cycles_per_us': p.u32(),
+                        'block': p.u32(),
+                        'per_sample': p.u32(),
+                        'alloc': p.u32(),
+                        'peak_hz': p.u32(),
+                    }
+                elif kind == BENCH_QS_TIMER:
+                    self.timers = {
+                        'levels': n,
+                        'timers': p.u16(),
+                        'cycles_per_us': p.u32(),
+                        'ticks': p.u32(),
+                        'list_mean': p.u32(),
+                        'list_max': p.u32(),
+                        'wheel_mean': p.u32(),
+                        'wheel_max': p.u32(),
+                        'list_arm': p.u32(),
+                        'wheel_arm': p.u32(),
+                        'list_disarm': p.u32(),
+                        'wheel_disarm': p.u32(),
+                        'moved': p.u32(),
+                    }
+            except ValueError:
+                continue
+
+    def dsp_results(self) -> Optional[Dict]:
+        """Block vs per-sample cost, per sample and as a sample-rate limit"""
+        d = self.dsp
+        if d is None:
+            return None
+        n = d['block_len'] or 1
+        hz = d['cycles_per_us'] * 1e6
+
+        def per_sample(cycles):
+            return round(cycles / n, 2)
+
+        def max_rate(cycles):
+            return round(hz * n / cycles) if cycles else None
+
+        return {
+            'block_len': d['block_len'],
+            'biquad_stages': d['stages'],
+            'cmsis_dsp': d['cmsis'],
+            'results_match': d['match'],
+            'peak_hz': d['peak_hz'],
+            'block_cyc_per_smp': per_sample(d['block']),
+            'sample_cyc_per_smp': per_sample(d['per_sample']),
+            'alloc_cyc_per_smp': per_sample(d['alloc']),
+            'block_max_rate_hz': max_rate(d['block']),
+            'per_sample_max_rate_hz': max_rate(d['per_sample']),
+        }
+
+    def timer_results(self) -> Optional[Dict]:
+        """Time wheel vs QF list, per tick and per timer"""
+        t = self.timers
+        if t is None:
+            return None
+        cpu = t['cycles_per_us'] or 1
+        return {
+            'timers': t['timers'],
+            'ticks': t['ticks'],
+            'wheel_levels': t['levels'],
+            'list_tick_mean_cyc': t['list_mean'],
+            'list_tick_max_cyc': t['list_max'],
+            'wheel_tick_mean_cyc': t['wheel_mean'],
+            'wheel_tick_max_cyc': t['wheel_max'],
+            'list_tick_mean_us': round(t['list_mean'] / cpu, 3),
+            'wheel_tick_mean_us': round(t['wheel_mean'] / cpu, 3),
+            'list_arm_cyc': t['list_arm'],
+            'wheel_arm_cyc': t['wheel_arm'],
+            'list_disarm_cyc': t['list_disarm'],
+            'wheel_disarm_cyc': t['wheel_disarm'],
+            'wheel_moves_per_tick': round(t['moved'] / (t['ticks'] or 1), 3),
+        }
+
+    def results(self, platform: str) -> Optional[Dict]:
+        """Results in the comparable format (times in us)"""
+        s = self.summary
+        if s is None:
+            return None
+        cpu = s['cycles_per_us'] or 1
+        window_us = s['ticks'] * s['cycles_per_tick'] / cpu
+        window_s = window_us / 1e6 or 1.0
+        names = {a['idx']: a for a in self.scenario.get('aos', [])}
+
+        aos = []
+        for idx in sorted(self.aos):
+            a = self.aos[idx]
+            info = names.get(idx, {})
+            aos.append({
+                'idx': idx,
+                'name': info.get('name', f'AO{idx}'),
+                'prio': a['prio'],
+                'rate_hz': info.get('rate_hz'),
+                'releases': a['releases'],
+                'deadline_us': round(a['deadline'] / cpu, 3),
+                'deadline_misses': a['misses'],
+                'resp_mean_us': round(a['resp_mean'] / cpu, 3),
+                'resp_max_us': round(a['resp_max'] / cpu, 3),
+                'received': a['received'],
+            })
+
+        return {
+            'format': RESULTS_FORMAT,
+            'scenario': self.scenario.get('name', 'unknown'),
+            'platform': platform,
+            'sdk': sdk_version(),
+            'summary': {
+                'window_s': round(window_s, 3),
+                'cpu_util_pct': round(100.0 * s['busy_us'] / window_us, 2)
+                                if window_us else 0.0,
+                'ctx_switches_per_s': round(s['ctx_sw'] / window_s, 1),
+                'ao_switches_per_s': round(s['ao_sw'] / window_s, 1),
+                'max_preempt_depth': s['max_depth'],
+                'stack_peak_bytes': s['stack_peak'],
+                'releases': sum(a['releases'] for a in aos),
+                'deadline_misses': sum(a['deadline_misses'] for a in aos),
+            },
+            'aos': aos,
+            'dsp': self.dsp_results(),
+            'timers': self.timer_results(),
+        }
+
+
+def print_report(r: Dict):
+    s = r['summary']
+    print(f"\nScheduling benchmark '{r['scenario']}' on {r['platform']} "
+          f"(SDK {r['sdk']}, {s['window_s']:.1f} s):")
+    print(f"  CPU utilization:    {s['cpu_util_pct']:.2f}%")
+    print(f"  Context switches:   {s['ctx_switches_per_s']:.1f}/s "
+          f"(AO switches {s['ao_switches_per_s']:.1f}/s)")
+    print(f"  Preemption depth:   {s['max_preempt_depth']}")
+    print(f"  Stack peak:         "
+          + (f"{s['stack_peak_bytes']} bytes" if s['stack_peak_bytes'] else "n/a"))
+    print(f"  Deadline misses:    {s['deadline_misses']} of "
+          f"{s['releases']} releases")
+    print(f"\n  {'AO':<12} {'Prio':>4} {'Rate':>6} {'Releases':>9} "
+          f"{'Mean us':>9} {'Max us':>9} {'Deadline':>9} {'Misses':>7}")
+    for a in sorted(r['aos'], key=lambda a: -a['prio']):
+        rate = f"{a['rate_hz']}" if a['rate_hz'] is not None else '?'
+        print(f"  {a['name']:<12} {a['prio']:>4} {rate:>6} {a['releases']:>9} "
+              f"{a['resp_mean_us']:>9.1f} {a['resp_max_us']:>9.1f} "
+              f"{a['deadline_us']:>9.0f} {a['deadline_misses']:>7}")
+    d = r.get('dsp')
+    if d:
+        kernels = 'CMSIS-DSP' if d['cmsis_dsp'] else 'portable C'
+        print(f"\n  DSP pipeline ({kernels}, {d['block_len']} samples, "
+              f"{d['biquad_stages']} biquads"
+              + ("" if d['results_match'] else ", RESULTS DIFFER") + "):")
+        print(f"    Block path:       {d['block_cyc_per_smp']:>8.1f} "
+              f"cycles/sample (filter, stats, FFT), "
+              f"max {d['block_max_rate_hz'] or 0:,} samples/s")
+        print(f"    Per-sample path:  {d['sample_cyc_per_smp']:>8.1f} "
+              f"cycles/sample (filter, stats, event; "
+              f"{d['alloc_cyc_per_smp']:.1f} for the event), "
+              f"max {d['per_sample_max_rate_hz'] or 0:,} samples/s")
+    t = r.get('timers')
+    if t:
+        print(f"\n  Time events ({t['timers']} armed per backend, "
+              f"{t['ticks']} ticks, {t['wheel_levels']}-level wheel):")
+        print(f"    {'':<12}{'tick mean':>10}{'tick max':>10}"
+              f"{'arm':>8}{'disarm':>8}  cycles")
+        for way in ('list', 'wheel'):
+            print(f"    {'QF list' if way == 'list' else 'Time wheel':<12}"
+                  f"{t[f'{way}_tick_mean_cyc']:>10}{t[f'{way}_tick_max_cyc']:>10}"
+                  f"{t[f'{way}_arm_cyc']:>8}{t[f'{way}_disarm_cyc']:>8}")
+        print(f"    Wheel moves:  {t['wheel_moves_per_tick']:.3f} events/tick")
+
+
+def compare(base: Dict, cur: Dict, tolerance: float) -> List[str]:
+    """Print metric changes against a baseline, return the regressions"""
+    regressions = []
+
+    def check(label, key, unit, worse_up, old, new):
+        if old is None or new is None:
+            return
+        delta = new - old
+        rel = (100.0 * delta / old) if old else (0.0 if not delta else 100.0)
+        flag = ''
+        if delta and (delta > 0) == worse_up:
+            # Misses are counts: any new miss is a regression
+            if key == 'deadline_misses' or abs(rel) > tolerance:
+                flag = '  REGRESSION'
+                regressions.append(f"{label} {key}: {old} -> {new} "
+                                   f"({rel:+.1f}%)")
+        print(f"  {label:<12} {key:<20} {old:>12} {new:>12} {unit:<3}"
+              f"{rel:+8.1f}%{flag}")
+
+    if (base.get('scenario'), base.get('platform')) != \
+            (cur.get('scenario'), cur.get('platform')):
+        print(f"Warning: comparing {base.get('scenario')}/{base.get('platform')} "
+              f"with {cur.get('scenario')}/{cur.get('platform')}")
+    print(f"\nChanges since SDK {base.get('sdk', '?')} "
+          f"(tolerance {tolerance:g}%):")
+    for key, unit, worse_up in SUMMARY_METRICS:
+        check('system', key, unit, worse_up,
+              base['summary'].get(key), cur['summary'].get(key))
+    old_aos = {a['name']: a for a in base.get('aos', [])}
+    for a in cur['aos']:
+        old = old_aos.get(a['name'])
+        if old is None:
+            print(f"  {a['name']:<12} (not in the baseline)")
+            continue
+        for key, unit, worse_up in AO_METRICS:
+            check(a['name'], key, unit, worse_up, old.get(key), a.get(key))
+    if base.get('dsp') and cur.get('dsp'):
+        for key, unit, worse_up in DSP_METRICS:
+            check('dsp', key, unit, worse_up,
+                  base['dsp'].get(key), cur['dsp'].get(key))
+    if base.get('timers') and cur.get('timers'):
+        for key, unit, worse_up in TIMER_METRICS:
+            check('timers', key, unit, worse_up,
+                  base['timers'].get(key), cur['timers'].get(key))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description='QP-QK SDK Scheduling Benchmark')
+    parser.add_argument('--port', help='Serial port of the target QS output')
+    parser.add_argument('--baud', type=int, default=921600,
+                       help='QS baud rate (default: 921600)')
+    parser.add_argument('--host', metavar='ELF',
+                       help='Run this host (posix) build and collect its QS')
+    parser.add_argument('--input', '-i',
+                       help='Raw QS capture file instead of a live run')
+    parser.add_argument('--scenario',
+                       help='bench_scenario.json of the generated project '
+                            '(AO names and rates)')
+    parser.add_argument('--platform',
+                       help='Platform label of the results '
+                            '(default: posix with --host, else stm32f4)')
+    parser.add_argument('--warmup', type=float, default=1.0,
+                       help='Seconds before the statistics are reset (default: 1)')
+    parser.add_argument('--duration', '-d', type=float, default=10.0,
+                       help='Measurement time in seconds (default: 10)')
+    parser.add_argument('--tstamp-size', type=int, default=4,
+                       choices=[1, 2, 4, 8],
+                       help='QS_TSTAMP_SIZE of the target (default: 4)')
+    parser.add_argument('--output', '-o',
+                       help='Write the results as JSON to this file')
+    parser.add_argument('--compare', metavar='BASELINE',
+                       help='Results of an earlier run to compare against')
+    parser.add_argument('--tolerance', type=float, default=10.0,
+                       help='Allowed regression in percent (default: 10)')
+    parser.add_argument('--dsp', action='store_true',
+                       help='Also run the block DSP benchmark (DSP_BENCH_ENABLE)')
+    parser.add_argument('--timers', type=int, nargs='?', const=0, metavar='N',
+                       help='Also compare the time wheel with the QF list tick '
+                            'with N timers each (TIME_WHEEL_BENCH_ENABLE, '
+                            'default: TIME_WHEEL_BENCH_TIMERS)')
+    parser.add_argument('--timer-ticks', type=int, default=0,
+                       help='Ticks of the time event measurement '
+                            '(default: TIME_WHEEL_BENCH_TICKS)')
+    parser.add_argument('--json', action='store_true',
+                       help='Print the results as JSON')
+
+    args = parser.parse_args()
+
+    try:
+        scenario = None
+        if args.scenario:
+            with open(args.scenario, 'r') as f:
+                scenario = json.load(f)
+        baseline = None
+        if args.compare:
+            with open(args.compare, 'r') as f:
+                baseline = json.load(f)
+            if baseline.get('format') != RESULTS_FORMAT:
+                raise ValueError(f"{args.compare}: not {RESULTS_FORMAT} results")
+        if args.host:
+            source = QSSource(tcp_listen=0)
+        else:
+            source = QSSource(args.port, args.baud, args.input)
+    except (ValueError, RuntimeError, OSError) as e:
+        print(f"Error: {e}")
+        sys.exit(1)
+
+    proc = None
+    bench = SchedBench(scenario)
+    try:
+        if args.host:
+            run_time = args.warmup + args.duration + 5.0
+            if args.timers is not None:
+                run_time += 2.5 + (args.timer_ticks or 1000) / 1000.0
+            proc = subprocess.Popen([args.host, '--duration', f'{run_time:g}',
+                                     '--qs', f'127.0.0.1:{source.tcp_port}'])
+            source.accept()
+        timers = None
+        if args.timers is not None:
+            timers = [args.timers, args.timer_ticks]
+        bench.collect(source, args.tstamp_size, args.warmup, args.duration,
+                      args.dsp, timers)
+    except KeyboardInterrupt:
+        pass
+    except (RuntimeError, OSError) as e:
+        print(f"Error: {e}")
+        sys.exit(1)
+    finally:
+        source.close()
+        if proc is not None:
+            proc.terminate()
+            proc.wait()
+
+    platform = args.platform or ('posix' if args.host else 'stm32f4')
+    results = bench.results(platform)
+    if results is None:
+        print("No benchmark records received "
+              "(is the firmware built with BENCH_ENABLE?)")
+        sys.exit(1)
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump(results, f, indent=2, sort_keys=True)
+            f.write('\n')
+
+    if args.json:
+        print(json.dumps(results, indent=2, sort_keys=True))
+    else:
+        print_report(results)
+
+    regressions = []
+    if baseline is not None:
+        regressions = compare(baseline, results, args.tolerance)
+        for r in regressions:
+            print(f"FAIL: {r}")
+
+    sys.exit(1 if regressions else 0)
+
+
+if __name__ == '__main__':
+    main()
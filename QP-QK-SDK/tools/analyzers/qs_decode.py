@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+"""
+QP-QK SDK Compact QS Decoder
+Decodes traces of the compact QS mode and measures the bandwidth saved
+
+Resolves interned strings (templates/services/qs_compact.c), unrolls the
+16-bit record time stamps into absolute time using the target's SYNC
+records, and prints user records according to per-record field formats.
+With --stats it compares the bytes on the wire with what the same records
+would cost with inline strings and 32-bit time stamps.
+"""
+
+import sys
+import json
+import argparse
+from typing import Dict, List, Optional
+
+from qs_stream import (QSSource, QSPayload, QSStringDict, QSTimeUnroller,
+                       QS_USER, QS_COMPACT_QS_REC, QS_COMPACT_QS_STR_DEF,
+                       QS_COMPACT_QS_SYNC, QS_COMPACT_CMD_DUMP)
+
+QS_FRAME_OVERHEAD = 4       # seq, record ID, checksum, frame flag
+FULL_TSTAMP_SIZE = 4        # QS_TSTAMP_SIZE without the compact mode
+
+FIELD_SIZES = {'u8': 1, 'u16': 2, 'u32': 4, 'u64': 8}
+
+
+class QSCompactDecoder:
+    """Decodes compact QS user records into (time, rec_id, fields)"""
+
+    def __init__(self, formats: Dict[int, List[str]], tstamp_size: int):
+        self.formats = formats
+        self.tstamp_size = tstamp_size
+        self.strings = QSStringDict()
+        self.clock = QSTimeUnroller(tstamp_size)
+        self.records = 0
+        self.wire_bytes = 0
+        self.full_bytes = 0
+        self.first_time: Optional[int] = None
+        self.last_time: Optional[int] = None
+
+    def decode(self, rec_id: int, payload: bytes) -> Optional[Dict]:
+        """Decode one record, None for service and unformatted records"""
+        wire = len(payload) + QS_FRAME_OVERHEAD
+        self.wire_bytes += wire
+        if rec_id < QS_USER:
+            self.full_bytes += wire
+            return None
+
+        p = QSPayload(payload)
+        try:
+            tstamp = p.uint(self.tstamp_size)
+            if rec_id == QS_COMPACT_QS_REC:
+                self._service(p)
+                self.full_bytes += wire
+                return None
+            now = self.clock.unroll(tstamp)
+            fields, saved = self._fields(p, self.formats.get(rec_id))
+        except ValueError:
+            self.full_bytes += wire
+            return None
+
+        self.full_bytes += wire + saved + (FULL_TSTAMP_SIZE - self.tstamp_size)
+        self.records += 1
+        if self.first_time is None:
+            self.first_time = now
+        self.last_time = now
+        return {'time': now, 'rec': rec_id - QS_USER, 'fields': fields}
+
+    def _service(self, p: QSPayload):
+        sub_type = p.u8()
+        if sub_type == QS_COMPACT_QS_STR_DEF:
+            self.strings.learn(p)
+        elif sub_type == QS_COMPACT_QS_SYNC:
+            self.clock.sync(p.u32())
+
+    def _fields(self, p: QSPayload, fmt: Optional[List[str]]):
+        """Return (decoded fields, bytes an uncompressed trace would add)"""
+        if fmt is None:
+            return [p.data[p.pos:].hex()], 0
+
+        fields: List = []
+        saved = 0
+        for kind in fmt:
+            if kind == 's':
+                start = p.pos
+                text = self.strings.read(p)
+                saved += (len(text.encode('utf-8')) + 1) - (p.pos - start)
+                fields.append(text)
+            elif kind == 'str':
+                fields.append(p.str())
+            elif kind == 'ts':
+                fields.append(self.clock.unroll(p.uint(self.tstamp_size)))
+                saved += FULL_TSTAMP_SIZE - self.tstamp_size
+            else:
+                fields.append(p.uint(FIELD_SIZES[kind]))
+        return fields, saved
+
+    def print_stats(self):
+        print("\nCompact QS Trace Statistics")
+        print("=" * 40)
+        print(f"User records:     {self.records}")
+        print(f"Interned strings: {len(self.strings.strings)} "
+              f"({self.strings.unresolved} unresolved references)")
+        print(f"Wire bytes:       {self.wire_bytes}")
+        print(f"Uncompressed:     {self.full_bytes} (estimated)")
+        if self.wire_bytes:
+            print(f"Compression:      {self.full_bytes / self.wire_bytes:.2f}x")
+        if self.records and self.first_time is not None \
+                and self.last_time > self.first_time:
+            span = self.last_time - self.first_time
+            print(f"Trace span:       {span} time stamp units")
+
+
+def parse_formats(specs: List[str]) -> Dict[int, List[str]]:
+    """--format 0=s,u32 -> {QS_USER + 0: ['s', 'u32']}"""
+    formats: Dict[int, List[str]] = {}
+    for spec in specs:
+        rec, _, fields = spec.partition('=')
+        kinds = [f.strip() for f in fields.split(',') if f.strip()]
+        for kind in kinds:
+            if kind not in FIELD_SIZES and kind not in ('s', 'str', 'ts'):
+                raise ValueError(f"Unknown field type '{kind}' in '{spec}'")
+        formats[QS_USER + int(rec, 0)] = kinds
+    return formats
+
+
+def main():
+    parser = argparse.ArgumentParser(description='QP-QK SDK Compact QS Decoder')
+    parser.add_argument('--port', help='Serial port of the QS output')
+    parser.add_argument('--baud', type=int, default=921600,
+                       help='QS baud rate (default: 921600)')
+    parser.add_argument('--input', '-i',
+                       help='Raw QS capture file instead of a serial port')
+    parser.add_argument('--duration', '-d', type=float,
+                       help='Decode for this many seconds (default: until EOF/Ctrl-C)')
+    parser.add_argument('--tstamp-size', type=int, default=2,
+                       choices=[1, 2, 4],
+                       help='QS_TSTAMP_SIZE of the target (default: 2)')
+    parser.add_argument('--format', '-f', action='append', default=[],
+                       help='Fields of user record N: N=s,u32,... '
+                            '(s = QS_STR_ID_, str = QS_STR_, ts = QS_TIME_, u8..u64)')
+    parser.add_argument('--stats', action='store_true',
+                       help='Print bandwidth statistics at the end')
+    parser.add_argument('--json', action='store_true',
+                       help='Print one JSON object per record')
+
+    args = parser.parse_args()
+
+    try:
+        formats = parse_formats(args.format)
+        source = QSSource(args.port, args.baud, args.input)
+    except (ValueError, RuntimeError, OSError) as e:
+        print(f"Error: {e}")
+        sys.exit(1)
+
+    decoder = QSCompactDecoder(formats, args.tstamp_size)
+
+    # Ask a running target for the strings it interned before we attached
+    source.command(QS_COMPACT_CMD_DUMP)
+    try:
+        for rec_id, payload in source.records(args.duration):
+            rec = decoder.decode(rec_id, payload)
+            if rec is None:
+                continue
+            if args.json:
+                print(json.dumps(rec))
+            else:
+                fields = ' '.join(str(f) for f in rec['fields'])
+                print(f"{rec['time']:>12} USER+{rec['rec']:<3} {fields}")
+    except KeyboardInterrupt:
+        pass
+    finally:
+        source.close()
+
+    if source.decoder.bad_frames or source.decoder.lost_frames:
+        print(f"Warning: {source.decoder.bad_frames} bad and "
+              f"{source.decoder.lost_frames} lost QS frames")
+    if args.stats:
+        decoder.print_stats()
+
+
+if __name__ == "__main__":
+    main()
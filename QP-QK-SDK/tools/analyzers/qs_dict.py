@@ -0,0 +1,317 @@
+#!/usr/bin/env python3
+"""
+QP-QK SDK QS Dictionary Tables
+Host side of the const QS dictionaries (templates/services/qs_dict.h)
+
+Reads the <name>_qsDict tables from the firmware ELF (symbol table and
+section data, no toolchain needed) and writes their names as a sidecar
+file in the dictionaries format of qs_ingest.py, which qs_replay.py --dict
+and the qs_ingest.py store (dictionaries.json) load as they are. Every
+table gets the same FNV-1a hash the firmware computes, its build ID.
+
+With --port, --listen or --input the tool reads the QS_DICT_QS_REC
+records a QS_DICT_ROM_ENABLE target sends in place of its dictionaries
+(asking a live target to send them again) and checks every hash against
+the ELF or sidecar: a table the host does not know means the names are
+from another build.
+"""
+
+import sys
+import json
+import struct
+import argparse
+from pathlib import Path
+from typing import Dict, List
+
+from qs_stream import QSSource, QS_USER, user_records
+
+QS_DICT_QS_REC = QS_USER + 15       # Must match qs_dict.h
+QS_DICT_QS_TABLE = 1
+QS_DICT_CMD_RESEND = 20             # QS_onCommand() case in main.c
+
+KINDS = {1: 'obj', 2: 'sig', 3: 'fun', 4: 'usr'}   # QSDictKind
+TABLE_SUFFIX = '_qsDict'
+
+FNV_BASIS = 2166136261
+FNV_PRIME = 16777619
+
+SHT_SYMTAB = 2
+SHT_NOBITS = 8
+SHF_ALLOC = 0x2
+STT_OBJECT = 1
+ET_DYN = 3
+
+
+class ElfImage:
+    """Symbols and loaded section contents of an ELF32/ELF64 file"""
+
+    def __init__(self, path: Path):
+        self.data = path.read_bytes()
+        if self.data[:4] != b'\x7fELF':
+            raise ValueError(f"{path}: not an ELF file")
+        self.ptr_size = {1: 4, 2: 8}.get(self.data[4])
+        if self.ptr_size is None:
+            raise ValueError(f"{path}: unknown ELF class")
+        self.endian = '<' if self.data[5] == 1 else '>'
+        wide = self.ptr_size == 8
+        self.relocatable = self._unpack('H', 0x10)[0] == ET_DYN
+
+        if wide:
+            shoff, = self._unpack('Q', 0x28)
+            shentsize, shnum, shstrndx = self._unpack('HHH', 0x3A)
+            shdr = 'IIQQQQIIQQ'
+        else:
+            shoff, = self._unpack('I', 0x20)
+            shentsize, shnum, shstrndx = self._unpack('HHH', 0x2E)
+            shdr = 'IIIIIIIIII'
+        self.sections = []
+        for i in range(shnum):
+            (name, stype, flags, addr, offset, size,
+             link, _, _, entsize) = self._unpack(shdr, shoff + i * shentsize)
+            self.sections.append({'name': name, 'type': stype, 'flags': flags,
+                                  'addr': addr, 'offset': offset,
+                                  'size': size, 'link': link,
+                                  'entsize': entsize})
+        if shstrndx < len(self.sections):
+            names = self.sections[shstrndx]
+            for s in self.sections:
+                s['name'] = self._cstr(names['offset'] + s['name'])
+
+    def _unpack(self, fmt: str, offset: int):
+        return struct.unpack_from(self.endian + fmt, self.data, offset)
+
+    def _cstr(self, offset: int) -> str:
+        end = self.data.index(b'\0', offset)
+        return self.data[offset:end].decode('utf-8', errors='replace')
+
+    def symbols(self) -> List[Dict]:
+        """Data objects of the symbol table (locals included)"""
+        syms = []
+        for sec in self.sections:
+            if sec['type'] != SHT_SYMTAB:
+                continue
+            strtab = self.sections[sec['link']]
+            wide = self.ptr_size == 8
+            size = 24 if wide else 16
+            for off in range(sec['offset'], sec['offset'] + sec['size'], size):
+                if wide:
+                    name, info, _, shndx, value, st_size = self._unpack('IBBHQQ', off)
+                else:
+                    name, value, st_size, info, _, shndx = self._unpack('IIIBBH', off)
+                if (info & 0xF) == STT_OBJECT and name:
+                    syms.append({'name': self._cstr(strtab['offset'] + name),
+                                 'addr': value, 'size': st_size})
+        return syms
+
+    def read(self, addr: int, size: int) -> bytes:
+        """Initial contents at a linked address"""
+        for s in self.sections:
+            if ((s['flags'] & SHF_ALLOC) and s['type'] != SHT_NOBITS
+                    and s['addr'] <= addr and addr + size <= s['addr'] + s['size']):
+                off = s['offset'] + addr - s['addr']
+                return self.data[off:off + size]
+        raise ValueError(f"address 0x{addr:x} is not in a loaded section")
+
+    def read_str(self, addr: int) -> str:
+        for s in self.sections:
+            if ((s['flags'] & SHF_ALLOC) and s['type'] != SHT_NOBITS
+                    and s['addr'] <= addr < s['addr'] + s['size']):
+                return self._cstr(s['offset'] + addr - s['addr'])
+        raise ValueError(f"string at 0x{addr:x} is not in a loaded section")
+
+
+def fnv(h: int, value: int, n_bytes: int) -> int:
+    for _ in range(n_bytes):
+        h = ((h ^ (value & 0xFF)) * FNV_PRIME) & 0xFFFFFFFF
+        value >>= 8
+    return h
+
+
+def table_hash(entries: List[Dict], ptr_size: int) -> int:
+    """QSDict_hash() of qs_dict.c"""
+    h = FNV_BASIS
+    for e in entries:
+        h = fnv(h, e['kind'], 1)
+        h = fnv(h, e['id'], 2)
+        h = fnv(h, e['obj'], ptr_size)
+        h = fnv(h, e['fun'], ptr_size)
+        for b in e['name'].encode('utf-8') + b'\0':
+            h = fnv(h, b, 1)
+    return h
+
+
+def read_tables(elf: ElfImage) -> List[Dict]:
+    """All <name>_qsDict tables, in QSDictEntry layout"""
+    p = elf.ptr_size
+    ptr = 'I' if p == 4 else 'Q'
+    entry_size = (3 * p + 3 + p - 1) // p * p
+    tables = []
+    for sym in elf.symbols():
+        if not sym['name'].endswith(TABLE_SUFFIX) or not sym['size']:
+            continue
+        if sym['size'] % entry_size:
+            raise ValueError(f"{sym['name']}: size {sym['size']} is not a "
+                             f"multiple of QSDictEntry ({entry_size} bytes)")
+        raw = elf.read(sym['addr'], sym['size'])
+        entries = []
+        for off in range(0, len(raw), entry_size):
+            obj, fun, name = struct.unpack_from(elf.endian + ptr * 3, raw, off)
+            rec_id, kind = struct.unpack_from(elf.endian + 'HB', raw, off + 3 * p)
+            if kind not in KINDS or not name:
+                raise ValueError(f"{sym['name']}: bad entry at +{off}")
+            entries.append({'kind': kind, 'id': rec_id, 'obj': obj, 'fun': fun,
+                            'name': elf.read_str(name)})
+        tables.append({'symbol': sym['name'], 'addr': sym['addr'],
+                       'entries': entries,
+                       'hash': table_hash(entries, p)})
+    return sorted(tables, key=lambda t: t['addr'])
+
+
+def to_dictionaries(tables: List[Dict], ptr_size: int) -> Dict:
+    """Sidecar in QSDictionaries.to_json() form, plus the table hashes"""
+    out = {'obj': {}, 'fun': {}, 'sig': {}, 'usr': {}}
+    for t in tables:
+        for e in t['entries']:
+            kind = KINDS[e['kind']]
+            name = e['name'].lstrip('&')    # As QS_obj/fun_dict_pre_() send it
+            if kind == 'obj':
+                out['obj'][f"0x{e['obj']:x}"] = name
+            elif kind == 'fun':
+                out['fun'][f"0x{e['fun']:x}"] = name
+            elif kind == 'sig':
+                key = f"{e['id']}@{e['obj']:x}" if e['obj'] else str(e['id'])
+                out['sig'][key] = e['name']
+            else:
+                out['usr'][str(e['id'])] = e['name']
+    out['ptr_size'] = ptr_size
+    out['tables'] = [{'symbol': t['symbol'], 'entries': len(t['entries']),
+                      'hash': f"0x{t['hash']:08x}"} for t in tables]
+    return out
+
+
+def receive_tables(source: QSSource, tstamp_size: int,
+                   duration: float) -> List[Dict]:
+    """QS_DICT_QS_TABLE records of a QS_DICT_ROM_ENABLE target"""
+    if source.is_live():
+        source.command(QS_DICT_CMD_RESEND)
+    seen = []
+    for _, p in user_records(source, QS_DICT_QS_REC, tstamp_size,
+                             duration if source.is_live() else None):
+        try:
+            if p.u8() != QS_DICT_QS_TABLE:
+                continue
+            rec = {'ptr_size': p.u8(), 'entries': p.u16(), 'hash': p.u32()}
+        except ValueError:
+            continue
+        if rec not in seen:
+            seen.append(rec)
+    return seen
+
+
+def main():
+    parser = argparse.ArgumentParser(description='QP-QK SDK QS Dictionary Tables')
+    parser.add_argument('firmware', nargs='?',
+                       help='Firmware ELF with the *_qsDict tables')
+    parser.add_argument('--dict',
+                       help='Sidecar written earlier with -o (instead of the ELF)')
+    parser.add_argument('--output', '-o',
+                       help='Write the dictionaries as a sidecar JSON file')
+    parser.add_argument('--list', action='store_true',
+                       help='Print every entry of every table')
+    parser.add_argument('--port', help='Serial port of the QS output')
+    parser.add_argument('--baud', type=int, default=921600,
+                       help='QS baud rate (default: 921600)')
+    parser.add_argument('--input', '-i',
+                       help='Raw QS capture file instead of a serial port')
+    parser.add_argument('--listen', type=int, metavar='TCP_PORT',
+                       help='Wait for a host build on this port '
+                            '(run it with --qs 127.0.0.1:TCP_PORT)')
+    parser.add_argument('--duration', '-d', type=float, default=3.0,
+                       help='Time to wait for the table records (default: 3 s)')
+    parser.add_argument('--tstamp-size', type=int, default=4,
+                       choices=[1, 2, 4, 8],
+                       help='QS_TSTAMP_SIZE of the target (default: 4)')
+
+    args = parser.parse_args()
+    if bool(args.firmware) == bool(args.dict):
+        parser.error('give either the firmware ELF or --dict')
+
+    try:
+        if args.firmware:
+            elf = ElfImage(Path(args.firmware))
+            tables = read_tables(elf)
+            dicts = to_dictionaries(tables, elf.ptr_size)
+            if elf.relocatable:
+                print("Warning: position-independent executable, the run-time "
+                      "addresses and hashes differ (link with -no-pie)")
+        else:
+            with open(args.dict, 'r') as f:
+                dicts = json.load(f)
+            tables = []
+    except (ValueError, OSError, json.JSONDecodeError) as e:
+        print(f"Error: {e}")
+        sys.exit(1)
+
+    known = {int(t['hash'], 16): t for t in dicts.get('tables', [])}
+    if not known:
+        print("No QS dictionary tables found (is qs_dict.c linked and "
+              "the firmware built with Q_SPY?)")
+        sys.exit(1)
+
+    print(f"{len(known)} tables, {sum(t['entries'] for t in known.values())} "
+          f"entries ({dicts.get('ptr_size', '?')}-byte pointers):")
+    for h, t in known.items():
+        print(f"  {t['symbol']:<32}{t['entries']:>6} entries  0x{h:08x}")
+    if args.list:
+        for t in tables:
+            print(f"\n{t['symbol']}:")
+            for e in t['entries']:
+                kind = KINDS[e['kind']]
+                where = (f"0x{e['fun']:x}" if kind == 'fun' else
+                         f"0x{e['obj']:x}" if kind == 'obj' else str(e['id']))
+                print(f"  {kind:<4}{where:>14}  {e['name']}")
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump(dicts, f, indent=2, sort_keys=True)
+        print(f"Dictionaries written to {args.output}")
+
+    if not (args.port or args.input or args.listen is not None):
+        sys.exit(0)
+
+    try:
+        source = QSSource(args.port, args.baud, args.input, args.listen)
+        if args.listen is not None:
+            print(f"Waiting for the host build on port {source.tcp_port}...")
+            source.accept(timeout=30.0)
+    except (ValueError, RuntimeError, OSError) as e:
+        print(f"Error: {e}")
+        sys.exit(1)
+
+    try:
+        received = receive_tables(source, args.tstamp_size, args.duration)
+    except KeyboardInterrupt:
+        received = []
+    finally:
+        source.close()
+
+    if not received:
+        print("No QS dictionary table records received "
+              "(is the firmware built with QS_DICT_ROM_ENABLE?)")
+        sys.exit(1)
+
+    unknown = 0
+    print(f"\nTarget sent {len(received)} tables:")
+    for rec in received:
+        t = known.get(rec['hash'])
+        if t and t['entries'] == rec['entries']:
+            print(f"  0x{rec['hash']:08x}  {t['symbol']} ({rec['entries']} entries)")
+        else:
+            unknown += 1
+            print(f"  0x{rec['hash']:08x}  UNKNOWN ({rec['entries']} entries, "
+                  "not from this build)")
+    sys.exit(1 if unknown else 0)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,270 @@
+#!/usr/bin/env python3
+"""
+QP-QK SDK Per-AO QS Filters
+Sets the QS record groups of each Active Object and reports the trace cost
+
+Sends the per-AO filters of templates/services/qs_filter.c over QS-RX,
+resets its counters, lets the target run, and reads back per AO (and for
+the non-AO context: ISRs, idle, startup) the records and bytes put into
+the QS buffer. The target's own timing of QS records turns them into CPU
+cycles, and the byte rate is set against the link bandwidth. With
+--before the same window is measured first with the filters as they are,
+so the effect of a filter change shows as a before/after pair.
+
+Filter specs (--set, applied in order):
+    PRIO=GROUPS     PRIO: AO priority, 'all' (every AO and the non-AO
+                    context) or 'other' (the non-AO context)
+                    GROUPS: comma separated sm, ao, eq, mp, te, qf, sc,
+                    u0..u4, or 'all', 'none', 'global' (follow the global
+                    filter again), or a number; a leading '+' adds the
+                    groups, a leading '-' removes them
+
+    --set all=none --set 3=sm,u0    Trace only AO 3, state machine + U0
+    --set 2=+ao                     Add the AO records to AO 2
+    --set all=global                Back to the global filter everywhere
+"""
+
+import sys
+import json
+import argparse
+from typing import Dict, List, Optional, Tuple
+
+from qs_stream import QSSource, QS_USER, user_records
+
+RTC_PROF_QS_REC = QS_USER + 24      # Must match rtc_profiler.h
+RTC_PROF_QS_TRACE = 5
+QS_FILT_CMD_SET = 21                # QS_onCommand() cases in main.c
+QS_FILT_CMD_REPORT = 22
+QS_FILT_CMD_RESET = 23
+
+QS_FILT_OTHER = 0xFF                # Must match qs_filter.h
+QS_FILT_GLOBAL = 0xFFFF
+QS_FILT_ALL = 0x0FFF
+GROUPS = ['sm', 'ao', 'eq', 'mp', 'te', 'qf', 'sc',
+          'u0', 'u1', 'u2', 'u3', 'u4']
+OP_SET, OP_ADD, OP_REMOVE = 0, 1, 2
+
+
+def parse_spec(spec: str) -> Tuple[int, int, int]:
+    """'PRIO=GROUPS' -> (prio, group mask, op) for QS_FILT_CMD_SET"""
+    prio_s, sep, groups_s = spec.partition('=')
+    if not sep:
+        raise ValueError(f"Bad filter '{spec}' (expected PRIO=GROUPS)")
+    prio_s = prio_s.strip().lower()
+    if prio_s == 'all':
+        prio = 0
+    elif prio_s == 'other':
+        prio = QS_FILT_OTHER
+    elif prio_s.isdigit() and 1 <= int(prio_s) < QS_FILT_OTHER:
+        prio = int(prio_s)
+    else:
+        raise ValueError(f"Bad AO priority '{prio_s}' in '{spec}'")
+
+    groups_s = groups_s.strip().lower()
+    op = OP_SET
+    if groups_s[:1] in ('+', '-'):
+        op = OP_ADD if groups_s[0] == '+' else OP_REMOVE
+        groups_s = groups_s[1:]
+
+    mask = 0
+    for name in filter(None, (g.strip() for g in groups_s.split(','))):
+        if name in GROUPS:
+            mask |= 1 << GROUPS.index(name)
+        elif name == 'all':
+            mask |= QS_FILT_ALL
+        elif name == 'none':
+            pass
+        elif name == 'global' and op == OP_SET:
+            mask = QS_FILT_GLOBAL
+        else:
+            try:
+                mask |= int(name, 0) & QS_FILT_ALL
+            except ValueError:
+                raise ValueError(f"Unknown group '{name}' in '{spec}'")
+    return prio, mask, op
+
+
+def group_names(mask: int) -> str:
+    if mask == QS_FILT_GLOBAL:
+        return 'global'
+    if mask == QS_FILT_ALL:
+        return 'all'
+    names = [g for i, g in enumerate(GROUPS) if mask & (1 << i)]
+    return ','.join(names) if names else 'none'
+
+
+def parse_trace(p) -> Dict:
+    return {'prio': p.u8(), 'groups': p.u16(), 'steps': p.u32(),
+            'records': p.u32(), 'bytes': p.u32(), 'cycles': p.u32(),
+            'window_us': p.u32(), 'cycles_per_us': p.u16(),
+            'rec_cycles': p.u16(), 'byte_cycles16': p.u16()}
+
+
+def summarize(t: Dict, link_bytes_per_s: Optional[float]) -> Dict:
+    """Rates over the measurement window"""
+    window = t['window_us'] / 1e6 or 1.0
+    s = dict(t)
+    s['context'] = 'non-AO' if t['prio'] == 0 else f"AO {t['prio']}"
+    s['group_names'] = group_names(t['groups'])
+    s['records_per_s'] = round(t['records'] / window, 1)
+    s['bytes_per_s'] = round(t['bytes'] / window, 1)
+    s['bytes_per_record'] = (round(t['bytes'] / t['records'], 1)
+                             if t['records'] else 0.0)
+    s['cycles_per_step'] = (round(t['cycles'] / t['steps'], 1)
+                            if t['steps'] else 0.0)
+    cpu_cycles = t['window_us'] * t['cycles_per_us']
+    s['cpu_pct'] = round(100.0 * t['cycles'] / cpu_cycles, 3) if cpu_cycles else 0.0
+    s['link_pct'] = (round(100.0 * s['bytes_per_s'] / link_bytes_per_s, 2)
+                     if link_bytes_per_s else None)
+    return s
+
+
+def measure(source: QSSource, tstamp_size: int, duration: float,
+            link_bytes_per_s: Optional[float]) -> List[Dict]:
+    contexts: Dict[int, Dict] = {}
+    if source.is_live():
+        source.command(QS_FILT_CMD_RESET)
+        print(f"Measuring for {duration:.0f} s...")
+        for _ in user_records(source, RTC_PROF_QS_REC, tstamp_size, duration):
+            pass
+        source.command(QS_FILT_CMD_REPORT)
+        records = user_records(source, RTC_PROF_QS_REC, tstamp_size, 1.5)
+    else:
+        records = user_records(source, RTC_PROF_QS_REC, tstamp_size)
+
+    for _, p in records:
+        try:
+            if p.u8() == RTC_PROF_QS_TRACE:
+                t = parse_trace(p)
+                contexts[t['prio']] = summarize(t, link_bytes_per_s)  # Last wins
+        except ValueError:
+            continue
+    return [contexts[n] for n in sorted(contexts)]
+
+
+def totals(contexts: List[Dict]) -> Dict:
+    cpu = sum(c['cpu_pct'] for c in contexts)
+    link = [c['link_pct'] for c in contexts if c['link_pct'] is not None]
+    return {'records_per_s': round(sum(c['records_per_s'] for c in contexts), 1),
+            'bytes_per_s': round(sum(c['bytes_per_s'] for c in contexts), 1),
+            'cpu_pct': round(cpu, 3),
+            'link_pct': round(sum(link), 2) if link else None}
+
+
+def print_report(title: str, contexts: List[Dict]):
+    c0 = contexts[0]
+    print(f"\n{title} ({c0['window_us'] / 1e6:.1f} s, "
+          f"{c0['rec_cycles']} cycles/record + "
+          f"{c0['byte_cycles16'] / 16:.2f} cycles/byte):")
+    print(f"  {'Context':<9}{'Groups':<22}{'steps':>9}{'rec/s':>10}{'B/s':>11}"
+          f"{'cyc/step':>10}{'CPU %':>8}{'link %':>8}")
+    for c in contexts:
+        link = f"{c['link_pct']:>8.2f}" if c['link_pct'] is not None else f"{'-':>8}"
+        print(f"  {c['context']:<9}{c['group_names']:<22}{c['steps']:>9}"
+              f"{c['records_per_s']:>10.1f}{c['bytes_per_s']:>11.1f}"
+              f"{c['cycles_per_step']:>10.1f}{c['cpu_pct']:>8.3f}{link}")
+    t = totals(contexts)
+    link = f"{t['link_pct']:>8.2f}" if t['link_pct'] is not None else f"{'-':>8}"
+    print(f"  {'Total':<31}{'':>9}{t['records_per_s']:>10.1f}"
+          f"{t['bytes_per_s']:>11.1f}{'':>10}{t['cpu_pct']:>8.3f}{link}")
+
+
+def check_bounds(contexts: List[Dict], max_cpu: Optional[float],
+                 max_link: Optional[float]) -> List[str]:
+    failures = []
+    t = totals(contexts)
+    if max_cpu is not None and t['cpu_pct'] > max_cpu:
+        failures.append(f"trace CPU load {t['cpu_pct']:.3f}% > {max_cpu:g}%")
+    if (max_link is not None and t['link_pct'] is not None
+            and t['link_pct'] > max_link):
+        failures.append(f"trace link load {t['link_pct']:.2f}% > {max_link:g}%")
+    return failures
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='QP-QK SDK Per-AO QS Filters',
+        epilog='Filter specs: PRIO=GROUPS, see the module docstring')
+    parser.add_argument('--port', help='Serial port of the QS output')
+    parser.add_argument('--baud', type=int, default=921600,
+                       help='QS baud rate (default: 921600)')
+    parser.add_argument('--input', '-i',
+                       help='Raw QS capture file instead of a serial port')
+    parser.add_argument('--listen', type=int, metavar='TCP_PORT',
+                       help='Wait for a host build on this port '
+                            '(run it with --qs 127.0.0.1:TCP_PORT)')
+    parser.add_argument('--set', '-s', action='append', default=[],
+                       metavar='PRIO=GROUPS', dest='specs',
+                       help='Per-AO filter to apply (repeatable, in order)')
+    parser.add_argument('--before', action='store_true',
+                       help='Measure a window before applying --set as well')
+    parser.add_argument('--duration', '-d', type=float, default=10.0,
+                       help='Measurement time in seconds (default: 10)')
+    parser.add_argument('--tstamp-size', type=int, default=4,
+                       choices=[1, 2, 4, 8],
+                       help='QS_TSTAMP_SIZE of the target (default: 4)')
+    parser.add_argument('--max-cpu', type=float, metavar='PCT',
+                       help='Fail if tracing takes more CPU than this')
+    parser.add_argument('--max-link', type=float, metavar='PCT',
+                       help='Fail if tracing takes more of the UART than this')
+    parser.add_argument('--json', action='store_true',
+                       help='Print the results as JSON')
+
+    args = parser.parse_args()
+
+    try:
+        specs = [parse_spec(s) for s in args.specs]
+        source = QSSource(args.port, args.baud, args.input, args.listen)
+        if args.listen is not None:
+            print(f"Waiting for the host build on port {source.tcp_port}...")
+            source.accept(timeout=30.0)
+    except (ValueError, RuntimeError, OSError) as e:
+        print(f"Error: {e}")
+        sys.exit(1)
+
+    # 8N1 UART: 10 bits per byte (a host build has no link to run out of)
+    link_bytes_per_s = args.baud / 10.0 if source.serial else None
+
+    before: List[Dict] = []
+    after: List[Dict] = []
+    try:
+        if args.before and specs and source.is_live():
+            before = measure(source, args.tstamp_size, args.duration,
+                             link_bytes_per_s)
+        for prio, mask, op in specs:
+            source.command(QS_FILT_CMD_SET, prio, mask, op)
+        after = measure(source, args.tstamp_size, args.duration,
+                        link_bytes_per_s)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        source.close()
+
+    if not after:
+        print("No trace cost records received "
+              "(is the firmware built with QS_FILT_ENABLE?)")
+        sys.exit(1)
+
+    failures = check_bounds(after, args.max_cpu, args.max_link)
+    if args.json:
+        result = {'filters': args.specs, 'contexts': after,
+                  'total': totals(after), 'failures': failures}
+        if before:
+            result['before'] = {'contexts': before, 'total': totals(before)}
+        print(json.dumps(result, indent=2))
+    else:
+        if before:
+            print_report('Before', before)
+        print_report('With filters' if specs else 'Current filters', after)
+        if before:
+            b, a = totals(before), totals(after)
+            print(f"\nTrace CPU load {b['cpu_pct']:.3f}% -> {a['cpu_pct']:.3f}%, "
+                  f"{b['bytes_per_s']:.0f} -> {a['bytes_per_s']:.0f} B/s")
+        for failure in failures:
+            print(f"FAIL: {failure}")
+
+    sys.exit(1 if failures else 0)
+
+
+if __name__ == '__main__':
+    main()
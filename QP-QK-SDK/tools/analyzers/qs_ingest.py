@@ -0,0 +1,547 @@
+#!/usr/bin/env python3
+"""
+QP-QK SDK QS Ingest
+Streams QS trace into a rotating on-disk store and keeps live metrics
+
+Built for soak tests that produce hours of trace. A dedicated reader
+thread only copies link bytes into memory-mapped, pre-sized segment files.
+A separate decoder thread follows the store, so a slow decode never
+backs up the link. Memory stays bounded: the store keeps the newest
+--segments files, and the metrics (event rates, queue margins, RTC
+histograms, pool and queue monitor stats) are updated per record.
+Nothing is ever re-parsed. Each segment is a plain raw capture that
+the other analyzers accept with --input.
+"""
+
+import os
+import sys
+import json
+import mmap
+import time
+import argparse
+import threading
+import subprocess
+from pathlib import Path
+from typing import Dict, List, Optional, Tuple
+
+from qs_stream import (QSSource, QSFrameDecoder, QSPayload, QS_FRAME,
+                       QS_SIG_DICT, QS_OBJ_DICT, QS_FUN_DICT, QS_USR_DICT,
+                       QS_USER)
+
+QS_QF_ACTIVE_POST = 14              # Pre-defined records (QP/C 7.x qs.h)
+QS_QF_ACTIVE_POST_LIFO = 15
+QS_QF_MPOOL_GET = 24
+QS_QF_PUBLISH = 26
+
+RTC_PROF_QS_REC = QS_USER + 24      # Must match rtc_profiler.h
+RTC_PROF_QS_VIOLATION = 1
+RTC_PROF_QS_AO_STATS = 2
+RTC_PROF_QS_SIG_STATS = 3
+QUEUE_MON_QS_REC = QS_USER + 22     # Must match queue_monitor.h
+QUEUE_MON_QS_OVERLOAD = 1
+QUEUE_MON_QS_STATS = 2
+POOL_MON_QS_REC = QS_USER + 23      # Must match pool_monitor.h
+POOL_MON_QS_STATS = 1
+
+# QS_onCommand() cases in main.c sent by --poll
+POLL_COMMANDS = [4, 6, 7]           # RTC_PROF, POOL_MON, QUEUE_MON report
+
+READ_SIZE = 64 * 1024               # Link bytes per read() of the reader
+DECODE_SIZE = 256 * 1024            # Store bytes per decoder pass
+
+SEGMENT_PREFIX = 'qs-'
+SEGMENT_SUFFIX = '.qs'
+
+
+class Segment:
+    """One pre-sized, memory-mapped capture file of the store"""
+
+    def __init__(self, path: Path, start: int, size: int):
+        self.path = path
+        self.start = start          # Store position of the first byte
+        self.used = 0
+        self.sealed = False
+        self.file = open(path, 'w+b')
+        self.file.truncate(size)
+        self.mm: Optional[mmap.mmap] = mmap.mmap(self.file.fileno(), size)
+
+    def release(self):
+        """Unmap and cut the file to the bytes actually written"""
+        if self.mm is not None:
+            self.mm.flush()
+            self.mm.close()
+            self.mm = None
+            self.file.truncate(self.used)
+            self.file.close()
+
+
+class SegmentStore:
+    """Ring of segment files written by the reader, followed by the decoder
+
+    Positions are byte offsets into the whole stream. Segments rotate on a
+    frame flag, so every file starts and ends on a frame boundary.
+    """
+
+    def __init__(self, directory: Path, segment_size: int, segments: int):
+        self.dir = directory
+        self.size = segment_size
+        self.keep = segments
+        self.lock = threading.Lock()
+        self.segments: List[Segment] = []
+        self.index = 0
+        self.written = 0
+        self.dropped = 0            # Bytes the decoder lost to rotation
+
+        self.dir.mkdir(parents=True, exist_ok=True)
+        for old in self.dir.glob(f'{SEGMENT_PREFIX}*{SEGMENT_SUFFIX}'):
+            old.unlink()
+        self._open()
+
+    def _open(self):
+        path = self.dir / f'{SEGMENT_PREFIX}{self.index:06d}{SEGMENT_SUFFIX}'
+        self.index += 1
+        self.segments.append(Segment(path, self.written, self.size))
+        while len(self.segments) > self.keep:
+            old = self.segments.pop(0)
+            old.release()
+            old.path.unlink()
+
+    def write(self, data: bytes):
+        """Append link bytes (reader thread)"""
+        while data:
+            seg = self.segments[-1]
+            room = self.size - seg.used
+            n = len(data)
+            if n > room:
+                # Rotate after the last frame that fits; only a frame
+                # longer than a whole segment is split
+                n = data.rfind(bytes([QS_FRAME]), 0, room) + 1
+                if n == 0 and seg.used == 0:
+                    n = room
+            if n:
+                seg.mm[seg.used:seg.used + n] = data[:n]
+                seg.used += n
+                self.written += n
+                data = data[n:]
+            if data:
+                with self.lock:
+                    seg.sealed = True
+                    self._open()
+
+    def read(self, pos: int, size: int) -> Tuple[int, bytes]:
+        """Bytes from stream position pos on (decoder thread)
+
+        Returns the position the data starts at: later than pos when the
+        segments holding pos were already rotated out.
+        """
+        with self.lock:
+            first = self.segments[0]
+            if pos < first.start:
+                self.dropped += first.start - pos
+                pos = first.start
+            for seg in self.segments:
+                if pos < seg.start + seg.used:
+                    off = pos - seg.start
+                    return pos, seg.mm[off:min(seg.used, off + size)]
+                if seg.sealed:
+                    seg.release()   # Fully decoded, cut it to size now
+            return pos, b''
+
+    def files(self) -> List[str]:
+        with self.lock:
+            return [seg.path.name for seg in self.segments]
+
+    def close(self):
+        with self.lock:
+            for seg in self.segments:
+                seg.release()
+
+
+class QSDictionaries:
+    """Object, function, signal and user record names sent by the target"""
+
+    def __init__(self):
+        self.obj: Dict[int, str] = {}
+        self.fun: Dict[int, str] = {}
+        self.sig: Dict[str, str] = {}   # 'sig' or 'sig@obj' -> name
+        self.usr: Dict[int, str] = {}
+        self.changed = False
+
+    def learn(self, rec_id: int, p: QSPayload, ptr_size: int) -> bool:
+        """Apply a dictionary record; False if rec_id is not one"""
+        if rec_id == QS_OBJ_DICT:
+            ptr = p.uint(ptr_size)
+            self.obj[ptr] = p.str()
+        elif rec_id == QS_FUN_DICT:
+            ptr = p.uint(ptr_size)
+            self.fun[ptr] = p.str()
+        elif rec_id == QS_SIG_DICT:
+            sig, obj = p.u16(), p.uint(ptr_size)
+            self.sig[f'{sig}@{obj:x}' if obj else str(sig)] = p.str()
+        elif rec_id == QS_USR_DICT:
+            rec = p.u8()
+            self.usr[rec] = p.str()
+        else:
+            return False
+        self.changed = True
+        return True
+
+    def obj_name(self, ptr: int) -> str:
+        return self.obj.get(ptr, f'0x{ptr:x}')
+
+    def sig_name(self, sig: int, obj: int = 0) -> str:
+        return self.sig.get(f'{sig}@{obj:x}') or self.sig.get(str(sig), str(sig))
+
+    def to_json(self) -> Dict:
+        return {'obj': {f'0x{k:x}': v for k, v in self.obj.items()},
+                'fun': {f'0x{k:x}': v for k, v in self.fun.items()},
+                'sig': self.sig,
+                'usr': {str(k): v for k, v in self.usr.items()}}
+
+    def load(self, data: Dict):
+        self.obj.update({int(k, 16): v for k, v in data.get('obj', {}).items()})
+        self.fun.update({int(k, 16): v for k, v in data.get('fun', {}).items()})
+        self.sig.update(data.get('sig', {}))
+        self.usr.update({int(k): v for k, v in data.get('usr', {}).items()})
+
+
+class LiveMetrics:
+    """Aggregates updated per record; snapshot() never touches the store"""
+
+    def __init__(self, dicts: QSDictionaries, ptr_size: int, tstamp_size: int):
+        self.dicts = dicts
+        self.ptr_size = ptr_size
+        self.tstamp_size = tstamp_size
+        self.lock = threading.Lock()
+        self.records: Dict[int, int] = {}
+        self.frames = 0
+        self.bytes = 0
+        self.sig_counts: Dict[int, int] = {}
+        self.ao_posts: Dict[int, Dict] = {}     # AO object pointer
+        self.pools: Dict[int, Dict] = {}        # Pool object pointer
+        self.rtc: Dict[int, Dict] = {}          # AO priority
+        self.rtc_sigs: Dict[int, Dict] = {}
+        self.queues: Dict[int, Dict] = {}       # AO priority
+        self.pool_mon: Dict[int, Dict] = {}     # Pool ID
+        self.violations = 0
+        self.overloads = 0
+        self.last_rates: Tuple[float, Dict[int, int], int, int] = (
+            time.time(), {}, 0, 0)
+        self.peak_rate: Dict[int, float] = {}
+
+    def consume(self, rec_id: int, payload: bytes):
+        """One decoded record (decoder thread, metrics lock held)"""
+        self.frames += 1
+        self.records[rec_id] = self.records.get(rec_id, 0) + 1
+        p = QSPayload(payload)
+        try:
+            if self.dicts.learn(rec_id, p, self.ptr_size):
+                return
+            if rec_id in (QS_QF_ACTIVE_POST, QS_QF_ACTIVE_POST_LIFO):
+                p.uint(self.tstamp_size)
+                p.uint(self.ptr_size)                   # Sender
+                sig, ao = p.u16(), p.uint(self.ptr_size)
+                p.u8(), p.u8()                          # poolId, refCtr
+                n_free = p.u8()                         # QF_EQUEUE_CTR_SIZE 1
+                self.sig_counts[sig] = self.sig_counts.get(sig, 0) + 1
+                s = self.ao_posts.setdefault(ao, {'posts': 0, 'min_free': n_free})
+                s['posts'] += 1
+                s['min_free'] = min(s['min_free'], n_free)
+            elif rec_id == QS_QF_PUBLISH:
+                p.uint(self.tstamp_size)
+                p.uint(self.ptr_size)
+                sig = p.u16()
+                self.sig_counts[sig] = self.sig_counts.get(sig, 0) + 1
+            elif rec_id == QS_QF_MPOOL_GET:
+                p.uint(self.tstamp_size)
+                pool, n_free = p.uint(self.ptr_size), p.u16()
+                s = self.pools.setdefault(pool, {'gets': 0, 'min_free': n_free})
+                s['gets'] += 1
+                s['min_free'] = min(s['min_free'], n_free)
+            elif rec_id >= QS_USER:
+                p.uint(self.tstamp_size)
+                self._user(rec_id, p)
+        except ValueError:
+            pass
+
+    def _user(self, rec_id: int, p: QSPayload):
+        kind = p.u8()
+        if rec_id == RTC_PROF_QS_REC:
+            if kind == RTC_PROF_QS_VIOLATION:
+                prio, sig = p.u8(), p.u16()
+                cycles = p.u32()
+                self.violations += 1
+                s = self.rtc.setdefault(prio, {})
+                s['last_violation'] = {'sig': self.dicts.sig_name(sig),
+                                       'cycles': cycles, 'budget': p.u32()}
+            elif kind == RTC_PROF_QS_AO_STATS:
+                prio = p.u8()
+                s = self.rtc.setdefault(prio, {})
+                for key in ['count', 'min', 'max', 'mean', 'violations']:
+                    s[key] = p.u32()
+                s['hist'] = [p.u16() for _ in range(p.remaining() // 2)]
+            elif kind == RTC_PROF_QS_SIG_STATS:
+                sig = p.u16()
+                self.rtc_sigs[sig] = {k: p.u32() for k in
+                                      ['count', 'min', 'max', 'mean']}
+        elif rec_id == QUEUE_MON_QS_REC:
+            prio = p.u8()
+            if kind == QUEUE_MON_QS_OVERLOAD:
+                self.overloads += 1
+            elif kind == QUEUE_MON_QS_STATS:
+                s = {k: p.u16() for k in ['capacity', 'depth', 'hwm']}
+                s.update({k: p.u32() for k in ['posts', 'overloads', 'drops']})
+                s['overloaded'] = bool(p.u8())
+                self.queues[prio] = s
+        elif rec_id == POOL_MON_QS_REC and kind == POOL_MON_QS_STATS:
+            pool_id = p.u8()
+            self.pool_mon[pool_id] = {
+                'block_size': p.u16(), 'n_tot': p.u16(), 'n_min': p.u16(),
+                'allocs': p.u32(), 'failures': p.u32()}
+
+    def snapshot(self) -> Dict:
+        """Current aggregates; event rates are over the last interval"""
+        with self.lock:
+            now = time.time()
+            t0, counts0, frames0, bytes0 = self.last_rates
+            dt = max(now - t0, 1e-6)
+            counts = dict(self.sig_counts)
+            self.last_rates = (now, counts, self.frames, self.bytes)
+
+            signals = {}
+            for sig, n in sorted(counts.items()):
+                rate = (n - counts0.get(sig, 0)) / dt
+                self.peak_rate[sig] = max(self.peak_rate.get(sig, 0.0), rate)
+                signals[self.dicts.sig_name(sig)] = {
+                    'events': n, 'rate': round(rate, 1),
+                    'peak_rate': round(self.peak_rate[sig], 1)}
+            d = self.dicts
+            return {
+                'time': now,
+                'frames': self.frames,
+                'frame_rate': round((self.frames - frames0) / dt, 1),
+                'byte_rate': round((self.bytes - bytes0) / dt, 1),
+                'records': {d.usr.get(k, str(k)): v
+                            for k, v in sorted(self.records.items())},
+                'signals': signals,
+                'queues': {d.obj_name(k): dict(v) for k, v in self.ao_posts.items()},
+                'pools': {d.obj_name(k): dict(v) for k, v in self.pools.items()},
+                'rtc': {str(k): dict(v) for k, v in sorted(self.rtc.items())},
+                'rtc_signals': {d.sig_name(k): dict(v)
+                                for k, v in sorted(self.rtc_sigs.items())},
+                'rtc_violations': self.violations,
+                'queue_monitor': {str(k): dict(v)
+                                  for k, v in sorted(self.queues.items())},
+                'queue_overloads': self.overloads,
+                'pool_monitor': {str(k): dict(v)
+                                 for k, v in sorted(self.pool_mon.items())},
+            }
+
+
+class QSIngest:
+    """Reader thread -> segment store -> decoder thread -> live metrics"""
+
+    def __init__(self, source: QSSource, store: SegmentStore,
+                 metrics: LiveMetrics):
+        self.source = source
+        self.store = store
+        self.metrics = metrics
+        self.decoder = QSFrameDecoder()
+        self.pos = 0                # Store position of the decoder
+        self.read_done = threading.Event()
+        self.stop = threading.Event()
+        self.error: Optional[str] = None
+        self.reader = threading.Thread(target=self._read, daemon=True)
+        self.worker = threading.Thread(target=self._decode, daemon=True)
+
+    def start(self):
+        self.reader.start()
+        self.worker.start()
+
+    def _read(self):
+        # A capture file can outrun the decoder: wait rather than rotate
+        # undecoded segments out (a live link is never held back)
+        limit = self.store.size * (self.store.keep - 2)
+        try:
+            while not self.stop.is_set():
+                if not self.source.is_live() and self.store.written - self.pos > limit:
+                    time.sleep(0.01)
+                    continue
+                data = self.source.read(READ_SIZE)
+                if data:
+                    self.store.write(data)
+                elif not self.source.is_live() or self.source.closed:
+                    break
+        except (OSError, RuntimeError) as e:
+            self.error = str(e)
+        finally:
+            self.read_done.set()
+
+    def _decode(self):
+        while True:
+            done = self.read_done.is_set()
+            pos, data = self.store.read(self.pos, DECODE_SIZE)
+            if pos != self.pos:
+                # Lagged past the retention: resync on the segment start
+                self.decoder.buf = b''
+                self.decoder.last_seq = None
+            if not data:
+                self.pos = pos
+                if done or self.stop.is_set():
+                    break
+                time.sleep(0.01)
+                continue
+            self.pos = pos + len(data)
+            with self.metrics.lock:
+                self.metrics.bytes += len(data)
+                for _, rec_id, payload in self.decoder.feed(data):
+                    self.metrics.consume(rec_id, payload)
+
+    def running(self) -> bool:
+        return self.worker.is_alive()
+
+    def shutdown(self):
+        self.stop.set()
+        self.reader.join()
+        self.worker.join()
+
+
+def write_json(path: Path, data: Dict):
+    """Replace path atomically so readers never see a partial file"""
+    tmp = path.with_suffix('.tmp')
+    with open(tmp, 'w') as f:
+        json.dump(data, f, indent=2)
+    os.replace(tmp, path)
+
+
+def summary_line(snap: Dict, ingest: QSIngest) -> str:
+    busiest = sorted(snap['signals'].items(), key=lambda kv: -kv[1]['rate'])[:3]
+    rates = ', '.join(f"{k} {v['rate']:.0f}/s" for k, v in busiest) or '-'
+    return (f"{snap['byte_rate'] / 1024:8.1f} KB/s {snap['frame_rate']:9.0f} rec/s"
+            f"  bad {ingest.decoder.bad_frames} lost {ingest.decoder.lost_frames}"
+            f" dropped {ingest.store.dropped} B"
+            f"  RTC viol {snap['rtc_violations']}  [{rates}]")
+
+
+def main():
+    parser = argparse.ArgumentParser(description='QP-QK SDK QS Ingest')
+    parser.add_argument('--port', help='Serial port of the QS output')
+    parser.add_argument('--baud', type=int, default=921600,
+                       help='QS baud rate (default: 921600)')
+    parser.add_argument('--input', '-i',
+                       help='Raw QS capture file instead of a serial port')
+    parser.add_argument('--connect', metavar='HOST:PORT',
+                       help='Read QS from a TCP endpoint (e.g. a serial bridge)')
+    parser.add_argument('--host', metavar='ELF',
+                       help='Run a posix build and ingest its QS output')
+    parser.add_argument('--store', default='qs_store',
+                       help='Store directory (default: qs_store)')
+    parser.add_argument('--segment-mb', type=float, default=64.0,
+                       help='Size of one segment file in MB (default: 64)')
+    parser.add_argument('--segments', type=int, default=16,
+                       help='Segment files kept, oldest deleted (default: 16)')
+    parser.add_argument('--duration', '-d', type=float,
+                       help='Stop after this many seconds (default: until EOF '
+                            'or Ctrl-C)')
+    parser.add_argument('--snapshot', type=float, default=1.0, metavar='SECONDS',
+                       help='Interval of metrics.json and the console line '
+                            '(default: 1)')
+    parser.add_argument('--poll', type=float, metavar='SECONDS',
+                       help='Request RTC, pool and queue reports this often')
+    parser.add_argument('--tstamp-size', type=int, default=4,
+                       choices=[1, 2, 4, 8],
+                       help='QS_TSTAMP_SIZE of the target (default: 4)')
+    parser.add_argument('--ptr-size', type=int, default=None, choices=[2, 4, 8],
+                       help='QS_OBJ_PTR_SIZE/QS_FUN_PTR_SIZE of the target '
+                            '(default: 4, 8 with --host)')
+    parser.add_argument('--quiet', '-q', action='store_true',
+                       help='No console summary line')
+
+    args = parser.parse_args()
+    ptr_size = args.ptr_size or (8 if args.host else 4)
+
+    try:
+        if args.segments < 2 or args.segment_mb <= 0:
+            raise ValueError("--segments must be >= 2 and --segment-mb > 0")
+        store_dir = Path(args.store)
+        if args.host:
+            source = QSSource(tcp_listen=0)
+        else:
+            source = QSSource(args.port, args.baud, args.input,
+                              tcp_connect=args.connect)
+        store = SegmentStore(store_dir, int(args.segment_mb * 1024 * 1024),
+                             args.segments)
+    except (ValueError, RuntimeError, OSError) as e:
+        print(f"Error: {e}")
+        sys.exit(1)
+
+    dicts = QSDictionaries()
+    dict_path = store_dir / 'dictionaries.json'
+    if dict_path.exists():
+        # Targets send dictionaries at startup only: keep names across runs
+        with open(dict_path, 'r') as f:
+            dicts.load(json.load(f))
+    metrics = LiveMetrics(dicts, ptr_size, args.tstamp_size)
+    ingest = QSIngest(source, store, metrics)
+
+    # The reader must get the GIL back quickly while the decoder is busy
+    sys.setswitchinterval(0.001)
+
+    proc = None
+    try:
+        if args.host:
+            cmd = [args.host, '--qs', f'127.0.0.1:{source.tcp_port}']
+            if args.duration:
+                cmd += ['--duration', f'{args.duration + 2.0:g}']
+            proc = subprocess.Popen(cmd)
+            source.accept()
+        ingest.start()
+        start = time.time()
+        next_poll = start
+        while ingest.running():
+            time.sleep(args.snapshot)
+            now = time.time()
+            if args.poll and source.is_live() and now >= next_poll:
+                next_poll = now + args.poll
+                for cmd_id in POLL_COMMANDS:
+                    source.command(cmd_id)
+            snap = metrics.snapshot()
+            snap['store'] = {'files': store.files(), 'written': store.written,
+                             'dropped': store.dropped}
+            write_json(store_dir / 'metrics.json', snap)
+            if dicts.changed:
+                dicts.changed = False
+                write_json(dict_path, dicts.to_json())
+            if not args.quiet:
+                print(summary_line(snap, ingest), flush=True)
+            if args.duration and now - start >= args.duration:
+                break
+    except KeyboardInterrupt:
+        pass
+    except (RuntimeError, OSError) as e:
+        print(f"Error: {e}")
+        sys.exit(1)
+    finally:
+        ingest.shutdown()
+        source.close()
+        store.close()
+        if proc is not None:
+            proc.terminate()
+            proc.wait()
+
+    snap = metrics.snapshot()
+    snap['store'] = {'files': store.files(), 'written': store.written,
+                     'dropped': store.dropped}
+    write_json(store_dir / 'metrics.json', snap)
+    write_json(dict_path, dicts.to_json())
+    if ingest.error:
+        print(f"Error: {ingest.error}")
+        sys.exit(1)
+    print(f"Ingested {store.written} bytes, {metrics.frames} records "
+          f"({ingest.decoder.bad_frames} bad, {ingest.decoder.lost_frames} lost "
+          f"on the link, {store.dropped} bytes rotated out before decoding)")
+    print(f"Store: {store_dir} ({', '.join(store.files())})")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,342 @@
+#!/usr/bin/env python3
+"""
+QP-QK SDK Trace Replay
+Turns field traces into replay scripts and runs them on the host build
+
+Collects the external-event records of the trace capture service
+(templates/services/trace_replay.c, REPLAY_CAPTURE_ENABLE firmware) from
+the target or from raw capture files, and writes them as a replay script:
+one line per event with the tick, trace time, target AO, signal and the
+event parameters. Several captures are appended into one workload.
+
+With --host the script is replayed on a posix build of the same AOs
+(REPLAY_ENABLE), which reports the instructions and cycles of every
+handler (AO and signal). The results are written as stable JSON so a code
+change can be checked against a baseline of the same workload with
+--compare, in CI or by hand.
+"""
+
+import sys
+import json
+import hashlib
+import argparse
+import subprocess
+import tempfile
+from pathlib import Path
+from typing import Dict, List, Optional, Tuple
+
+from qs_stream import QSSource, QSPayload, QSTimeUnroller, QS_USER
+from qs_ingest import QSDictionaries
+from qk_bench import sdk_version
+
+REPLAY_QS_REC = QS_USER + 17        # Must match trace_replay.h
+REPLAY_QS_EVT = 1
+REPLAY_MAX_PAYLOAD = 48
+
+SCRIPT_FORMAT = 'qk-replay-script/1'
+RESULTS_FORMAT = 'qk-replay/1'      # Written by Replay_report()
+
+# Handler metrics compared by --compare: (key, unit); all are worse up
+HANDLER_METRICS = {
+    'perf': [('instr_mean', 'ins'), ('cycles_mean', 'cyc')],
+    'clock': [('ns_mean', 'ns')],
+}
+
+
+class ReplayCapture:
+    """Collects REPLAY_QS_EVT records into replay steps"""
+
+    def __init__(self, tstamp_size: int, ptr_size: int, tick_hz: int):
+        self.tstamp_size = tstamp_size
+        self.ptr_size = ptr_size
+        self.tick_hz = tick_hz
+        self.dicts = QSDictionaries()
+        self.steps: List[Tuple[int, int, int, int, bytes]] = []
+        self.names: Dict[Tuple[int, int], Tuple[str, str]] = {}
+        self.truncated = 0
+        self._tick_base = 0         # Ticks of the captures before this one
+        self._us_base = 0
+
+    def collect(self, source: QSSource, duration: Optional[float] = None):
+        """Append the events of one capture (a target run)"""
+        unroller = QSTimeUnroller(self.tstamp_size)
+        first: Optional[Tuple[int, int]] = None     # (tick, time) of event 1
+        last_tick = 0
+        last_us = 0
+
+        for rec_id, payload in source.records(duration):
+            p = QSPayload(payload)
+            try:
+                if self.dicts.learn(rec_id, p, self.ptr_size):
+                    continue
+                if rec_id != REPLAY_QS_REC:
+                    continue
+                tstamp = p.uint(self.tstamp_size)
+                if p.u8() != REPLAY_QS_EVT:
+                    continue
+                prio, ao, tick, sig = p.u8(), p.u32(), p.u32(), p.u16()
+                params = bytes(p.u8() for _ in range(p.u8()))
+            except ValueError:
+                continue
+
+            us = unroller.unroll(tstamp)
+            if first is None:
+                first = (tick, us)
+            # Idle ticks before the first event are dropped; the trace time
+            # is anchored so that tick n is at n / tick_hz s
+            tick = self._tick_base + (tick - first[0])
+            us = max(0, self._us_base + (us - first[1]))
+            us = max(us, (tick * 1000000) // self.tick_hz)
+            if len(params) > REPLAY_MAX_PAYLOAD:
+                params = params[:REPLAY_MAX_PAYLOAD]
+                self.truncated += 1
+            self.steps.append((tick, us, prio, sig, params))
+            self.names.setdefault((prio, sig), (self.dicts.obj_name(ao),
+                                                self.dicts.sig_name(sig, ao)))
+            last_tick, last_us = tick, us
+
+        if first is not None:
+            # The next capture starts one tick after this one ended
+            self._tick_base = last_tick + 1
+            self._us_base = max(last_us,
+                                (self._tick_base * 1000000) // self.tick_hz)
+
+        if source.decoder.bad_frames or source.decoder.lost_frames:
+            print(f"Warning: {source.decoder.bad_frames} bad and "
+                  f"{source.decoder.lost_frames} lost QS frames "
+                  "(the replay misses those events)")
+
+    def write(self, path: str, origin: str):
+        with open(path, 'w') as f:
+            f.write(f"# {SCRIPT_FORMAT} from {origin}\n")
+            f.write(f"# {len(self.steps)} events, "
+                    f"{self.steps[-1][0] if self.steps else 0} ticks "
+                    f"at {self.tick_hz} Hz\n")
+            for (prio, sig), (ao, sig_name) in sorted(self.names.items()):
+                f.write(f"# name {prio} {sig} {ao} {sig_name}\n")
+            f.write("# tick time_us prio sig params\n")
+            for tick, us, prio, sig, params in self.steps:
+                f.write(f"{tick} {us} {prio} {sig} "
+                        f"{params.hex() if params else '-'}\n")
+
+
+def script_names(path: str) -> Dict[Tuple[int, int], Tuple[str, str]]:
+    """AO and signal names from the '# name' lines of a replay script"""
+    names = {}
+    with open(path, 'r') as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) == 6 and fields[:2] == ['#', 'name']:
+                names[(int(fields[2]), int(fields[3]))] = (fields[4], fields[5])
+    return names
+
+
+def run_host(elf: str, script: str, timeout: float) -> Dict:
+    """Replay the script on the host build, return its report"""
+    with tempfile.TemporaryDirectory() as tmp:
+        report = Path(tmp) / 'replay.json'
+        result = subprocess.run([elf, '--replay', script,
+                                 '--replay-report', str(report),
+                                 '--qs', 'off'],
+                                capture_output=True, text=True,
+                                timeout=timeout)
+        if result.returncode != 0 or not report.exists():
+            sys.stderr.write(result.stdout + result.stderr)
+            raise RuntimeError(f"{elf} --replay failed (exit "
+                               f"{result.returncode}; is it built with "
+                               "REPLAY_ENABLE?)")
+        with open(report, 'r') as f:
+            return json.load(f)
+
+
+def label(h: Dict, names: Dict[Tuple[int, int], Tuple[str, str]]) -> str:
+    ao, sig = names.get((h['prio'], h['sig']), (None, None))
+    return f"{ao or 'prio ' + str(h['prio'])}/{sig or h['sig']}"
+
+
+def print_report(r: Dict, names: Dict[Tuple[int, int], Tuple[str, str]]):
+    perf = r['counters'] == 'perf'
+    print(f"\nReplay of {r['script']} (SDK {r['sdk']}): {r['ticks']} ticks, "
+          f"{r['injected']} events injected, {r['failed']} failed")
+    if not perf:
+        print("  No hardware counters on this host: wall time only "
+              "(not reproducible, compare with care)")
+    print(f"\n  {'Handler':<32} {'Count':>8} {'Instr/evt':>11} "
+          f"{'Max instr':>11} {'Cycles/evt':>11} {'ns/evt':>9}")
+    for h in r['handlers']:
+        print(f"  {label(h, names):<32} {h['count']:>8} "
+              f"{h['instr_mean'] if perf else '-':>11} "
+              f"{h['instr_max'] if perf else '-':>11} "
+              f"{h['cycles_mean'] if perf else '-':>11} {h['ns_mean']:>9}")
+
+
+def compare(base: Dict, cur: Dict, tolerance: float,
+            names: Dict[Tuple[int, int], Tuple[str, str]]) -> List[str]:
+    """Print handler cost changes against a baseline, return the regressions"""
+    regressions = []
+    if base.get('counters') != cur.get('counters'):
+        print(f"Warning: baseline counters are {base.get('counters')}, "
+              f"these are {cur.get('counters')}: comparing wall time")
+        metrics = HANDLER_METRICS['clock']
+    else:
+        metrics = HANDLER_METRICS[cur['counters']]
+    if base.get('script_sha') != cur.get('script_sha'):
+        print("Warning: the baseline replayed a different script")
+
+    print(f"\nChanges since SDK {base.get('sdk', '?')} "
+          f"(tolerance {tolerance:g}%):")
+    old = {(h['prio'], h['sig']): h for h in base.get('handlers', [])}
+    for h in cur['handlers']:
+        name = label(h, names)
+        o = old.pop((h['prio'], h['sig']), None)
+        if o is None:
+            print(f"  {name:<32} (not in the baseline)")
+            continue
+        if o['count'] != h['count']:
+            # Same workload, different dispatches: the behaviour changed
+            print(f"  {name:<32} count {o['count']} -> {h['count']}")
+        for key, unit in metrics:
+            a, b = o.get(key, 0), h.get(key, 0)
+            rel = (100.0 * (b - a) / a) if a else (0.0 if a == b else 100.0)
+            flag = ''
+            if rel > tolerance:
+                flag = '  REGRESSION'
+                regressions.append(f"{name} {key}: {a} -> {b} ({rel:+.1f}%)")
+            print(f"  {name:<32} {key:<12} {a:>10} {b:>10} {unit:<4}"
+                  f"{rel:+8.1f}%{flag}")
+    for h in old.values():
+        print(f"  {label(h, names):<32} (no longer dispatched)")
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description='QP-QK SDK Trace Replay')
+    parser.add_argument('--port', help='Serial port of the target QS output')
+    parser.add_argument('--baud', type=int, default=921600,
+                       help='QS baud rate (default: 921600)')
+    parser.add_argument('--input', '-i', action='append', default=[],
+                       help='Raw QS capture file (repeat to append captures)')
+    parser.add_argument('--duration', '-d', type=float, default=60.0,
+                       help='Capture time with --port in seconds (default: 60)')
+    parser.add_argument('--tstamp-size', type=int, default=4,
+                       choices=[1, 2, 4, 8],
+                       help='QS_TSTAMP_SIZE of the target (default: 4)')
+    parser.add_argument('--ptr-size', type=int, default=4, choices=[2, 4, 8],
+                       help='QS_OBJ_PTR_SIZE of the target (default: 4)')
+    parser.add_argument('--tick-hz', type=int, default=1000,
+                       help='BSP_TICKS_PER_SEC of the target (default: 1000)')
+    parser.add_argument('--dict',
+                       help='dictionaries.json of a qs_ingest.py store, for '
+                            'captures that started after the target did')
+    parser.add_argument('--script', '-s',
+                       help='Replay this script instead of capturing one')
+    parser.add_argument('--output', '-o',
+                       help='Write the captured script (or with --host, the '
+                            'replay results) to this file')
+    parser.add_argument('--host', metavar='ELF',
+                       help='Replay on this host (posix, REPLAY_ENABLE) build')
+    parser.add_argument('--timeout', type=float, default=600.0,
+                       help='Limit for the host replay in seconds (default: 600)')
+    parser.add_argument('--compare', metavar='BASELINE',
+                       help='Replay results of an earlier run to compare against')
+    parser.add_argument('--tolerance', type=float, default=5.0,
+                       help='Allowed regression in percent (default: 5)')
+    parser.add_argument('--json', action='store_true',
+                       help='Print the replay results as JSON')
+
+    args = parser.parse_args()
+
+    if not (args.script or args.port or args.input):
+        print("Error: a capture (--port, --input) or a --script is required")
+        sys.exit(1)
+    if args.script and not args.host:
+        print("Error: --script needs --host")
+        sys.exit(1)
+    if not args.host and not args.output:
+        print("Error: --output is required to save the captured script")
+        sys.exit(1)
+
+    try:
+        baseline = None
+        if args.compare:
+            with open(args.compare, 'r') as f:
+                baseline = json.load(f)
+            if baseline.get('format') != RESULTS_FORMAT:
+                raise ValueError(f"{args.compare}: not {RESULTS_FORMAT} results")
+
+        script = args.script
+        tmp = None
+        if not script:
+            capture = ReplayCapture(args.tstamp_size, args.ptr_size,
+                                    args.tick_hz)
+            if args.dict:
+                with open(args.dict, 'r') as f:
+                    capture.dicts.load(json.load(f))
+            sources = args.input or [None]
+            for path in sources:
+                source = QSSource(args.port, args.baud, path)
+                try:
+                    if path is None:
+                        print(f"Capturing for {args.duration:.0f} s...")
+                    capture.collect(source,
+                                    args.duration if path is None else None)
+                except KeyboardInterrupt:
+                    pass
+                finally:
+                    source.close()
+            if not capture.steps:
+                print("No replay records received "
+                      "(is the firmware built with REPLAY_CAPTURE_ENABLE?)")
+                sys.exit(1)
+            if capture.truncated:
+                print(f"Warning: {capture.truncated} events had more than "
+                      f"{REPLAY_MAX_PAYLOAD} parameter bytes (truncated)")
+            if args.host:
+                tmp = tempfile.NamedTemporaryFile('w', suffix='.replay',
+                                                  delete=False)
+                tmp.close()
+                script = tmp.name
+            else:
+                script = args.output
+            capture.write(script, ', '.join(args.input) or args.port)
+            print(f"{len(capture.steps)} events over "
+                  f"{capture.steps[-1][0]} ticks"
+                  + ("" if args.host else f" written to {script}"))
+            if not args.host:
+                sys.exit(0)
+
+        names = script_names(script)
+        results = run_host(args.host, script, args.timeout)
+        # Same script and SDK version label comparable runs
+        with open(script, 'rb') as f:
+            results['script_sha'] = hashlib.sha256(f.read()).hexdigest()[:16]
+        results['script'] = Path(args.script).name if args.script else 'capture'
+        results['sdk'] = sdk_version()
+        if tmp is not None:
+            Path(tmp.name).unlink()
+    except (ValueError, RuntimeError, OSError,
+            subprocess.SubprocessError) as e:
+        print(f"Error: {e}")
+        sys.exit(1)
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump(results, f, indent=2, sort_keys=True)
+            f.write('\n')
+
+    if args.json:
+        print(json.dumps(results, indent=2, sort_keys=True))
+    else:
+        print_report(results, names)
+
+    regressions = []
+    if baseline is not None:
+        regressions = compare(baseline, results, args.tolerance, names)
+        for r in regressions:
+            print(f"FAIL: {r}")
+
+    sys.exit(1 if regressions else 0)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,348 @@
+#!/usr/bin/env python3
+"""
+QP-QK SDK QS Stream Decoder
+Shared QS (Q-Spy) frame decoder for the SDK analysis tools
+
+Decodes the HDLC-like QS transport used by the target (0x7E frame flag,
+0x7D escape, 8-bit checksum) into records, and encodes QS-RX commands so
+tools can trigger on-target reports without QSpy in the loop.
+"""
+
+import socket
+import struct
+import time
+from pathlib import Path
+from typing import Dict, Iterator, Optional, Tuple
+
+QS_FRAME = 0x7E
+QS_ESC = 0x7D
+QS_ESC_XOR = 0x20
+QS_GOOD_CHKSUM = 0xFF
+
+QS_SIG_DICT = 60        # Dictionary records (not time-stamped)
+QS_OBJ_DICT = 61
+QS_FUN_DICT = 62
+QS_USR_DICT = 63
+QS_USER = 100           # First application-specific record ID
+QS_RX_COMMAND = 1       # QS-RX record: user command to QS_onCommand()
+
+QS_COMPACT_QS_REC = QS_USER + 18    # Must match qs_compact.h
+QS_COMPACT_QS_STR_DEF = 1
+QS_COMPACT_QS_SYNC = 2
+QS_COMPACT_DEF_FLAG = 0x80
+QS_COMPACT_INLINE = 0xFF
+QS_COMPACT_CMD_DUMP = 8             # QS_onCommand() case for QS_COMPACT_DUMP()
+
+
+class QSPayload:
+    """Little-endian reader over the payload of one QS record"""
+    
+    def __init__(self, data: bytes):
+        self.data = data
+        self.pos = 0
+    
+    def _take(self, fmt: str):
+        size = struct.calcsize(fmt)
+        if self.pos + size > len(self.data):
+            raise ValueError("QS record too short")
+        value = struct.unpack_from(fmt, self.data, self.pos)[0]
+        self.pos += size
+        return value
+    
+    def u8(self) -> int:
+        return self._take('<B')
+    
+    def u16(self) -> int:
+        return self._take('<H')
+    
+    def u32(self) -> int:
+        return self._take('<I')
+    
+    def u64(self) -> int:
+        return self._take('<Q')
+    
+    def uint(self, size: int) -> int:
+        """Unsigned value of QS_TSTAMP_SIZE-like configurable width"""
+        return {1: self.u8, 2: self.u16, 4: self.u32, 8: self.u64}[size]()
+    
+    def str(self) -> str:
+        """Zero-terminated string (QS_STR_)"""
+        end = self.data.find(b'\0', self.pos)
+        if end < 0:
+            raise ValueError("QS string not terminated")
+        text = self.data[self.pos:end].decode('utf-8', errors='replace')
+        self.pos = end + 1
+        return text
+    
+    def remaining(self) -> int:
+        return len(self.data) - self.pos
+
+
+class QSFrameDecoder:
+    """Incremental QS frame decoder: feed() bytes, get (seq, rec_id, payload)
+    
+    Works on whole frames (split on the frame flag, then unescape) rather
+    than byte by byte, which keeps up with multi-Mbaud links in Python.
+    """
+    
+    def __init__(self):
+        self.buf = b''          # Escaped bytes of the unfinished frame
+        self.bad_frames = 0
+        self.lost_frames = 0
+        self.last_seq: Optional[int] = None
+    
+    def feed(self, data: bytes) -> Iterator[Tuple[int, int, bytes]]:
+        parts = bytes(data).split(b'\x7e')
+        if len(parts) == 1:
+            self.buf += parts[0]
+            return
+        parts[0] = self.buf + parts[0]
+        self.buf = parts.pop()
+        for raw in parts:
+            frame = self._finish(raw)
+            if frame is not None:
+                yield frame
+    
+    @staticmethod
+    def _unescape(raw: bytes) -> bytes:
+        # The target only escapes the flag and the escape byte itself
+        if raw.count(QS_ESC) == (raw.count(b'\x7d\x5e')
+                                 + raw.count(b'\x7d\x5d')):
+            return raw.replace(b'\x7d\x5e', b'\x7e').replace(b'\x7d\x5d', b'\x7d')
+        out = bytearray()
+        escaped = False
+        for b in raw:
+            if b == QS_ESC:
+                escaped = True
+            else:
+                out.append((b ^ QS_ESC_XOR) if escaped else b)
+                escaped = False
+        return bytes(out)
+    
+    def _finish(self, raw: bytes) -> Optional[Tuple[int, int, bytes]]:
+        frame = self._unescape(raw) if QS_ESC in raw else raw
+        if len(frame) < 3:
+            return None
+        if (sum(frame) & 0xFF) != QS_GOOD_CHKSUM:
+            self.bad_frames += 1
+            return None
+        
+        seq, rec_id = frame[0], frame[1]
+        if self.last_seq is not None:
+            self.lost_frames += (seq - self.last_seq - 1) & 0xFF
+        self.last_seq = seq
+        return seq, rec_id, frame[2:-1]
+
+
+def encode_frame(seq: int, rec_id: int, payload: bytes) -> bytes:
+    """Encode one QS/QS-RX frame with checksum, escaping and frame flag"""
+    body = bytes([seq & 0xFF, rec_id]) + payload
+    body += bytes([~sum(body) & 0xFF])
+    out = bytearray()
+    for b in body:
+        if b in (QS_FRAME, QS_ESC):
+            out += bytes([QS_ESC, b ^ QS_ESC_XOR])
+        else:
+            out.append(b)
+    out.append(QS_FRAME)
+    return bytes(out)
+
+
+def encode_command(seq: int, cmd_id: int, param1: int = 0,
+                   param2: int = 0, param3: int = 0) -> bytes:
+    """QS-RX command frame dispatched to QS_onCommand() on the target"""
+    return encode_frame(seq, QS_RX_COMMAND,
+                        struct.pack('<BIII', cmd_id, param1, param2, param3))
+
+
+class QSSource:
+    """QS byte source: serial port (needs pyserial), raw capture file, a
+    TCP port a host (posix) build connects to as if it were QSPY, or a
+    host:port to connect to (e.g. a TCP-to-serial bridge)"""
+    
+    def __init__(self, port: Optional[str] = None, baud: int = 921600,
+                 input_file: Optional[str] = None,
+                 tcp_listen: Optional[int] = None,
+                 tcp_connect: Optional[str] = None):
+        self.serial = None
+        self.file = None
+        self.server = None
+        self.sock = None
+        self.closed = False
+        self.tx_seq = 0
+        self.decoder = QSFrameDecoder()
+        
+        if input_file:
+            self.file = open(Path(input_file), 'rb')
+        elif tcp_listen is not None:
+            self.server = socket.create_server(('127.0.0.1', tcp_listen))
+        elif tcp_connect:
+            host, _, tcp_port = tcp_connect.rpartition(':')
+            if not host or not tcp_port.isdigit():
+                raise ValueError(f"Bad TCP endpoint '{tcp_connect}' "
+                                 "(expected host:port)")
+            self.sock = socket.create_connection((host, int(tcp_port)),
+                                                 timeout=5.0)
+            self.sock.settimeout(0.1)
+        elif port:
+            try:
+                import serial
+            except ImportError:
+                raise RuntimeError("pyserial is required for --port "
+                                   "(pip install pyserial)")
+            self.serial = serial.Serial(port, baud, timeout=0.1)
+        else:
+            raise ValueError("Either a serial port or an input file is required")
+    
+    @property
+    def tcp_port(self) -> int:
+        """Port to pass to the host build (--qs 127.0.0.1:PORT)"""
+        return self.server.getsockname()[1]
+    
+    def accept(self, timeout: float = 5.0):
+        """Wait for the host build to connect"""
+        self.server.settimeout(timeout)
+        try:
+            self.sock, _ = self.server.accept()
+        except socket.timeout:
+            raise RuntimeError("The host build did not connect to QS")
+        self.sock.settimeout(0.1)
+    
+    def read(self, size: int = 4096) -> bytes:
+        if self.file:
+            return self.file.read(size)
+        if self.sock:
+            try:
+                data = self.sock.recv(size)
+            except socket.timeout:
+                return b''
+            except ConnectionResetError:
+                data = b''
+            self.closed = not data
+            return data
+        return self.serial.read(size)
+    
+    def is_live(self) -> bool:
+        return ((self.serial is not None) or (self.server is not None)
+                or (self.sock is not None))
+    
+    def command(self, cmd_id: int, param1: int = 0,
+                param2: int = 0, param3: int = 0) -> bool:
+        """Send a QS-RX command (ignored for capture files)"""
+        if not (self.serial or self.sock):
+            return False
+        self.tx_seq = (self.tx_seq + 1) & 0xFF
+        frame = encode_command(self.tx_seq, cmd_id, param1, param2, param3)
+        if self.sock:
+            self.sock.sendall(frame)
+        else:
+            self.serial.write(frame)
+        return True
+    
+    def records(self, duration: Optional[float] = None
+                ) -> Iterator[Tuple[int, bytes]]:
+        """Yield (rec_id, payload) until EOF or the duration elapses"""
+        deadline = (time.time() + duration) if duration else None
+        while deadline is None or time.time() < deadline:
+            data = self.read()
+            if not data:
+                if self.file or self.closed:
+                    break
+                continue
+            for _, rec_id, payload in self.decoder.feed(data):
+                yield rec_id, payload
+    
+    def close(self):
+        if self.file:
+            self.file.close()
+        if self.serial:
+            self.serial.close()
+        if self.sock:
+            self.sock.close()
+        if self.server:
+            self.server.close()
+
+
+def user_records(source: QSSource, rec_id: int, tstamp_size: int = 4,
+                 duration: Optional[float] = None
+                 ) -> Iterator[Tuple[int, QSPayload]]:
+    """Yield (timestamp, payload) of one QS user record ID"""
+    for rid, payload in source.records(duration):
+        if rid == rec_id:
+            p = QSPayload(payload)
+            try:
+                yield p.uint(tstamp_size), p
+            except ValueError:
+                continue
+
+
+class QSStringDict:
+    """Resolves QS_STR_ID_() fields of the compact trace mode (qs_compact.h)"""
+    
+    def __init__(self):
+        self.strings: Dict[int, str] = {}
+        self.unresolved = 0
+    
+    def read(self, p: QSPayload) -> str:
+        """Read one QS_STR_ID_() field, learning inline definitions"""
+        b = p.u8()
+        if b == QS_COMPACT_INLINE:
+            return p.str()
+        if b & QS_COMPACT_DEF_FLAG:
+            text = p.str()
+            self.strings[b & ~QS_COMPACT_DEF_FLAG] = text
+            return text
+        if b not in self.strings:
+            self.unresolved += 1
+            return f"<str#{b}>"
+        return self.strings[b]
+    
+    def learn(self, p: QSPayload):
+        """Apply a STR_DEF record (payload after the sub-type byte)"""
+        str_id = p.u8()
+        self.strings[str_id] = p.str()
+
+
+class QSTimeUnroller:
+    """Unrolls truncated QS time stamps into a monotonic 64-bit time
+    
+    Correct as long as consecutive records are less than one wrap period
+    apart; the target's SYNC records guarantee that and re-anchor the time.
+    The time is in the target's QS_onGetTime() unit (microseconds on both
+    SDK BSPs), and SYNC carries the untruncated 32-bit BSP_getTimeUs().
+    
+    A SYNC that arrives after the 16-bit stamp wrapped keeps time going
+    forward (run with python3 -m doctest qs_stream.py):
+    
+    >>> clock = QSTimeUnroller(2)
+    >>> clock.unroll(0xFFF0)
+    65520
+    >>> clock.unroll(0x0010)
+    65552
+    >>> clock.sync(0x00010020)
+    >>> clock.time
+    65568
+    >>> clock.unroll(0x0030)
+    65584
+    """
+    
+    def __init__(self, tstamp_size: int):
+        self.mask = (1 << (8 * tstamp_size)) - 1
+        self.time: Optional[int] = None
+    
+    def unroll(self, tstamp: int) -> int:
+        if self.time is None:
+            self.time = tstamp
+        else:
+            self.time += (tstamp - self.time) & self.mask
+        return self.time
+    
+    def sync(self, full: int):
+        """Re-anchor on the full 32-bit time (BSP_getTimeUs()) of a SYNC"""
+        if self.time is None:
+            self.time = full
+            return
+        anchored = (self.time & ~0xFFFFFFFF) | full
+        if anchored + 0x80000000 < self.time:
+            anchored += 1 << 32
+        self.time = anchored
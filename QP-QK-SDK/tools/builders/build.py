@@ -4,7 +4,8 @@ QP-QK SDK Build Tool
 AI Agent automated build system for QP-QK projects
 
 This tool provides automated building for microcontroller projects
-using the QP framework with QK kernel.
+using the QP framework with the QK kernel, or with the cooperative QV
+kernel ('kernel: qv' in the config or --kernel qv).
 """
 
 import os
@@ -13,18 +14,181 @@ import argparse
 import subprocess
 import json
 import yaml
+import shutil
+import hashlib
+import threading
+from concurrent.futures import ThreadPoolExecutor
 from pathlib import Path
-from typing import Dict, List, Optional
+from typing import Dict, List, Optional, Tuple
 import time
 
+from footprint import FootprintAnalyzer
+
+# SDK templates, used for the host (posix) platform sources
+SDK_ROOT = Path(__file__).resolve().parents[2]
+TEMPLATES_DIR = SDK_ROOT / 'templates'
+PLATFORM_CONFIGS = SDK_ROOT / 'config' / 'platforms' / 'platform_configs.yaml'
+
+# Platforms that run natively on the build machine (QP posix-qv port)
+HOST_PLATFORMS = ('posix',)
+
+# Kernels of the target build: the QP port decides which one is linked
+KERNELS = ('qk', 'qv')
+
+def file_digest(path: Path) -> str:
+    """SHA-256 of a file's contents"""
+    h = hashlib.sha256()
+    with open(path, 'rb') as f:
+        for chunk in iter(lambda: f.read(65536), b''):
+            h.update(chunk)
+    return h.hexdigest()
+
+
+def parse_depfile(dep_file: Path) -> List[str]:
+    """Prerequisites of the first rule of a gcc -MMD depfile"""
+    text = dep_file.read_text().replace('\\\n', ' ')
+    rule = text.split('\n', 1)[0]
+    # 'obj.o: src.c a.h b.h' (skip a drive letter colon on Windows)
+    colon = rule.find(': ')
+    if colon < 0:
+        return []
+    deps = rule[colon + 2:].replace('\\ ', '\0').split()
+    return [d.replace('\0', ' ') for d in deps]
+
+
+class ObjectCache:
+    """Content-addressed object cache
+    
+    An object is identified by a base key (compiler, flags, source contents)
+    plus the contents of every header it included at the last compile. The
+    manifest of a base key lists those headers with their hashes, so a hit
+    is confirmed without running the preprocessor. The same layout is used
+    for the per-object stamp files in build/obj and for the optional shared
+    cache directory, which lets board variants and projects with identical
+    flags reuse each other's objects.
+    
+    Paths under the project root are stored as '<project>/...', so a shared
+    entry is checked against the headers of the project being built, not
+    those of the project that filled the cache.
+    """
+    
+    MAX_VARIANTS = 8    # Header sets remembered per base key
+    SIDECARS = ('.su', '.ci')   # Stack usage/call graph files of an object
+    
+    def __init__(self, cache_dir: Optional[Path], project_root: Path):
+        self.cache_dir = cache_dir
+        self.root = str(project_root.resolve())
+        self.digests: Dict[str, str] = {}
+        if cache_dir is not None:
+            (cache_dir / 'obj').mkdir(parents=True, exist_ok=True)
+            (cache_dir / 'manifest').mkdir(parents=True, exist_ok=True)
+    
+    def portable(self, path: str) -> str:
+        path = os.path.abspath(path)
+        if path.startswith(self.root + os.sep):
+            return '<project>' + path[len(self.root):]
+        return path
+    
+    def local(self, path: str) -> str:
+        if path.startswith('<project>'):
+            return self.root + path[len('<project>'):]
+        return path
+    
+    def digest(self, path: str) -> Optional[str]:
+        """Memoized file hash, None when the file is gone"""
+        if path not in self.digests:
+            try:
+                self.digests[path] = file_digest(Path(path))
+            except OSError:
+                self.digests[path] = ''
+        return self.digests[path] or None
+    
+    def header_digests(self, deps: List[str]) -> Dict[str, str]:
+        """Portable header paths -> hashes, for a stamp or manifest"""
+        return {self.portable(d): self.digest(os.path.abspath(d)) or ''
+                for d in deps}
+    
+    def headers_match(self, headers: Dict[str, str]) -> bool:
+        return all(self.digest(self.local(h)) == d for h, d in headers.items())
+    
+    def object_key(self, base: str, headers: Dict[str, str]) -> str:
+        h = hashlib.sha256(base.encode())
+        for path in sorted(headers):
+            h.update(f'{path}={headers[path]}'.encode())
+        return h.hexdigest()
+    
+    def _entries(self, base: str) -> List[Dict[str, str]]:
+        manifest = self.cache_dir / 'manifest' / f'{base}.json'
+        try:
+            return json.loads(manifest.read_text())['entries']
+        except (OSError, ValueError, KeyError):
+            return []
+    
+    def lookup(self, base: str) -> Optional[Tuple[Path, Dict[str, str]]]:
+        """Cached object for this base key whose headers are unchanged"""
+        if self.cache_dir is None:
+            return None
+        for headers in self._entries(base):
+            if self.headers_match(headers):
+                obj = self.cache_dir / 'obj' / f'{self.object_key(base, headers)}.o'
+                if obj.exists():
+                    return (obj, headers)
+        return None
+    
+    def store(self, base: str, headers: Dict[str, str], obj_file: Path):
+        if self.cache_dir is None:
+            return
+        key = self.object_key(base, headers)
+        for suffix in self.SIDECARS:
+            sidecar = obj_file.with_suffix(suffix)
+            if sidecar.exists():
+                self._publish(self.cache_dir / 'obj' / f'{key}{suffix}',
+                              lambda tmp: shutil.copyfile(sidecar, tmp))
+        self._publish(self.cache_dir / 'obj' / f'{key}.o',
+                      lambda tmp: shutil.copyfile(obj_file, tmp))
+        # Newest first; a few header variants per source (board configs)
+        entries = [headers] + [e for e in self._entries(base) if e != headers]
+        manifest = {'entries': entries[:self.MAX_VARIANTS]}
+        self._publish(self.cache_dir / 'manifest' / f'{base}.json',
+                      lambda tmp: tmp.write_text(json.dumps(manifest)))
+    
+    def _publish(self, dst: Path, write):
+        # Write-then-rename: concurrent jobs and CI runners never see a
+        # partial file, the last writer of an entry wins
+        tmp = dst.with_name(f'{dst.name}.{os.getpid()}.{threading.get_ident()}.tmp')
+        write(tmp)
+        os.replace(tmp, dst)
+
+
 class QKBuilder:
     """Automated build system for QP-QK projects"""
     
-    def __init__(self, project_root: str):
-        self.project_root = Path(project_root)
-        self.build_dir = self.project_root / "build"
+    def __init__(self, project_root: str, platform: Optional[str] = None,
+                 jobs: Optional[int] = None, cache_dir: Optional[str] = None,
+                 analyze: bool = True, kernel: Optional[str] = None,
+                 build_dir: Optional[str] = None):
+        self.project_root = Path(project_root).resolve()
+        self.build_dir = Path(build_dir).resolve() if build_dir \
+            else self.project_root / "build"
         self.config = self.load_build_config()
+        if kernel:
+            self.config['kernel'] = kernel
+        self.kernel = self.config.get('kernel', 'qk')
+        if self.kernel not in KERNELS:
+            raise ValueError(f"Unsupported kernel '{self.kernel}' "
+                             f"(supported: {', '.join(KERNELS)})")
+        self.jobs = jobs or self.config.get('jobs') or os.cpu_count() or 1
+        cache_dir = cache_dir or self.config.get('cache_dir') \
+            or os.environ.get('QK_BUILD_CACHE')
+        self.cache = ObjectCache(Path(cache_dir).expanduser() if cache_dir else None,
+                                 self.project_root)
+        if platform:
+            self.config['platform'] = platform
+            if platform in HOST_PLATFORMS:
+                self.config['toolchain'] = 'gcc'
         self.toolchain = self.setup_toolchain()
+        self.analyze = analyze and self.config.get('stack_analysis', {}) is not False \
+            and self.supports_stack_analysis()
         
     def load_build_config(self) -> Dict:
         """Load build configuration from project"""
@@ -64,14 +228,25 @@ class QKBuilder:
                 'objcopy': 'arm-none-eabi-objcopy',
                 'objdump': 'arm-none-eabi-objdump',
                 'size': 'arm-none-eabi-size',
+                'nm': 'arm-none-eabi-nm',
                 'gdb': 'arm-none-eabi-gdb'
             },
+            'gcc': {
+                'cc': 'gcc',
+                'ld': 'gcc',
+                'objcopy': 'objcopy',
+                'objdump': 'objdump',
+                'size': 'size',
+                'nm': 'nm',
+                'gdb': 'gdb'
+            },
             'clang': {
                 'cc': 'clang',  
                 'ld': 'clang',
                 'objcopy': 'llvm-objcopy',
                 'objdump': 'llvm-objdump',
                 'size': 'llvm-size',
+                'nm': 'llvm-nm',
                 'gdb': 'gdb'
             }
         }
@@ -79,6 +254,33 @@ class QKBuilder:
         toolchain_name = self.config.get('toolchain', 'gcc-arm-none-eabi')
         return toolchain_configs.get(toolchain_name, toolchain_configs['gcc-arm-none-eabi'])
     
+    def supports_stack_analysis(self) -> bool:
+        """The compiler writes call graphs with stack usage (GCC 10+)"""
+        try:
+            result = subprocess.run([self.toolchain['cc'], '-fcallgraph-info=su',
+                                     '-E', '-x', 'c', os.devnull],
+                                    capture_output=True, text=True)
+        except OSError:
+            return False
+        return result.returncode == 0
+    
+    def load_budgets(self) -> Dict:
+        """Footprint budgets: platform defaults, overridden by the project"""
+        budgets = {}
+        try:
+            with open(PLATFORM_CONFIGS, 'r') as f:
+                platforms = yaml.safe_load(f).get('platforms', {})
+            budgets = dict(platforms.get(self.config.get('platform', 'stm32f4'), {})
+                           .get('budgets', {}) or {})
+        except (OSError, yaml.YAMLError, AttributeError):
+            pass
+        project = self.config.get('budgets', {}) or {}
+        subsystems = dict(budgets.get('subsystems', {}) or {})
+        subsystems.update(project.get('subsystems', {}) or {})
+        budgets.update(project)
+        budgets['subsystems'] = subsystems
+        return budgets
+    
     def get_platform_flags(self) -> Dict:
         """Get platform-specific compiler flags"""
         platform_flags = {
@@ -101,6 +303,7 @@ class QKBuilder:
                     '-Wl,--gc-sections',
                     '-Wl,-Map=build/output.map'
                 ],
+                'libs': ['-lm'],
                 'linker_script': 'STM32F411RETx_FLASH.ld'
             },
             'esp32': {
@@ -126,14 +329,62 @@ class QKBuilder:
                     '-Wl,--gc-sections'
                 ],
                 'linker_script': 'msp430g2553.ld'
+            },
+            'posix': {
+                'cflags': [
+                    '-std=gnu99',   # POSIX APIs are hidden by strict c99
+                    '-pthread'
+                ],
+                'ldflags': [
+                    '-pthread',
+                    '-no-pie',      # Linked = run-time addresses (qs_dict.py)
+                    '-Wl,-Map=build/output.map'
+                ],
+                'libs': ['-lm']
             }
         }
         
         platform = self.config.get('platform', 'stm32f4')
         return platform_flags.get(platform, platform_flags['stm32f4'])
     
+    def is_host(self) -> bool:
+        """True when the firmware runs natively on the build machine"""
+        return self.config.get('platform') in HOST_PLATFORMS
+    
+    def get_platform_config(self) -> Dict:
+        """Per-platform overrides from the 'platforms:' config section"""
+        platforms = self.config.get('platforms', {}) or {}
+        return platforms.get(self.config.get('platform', 'stm32f4'), {}) or {}
+    
+    def collect_host_sources(self) -> List[Path]:
+        """Project sources for the posix platform
+        
+        Without a 'platforms: posix: sources:' override, the project's own
+        main.c/bsp.c (target hardware) are replaced by the SDK posix
+        templates and the SDK services are added; AO sources are reused.
+        """
+        override = self.get_platform_config().get('sources')
+        if override:
+            sources = []
+            for pattern in override:
+                sources.extend(self.project_root.glob(pattern))
+            return sources
+        
+        sources = []
+        for pattern in self.config.get('sources', ['src/*.c']):
+            for src in self.project_root.glob(pattern):
+                if src.name not in ('main.c', 'bsp.c') \
+                        and 'services' not in src.parts:
+                    sources.append(src)
+        sources.extend(sorted((TEMPLATES_DIR / 'platforms' / 'posix').glob('*.c')))
+        sources.extend(sorted((TEMPLATES_DIR / 'services').glob('*.c')))
+        return sources
+    
     def collect_sources(self) -> List[Path]:
         """Collect all source files for compilation"""
+        if self.is_host():
+            return self.collect_host_sources() + self.collect_qp_host_sources()
+        
         sources = []
         source_patterns = self.config.get('sources', ['src/*.c'])
         
@@ -153,35 +404,61 @@ class QKBuilder:
             qp_src = qp_path / 'src'
             if qp_src.exists():
                 sources.extend(qp_src.glob('qf/*.c'))
-                sources.extend(qp_src.glob('qk/*.c'))  # QK kernel
+                sources.extend(qp_src.glob(f'{self.kernel}/*.c'))  # QK or QV
                 sources.extend(qp_src.glob('qs/*.c'))   # QS tracing
         
         return sources
     
+    def collect_qp_host_sources(self) -> List[Path]:
+        """QP sources for the posix-qv port (QS transport is in bsp.c)"""
+        sources = []
+        qp_path = Path(self.config.get('qp_path', '../qpc'))
+        if qp_path.exists():
+            sources.extend((qp_path / 'src').glob('qf/*.c'))
+            if self.config.get('debug', True):
+                sources.extend(p for p in (qp_path / 'src').glob('qs/*.c')
+                               if p.name != 'qutest.c')
+            port_src = qp_path / 'ports' / 'posix-qv' / 'qf_port.c'
+            if port_src.exists():
+                sources.append(port_src)
+        return sources
+    
     def get_include_dirs(self) -> List[str]:
         """Get include directories"""
         includes = []
         
-        # Project includes
+        # Project includes (posix may override them)
         project_includes = self.config.get('includes', ['inc', 'src'])
+        if self.is_host():
+            project_includes = self.get_platform_config().get(
+                'includes', project_includes)
         for inc in project_includes:
             inc_path = self.project_root / inc
             if inc_path.exists():
                 includes.append(str(inc_path))
         
+        # Host BSP headers come first so they shadow the target ones
+        if self.is_host():
+            includes.insert(0, str(TEMPLATES_DIR / 'platforms' / 'posix'))
+            includes.append(str(TEMPLATES_DIR / 'services'))
+        
         # QP framework includes
         qp_path = Path(self.config.get('qp_path', '../qpc'))
         if qp_path.exists():
+            port = (qp_path / 'ports' / 'posix-qv') if self.is_host() \
+                else (qp_path / 'ports' / 'arm-cm' / self.kernel / 'gnu')
             includes.extend([
                 str(qp_path / 'include'),
-                str(qp_path / 'ports' / 'arm-cm' / 'qk' / 'gnu')
+                str(port)
             ])
         
         return includes
     
     def get_defines(self) -> List[str]:
         """Get preprocessor defines"""
-        defines = self.config.get('defines', [])
+        defines = list(self.config.get('defines', []))
+        if self.is_host():
+            defines = list(self.get_platform_config().get('defines', []))
         
         # Add QP-specific defines
         defines.extend([
@@ -196,9 +473,9 @@ class QKBuilder:
         print("Compiling source files...")
         
         # Create build directory
-        self.build_dir.mkdir(exist_ok=True)
+        self.build_dir.mkdir(parents=True, exist_ok=True)
         obj_dir = self.build_dir / "obj"
-        obj_dir.mkdir(exist_ok=True)
+        obj_dir.mkdir(parents=True, exist_ok=True)
         
         objects = []
         platform_flags = self.get_platform_flags()
@@ -216,6 +493,10 @@ class QKBuilder:
         if self.config.get('debug', True):
             cflags.extend(['-g', '-DDEBUG'])
         
+        # Frame sizes and call graph of every object, for analyze_footprint()
+        if self.analyze:
+            cflags.extend(['-fstack-usage', '-fcallgraph-info=su'])
+        
         # Add platform-specific flags
         cflags.extend(platform_flags['cflags'])
         
@@ -227,27 +508,90 @@ class QKBuilder:
         for define in defines:
             cflags.append(f'-D{define}')
         
-        # Compile each source file
-        for src in sources:
-            obj_file = obj_dir / f"{src.stem}.o"
-            objects.append(obj_file)
-            
-            # Check if compilation needed
-            if (not obj_file.exists() or 
-                src.stat().st_mtime > obj_file.stat().st_mtime):
-                
-                cmd = [self.toolchain['cc']] + cflags + ['-c', str(src), '-o', str(obj_file)]
-                
-                print(f"Compiling {src.name}...")
-                result = subprocess.run(cmd, capture_output=True, text=True)
-                
-                if result.returncode != 0:
-                    print(f"Error compiling {src.name}:")
-                    print(result.stderr)
-                    sys.exit(1)
+        # Compile on a worker pool; each job decides on its own whether the
+        # object is up to date, comes from the cache or must be compiled
+        objects = [self.object_path(obj_dir, src) for src in sources]
+        with ThreadPoolExecutor(max_workers=self.jobs) as pool:
+            results = list(pool.map(
+                lambda job: self.compile_source(job[0], job[1], cflags),
+                zip(sources, objects)))
+        
+        failed = [(src, err) for src, (state, err) in zip(sources, results)
+                  if state == 'failed']
+        for src, err in failed:
+            print(f"Error compiling {src.name}:")
+            print(err)
+        if failed:
+            sys.exit(1)
+        
+        counts = {state: sum(1 for r in results if r[0] == state)
+                  for state in ('compiled', 'cached', 'up-to-date')}
+        print(f"{counts['compiled']} compiled, {counts['cached']} from cache, "
+              f"{counts['up-to-date']} up to date ({self.jobs} jobs)")
         
         return objects
     
+    def object_path(self, obj_dir: Path, src: Path) -> Path:
+        """Object file name, unique per source path (same stems don't collide)"""
+        tag = hashlib.sha1(str(src.resolve()).encode()).hexdigest()[:8]
+        return obj_dir / f"{src.stem}_{tag}.o"
+    
+    def base_key(self, src: Path, cflags: List[str]) -> str:
+        """Hash of compiler, flags and source contents
+        
+        The project root is normalized out of the flags so that identical
+        projects in different checkouts share cache entries.
+        """
+        root = str(self.project_root.resolve())
+        h = hashlib.sha256(self.toolchain['cc'].encode())
+        for flag in cflags:
+            h.update(b'\0' + flag.replace(root, '<project>').encode())
+        h.update(b"\0" + (self.cache.digest(os.path.abspath(src)) or "").encode())
+        return h.hexdigest()
+    
+    def compile_source(self, src: Path, obj_file: Path,
+                       cflags: List[str]) -> Tuple[str, str]:
+        """Bring one object up to date: (state, compiler errors)"""
+        base = self.base_key(src, cflags)
+        stamp_file = obj_file.with_suffix('.json')
+        
+        # Up to date: same flags and source, none of its headers changed
+        try:
+            stamp = json.loads(stamp_file.read_text())
+            if (obj_file.exists() and stamp['base'] == base
+                    and self.cache.headers_match(stamp['headers'])):
+                return ('up-to-date', '')
+        except (OSError, ValueError, KeyError):
+            pass
+        
+        hit = self.cache.lookup(base)
+        if hit is not None:
+            cached_obj, headers = hit
+            shutil.copyfile(cached_obj, obj_file)
+            for suffix in ObjectCache.SIDECARS:
+                if cached_obj.with_suffix(suffix).exists():
+                    shutil.copyfile(cached_obj.with_suffix(suffix),
+                                    obj_file.with_suffix(suffix))
+            stamp_file.write_text(json.dumps({'base': base, 'headers': headers}))
+            return ('cached', '')
+        
+        dep_file = obj_file.with_suffix('.d')
+        cmd = ([self.toolchain['cc']] + cflags +
+               ['-MMD', '-MF', str(dep_file),
+                '-c', str(src), '-o', str(obj_file)])
+        print(f"Compiling {src.name}...")
+        result = subprocess.run(cmd, capture_output=True, text=True)
+        if result.returncode != 0:
+            stamp_file.unlink(missing_ok=True)
+            return ('failed', result.stderr)
+        
+        src_path = os.path.abspath(src)
+        headers = self.cache.header_digests(
+            [d for d in parse_depfile(dep_file) if os.path.abspath(d) != src_path])
+        stamp_file.write_text(json.dumps({'base': base, 'headers': headers}))
+        self.cache.store(base, headers, obj_file)
+        return ('compiled', '')
+    
     def link_executable(self, objects: List[Path]) -> Path:
         """Link object files into executable"""
         print("Linking executable...")
@@ -255,17 +599,24 @@ class QKBuilder:
         platform_flags = self.get_platform_flags()
         output_elf = self.build_dir / f"{self.config.get('project_name', 'firmware')}.elf"
         
-        # Linker flags
-        ldflags = platform_flags['ldflags']
+        # Linker flags (map file in this project's build dir, whatever the cwd)
+        ldflags = [f.replace('-Map=build/', f'-Map={self.build_dir}/')
+                   for f in platform_flags['ldflags']]
         
         # Add linker script if specified
-        linker_script = self.project_root / platform_flags.get('linker_script', '')
-        if linker_script.exists():
-            ldflags.extend(['-T', str(linker_script)])
+        if platform_flags.get('linker_script'):
+            linker_script = self.project_root / platform_flags['linker_script']
+            if linker_script.exists():
+                ldflags.extend(['-T', str(linker_script)])
+        
+        # Libraries go after the objects that use them (project ones first,
+        # e.g. CMSIS-DSP: ['-L<path>/Lib/GCC', '-larm_cortexM4lf_math'])
+        libs = list(self.config.get('libs', [])) if not self.is_host() else []
+        libs.extend(platform_flags.get('libs', []))
         
         # Link command
         cmd = ([self.toolchain['ld']] + ldflags + 
-               [str(obj) for obj in objects] + 
+               [str(obj) for obj in objects] + libs +
                ['-o', str(output_elf)])
         
         result = subprocess.run(cmd, capture_output=True, text=True)
@@ -321,6 +672,31 @@ class QKBuilder:
         with open(size_file, 'w') as f:
             f.write(result.stdout)
     
+    def analyze_footprint(self, elf_file: Path, sources: List[Path]) -> bool:
+        """Worst-case stack and static RAM against the budgets"""
+        print("Analyzing stack and RAM footprint...")
+        
+        settings = self.config.get('stack_analysis', {}) or {}
+        analyzer = FootprintAnalyzer(self.toolchain, self.build_dir / 'obj',
+                                     sources, self.load_budgets(),
+                                     settings if isinstance(settings, dict) else {},
+                                     preemptive=not self.is_host()
+                                     and self.kernel == 'qk')
+        stack = analyzer.analyze_stack()
+        ram = analyzer.analyze_ram(elf_file)
+        analyzer.print_report(stack, ram)
+        
+        # Save footprint report
+        report_file = self.build_dir / "footprint_report.json"
+        with open(report_file, 'w') as f:
+            json.dump({'stack': stack, 'ram': ram, 'warnings': analyzer.errors},
+                      f, indent=2, default=list)
+        
+        over = analyzer.check(stack, ram)
+        for msg in over:
+            print(f"ERROR: Budget exceeded: {msg}")
+        return not over
+    
     def validate_build(self, elf_file: Path) -> bool:
         """Validate the built firmware"""
         print("Validating build...")
@@ -352,11 +728,13 @@ class QKBuilder:
             print(f"ERROR: Missing required symbols: {missing_symbols}")
             validation_passed = False
         
-        # Check for QK kernel symbols
-        qk_symbols = ['QK_sched_', 'QK_activate_']
-        qk_found = any(sym in result.stdout for sym in qk_symbols)
-        if not qk_found:
-            print("WARNING: QK kernel symbols not found - ensure QK is linked")
+        # Check for the kernel symbols (the host build uses posix-qv)
+        if not self.is_host():
+            kernel_symbols = ['QK_sched_', 'QK_activate_'] if self.kernel == 'qk' \
+                else ['QV_onIdle']
+            if not any(sym in result.stdout for sym in kernel_symbols):
+                print(f"WARNING: {self.kernel.upper()} kernel symbols not found "
+                      f"- ensure {self.kernel.upper()} is linked")
         
         return validation_passed
     
@@ -367,6 +745,8 @@ class QKBuilder:
         print(f"Project: {self.project_root}")
         print(f"Platform: {self.config.get('platform', 'unknown')}")
         print(f"Toolchain: {self.config.get('toolchain', 'unknown')}")
+        if not self.is_host():
+            print(f"Kernel: {self.kernel.upper()}")
         print()
         
         try:
@@ -380,13 +760,17 @@ class QKBuilder:
             # Link
             elf_file = self.link_executable(objects)
             
-            # Generate binaries
-            outputs = self.generate_binary(elf_file)
+            # Generate binaries (a host executable is run as is)
+            outputs = {} if self.is_host() else self.generate_binary(elf_file)
             outputs['elf'] = elf_file
             
             # Analyze size
             self.analyze_size(elf_file)
             
+            if self.analyze and not self.analyze_footprint(elf_file, sources):
+                print("Footprint budget check failed!")
+                sys.exit(1)
+            
             # Validate
             if not self.validate_build(elf_file):
                 print("Build validation failed!")
@@ -412,6 +796,14 @@ class QKBuilder:
                 'build_time': time.time() - start_time
             }
     
+    def run(self, elf_file: Path, args: List[str]) -> int:
+        """Run a host (posix) build, e.g. for load tests"""
+        if not self.is_host():
+            print("Error: --run needs a host platform (--platform posix)")
+            return 1
+        print(f"Running {elf_file.name} {' '.join(args)}")
+        return subprocess.run([str(elf_file)] + args).returncode
+    
     def clean(self):
         """Clean build artifacts"""
         print("Cleaning build artifacts...")
@@ -436,12 +828,35 @@ def main():
                        help='Only clean, do not build')
     parser.add_argument('--verbose', '-v', action='store_true',
                        help='Verbose output')
+    parser.add_argument('--jobs', '-j', type=int,
+                       help='Parallel compile jobs (default: CPU count)')
+    parser.add_argument('--cache',
+                       help='Shared object cache directory '
+                            '(default: cache_dir in the config or $QK_BUILD_CACHE)')
+    parser.add_argument('--no-analyze', action='store_true',
+                       help='Skip the stack/RAM footprint analysis and budgets')
+    parser.add_argument('--platform',
+                       help='Override the configured platform '
+                            '(posix = native host build)')
+    parser.add_argument('--kernel', choices=KERNELS,
+                       help='Override the configured kernel of a target build '
+                            '(qk = preemptive, qv = cooperative)')
+    parser.add_argument('--build-dir',
+                       help='Build output directory (default: <project>/build)')
+    parser.add_argument('--run', action='store_true',
+                       help='Run the host build afterwards; arguments after -- '
+                            'are passed on (e.g. -- --duration 10 --load 3:5:5000)')
+    parser.add_argument('run_args', nargs=argparse.REMAINDER,
+                       help=argparse.SUPPRESS)
     
     args = parser.parse_args()
+    run_args = args.run_args[1:] if args.run_args[:1] == ['--'] else args.run_args
     
     # Create builder
     try:
-        builder = QKBuilder(args.project)
+        builder = QKBuilder(args.project, args.platform, args.jobs, args.cache,
+                            analyze=not args.no_analyze, kernel=args.kernel,
+                            build_dir=args.build_dir)
     except Exception as e:
         print(f"Error initializing builder: {e}")
         sys.exit(1)
@@ -456,6 +871,9 @@ def main():
         
         if not result['success']:
             sys.exit(1)
+        
+        if args.run:
+            sys.exit(builder.run(result['outputs']['elf'], run_args))
 
 
 if __name__ == '__main__':
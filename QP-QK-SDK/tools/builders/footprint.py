@@ -0,0 +1,398 @@
+#!/usr/bin/env python3
+"""
+QP-QK SDK Footprint Analyzer
+Static worst-case stack and RAM footprint of a QP-QK build
+
+Used by build.py after linking. The objects are compiled with
+-fstack-usage and -fcallgraph-info=su, which give the frame size of every
+function and its direct calls. From these the analyzer computes:
+
+- the worst-case stack of every AO (the deepest path through its state
+  handlers, plus the QK activation and the QHsm/QMsm dispatcher frames)
+- the worst-case stack of every ISR (functions named *_Handler)
+- the total bound of the shared stack: main() plus one AO per preemption
+  level along the QK priorities, plus every ISR level, plus an exception
+  frame per nesting level (on the cooperative POSIX port only one AO runs
+  at a time)
+- static RAM per subsystem, from the symbol sizes of the ELF
+
+and checks them against the budgets of the platform
+(config/platforms/platform_configs.yaml) and of the project.
+
+Optional 'stack_analysis:' settings in build_config.yaml (or false to
+turn the analysis off):
+  priorities:   {AOClass: prio} when QACTIVE_START() can't be resolved
+  isr_levels:   {ISR_Handler: level}, ISRs of one NVIC level don't nest
+  extern:       {function: bytes} for code without a call graph (libc,
+                assembly) and for indirect callees
+  subsystems:   {name: regex} extra RAM subsystems (checked first)
+  exception_frame: bytes per nesting level (default: the platform budget)
+"""
+
+import re
+import subprocess
+from pathlib import Path
+from typing import Dict, List, Optional, Set, Tuple
+
+# QP functions that call state handlers through pointers; these indirect
+# calls are covered by adding the AO's handlers on top of them
+DISPATCHERS = ('QHsm_dispatch_', 'QMsm_dispatch_')
+QP_INDIRECT = DISPATCHERS + ('QHsm_init_', 'QMsm_init_', 'QHsm_tran_',
+                             'QMsm_execTatbl_', 'QMsm_exitToTranSource_',
+                             'QMsm_enterHistory_', 'QHsm_isIn_', 'QMsm_isInState',
+                             'QHsm_childState', 'QK_activate_', 'QF_run',
+                             'QActive_start_', 'QS_rxParse_', 'QS_rxHandleGoodFrame_')
+
+# Static RAM subsystems, matched on the symbol name (first match wins)
+SUBSYSTEMS = [
+    ('event_pools', r'(?i)pool'),
+    ('queues', r'(?i)queue|qsto'),
+    ('qs_buffers', r'(?i)^(l_)?qs|^QS_'),
+    ('subscriber_lists', r'(?i)subscr'),
+    ('kernel', r'^(QF_|QK_|QV_|QActive_|QTimeEvt_|QHsm_|QMsm_)'),
+]
+
+ISR_NAME = re.compile(r'^\w+_(IRQ)?Handler$')
+CI_NODE = re.compile(r'node: \{ title: "([^"]+)" label: "([^"]*)"')
+CI_EDGE = re.compile(r'edge: \{ sourcename: "([^"]+)" targetname: "([^"]+)"')
+CI_STACK = re.compile(r'\\n(\d+) bytes \(([a-z,]+)\)')
+HANDLER = re.compile(r'\bQState\s+(\w+)\s*\(\s*(\w+)\s*\*\s*const\s+me\b')
+AO_START = re.compile(r'QACTIVE_START\(\s*&?\s*(\w+)(?:\.super)?\s*,\s*([^,]+?)\s*,')
+DEFINE = re.compile(r'^\s*#\s*define\s+(\w+)\s+([^/\n]+)', re.M)
+ENUM_VALUE = re.compile(r'\b(\w+)\s*=\s*([^,}\n/]+)')
+
+
+class CallGraph:
+    """Functions from the -fcallgraph-info files of one build"""
+
+    def __init__(self):
+        self.stack: Dict[str, int] = {}         # func -> frame bytes
+        self.dynamic: Set[str] = set()          # alloca/VLA, not bounded
+        self.calls: Dict[str, Set[str]] = {}    # func -> direct callees
+        self.indirect: Set[str] = set()         # funcs with pointer calls
+        self.unresolved: Set[str] = set()       # callees without a frame
+        self.memo: Dict[str, Tuple[Optional[int], List[str]]] = {}
+
+    def load(self, ci_files: List[Path]):
+        for ci in ci_files:
+            text = ci.read_text(errors='replace')
+            # Static functions of one file shadow global ones of the same
+            # name: resolve calls in this file first
+            local: Dict[str, str] = {}
+            for title, label in CI_NODE.findall(text):
+                m = CI_STACK.search(label)
+                if m is None:
+                    continue                    # Declared only (external)
+                key = title if title not in self.stack else f'{title}@{ci.stem}'
+                local[title] = key
+                self.stack[key] = int(m.group(1))
+                self.calls.setdefault(key, set())
+                if 'dynamic' in m.group(2) and 'bounded' not in m.group(2):
+                    self.dynamic.add(key)
+            for src, dst in CI_EDGE.findall(text):
+                caller = local.get(src, src)
+                if dst == '__indirect_call':
+                    self.indirect.add(caller)
+                else:
+                    self.calls.setdefault(caller, set()).add(local.get(dst, dst))
+
+    def worst(self, func: str, extern: Dict[str, int],
+              path: Tuple[str, ...] = ()) -> Tuple[Optional[int], List[str]]:
+        """Deepest stack from func: (bytes or None if unbounded, path)"""
+        if func in path:
+            raise RecursionError(' -> '.join(path + (func,)))
+        if func in self.memo:
+            return self.memo[func]
+        if func not in self.stack:
+            if func not in extern:
+                self.unresolved.add(func)
+            return extern.get(func, 0), [func]
+        if func in self.dynamic:
+            return None, [func]
+        best, best_path = 0, []
+        for callee in sorted(self.calls.get(func, ())):
+            depth, sub = self.worst(callee, extern, path + (func,))
+            if depth is None:
+                best, best_path = None, sub
+                break
+            if depth > best:
+                best, best_path = depth, sub
+        result = (None if best is None else self.stack[func] + best,
+                  [func] + best_path)
+        self.memo[func] = result
+        return result
+
+
+class FootprintAnalyzer:
+    """Stack and RAM analysis of a linked build against budgets"""
+
+    def __init__(self, toolchain: Dict, obj_dir: Path, sources: List[Path],
+                 budgets: Dict, settings: Dict, preemptive: bool):
+        self.toolchain = toolchain
+        self.obj_dir = obj_dir
+        self.sources = sources
+        self.budgets = budgets or {}
+        self.settings = settings or {}
+        self.preemptive = preemptive
+        self.extern = dict(self.settings.get('extern', {}) or {})
+        self.graph = CallGraph()
+        self.errors: List[str] = []
+
+    #------------------------------------------------------------------------
+    # Source scan: which state handlers belong to which AO, and priorities
+    #------------------------------------------------------------------------
+
+    def scan_sources(self) -> Dict[str, Dict]:
+        """AO class -> {handlers, prio}"""
+        aos: Dict[str, Dict] = {}
+        symbols: Dict[str, str] = {}
+        starts: List[Tuple[str, str]] = []
+        instances: Dict[str, str] = {}
+        for src in self.sources:
+            try:
+                text = src.read_text(errors='replace')
+            except OSError:
+                continue
+            for func, cls in HANDLER.findall(text):
+                aos.setdefault(cls, {'handlers': set(), 'prio': None})
+                aos[cls]['handlers'].add(func)
+            starts.extend(AO_START.findall(text))
+            for cls, inst in re.findall(r'^\s*(?:static\s+)?(\w+)\s+(AO_\w+)\s*;',
+                                        text, re.M):
+                instances[inst] = cls
+        # Priority macros and enumerators of the project headers
+        for header in {p for src in self.sources
+                       for p in (src.parent, src.parent.parent / 'inc')}:
+            for h in sorted(header.glob('*.h')) if header.is_dir() else []:
+                text = h.read_text(errors='replace')
+                symbols.update({k: v.strip() for k, v in DEFINE.findall(text)})
+                symbols.update({k: v.strip() for k, v in ENUM_VALUE.findall(text)
+                                if k.isupper()})
+
+        for inst, expr in starts:
+            cls = instances.get(inst, inst[3:] if inst.startswith('AO_') else inst)
+            if cls in aos:
+                aos[cls]['prio'] = self.eval_prio(expr, symbols)
+        for cls, prio in (self.settings.get('priorities', {}) or {}).items():
+            aos.setdefault(cls, {'handlers': set(), 'prio': None})['prio'] = prio
+        return aos
+
+    @staticmethod
+    def eval_prio(expr: str, symbols: Dict[str, str], depth: int = 0) -> Optional[int]:
+        """Value of a priority expression such as (AO_BLINKY_PRIO + 1U)"""
+        if depth > 8:
+            return None
+        out = expr
+        for name in set(re.findall(r'\b[A-Za-z_]\w*\b', expr)):
+            if name not in symbols:
+                return None
+            value = FootprintAnalyzer.eval_prio(symbols[name], symbols, depth + 1)
+            if value is None:
+                return None
+            out = re.sub(rf'\b{name}\b', str(value), out)
+        out = re.sub(r'(\d+)[uU]\b', r'\1', out)
+        if not re.fullmatch(r'[\d\s()+\-*]+', out):
+            return None
+        try:
+            return int(eval(out, {'__builtins__': {}}))
+        except (SyntaxError, ValueError):
+            return None
+
+    #------------------------------------------------------------------------
+    # Stack
+    #------------------------------------------------------------------------
+
+    def worst(self, func: str) -> Tuple[Optional[int], List[str]]:
+        try:
+            return self.graph.worst(func, self.extern)
+        except RecursionError as e:
+            self.errors.append(f"Recursion, stack not bounded: {e}")
+            return None, [func]
+
+    def analyze_stack(self) -> Dict:
+        self.graph.load(sorted(self.obj_dir.glob('*.ci')))
+        frame = int(self.settings.get('exception_frame',
+                                      self.budgets.get('exception_frame',
+                                                       32 if self.preemptive else 0)))
+
+        # QK activation and dispatcher frames under every handler
+        def linked(func):
+            return (self.worst(func)[0] or 0) if func in self.graph.stack else 0
+        activate = linked('QK_activate_') if self.preemptive else 0
+        dispatch = max(linked(d) for d in DISPATCHERS)
+
+        aos = []
+        for cls, info in sorted(self.scan_sources().items()):
+            best, best_path = 0, []
+            for h in sorted(info['handlers']):
+                if h not in self.graph.stack:
+                    continue
+                depth, path = self.worst(h)
+                if depth is None:
+                    best = None
+                    break
+                if depth > best:
+                    best, best_path = depth, path
+            if best is not None and not best_path:
+                continue                        # No handler linked in
+            aos.append({'name': cls, 'prio': info['prio'],
+                        'handler': best, 'path': best_path,
+                        'stack': None if best is None
+                                 else activate + dispatch + best})
+
+        isr_levels = self.settings.get('isr_levels', {}) or {}
+        isrs = []
+        for func in sorted(self.graph.stack):
+            # PendSV only returns to thread mode for QK_activate_(), its
+            # frame is the exception frame of the AO level
+            if ISR_NAME.match(func) and func != 'PendSV_Handler':
+                depth, path = self.worst(func)
+                isrs.append({'name': func, 'level': isr_levels.get(func, func),
+                             'stack': depth, 'path': path})
+
+        main, main_path = self.worst('main')
+        levels = self.levels(aos, isrs)
+        total = None
+        if main is not None and all(v is not None for _, v in levels):
+            total = main + sum(v for _, v in levels) + frame * len(levels)
+
+        for func in sorted(self.graph.indirect):
+            if func not in QP_INDIRECT and not ISR_NAME.match(func):
+                self.errors.append(f"Indirect call in {func} not followed "
+                                   "(add its callees to stack_analysis.extern)")
+        for func in sorted(self.graph.dynamic):
+            self.errors.append(f"Unbounded dynamic stack in {func}")
+
+        return {
+            'main': main, 'main_path': main_path,
+            'activate': activate, 'dispatch': dispatch,
+            'exception_frame': frame,
+            'aos': aos, 'isrs': isrs,
+            'levels': [{'level': name, 'stack': v} for name, v in levels],
+            'total': total,
+            'unresolved': sorted(self.graph.unresolved - set(self.extern)),
+        }
+
+    def levels(self, aos: List[Dict], isrs: List[Dict]) -> List[Tuple[str, Optional[int]]]:
+        """Worst stack per nesting level, lowest priority first
+
+        Under QK an AO preempts only lower priorities, so at most one AO per
+        priority is on the stack: the levels are the distinct priorities
+        (an AO with an unknown priority is a level of its own). The
+        cooperative kernel runs one AO at a time: a single level. ISRs
+        nest per NVIC level on top of any AO.
+        """
+        def worst_of(items):
+            values = [i['stack'] for i in items]
+            return None if None in values else max(values, default=0)
+
+        groups: Dict[str, List[Dict]] = {}
+        if self.preemptive:
+            for ao in sorted(aos, key=lambda a: (a['prio'] is None, a['prio'] or 0)):
+                key = f"prio {ao['prio']}" if ao['prio'] is not None else ao['name']
+                groups.setdefault(key, []).append(ao)
+        elif aos:
+            groups['AOs'] = aos
+        for isr in isrs:
+            groups.setdefault(f"ISR {isr['level']}", []).append(isr)
+        return [(name, worst_of(items)) for name, items in groups.items()]
+
+    #------------------------------------------------------------------------
+    # Static RAM
+    #------------------------------------------------------------------------
+
+    def analyze_ram(self, elf_file: Path) -> Dict:
+        result = subprocess.run([self.toolchain['size'], '-A', '-d', str(elf_file)],
+                                capture_output=True, text=True)
+        total = 0
+        for line in result.stdout.splitlines():
+            parts = line.split()
+            if len(parts) >= 2 and parts[1].isdigit() and \
+                    re.match(r'^\.(data|bss|noinit|tbss|tdata)\b', parts[0]):
+                total += int(parts[1])
+
+        patterns = [(name, re.compile(rx)) for name, rx in SUBSYSTEMS]
+        for name, rx in (self.settings.get('subsystems', {}) or {}).items():
+            patterns.insert(0, (name, re.compile(rx)))
+        subsystems: Dict[str, int] = {name: 0 for name, _ in patterns}
+        subsystems['other'] = 0
+        symbols: Dict[str, List[Tuple[str, int]]] = {}
+
+        nm = self.toolchain.get('nm', 'nm')
+        result = subprocess.run([nm, '-S', '-t', 'd', str(elf_file)],
+                                capture_output=True, text=True)
+        for line in result.stdout.splitlines():
+            parts = line.split()
+            if len(parts) != 4 or parts[2] not in 'bBdD':
+                continue
+            size, sym = int(parts[1]), parts[3]
+            name = next((n for n, rx in patterns if rx.search(sym)), 'other')
+            subsystems[name] += size
+            symbols.setdefault(name, []).append((sym, size))
+
+        return {'total': total, 'subsystems': subsystems,
+                'largest': {n: sorted(s, key=lambda x: -x[1])[:3]
+                            for n, s in symbols.items()}}
+
+    #------------------------------------------------------------------------
+    # Report and budgets
+    #------------------------------------------------------------------------
+
+    def check(self, stack: Dict, ram: Dict) -> List[str]:
+        """Budget violations (also unbounded results when a stack budget is set)"""
+        over = []
+        limit = self.budgets.get('stack_bytes')
+        if limit is not None:
+            if stack['total'] is None:
+                over.append("Stack bound unknown (recursion or dynamic stack) "
+                            f"with a budget of {limit} bytes")
+            elif stack['total'] > limit:
+                over.append(f"Stack: {stack['total']} bytes > budget {limit}")
+        limit = self.budgets.get('ram_bytes')
+        if limit is not None and ram['total'] > limit:
+            over.append(f"Static RAM: {ram['total']} bytes > budget {limit}")
+        for name, limit in (self.budgets.get('subsystems', {}) or {}).items():
+            used = ram['subsystems'].get(name, 0)
+            if used > limit:
+                over.append(f"RAM {name}: {used} bytes > budget {limit}")
+        return over
+
+    def print_report(self, stack: Dict, ram: Dict):
+        def fmt(v):
+            return 'unbounded' if v is None else f'{v}'
+
+        print("\nWorst-case stack (bytes):")
+        print(f"  {'main()':<28} {fmt(stack['main']):>9}  "
+              f"{' > '.join(stack['main_path'][:6])}")
+        print(f"  {'Activation + dispatch':<28} "
+              f"{stack['activate'] + stack['dispatch']:>9}")
+        for ao in stack['aos']:
+            prio = '?' if ao['prio'] is None else ao['prio']
+            print(f"  {'AO ' + ao['name'] + f' (prio {prio})':<28} "
+                  f"{fmt(ao['stack']):>9}  {' > '.join(ao['path'][:6])}")
+        for isr in stack['isrs']:
+            print(f"  {'ISR ' + isr['name']:<28} {fmt(isr['stack']):>9}  "
+                  f"{' > '.join(isr['path'][:6])}")
+        print(f"  Nesting levels: " + ', '.join(
+            f"{lv['level']} {fmt(lv['stack'])}" for lv in stack['levels']))
+        print(f"  {'Total (+' + str(stack['exception_frame']) + ' B/level)':<28} "
+              f"{fmt(stack['total']):>9}  budget "
+              f"{self.budgets.get('stack_bytes', '-')}")
+        if stack['unresolved']:
+            print(f"  No frame size (counted as 0): "
+                  f"{', '.join(stack['unresolved'][:12])}"
+                  + (' ...' if len(stack['unresolved']) > 12 else ''))
+
+        print("\nStatic RAM (bytes):")
+        sub_budgets = self.budgets.get('subsystems', {}) or {}
+        for name, used in ram['subsystems'].items():
+            if not used and name not in sub_budgets:
+                continue
+            largest = ', '.join(f"{s} {n}" for s, n in ram['largest'].get(name, []))
+            print(f"  {name:<28} {used:>9}  budget {sub_budgets.get(name, '-'):<7} "
+                  f"{largest}")
+        print(f"  {'Total (.data + .bss)':<28} {ram['total']:>9}  budget "
+              f"{self.budgets.get('ram_bytes', '-')}")
+
+        for err in self.errors:
+            print(f"WARNING: {err}")
@@ -13,16 +13,129 @@ import argparse
 import subprocess
 import json
 import time
+import re
+import zlib
+import hashlib
+import threading
+from concurrent.futures import ThreadPoolExecutor, as_completed
 from pathlib import Path
-from typing import Dict, List, Optional
+from typing import Dict, List, Optional, Tuple
+
+# Interfaces that can program, read back and verify address ranges
+DELTA_INTERFACES = ('stlink', 'openocd', 'jlink')
+
+# Scripted sessions need no server ports, and parallel fleet sessions would
+# collide on the defaults (3333/6666/4444)
+OPENOCD_NO_SERVERS = ('gdb_port disabled', 'tcl_port disabled', 'telnet_port disabled')
+
+# STM32F4 sector layout: (sector size, count) from the flash base
+STM32F4_SECTORS = [(16 * 1024, 4), (64 * 1024, 1), (128 * 1024, 11)]
+
+
+def parse_size(text) -> int:
+    """'512K' / '1M' / 4096 -> bytes"""
+    text = str(text).strip().upper()
+    scale = {'K': 1024, 'M': 1024 * 1024}.get(text[-1:], 1)
+    return int(text.rstrip('KMB') or 0, 0) * scale
+
+
+def sector_layout(config: Dict) -> List[Tuple[int, int]]:
+    """(address, size) of each flash sector covered by 'flash_size'
+    
+    'sectors' in flash_config.json overrides the STM32F4 default, as a
+    list of [size, count] pairs, e.g. [["2K", 256]] for a uniform part.
+    """
+    base = int(config.get('flash_base', '0x08000000'), 0)
+    total = parse_size(config.get('flash_size', '512K'))
+    groups = [(parse_size(size), int(count))
+              for size, count in config.get('sectors', [])] or STM32F4_SECTORS
+    
+    sectors = []
+    addr = base
+    for size, count in groups:
+        for _ in range(count):
+            if addr - base >= total:
+                return sectors
+            sectors.append((addr, size))
+            addr += size
+    return sectors
+
+
+def sector_crcs(image: bytes, base: int,
+                sectors: List[Tuple[int, int]]) -> Dict[str, int]:
+    """CRC32 of the image bytes in every sector the image touches
+    
+    Keys are hex sector addresses (JSON-friendly). The last sector is
+    covered only up to the end of the image, so a read-back truncated to
+    the image length gives the same CRCs.
+    """
+    crcs = {}
+    for addr, size in sectors:
+        start = addr - base
+        if start >= len(image):
+            break
+        chunk = image[start:start + size]
+        crcs[f'0x{addr:08X}'] = zlib.crc32(chunk) & 0xFFFFFFFF
+    return crcs
+
+
+class FlashStateCache:
+    """Per-probe record of what was last flashed (sector CRCs)
+    
+    Keyed by interface and probe serial, so each board on a rig has its
+    own entry. Stored in ~/.cache/qp-qk/flash unless 'flash_cache_dir'
+    is set. The record is only as good as the assumption that nothing
+    else flashed the board since; --full refreshes it.
+    """
+    
+    def __init__(self, cache_dir: Optional[str] = None):
+        self.cache_dir = Path(cache_dir or '~/.cache/qp-qk/flash').expanduser()
+    
+    def _path(self, interface: str, serial: str) -> Path:
+        return self.cache_dir / f"{interface}-{serial}.json"
+    
+    def load(self, interface: str, serial: str, base: int) -> Optional[Dict[str, int]]:
+        try:
+            with open(self._path(interface, serial), 'r') as f:
+                state = json.load(f)
+        except (OSError, ValueError):
+            return None
+        if state.get('flash_base') != base:
+            return None
+        return state.get('sectors')
+    
+    def save(self, interface: str, serial: str, base: int,
+             crcs: Dict[str, int], image: bytes):
+        self.cache_dir.mkdir(parents=True, exist_ok=True)
+        state = {
+            'flash_base': base,
+            'image_sha256': hashlib.sha256(image).hexdigest(),
+            'image_size': len(image),
+            'sectors': crcs,
+            'time': time.strftime('%Y-%m-%dT%H:%M:%S')
+        }
+        tmp = self._path(interface, serial).with_suffix('.tmp')
+        with open(tmp, 'w') as f:
+            json.dump(state, f, indent=2)
+        os.replace(tmp, self._path(interface, serial))
+    
+    def invalidate(self, interface: str, serial: str):
+        try:
+            self._path(interface, serial).unlink()
+        except OSError:
+            pass
+
 
 class QKFlasher:
     """Automated flash and deployment system for QP-QK projects"""
     
-    def __init__(self, project_root: str):
+    def __init__(self, project_root: str, log=print):
         self.project_root = Path(project_root)
         self.build_dir = self.project_root / "build"
+        self.work_dir = self.build_dir     # Tool scripts and delta chunks
+        self.log = log
         self.config = self.load_flash_config()
+        self.state_cache = FlashStateCache(self.config.get('flash_cache_dir'))
         
     def load_flash_config(self) -> Dict:
         """Load flash configuration from project"""
@@ -114,18 +227,18 @@ class QKFlasher:
         try:
             result = subprocess.run(['which', tool], capture_output=True, text=True)
             if result.returncode == 0:
-                print(f"Found {tool}: {result.stdout.strip()}")
+                self.log(f"Found {tool}: {result.stdout.strip()}")
                 return True
             else:
-                print(f"Tool {tool} not found in PATH")
+                self.log(f"Tool {tool} not found in PATH")
                 return False
         except Exception as e:
-            print(f"Error checking tool availability: {e}")
+            self.log(f"Error checking tool availability: {e}")
             return False
     
     def probe_target(self, interface: str) -> Dict:
         """Probe for connected target device"""
-        print(f"Probing for target using {interface}...")
+        self.log(f"Probing for target using {interface}...")
         
         interface_config = self.get_interface_config(interface)
         probe_cmd = interface_config['probe_cmd']
@@ -134,16 +247,16 @@ class QKFlasher:
             result = subprocess.run(probe_cmd, capture_output=True, text=True, timeout=10)
             
             if result.returncode == 0:
-                print("Target device found:")
-                print(result.stdout)
+                self.log("Target device found:")
+                self.log(result.stdout)
                 return {
                     'found': True,
                     'output': result.stdout,
                     'error': None
                 }
             else:
-                print("No target device found:")
-                print(result.stderr)
+                self.log("No target device found:")
+                self.log(result.stderr)
                 return {
                     'found': False,
                     'output': result.stdout,
@@ -151,14 +264,14 @@ class QKFlasher:
                 }
                 
         except subprocess.TimeoutExpired:
-            print("Probe timeout - device may not be connected")
+            self.log("Probe timeout - device may not be connected")
             return {
                 'found': False,
                 'output': '',
                 'error': 'Timeout'
             }
         except Exception as e:
-            print(f"Error probing target: {e}")
+            self.log(f"Error probing target: {e}")
             return {
                 'found': False,
                 'output': '',
@@ -185,34 +298,34 @@ class QKFlasher:
     
     def flash_stlink(self, firmware_file: Path) -> bool:
         """Flash using ST-Link interface"""
-        print(f"Flashing {firmware_file.name} using ST-Link...")
+        self.log(f"Flashing {firmware_file.name} using ST-Link...")
         
         flash_base = self.config.get('flash_base', '0x08000000')
         
-        cmd = ['st-flash', 'write', str(firmware_file), flash_base]
+        cmd = ['st-flash'] + self.stlink_args() + ['write', str(firmware_file), flash_base]
         
         try:
             result = subprocess.run(cmd, capture_output=True, text=True)
             
             if result.returncode == 0:
-                print("Flash successful!")
-                print(result.stdout)
+                self.log("Flash successful!")
+                self.log(result.stdout)
                 return True
             else:
-                print("Flash failed:")
-                print(result.stderr)
+                self.log("Flash failed:")
+                self.log(result.stderr)
                 return False
                 
         except Exception as e:
-            print(f"Error during flashing: {e}")
+            self.log(f"Error during flashing: {e}")
             return False
     
     def flash_jlink(self, firmware_file: Path) -> bool:
         """Flash using J-Link interface"""
-        print(f"Flashing {firmware_file.name} using J-Link...")
+        self.log(f"Flashing {firmware_file.name} using J-Link...")
         
         # Create J-Link script
-        script_file = self.build_dir / "flash.jlink"
+        script_file = self.work_dir / "flash.jlink"
         target = self.config.get('target', 'stm32f4')
         flash_base = self.config.get('flash_base', '0x08000000')
         
@@ -231,37 +344,41 @@ exit
         with open(script_file, 'w') as f:
             f.write(jlink_script)
         
-        cmd = ['JLinkExe', '-CommanderScript', str(script_file)]
+        cmd = ['JLinkExe'] + self.jlink_args() + ['-CommanderScript', str(script_file)]
         
         try:
             result = subprocess.run(cmd, capture_output=True, text=True)
             
             if result.returncode == 0:
-                print("Flash successful!")
+                self.log("Flash successful!")
                 return True
             else:
-                print("Flash failed:")
-                print(result.stderr)
+                self.log("Flash failed:")
+                self.log(result.stderr)
                 return False
                 
         except Exception as e:
-            print(f"Error during flashing: {e}")
+            self.log(f"Error during flashing: {e}")
             return False
     
     def flash_openocd(self, firmware_file: Path) -> bool:
         """Flash using OpenOCD"""
-        print(f"Flashing {firmware_file.name} using OpenOCD...")
+        self.log(f"Flashing {firmware_file.name} using OpenOCD...")
         
         target = self.config.get('target', 'stm32f4')
         flash_base = self.config.get('flash_base', '0x08000000')
         
         # Create OpenOCD config
-        config_file = self.build_dir / "openocd.cfg"
+        config_file = self.work_dir / "openocd.cfg"
+        
+        serial = self.config.get('probe_serial')
+        adapter = f"adapter serial {serial}\n" if serial else ""
+        servers = ''.join(f"{c}\n" for c in OPENOCD_NO_SERVERS)
         
         openocd_config = f"""
 source [find interface/stlink.cfg]
-source [find target/{target}x.cfg]
-init
+{adapter}source [find target/{target}x.cfg]
+{servers}init
 reset halt
 flash write_image erase {firmware_file.absolute()} {flash_base}
 reset run
@@ -277,20 +394,20 @@ shutdown
             result = subprocess.run(cmd, capture_output=True, text=True)
             
             if result.returncode == 0:
-                print("Flash successful!")
+                self.log("Flash successful!")
                 return True
             else:
-                print("Flash failed:")
-                print(result.stderr)
+                self.log("Flash failed:")
+                self.log(result.stderr)
                 return False
                 
         except Exception as e:
-            print(f"Error during flashing: {e}")
+            self.log(f"Error during flashing: {e}")
             return False
     
     def flash_dfu(self, firmware_file: Path) -> bool:
         """Flash using DFU (Device Firmware Update)"""
-        print(f"Flashing {firmware_file.name} using DFU...")
+        self.log(f"Flashing {firmware_file.name} using DFU...")
         
         flash_base = self.config.get('flash_base', '0x08000000')
         
@@ -305,21 +422,21 @@ shutdown
             result = subprocess.run(cmd, capture_output=True, text=True)
             
             if result.returncode == 0:
-                print("Flash successful!")
-                print(result.stdout)
+                self.log("Flash successful!")
+                self.log(result.stdout)
                 return True
             else:
-                print("Flash failed:")
-                print(result.stderr)
+                self.log("Flash failed:")
+                self.log(result.stderr)
                 return False
                 
         except Exception as e:
-            print(f"Error during flashing: {e}")
+            self.log(f"Error during flashing: {e}")
             return False
     
     def flash_esp32(self, firmware_file: Path) -> bool:
         """Flash ESP32 using esptool"""
-        print(f"Flashing {firmware_file.name} to ESP32...")
+        self.log(f"Flashing {firmware_file.name} to ESP32...")
         
         port = self.config.get('port', '/dev/ttyUSB0')
         baud = self.config.get('baud', '921600')
@@ -338,21 +455,21 @@ shutdown
             result = subprocess.run(cmd, capture_output=True, text=True)
             
             if result.returncode == 0:
-                print("Flash successful!")
-                print(result.stdout)
+                self.log("Flash successful!")
+                self.log(result.stdout)
                 return True
             else:
-                print("Flash failed:")
-                print(result.stderr)
+                self.log("Flash failed:")
+                self.log(result.stderr)
                 return False
                 
         except Exception as e:
-            print(f"Error during flashing: {e}")
+            self.log(f"Error during flashing: {e}")
             return False
     
     def flash_msp430(self, firmware_file: Path) -> bool:
         """Flash MSP430 using mspdebug"""
-        print(f"Flashing {firmware_file.name} to MSP430...")
+        self.log(f"Flashing {firmware_file.name} to MSP430...")
         
         programmer = self.config.get('programmer', 'rf2500')
         
@@ -362,29 +479,215 @@ shutdown
             result = subprocess.run(cmd, capture_output=True, text=True)
             
             if result.returncode == 0:
-                print("Flash successful!")
-                print(result.stdout)
+                self.log("Flash successful!")
+                self.log(result.stdout)
                 return True
             else:
-                print("Flash failed:")
-                print(result.stderr)
+                self.log("Flash failed:")
+                self.log(result.stderr)
                 return False
                 
         except Exception as e:
-            print(f"Error during flashing: {e}")
+            self.log(f"Error during flashing: {e}")
             return False
     
+    def probe_serial(self, interface: str, probe_output: str) -> Optional[str]:
+        """Probe serial number from the config or the probe output"""
+        if self.config.get('probe_serial'):
+            return str(self.config['probe_serial'])
+        patterns = {
+            'stlink': r'serial:\s*([0-9A-Fa-f]+)',
+            'jlink': r'S/N:\s*(\d+)',
+            'openocd': r'(?:adapter |hla_)?serial(?: number)?[:\s]+([0-9A-Fa-f]{8,})'
+        }
+        match = re.search(patterns.get(interface, r'$^'), probe_output or '')
+        return match.group(1) if match else None
+    
+    def enumerate_probes(self, interface: str) -> List[str]:
+        """Serial numbers of all attached probes of this interface"""
+        try:
+            if interface in ('stlink', 'openocd'):
+                # OpenOCD drives the same ST-Link probes: st-info lists them
+                result = subprocess.run(['st-info', '--probe'],
+                                        capture_output=True, text=True, timeout=10)
+                pattern = r'serial:\s*([0-9A-Fa-f]+)'
+            elif interface == 'jlink':
+                script_file = self.work_dir / 'list.jlink'
+                with open(script_file, 'w') as f:
+                    f.write("ShowEmuList\nexit\n")
+                result = subprocess.run(['JLinkExe', '-CommanderScript', str(script_file)],
+                                        capture_output=True, text=True, timeout=10)
+                pattern = r'Serial number:\s*(\d+)'
+            else:
+                return []
+        except (OSError, subprocess.TimeoutExpired) as e:
+            self.log(f"Error listing probes: {e}")
+            return []
+        
+        serials: List[str] = []
+        for serial in re.findall(pattern, result.stdout):
+            if serial not in serials:
+                serials.append(serial)
+        return serials
+    
+    def run_jlink_script(self, name: str, commands: List[str]) -> bool:
+        """Run J-Link Commander commands on the configured probe"""
+        script_file = self.work_dir / name
+        target = self.config.get('target', 'stm32f4')
+        with open(script_file, 'w') as f:
+            f.write(f"device {target.upper()}\nsi 1\nspeed 4000\nr\nh\n")
+            f.write('\n'.join(commands) + '\nexit\n')
+        cmd = ['JLinkExe'] + self.jlink_args() + ['-CommanderScript', str(script_file)]
+        result = subprocess.run(cmd, capture_output=True, text=True)
+        # JLinkExe exits 0 on most errors: check the log as well
+        return result.returncode == 0 and 'ERROR' not in result.stdout.upper() \
+            and 'FAILED' not in result.stdout.upper()
+    
+    def run_openocd(self, commands: List[str]) -> bool:
+        """Run an OpenOCD session (init/halt, commands, reset run)"""
+        target = self.config.get('target', 'stm32f4')
+        cmd = ['openocd', '-f', 'interface/stlink.cfg']
+        if self.config.get('probe_serial'):
+            cmd += ['-c', f"adapter serial {self.config['probe_serial']}"]
+        cmd += ['-f', f'target/{target}x.cfg']
+        for c in OPENOCD_NO_SERVERS:
+            cmd += ['-c', c]
+        cmd += ['-c', 'init; reset halt']
+        for c in commands:
+            cmd += ['-c', c]
+        cmd += ['-c', 'shutdown']
+        result = subprocess.run(cmd, capture_output=True, text=True)
+        return result.returncode == 0
+    
+    def stlink_args(self) -> List[str]:
+        if self.config.get('probe_serial'):
+            return ['--serial', str(self.config['probe_serial'])]
+        return []
+    
+    def jlink_args(self) -> List[str]:
+        if self.config.get('probe_serial'):
+            return ['-SelectEmuBySN', str(self.config['probe_serial'])]
+        return []
+    
+    def read_flash(self, interface: str, addr: int, size: int, out: Path) -> Optional[bytes]:
+        """Read a flash range back from the target"""
+        if interface == 'stlink':
+            ok = subprocess.run(['st-flash'] + self.stlink_args() +
+                                ['read', str(out), hex(addr), str(size)],
+                                capture_output=True, text=True).returncode == 0
+        elif interface == 'openocd':
+            ok = self.run_openocd([f'dump_image {out.absolute()} {hex(addr)} {size}'])
+        elif interface == 'jlink':
+            ok = self.run_jlink_script('read.jlink',
+                                       [f'savebin {out.absolute()}, {hex(addr)}, {hex(size)}'])
+        else:
+            return None
+        if not ok or not out.exists():
+            return None
+        return out.read_bytes()
+    
+    def program_range(self, interface: str, chunk_file: Path, addr: int) -> bool:
+        """Erase the sectors under one range and program it"""
+        if interface == 'stlink':
+            # st-flash erases exactly the sectors the write covers
+            cmd = ['st-flash'] + self.stlink_args() + ['write', str(chunk_file), hex(addr)]
+            return subprocess.run(cmd, capture_output=True, text=True).returncode == 0
+        if interface == 'openocd':
+            return self.run_openocd([
+                f'flash write_image erase {chunk_file.absolute()} {hex(addr)} bin',
+                f'verify_image {chunk_file.absolute()} {hex(addr)} bin'])
+        if interface == 'jlink':
+            return self.run_jlink_script('delta.jlink', [
+                f'loadbin {chunk_file.absolute()}, {hex(addr)}',
+                f'verifybin {chunk_file.absolute()}, {hex(addr)}'])
+        return False
+    
+    def verify_range(self, interface: str, addr: int, data: bytes) -> bool:
+        """CRC check of one programmed range
+        
+        OpenOCD (verify_image) and J-Link (verifybin) already compared a
+        target-side checksum while programming; ST-Link reads back only
+        the range that was programmed.
+        """
+        if interface != 'stlink':
+            return True
+        out = self.work_dir / 'delta' / f'verify_{addr:08X}.bin'
+        readback = self.read_flash(interface, addr, len(data), out)
+        return readback is not None and \
+            zlib.crc32(readback[:len(data)]) == zlib.crc32(data)
+    
+    def delta_flash(self, interface: str, firmware_file: Path, serial: Optional[str]) -> Dict:
+        """Erase and program only the sectors that differ from the target
+        
+        The sector CRCs of the target come from the cache entry of this
+        probe serial, or from a read-back of the image span when there is
+        none. Each changed range is verified by CRC afterwards.
+        """
+        image = firmware_file.read_bytes()
+        base = int(self.config.get('flash_base', '0x08000000'), 0)
+        sectors = [s for s in sector_layout(self.config) if s[0] - base < len(image)]
+        if not sectors or sectors[-1][0] + sectors[-1][1] - base < len(image):
+            return {'success': False, 'error': 'Image larger than flash_size'}
+        new_crcs = sector_crcs(image, base, sectors)
+        
+        old_crcs = self.state_cache.load(interface, serial, base) if serial else None
+        source = 'cache'
+        if old_crcs is None:
+            source = 'read-back'
+            span = sectors[-1][0] + sectors[-1][1] - base
+            delta_dir = self.work_dir / 'delta'
+            delta_dir.mkdir(parents=True, exist_ok=True)
+            current = self.read_flash(interface, base, span, delta_dir / 'readback.bin')
+            if current is None:
+                return {'success': False, 'error': 'Flash read-back failed'}
+            # Compare only what the new image defines in its last sector
+            current = current[:len(image)]
+            old_crcs = sector_crcs(current, base, sectors)
+        
+        changed = [(addr, size) for addr, size in sectors
+                   if old_crcs.get(f'0x{addr:08X}') != new_crcs[f'0x{addr:08X}']]
+        changed_bytes = sum(size for _, size in changed)
+        self.log(f"Delta ({source}): {len(changed)}/{len(sectors)} sectors changed "
+              f"({changed_bytes // 1024} KB of {sum(s for _, s in sectors) // 1024} KB)")
+        
+        # Merge neighbouring sectors into one program/verify range each
+        ranges: List[List[int]] = []
+        for addr, size in changed:
+            if ranges and ranges[-1][0] + ranges[-1][1] == addr:
+                ranges[-1][1] += size
+            else:
+                ranges.append([addr, size])
+        
+        delta_dir = self.work_dir / 'delta'
+        delta_dir.mkdir(parents=True, exist_ok=True)
+        for addr, size in ranges:
+            data = image[addr - base:addr - base + size]
+            chunk_file = delta_dir / f'sector_{addr:08X}.bin'
+            chunk_file.write_bytes(data)
+            self.log(f"  Programming 0x{addr:08X} ({len(data)} bytes)...")
+            if not self.program_range(interface, chunk_file, addr) \
+                    or not self.verify_range(interface, addr, data):
+                if serial:
+                    self.state_cache.invalidate(interface, serial)
+                return {'success': False, 'error': f'Delta flash failed at 0x{addr:08X}'}
+        
+        if serial:
+            self.state_cache.save(interface, serial, base, new_crcs, image)
+        return {'success': True, 'sectors_changed': len(changed),
+                'sectors_total': len(sectors), 'bytes_programmed': changed_bytes,
+                'source': source}
+    
     def erase_flash(self, interface: str) -> bool:
         """Erase target flash memory"""
-        print(f"Erasing flash using {interface}...")
+        self.log(f"Erasing flash using {interface}...")
         
         interface_config = self.get_interface_config(interface)
         
         if interface == 'stlink':
-            cmd = ['st-flash', 'erase']
+            cmd = ['st-flash'] + self.stlink_args() + ['erase']
         elif interface == 'jlink':
             # Create J-Link erase script
-            script_file = self.build_dir / "erase.jlink"
+            script_file = self.work_dir / "erase.jlink"
             target = self.config.get('target', 'stm32f4')
             
             jlink_script = f"""
@@ -399,40 +702,40 @@ exit
             with open(script_file, 'w') as f:
                 f.write(jlink_script)
             
-            cmd = ['JLinkExe', '-CommanderScript', str(script_file)]
+            cmd = ['JLinkExe'] + self.jlink_args() + ['-CommanderScript', str(script_file)]
         elif interface == 'dfu':
             flash_base = self.config.get('flash_base', '0x08000000')
             cmd = ['dfu-util', '-a', '0', '-s', f'{flash_base}:mass-erase:force']
         elif interface == 'esp32':
             cmd = ['esptool.py', '--chip', 'esp32', 'erase_flash']
         else:
-            print(f"Erase not implemented for {interface}")
+            self.log(f"Erase not implemented for {interface}")
             return False
         
         try:
             result = subprocess.run(cmd, capture_output=True, text=True)
             
             if result.returncode == 0:
-                print("Erase successful!")
+                self.log("Erase successful!")
                 return True
             else:
-                print("Erase failed:")
-                print(result.stderr)
+                self.log("Erase failed:")
+                self.log(result.stderr)
                 return False
                 
         except Exception as e:
-            print(f"Error during erase: {e}")
+            self.log(f"Error during erase: {e}")
             return False
     
     def reset_target(self, interface: str) -> bool:
         """Reset target device"""
-        print(f"Resetting target using {interface}...")
+        self.log(f"Resetting target using {interface}...")
         
         if interface == 'stlink':
-            cmd = ['st-flash', 'reset']
+            cmd = ['st-flash'] + self.stlink_args() + ['reset']
         elif interface == 'jlink':
             # Create J-Link reset script
-            script_file = self.build_dir / "reset.jlink"
+            script_file = self.work_dir / "reset.jlink"
             target = self.config.get('target', 'stm32f4')
             
             jlink_script = f"""
@@ -446,26 +749,26 @@ exit
             with open(script_file, 'w') as f:
                 f.write(jlink_script)
             
-            cmd = ['JLinkExe', '-CommanderScript', str(script_file)]
+            cmd = ['JLinkExe'] + self.jlink_args() + ['-CommanderScript', str(script_file)]
         elif interface == 'esp32':
             cmd = ['esptool.py', '--chip', 'esp32', 'run']
         else:
-            print(f"Reset not implemented for {interface}")
+            self.log(f"Reset not implemented for {interface}")
             return False
         
         try:
             result = subprocess.run(cmd, capture_output=True, text=True)
             
             if result.returncode == 0:
-                print("Reset successful!")
+                self.log("Reset successful!")
                 return True
             else:
-                print("Reset failed:")
-                print(result.stderr)
+                self.log("Reset failed:")
+                self.log(result.stderr)
                 return False
                 
         except Exception as e:
-            print(f"Error during reset: {e}")
+            self.log(f"Error during reset: {e}")
             return False
     
     def flash(self, interface: str, firmware_file: Optional[Path] = None, 
@@ -473,7 +776,7 @@ exit
         """Perform complete flash operation"""
         
         start_time = time.time()
-        print(f"Starting flash operation using {interface}")
+        self.log(f"Starting flash operation using {interface}")
         
         try:
             # Check tool availability
@@ -495,10 +798,13 @@ exit
                         'flash_time': 0
                     }
             
-            print(f"Using firmware file: {firmware_file}")
+            self.log(f"Using firmware file: {firmware_file}")
             
-            # Probe target
-            probe_result = self.probe_target(interface)
+            # Probe target (fleet mode already found the probe by serial)
+            if self.config.get('skip_probe', False):
+                probe_result = {'found': True, 'output': '', 'error': None}
+            else:
+                probe_result = self.probe_target(interface)
             if not probe_result['found']:
                 return {
                     'success': False,
@@ -506,8 +812,34 @@ exit
                     'flash_time': 0
                 }
             
+            serial = self.probe_serial(interface, probe_result['output'])
+            use_delta = (self.config.get('delta_flash', False)
+                         and not self.config.get('erase_before_flash', False)
+                         and interface in DELTA_INTERFACES
+                         and firmware_file.suffix == '.bin')
+            if self.config.get('delta_flash', False) and not use_delta:
+                self.log("Delta flash needs a .bin image, no --erase and "
+                      f"one of {', '.join(DELTA_INTERFACES)}: full flash")
+            
+            if use_delta:
+                delta = self.delta_flash(interface, firmware_file, serial)
+                if not delta['success']:
+                    return {
+                        'success': False,
+                        'error': delta['error'],
+                        'flash_time': time.time() - start_time
+                    }
+                if delta['sectors_changed'] and self.config.get('reset_after_flash', True):
+                    self.reset_target(interface)
+                flash_time = time.time() - start_time
+                self.log(f"\nDelta flash completed successfully in {flash_time:.2f} seconds")
+                delta.update({'firmware_file': str(firmware_file), 'flash_time': flash_time})
+                return delta
+            
             # Erase if requested
             if self.config.get('erase_before_flash', False):
+                if serial:
+                    self.state_cache.invalidate(interface, serial)
                 if not self.erase_flash(interface):
                     return {
                         'success': False,
@@ -534,18 +866,28 @@ exit
                 }
             
             if not flash_func(firmware_file):
+                if serial:
+                    self.state_cache.invalidate(interface, serial)
                 return {
                     'success': False,
                     'error': 'Flash operation failed',
                     'flash_time': time.time() - start_time
                 }
             
+            # Baseline for the next delta flash of this board
+            if serial and interface in DELTA_INTERFACES and firmware_file.suffix == '.bin':
+                image = firmware_file.read_bytes()
+                base = int(self.config.get('flash_base', '0x08000000'), 0)
+                self.state_cache.save(interface, serial, base,
+                                      sector_crcs(image, base, sector_layout(self.config)),
+                                      image)
+            
             # Reset if requested
             if self.config.get('reset_after_flash', True):
                 self.reset_target(interface)
             
             flash_time = time.time() - start_time
-            print(f"\nFlash completed successfully in {flash_time:.2f} seconds")
+            self.log(f"\nFlash completed successfully in {flash_time:.2f} seconds")
             
             return {
                 'success': True,
@@ -561,6 +903,126 @@ exit
             }
 
 
+class FleetFlasher:
+    """Flashes the same firmware to many boards, one worker per probe"""
+    
+    def __init__(self, project_root: str, interface: str, jobs: Optional[int] = None):
+        self.project_root = project_root
+        self.interface = interface
+        self.jobs = jobs
+        self.lock = threading.Lock()
+        self.overrides: Dict = {}
+        
+    def board_log(self, serial: str):
+        """Print function that tags every line with the board's serial"""
+        def log(*args, **kwargs):
+            text = ' '.join(str(a) for a in args)
+            with self.lock:
+                for line in text.strip('\n').splitlines() or ['']:
+                    print(f"[{serial}] {line}", flush=True)
+        return log
+    
+    def board(self, serial: str) -> QKFlasher:
+        """Flasher bound to one probe, with its own scratch directory"""
+        flasher = QKFlasher(self.project_root, log=self.board_log(serial))
+        flasher.config.update(self.overrides)
+        flasher.config['probe_serial'] = serial
+        flasher.config['skip_probe'] = True
+        flasher.work_dir = flasher.build_dir / 'fleet' / serial
+        flasher.work_dir.mkdir(parents=True, exist_ok=True)
+        return flasher
+    
+    def flash_board(self, serial: str, firmware_file: Path) -> Dict:
+        start_time = time.time()
+        try:
+            result = self.board(serial).flash(self.interface, firmware_file)
+        except Exception as e:
+            result = {'success': False, 'error': str(e)}
+        result['serial'] = serial
+        result['flash_time'] = time.time() - start_time
+        status = 'OK' if result['success'] else f"FAILED: {result.get('error')}"
+        with self.lock:
+            print(f"[{serial}] {status} ({result['flash_time']:.2f} s)", flush=True)
+        return result
+    
+    def flash(self, serials: Optional[List[str]], firmware_file: Optional[Path],
+              file_type: str = 'bin') -> Dict:
+        """Flash all boards concurrently and return the fleet summary"""
+        master = QKFlasher(self.project_root)
+        master.config.update(self.overrides)
+        start_time = time.time()
+        summary = {
+            'interface': self.interface,
+            'firmware': None,
+            'boards': [],
+            'total_time': 0,
+            'ok': 0,
+            'failed': 0
+        }
+        
+        # Fail once for the whole fleet, not once per board
+        if not master.check_tool_availability(self.interface):
+            summary['error'] = f'Programming tool for {self.interface} not available'
+            return summary
+        
+        if firmware_file is None:
+            firmware_file = master.find_firmware_file(file_type)
+            if firmware_file is None:
+                summary['error'] = f'No {file_type} file found in build directory'
+                return summary
+        summary['firmware'] = str(firmware_file)
+        
+        if not serials:
+            serials = master.enumerate_probes(self.interface)
+        if not serials:
+            summary['error'] = f'No {self.interface} probes found'
+            return summary
+        
+        jobs = self.jobs or min(8, len(serials))
+        print(f"Flashing {firmware_file.name} to {len(serials)} boards "
+              f"using {self.interface} ({jobs} jobs)")
+        
+        with ThreadPoolExecutor(max_workers=jobs) as pool:
+            futures = [pool.submit(self.flash_board, serial, firmware_file)
+                       for serial in serials]
+            results = [f.result() for f in as_completed(futures)]
+        
+        # Report in probe order, whatever order the boards finished in
+        order = {serial: i for i, serial in enumerate(serials)}
+        for result in sorted(results, key=lambda r: order[r['serial']]):
+            summary['boards'].append({
+                'serial': result['serial'],
+                'success': result['success'],
+                'error': result.get('error'),
+                'flash_time': round(result['flash_time'], 3),
+                'sectors_changed': result.get('sectors_changed'),
+                'bytes_programmed': result.get('bytes_programmed')
+            })
+        summary['total_time'] = round(time.time() - start_time, 3)
+        summary['ok'] = sum(1 for b in summary['boards'] if b['success'])
+        summary['failed'] = len(summary['boards']) - summary['ok']
+        return summary
+    
+    @staticmethod
+    def print_summary(summary: Dict):
+        print("\nFleet Flash Summary")
+        print("=" * 60)
+        print(f"{'Serial':<26} {'Result':<8} {'Time (s)':>8}  Details")
+        print("-" * 60)
+        for b in summary['boards']:
+            if not b['success']:
+                details = b['error'] or ''
+            elif b['sectors_changed'] is not None:
+                details = f"{b['sectors_changed']} sectors changed"
+            else:
+                details = 'full flash'
+            print(f"{b['serial']:<26} {'OK' if b['success'] else 'FAILED':<8} "
+                  f"{b['flash_time']:>8.2f}  {details}")
+        print("-" * 60)
+        print(f"{summary['ok']} ok, {summary['failed']} failed "
+              f"in {summary['total_time']:.2f} s")
+
+
 def main():
     parser = argparse.ArgumentParser(description='QP-QK SDK Flash Tool')
     parser.add_argument('--project', '-p', default='.',
@@ -579,9 +1041,51 @@ def main():
                        help='Do not reset target after flashing')
     parser.add_argument('--probe-only', action='store_true',
                        help='Only probe for target, do not flash')
+    parser.add_argument('--delta', action='store_true',
+                       help='Program only sectors that changed since the last '
+                            'flash of this probe (stlink/openocd/jlink, .bin)')
+    parser.add_argument('--full', action='store_true',
+                       help='Full flash even if delta_flash is configured '
+                            '(refreshes the sector CRC cache)')
+    parser.add_argument('--serial', '-s',
+                       help='Probe serial number (selects the probe, keys the delta cache)')
+    parser.add_argument('--fleet', action='store_true',
+                       help='Flash every attached probe of --interface in parallel')
+    parser.add_argument('--serials',
+                       help='Comma-separated probe serials for --fleet (default: all attached)')
+    parser.add_argument('--jobs', '-j', type=int,
+                       help='Boards flashed at once with --fleet (default: min(8, boards))')
+    parser.add_argument('--summary',
+                       help='Write the --fleet result summary to this JSON file')
     
     args = parser.parse_args()
     
+    firmware_file = Path(args.file) if args.file else None
+    
+    # Fleet mode: one worker per probe, summary at the end
+    if args.fleet:
+        fleet = FleetFlasher(args.project, args.interface, args.jobs)
+        if args.erase:
+            fleet.overrides['erase_before_flash'] = True
+        if args.no_reset:
+            fleet.overrides['reset_after_flash'] = False
+        if args.delta:
+            fleet.overrides['delta_flash'] = True
+        if args.full:
+            fleet.overrides['delta_flash'] = False
+        serials = [s.strip() for s in args.serials.split(',') if s.strip()] \
+            if args.serials else None
+        
+        summary = fleet.flash(serials, firmware_file, args.type)
+        if summary.get('error'):
+            print(f"Error: {summary['error']}")
+        else:
+            FleetFlasher.print_summary(summary)
+        if args.summary:
+            with open(args.summary, 'w') as f:
+                json.dump(summary, f, indent=2)
+        sys.exit(0 if summary['boards'] and summary['failed'] == 0 else 1)
+    
     # Create flasher
     try:
         flasher = QKFlasher(args.project)
@@ -594,6 +1098,12 @@ def main():
         flasher.config['erase_before_flash'] = True
     if args.no_reset:
         flasher.config['reset_after_flash'] = False
+    if args.delta:
+        flasher.config['delta_flash'] = True
+    if args.full:
+        flasher.config['delta_flash'] = False
+    if args.serial:
+        flasher.config['probe_serial'] = args.serial
     
     # Probe only if requested
     if args.probe_only:
@@ -601,7 +1111,6 @@ def main():
         sys.exit(0 if result['found'] else 1)
     
     # Flash firmware
-    firmware_file = Path(args.file) if args.file else None
     result = flasher.flash(args.interface, firmware_file, args.type)
     
     if not result['success']:
@@ -0,0 +1,444 @@
+#!/usr/bin/env python3
+"""
+QP-QK SDK Benchmark Generator
+Generates a multi-rate scheduling benchmark project from a scenario file
+
+Instantiates one synthetic Active Object per scenario entry from
+templates/active_objects/active_object_template.{c,h}, with the release
+rate, RTC cost and publish/subscribe fan-out of the scenario, and expands
+the STM32F4 and POSIX main.c templates to start them. The project builds
+for both platforms with tools/builders/build.py and is run and measured
+with tools/analyzers/qk_bench.py.
+"""
+
+import os
+import re
+import sys
+import json
+import argparse
+import datetime
+from pathlib import Path
+from typing import Dict, List, Optional
+
+import yaml
+
+SDK_ROOT = Path(__file__).resolve().parents[2]
+TEMPLATES_DIR = SDK_ROOT / 'templates'
+AO_TEMPLATE = TEMPLATES_DIR / 'active_objects' / 'active_object_template'
+DEFAULT_SCENARIO = SDK_ROOT / 'config' / 'bench' / 'multirate.yaml'
+
+TICKS_PER_SEC = 1000        # BSP_TICKS_PER_SEC of both platform templates
+MAX_AOS = 32                # QF_MAX_ACTIVE of the QK and posix-qv ports
+AO_SIGNALS = 8              # Signal range reserved per AO (template uses 7)
+
+# A line holding only a '// {{MARKER}}' comment
+MARKER_LINE = re.compile(r'^([ \t]*)// \{\{([A-Z_]+)\}\}[ \t]*(?:\n|$)', re.M)
+PLACEHOLDER = re.compile(r'\{\{([A-Z_]+)\}\}')
+
+
+def snake(name: str) -> str:
+    """BenchControl -> bench_control"""
+    return re.sub(r'(?<=[a-z0-9])(?=[A-Z])', '_', name).lower()
+
+
+def expand(text: str, values: Dict[str, str], blocks: Dict[str, str]) -> str:
+    """Fill a template: marker lines get code blocks, placeholders values
+
+    Marker lines without a block are dropped, so the output carries no
+    leftover expansion points.
+    """
+    def block(m):
+        code = blocks.get(m.group(2))
+        if code is None:
+            return ''
+        indent = m.group(1)
+        return ''.join(((indent + line) if line else '') + '\n'
+                       for line in code.rstrip('\n').split('\n'))
+
+    text = MARKER_LINE.sub(block, text)
+    return PLACEHOLDER.sub(lambda m: values.get(m.group(1), m.group(0)), text)
+
+
+def check_expanded(text: str, name: str):
+    """Placeholders left in code (not in comments) would not compile"""
+    for n, line in enumerate(text.split('\n'), 1):
+        code = line.split('//')[0]
+        if code.lstrip().startswith('*') or code.lstrip().startswith('/*'):
+            continue
+        m = PLACEHOLDER.search(code)
+        if m:
+            raise ValueError(f"{name}:{n}: unexpanded {m.group(0)}")
+
+
+class BenchGenerator:
+    """Resolves a scenario and writes the benchmark project"""
+
+    def __init__(self, scenario_file: Path, out_dir: Path,
+                 qp_path: Optional[str] = None):
+        self.scenario_file = scenario_file
+        self.out_dir = out_dir
+        self.qp_path = qp_path
+        with open(scenario_file, 'r') as f:
+            self.scenario = yaml.safe_load(f) or {}
+        self.aos = self.resolve()
+        self.date = datetime.date.today().isoformat()
+
+    def resolve(self) -> List[Dict]:
+        """Scenario entries with defaults, priorities and subscribers"""
+        defaults = {'sub_us': 10, 'queue': 8, 'fanout': 0}
+        defaults.update(self.scenario.get('defaults', {}) or {})
+        entries = self.scenario.get('aos') or []
+        if not entries:
+            raise ValueError("Scenario has no 'aos'")
+        if len(entries) > MAX_AOS:
+            raise ValueError(f"At most {MAX_AOS} AOs (QF_MAX_ACTIVE)")
+
+        aos = []
+        for idx, entry in enumerate(entries):
+            ao = dict(defaults)
+            ao.update(entry)
+            name = str(ao.get('name', f'Ao{idx}'))
+            if not re.fullmatch(r'[A-Z][A-Za-z0-9]*', name):
+                raise ValueError(f"AO name '{name}' must be CamelCase")
+            rate = int(ao['rate_hz'])
+            if rate <= 0 or TICKS_PER_SEC % rate:
+                raise ValueError(f"{name}: rate_hz must divide "
+                                 f"{TICKS_PER_SEC} (the tick rate)")
+            period_ms = 1000 // rate
+            aos.append({
+                'idx': idx,
+                'name': name,
+                'ao_name': 'Bench' + name,
+                'rate_hz': rate,
+                'period_ticks': TICKS_PER_SEC // rate,
+                'rtc_us': int(ao['rtc_us']),
+                'sub_us': int(ao['sub_us']),
+                'queue': int(ao['queue']),
+                'deadline_ms': int(ao.get('deadline_ms', period_ms)),
+                'prio': ao.get('prio'),
+                'fanout': int(ao['fanout']),
+                'subscribers': ao.get('subscribers'),
+            })
+
+        # Rate-monotonic priorities (1 = lowest), ties in scenario order
+        order = sorted(aos, key=lambda a: (a['rate_hz'], -a['idx']))
+        for prio, ao in enumerate(order, 1):
+            if ao['prio'] is None:
+                ao['prio'] = prio
+        prios = [ao['prio'] for ao in aos]
+        if len(set(prios)) != len(prios) or min(prios) < 1:
+            raise ValueError(f"AO priorities must be unique and >= 1: {prios}")
+
+        # Subscribers: explicit names, or the next `fanout` AOs in the list
+        by_name = {ao['name']: ao for ao in aos}
+        for ao in aos:
+            if ao['subscribers'] is not None:
+                missing = [n for n in ao['subscribers'] if n not in by_name]
+                if missing:
+                    raise ValueError(f"{ao['name']}: unknown subscribers "
+                                     f"{missing}")
+                ao['subscribers'] = [str(n) for n in ao['subscribers']]
+            else:
+                if ao['fanout'] >= len(aos):
+                    raise ValueError(f"{ao['name']}: fanout {ao['fanout']} "
+                                     f"needs more AOs")
+                ao['subscribers'] = [aos[(ao['idx'] + k) % len(aos)]['name']
+                                     for k in range(1, ao['fanout'] + 1)]
+            ao['fanout'] = len(ao['subscribers'])
+            ao['pub_sig'] = f"BENCH_PUB_{ao['name'].upper()}_SIG"
+        return aos
+
+    def publishers_of(self, ao: Dict) -> List[Dict]:
+        return [p for p in self.aos if ao['name'] in p['subscribers']]
+
+    def rel(self, path: Path) -> str:
+        """SDK path relative to the project, for build_config.yaml"""
+        return os.path.relpath(path, self.out_dir.resolve())
+
+    #------------------------------------------------------------------------
+    # Active Objects
+    #------------------------------------------------------------------------
+
+    def ao_values(self, ao: Dict) -> Dict[str, str]:
+        upper = ao['ao_name'].upper()
+        n_pub = sum(1 for a in self.aos if a['subscribers'])
+        return {
+            'AO_NAME': ao['ao_name'],
+            'AO_NAME_UPPER': upper,
+            'AO_NAME_LOWER': snake(ao['ao_name']),
+            'AO_DESCRIPTION': f"Synthetic {ao['rate_hz']} Hz benchmark",
+            'GENERATION_DATE': self.date,
+            'SIGNAL_BASE': f"(MAX_SIG + {n_pub + AO_SIGNALS * ao['idx']}U)",
+            'MAX_RTC_TIME': str(2 * ao['rtc_us']),
+            'QUEUE_LENGTH': str(ao['queue']),
+            'STACK_SIZE': '0',
+            'TICK_PERIOD': '1000',      # TICK_SIG housekeeping, 1 Hz
+            'TIMEOUT_VALUE': '1000',
+            'FREQUENCY': str(ao['rate_hz']),
+            'DEADLINE': str(ao['deadline_ms']),
+            'TRACE_OFFSET': '0',        # Filtered out during the run
+        }
+
+    def ao_header_blocks(self, ao: Dict) -> Dict[str, str]:
+        upper = ao['ao_name'].upper()
+        return {
+            'ADDITIONAL_INCLUDES': '#include "bench_config.h"',
+            'CUSTOM_MACROS': '\n'.join([
+                f"{'#define AO_' + upper + '_PRIO':<36}{ao['prio']}U",
+                f"{'#define ' + upper + '_BENCH_IDX':<36}{ao['idx']}U",
+                f"{'#define ' + upper + '_RTC_US':<36}"
+                f"{str(ao['rtc_us']) + 'U':<8}// Busy time per release",
+                f"{'#define ' + upper + '_SUB_US':<36}"
+                f"{str(ao['sub_us']) + 'U':<8}// Busy time per published event"]),
+        }
+
+    def ao_source_blocks(self, ao: Dict) -> Dict[str, str]:
+        upper = ao['ao_name'].upper()
+        idx = f"{upper}_BENCH_IDX"
+        blocks = {
+            'ACTIVE_ENTRY_ACTIONS': f"BENCH_ARM({idx});",
+        }
+
+        main = [f"BENCH_BEGIN({idx});",
+                f"BENCH_SPIN({upper}_RTC_US);"]
+        if ao['subscribers']:
+            blocks['LOCAL_CONSTANTS'] = (
+                f"// Published every release to: {', '.join(ao['subscribers'])}\n"
+                f"static QEvt const l_pubEvt = QEVT_INITIALIZER({ao['pub_sig']});")
+            main.append("QACTIVE_PUBLISH(&l_pubEvt, &me->super);")
+        main += [f"BENCH_RELEASED({idx});", "BENCH_END();"]
+        blocks['MAIN_OPERATION_CODE'] = '\n'.join(main)
+
+        pubs = self.publishers_of(ao)
+        if pubs:
+            blocks['SUBSCRIPTION_LIST'] = '\n'.join(
+                f"QActive_subscribe(&me->super, {p['pub_sig']});" for p in pubs)
+            cases = [f"case {p['pub_sig']}:" for p in pubs]
+            cases[-1] += ' {'
+            blocks['RUNNING_EVENT_HANDLERS'] = '\n'.join(cases + [
+                "    // Published by a benchmark AO: subscriber RTC cost",
+                f"    BENCH_BEGIN({idx});",
+                f"    BENCH_SPIN({upper}_SUB_US);",
+                f"    BENCH_RECEIVED({idx});",
+                "    BENCH_END();",
+                "    status_ = Q_HANDLED();",
+                "    break;",
+                "}",
+                ""])
+        return blocks
+
+    def write_ao(self, ao: Dict, src_dir: Path):
+        values = self.ao_values(ao)
+        lower = values['AO_NAME_LOWER']
+
+        header = expand(AO_TEMPLATE.with_suffix('.h').read_text(),
+                        values, self.ao_header_blocks(ao))
+        # Drop the template usage notes after the include guard
+        guard = f"#endif // {values['AO_NAME_UPPER']}_H\n"
+        header = header[:header.index(guard) + len(guard)]
+        source = expand(AO_TEMPLATE.with_suffix('.c').read_text(),
+                        values, self.ao_source_blocks(ao))
+
+        for text, name in ((header, f"{lower}.h"), (source, f"{lower}.c")):
+            check_expanded(text, name)
+            (src_dir / name).write_text(text)
+
+    #------------------------------------------------------------------------
+    # Project glue
+    #------------------------------------------------------------------------
+
+    def config_header(self) -> str:
+        name = self.scenario.get('name', self.scenario_file.stem)
+        lines = [
+            "/**",
+            " * @file bench_config.h",
+            f" * @brief Scheduling Benchmark Scenario \"{name}\"",
+            " * @version 1.0.0",
+            f" * @date {self.date}",
+            " *",
+            f" * Generated by tools/generators/bench_gen.py from "
+            f"{self.scenario_file.name}.",
+            " * Regenerate instead of editing.",
+            " */",
+            "",
+            "#ifndef BENCH_CONFIG_H",
+            "#define BENCH_CONFIG_H",
+            "",
+            '#include "project_template.h"',
+            '#include "bench_stats.h"',
+            "",
+            "// Published benchmark signals, one per publishing AO",
+            "enum BenchPubSignals {",
+        ]
+        pubs = [ao for ao in self.aos if ao['subscribers']]
+        for n, ao in enumerate(pubs):
+            init = ' = MAX_SIG' if n == 0 else ''
+            lines.append(f"    {ao['pub_sig']}{init},")
+        lines += [
+            "    BENCH_MAX_PUB_SIG          // Size of the subscriber table",
+            "};",
+            "",
+            f"#define BENCH_NUM_AOS           {len(self.aos)}U",
+            "",
+            "#endif // BENCH_CONFIG_H",
+            "",
+        ]
+        return '\n'.join(lines)
+
+    def main_blocks(self) -> Dict[str, str]:
+        # Start in priority order (lowest to highest)
+        by_prio = sorted(self.aos, key=lambda a: a['prio'])
+        includes = ['#include "bench_config.h"'] + [
+            f'#include "{snake(ao["ao_name"])}.h"' for ao in self.aos]
+        storage = includes + [
+            "",
+            "// Two START_SIGs take each benchmark AO from inactive to running"]
+        start = []
+        for ao in by_prio:
+            n, upper = ao['ao_name'], ao['ao_name'].upper()
+            storage += [
+                f"static QEvt const *l_{n[0].lower() + n[1:]}QueueSto[{upper}_QUEUE_LEN];",
+                f"static QEvt const l_{n[0].lower() + n[1:]}StartEvt = "
+                f"QEVT_INITIALIZER({upper}_START_SIG);"]
+            q = f"l_{n[0].lower() + n[1:]}"
+            start += [
+                f"{n}_ctor();",
+                f"QACTIVE_START(&AO_{n}.super, AO_{upper}_PRIO,",
+                f"              {q}QueueSto, Q_DIM({q}QueueSto),",
+                "              (void *)0, 0U, (void *)0);",
+                f"BENCH_ATTACH({upper}_BENCH_IDX, &AO_{n}.super,",
+                f"             BSP_TICKS_PER_SEC / {upper}_FREQUENCY_HZ,",
+                f"             {upper}_DEADLINE_MS * 1000U);",
+                f"QACTIVE_POST(&AO_{n}.super, &{q}StartEvt, (void *)0);",
+                f"QACTIVE_POST(&AO_{n}.super, &{q}StartEvt, (void *)0);",
+                ""]
+
+        qs = []
+        if self.scenario.get('trace', 'results') != 'all':
+            qs += ["// Benchmark: only the results record, so that tracing",
+                   "// does not add load to the measured schedule",
+                   "QS_GLB_FILTER(-QS_ALL_RECORDS);",
+                   "QS_GLB_FILTER(BENCH_QS_REC);"]
+        qs += ["QS_USR_DICTIONARY(BENCH_QS_REC);"]
+        qs += [f"QS_SIG_DICTIONARY({ao['pub_sig']}, (void *)0);"
+               for ao in self.aos if ao['subscribers']]
+
+        return {
+            'ACTIVE_OBJECT_STORAGE_DECLARATIONS': '\n'.join(storage),
+            'QS_SIGNAL_DICTIONARY_ENTRIES': '\n'.join(qs),
+            'ACTIVE_OBJECT_START_SEQUENCE': '\n'.join(start),
+        }
+
+    def write_main(self, platform: str, out_file: Path):
+        text = (TEMPLATES_DIR / 'platforms' / platform / 'main.c').read_text()
+        anchor = 'static QSubscrList l_subscrSto[MAX_SIG];'
+        if anchor not in text:
+            raise ValueError(f"{platform}/main.c: subscriber table not found")
+        text = text.replace(anchor,
+                            'static QSubscrList l_subscrSto[BENCH_MAX_PUB_SIG];')
+        text = expand(text, {}, self.main_blocks())
+        check_expanded(text, f"{platform}/main.c")
+        out_file.parent.mkdir(parents=True, exist_ok=True)
+        out_file.write_text(text)
+
+    def build_config(self) -> Dict:
+        services = self.rel(TEMPLATES_DIR / 'services')
+        defines = ['BENCH_ENABLE',
+                   f'BENCH_MAX_AOS={len(self.aos)}U',
+                   f'TICK_DIV_MAX_SUBS={max(8, len(self.aos))}U']
+        config = {
+            'platform': 'stm32f4',
+            'toolchain': 'gcc-arm-none-eabi',
+            'optimization': 'O2',
+            'debug': True,              # QS carries the results
+            'sources': ['src/*.c', 'target/main.c',
+                        self.rel(TEMPLATES_DIR / 'platforms' / 'stm32f4' / 'bsp.c'),
+                        f'{services}/*.c'],
+            'includes': ['src', self.rel(TEMPLATES_DIR / 'platforms' / 'stm32f4'),
+                         services],
+            'defines': ['USE_HAL_DRIVER', 'STM32F411xE'] + defines,
+            'platforms': {
+                'posix': {
+                    'sources': ['src/*.c', 'host/main.c',
+                                self.rel(TEMPLATES_DIR / 'platforms' / 'posix'
+                                         / 'bsp.c'),
+                                f'{services}/*.c'],
+                    'includes': ['src'],
+                    'defines': defines,
+                },
+            },
+        }
+        if self.qp_path:
+            config['qp_path'] = str(Path(self.qp_path).resolve())
+        return config
+
+    def scenario_record(self) -> Dict:
+        """Resolved scenario, read by qk_bench.py to name the results"""
+        return {
+            'name': self.scenario.get('name', self.scenario_file.stem),
+            'description': self.scenario.get('description', ''),
+            'aos': [{k: ao[k] for k in ('idx', 'name', 'prio', 'rate_hz',
+                                        'period_ticks', 'rtc_us', 'sub_us',
+                                        'deadline_ms', 'subscribers')}
+                    for ao in self.aos],
+        }
+
+    def generate(self):
+        src_dir = self.out_dir / 'src'
+        src_dir.mkdir(parents=True, exist_ok=True)
+        for ao in self.aos:
+            self.write_ao(ao, src_dir)
+        (src_dir / 'bench_config.h').write_text(self.config_header())
+        self.write_main('stm32f4', self.out_dir / 'target' / 'main.c')
+        self.write_main('posix', self.out_dir / 'host' / 'main.c')
+        with open(self.out_dir / 'build_config.yaml', 'w') as f:
+            f.write(f"# Generated by tools/generators/bench_gen.py from "
+                    f"{self.scenario_file.name}\n")
+            yaml.safe_dump(self.build_config(), f, sort_keys=False)
+        with open(self.out_dir / 'bench_scenario.json', 'w') as f:
+            json.dump(self.scenario_record(), f, indent=2)
+            f.write('\n')
+
+    def print_summary(self):
+        load = 0.0
+        print(f"Benchmark '{self.scenario_record()['name']}' "
+              f"-> {self.out_dir}")
+        print(f"  {'AO':<12} {'Prio':>4} {'Rate':>6} {'RTC us':>7} "
+              f"{'Deadline':>9}  Subscribers")
+        for ao in sorted(self.aos, key=lambda a: -a['prio']):
+            load += ao['rate_hz'] * ao['rtc_us'] / 1e4
+            load += sum(ao['rate_hz'] * s['sub_us'] / 1e4 for s in self.aos
+                        if s['name'] in ao['subscribers'])
+            print(f"  {ao['name']:<12} {ao['prio']:>4} {ao['rate_hz']:>4} Hz "
+                  f"{ao['rtc_us']:>7} {ao['deadline_ms']:>6} ms  "
+                  f"{', '.join(ao['subscribers']) or '-'}")
+        print(f"  Nominal CPU load: {load:.1f}%")
+
+
+def main():
+    parser = argparse.ArgumentParser(description='QP-QK SDK Benchmark Generator')
+    parser.add_argument('--scenario', '-s', default=str(DEFAULT_SCENARIO),
+                       help='Scenario YAML (default: config/bench/multirate.yaml)')
+    parser.add_argument('--output', '-o', required=True,
+                       help='Project directory to generate')
+    parser.add_argument('--qp-path',
+                       help='QP/C installation (default: ../qpc, as build.py)')
+
+    args = parser.parse_args()
+
+    try:
+        gen = BenchGenerator(Path(args.scenario), Path(args.output), args.qp_path)
+        gen.generate()
+    except (ValueError, KeyError, OSError, yaml.YAMLError) as e:
+        print(f"Error: {e}")
+        sys.exit(1)
+
+    gen.print_summary()
+    print("\nBuild and run:")
+    print(f"  python3 tools/builders/build.py -p {args.output} --platform posix")
+    print(f"  python3 tools/analyzers/qk_bench.py --host {args.output}/build/firmware.elf "
+          f"--scenario {args.output}/bench_scenario.json")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,62 @@
+import * as vscode from 'vscode';
+import { QpMermaidParser } from '../parser/qpMermaidParser';
+import { StateMachineValidator, DispatchOptions } from '../validator/stateMachineValidator';
+
+/** Hot signal settings shared by validation, the report and code generation */
+export function getDispatchOptions(): DispatchOptions {
+    const config = vscode.workspace.getConfiguration('qp-mermaid');
+    return {
+        hotSignals: config.get<string[]>('validation.hotSignals', ['TIMEOUT', 'TICK']),
+        depthLimit: config.get<number>('validation.hotDepthLimit', 2)
+    };
+}
+
+export function registerDispatchReportCommand(context: vscode.ExtensionContext) {
+    const reportCommand = vscode.commands.registerCommand('qp-mermaid.dispatchReport', async () => {
+        const editor = vscode.window.activeTextEditor;
+        if (!editor) {
+            vscode.window.showErrorMessage('No active editor found');
+            return;
+        }
+
+        if (!editor.document.fileName.endsWith('.qp.mmd')) {
+            vscode.window.showErrorMessage('Please open a .qp.mmd file');
+            return;
+        }
+
+        try {
+            const parser = new QpMermaidParser();
+            const stateMachine = parser.parse(editor.document.getText());
+
+            const validator = new StateMachineValidator();
+            const report = validator.analyzeDispatch(stateMachine, getDispatchOptions());
+
+            // <name>.dispatch.json next to the diagram, for the generator
+            // and for tracking the cost across design changes
+            const baseName = editor.document.fileName.replace(/\.qp\.mmd$/, '');
+            const reportPath = vscode.Uri.file(`${baseName}.dispatch.json`);
+            await vscode.workspace.fs.writeFile(reportPath,
+                Buffer.from(JSON.stringify(report, null, 2) + '\n'));
+
+            const outputChannel = vscode.window.createOutputChannel('QP Mermaid Dispatch Cost');
+            outputChannel.clear();
+            outputChannel.appendLine(`=== Dispatch cost: ${stateMachine.name} ===`);
+            outputChannel.appendLine('Signal                 Hot  Handled  Unhandled  Max depth  Mean depth  Max calls  Max actions');
+            for (const s of report.signals) {
+                outputChannel.appendLine(
+                    `${s.signal.padEnd(22)} ${(s.hot ? 'yes' : '').padEnd(4)} ` +
+                    `${String(s.handledIn).padStart(7)}  ${String(s.unhandledIn).padStart(9)}  ` +
+                    `${String(s.maxDepth).padStart(9)}  ${s.meanDepth.toFixed(2).padStart(10)}  ` +
+                    `${String(s.maxCalls).padStart(9)}  ${String(s.maxActions).padStart(11)}`);
+            }
+            outputChannel.appendLine('');
+            outputChannel.appendLine(`Report written to ${reportPath.fsPath}`);
+            outputChannel.show();
+
+        } catch (error) {
+            vscode.window.showErrorMessage(`Dispatch report failed: ${error}`);
+        }
+    });
+
+    context.subscriptions.push(reportCommand);
+}
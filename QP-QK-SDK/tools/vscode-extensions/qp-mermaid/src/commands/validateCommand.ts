@@ -1,6 +1,7 @@
 import * as vscode from 'vscode';
 import { QpMermaidParser } from '../parser/qpMermaidParser';
 import { StateMachineValidator } from '../validator/stateMachineValidator';
+import { getDispatchOptions } from './dispatchReportCommand';
 
 export function registerValidateCommand(context: vscode.ExtensionContext) {
     const validateCommand = vscode.commands.registerCommand('qp-mermaid.validate', async () => {
@@ -22,7 +23,7 @@ export function registerValidateCommand(context: vscode.ExtensionContext) {
 
             // Validate it
             const validator = new StateMachineValidator();
-            const errors = validator.validate(stateMachine);
+            const errors = validator.validate(stateMachine, getDispatchOptions());
 
             // Create diagnostics
             const diagnostics: vscode.Diagnostic[] = [];
@@ -3,6 +3,8 @@ import { PreviewPanel } from './webview/previewPanel';
 import { QpMermaidParser } from './parser/qpMermaidParser';
 import { QpCodeGenerator } from './generator/qpCodeGenerator';
 import { registerValidateCommand } from './commands/validateCommand';
+import { registerDispatchReportCommand, getDispatchOptions } from './commands/dispatchReportCommand';
+import { StateMachineValidator } from './validator/stateMachineValidator';
 
 export function activate(context: vscode.ExtensionContext) {
     console.log('QP Mermaid extension is now active!');
@@ -46,10 +48,21 @@ export function activate(context: vscode.ExtensionContext) {
             const config = vscode.workspace.getConfiguration('qp-mermaid');
             const targetLanguage = config.get<string>('codeGeneration.targetLanguage', 'C');
             const includeComments = config.get<boolean>('codeGeneration.includeComments', true);
+            const mode = config.get<string>('codeGeneration.mode', 'switch');
+            const emitBenchmark = config.get<boolean>('codeGeneration.emitBenchmark', false);
+            const optimizeDispatch = config.get<boolean>('codeGeneration.optimizeDispatch', false);
+            const qsDictionary = config.get<boolean>('codeGeneration.qsDictionary', true);
+            const dispatchReport = optimizeDispatch
+                ? new StateMachineValidator().analyzeDispatch(stateMachine, getDispatchOptions())
+                : undefined;
 
             const generatedCode = generator.generate(stateMachine, {
                 language: targetLanguage as 'C' | 'C++',
-                includeComments
+                includeComments,
+                mode: mode as 'switch' | 'table',
+                emitBenchmark,
+                dispatchReport,
+                qsDictionary
             });
 
             // Create output files
@@ -66,6 +79,10 @@ export function activate(context: vscode.ExtensionContext) {
 
             await vscode.workspace.fs.writeFile(headerPath, Buffer.from(generatedCode.header));
             await vscode.workspace.fs.writeFile(sourcePath, Buffer.from(generatedCode.source));
+            if (generatedCode.benchmark) {
+                const benchPath = vscode.Uri.file(`${baseName}_bench.c`);
+                await vscode.workspace.fs.writeFile(benchPath, Buffer.from(generatedCode.benchmark));
+            }
 
             vscode.window.showInformationMessage(`Generated ${stateMachine.name}.h and ${stateMachine.name}.c`);
 
@@ -133,6 +150,9 @@ export function activate(context: vscode.ExtensionContext) {
     // Register validation command
     registerValidateCommand(context);
 
+    // Register dispatch cost report command
+    registerDispatchReportCommand(context);
+
     context.subscriptions.push(
         previewCommand,
         generateCodeCommand,
@@ -1,5 +1,16 @@
 import { StateMachine, State, Transition, GeneratorOptions, GeneratedCode } from '../types/stateMachine';
 
+/** One precomputed transition of the table backend */
+interface TableTransition {
+    guard: number;
+    action: number;
+    target: number;
+    exitOff: number;
+    exitLen: number;
+    entryOff: number;
+    entryLen: number;
+}
+
 export class QpCodeGenerator {
     private stateMachine!: StateMachine;
     private options!: GeneratorOptions;
@@ -9,10 +20,18 @@ export class QpCodeGenerator {
         this.stateMachine = stateMachine;
         this.options = options;
 
-        return {
+        const code: GeneratedCode = {
             header: this.generateHeader(),
-            source: this.generateSource()
+            source: this.isTableMode() ? this.generateTableSource() : this.generateSource()
         };
+        if (options.emitBenchmark) {
+            code.benchmark = this.generateBenchmark();
+        }
+        return code;
+    }
+
+    private isTableMode(): boolean {
+        return this.options.mode === 'table';
     }
 
     private generateHeader(): string {
@@ -54,6 +73,11 @@ export class QpCodeGenerator {
             const comment = member.comment ? ` /* ${member.comment} */` : '';
             lines.push(`${this.indent}${member.type} ${member.name};${comment}`);
         }
+
+        if (this.isTableMode()) {
+            const comment = this.options.includeComments ? ' /* current leaf state (table backend) */' : '';
+            lines.push(`${this.indent}uint8_t state_;${comment}`);
+        }
         
         lines.push(`} ${this.stateMachine.name};`);
         lines.push('');
@@ -87,17 +111,26 @@ export class QpCodeGenerator {
         lines.push(`#include "qpc.h"`);
         lines.push(`#include "${this.stateMachine.name}.h"`);
         lines.push(`#include "bsp.h"`);
+        if (this.hasQsDictionary()) {
+            lines.push(`#include "qs_dict.h"`);
+        }
         lines.push('');
 
         // Forward declarations
         lines.push('/* State handler declarations */');
         const allStates = this.getAllStates();
+        lines.push(`static QState ${this.stateMachine.name}_initial(${this.stateMachine.name} * const me, QEvt const * const e);`);
         for (const state of allStates) {
             const stateName = this.resolveStateName(state.name);
             lines.push(`static QState ${this.stateMachine.name}_${stateName}(${this.stateMachine.name} * const me, QEvt const * const e);`);
         }
         lines.push('');
 
+        // Local instance
+        lines.push(`/* Local instance */`);
+        lines.push(`static ${this.stateMachine.name} l_${this.stateMachine.name.toLowerCase()};`);
+        lines.push('');
+
         // Global pointer
         if (this.stateMachine.type === 'QActive') {
             lines.push(`/* Global pointer to the ${this.stateMachine.name} active object */`);
@@ -105,10 +138,10 @@ export class QpCodeGenerator {
             lines.push('');
         }
 
-        // Local instance
-        lines.push(`/* Local instance */`);
-        lines.push(`static ${this.stateMachine.name} l_${this.stateMachine.name.toLowerCase()};`);
-        lines.push('');
+        lines.push(...this.generateQsDictionary([
+            `${this.stateMachine.name}_initial`,
+            ...allStates.map(state => `${this.stateMachine.name}_${this.resolveStateName(state.name)}`)
+        ]));
 
         // Constructor
         lines.push(`void ${this.stateMachine.name}_ctor(${this.stateMachine.name} * const me) {`);
@@ -133,6 +166,9 @@ export class QpCodeGenerator {
             lines.push(`${this.indent}/* Initialize hardware, subscribe to events, etc. */`);
         }
         
+        if (this.hasQsDictionary()) {
+            lines.push(`${this.indent}QS_DICT_SEND(${this.stateMachine.name});`);
+        }
         const initialStateName = this.resolveStateName(this.stateMachine.initialState);
         lines.push(`${this.indent}return Q_TRAN(&${this.stateMachine.name}_${initialStateName});`);
         lines.push('}');
@@ -156,6 +192,16 @@ export class QpCodeGenerator {
         lines.push(`${this.indent}QState status_;`);
         lines.push(`${this.indent}switch (e->sig) {`);
 
+        // Hot signals first (dispatch report), including handlers hoisted
+        // from superstates so they do not walk the hierarchy
+        const { hot, rest } = this.orderTransitions(state);
+        for (const { transition, hoistedFrom } of hot) {
+            if (hoistedFrom && this.options.includeComments) {
+                lines.push(`${this.indent}${this.indent}/* hot: hoisted from ${hoistedFrom} */`);
+            }
+            lines.push(...this.generateTransitionCase(transition));
+        }
+
         // Entry actions
         if (state.entryActions.length > 0) {
             lines.push(`${this.indent}${this.indent}case Q_ENTRY_SIG: {`);
@@ -188,40 +234,8 @@ export class QpCodeGenerator {
         }
 
         // Event transitions
-        for (const transition of state.transitions) {
-            if (!transition.isInternal) {
-                lines.push(`${this.indent}${this.indent}case ${transition.event}: {`);
-                
-                if (transition.guard) {
-                    lines.push(`${this.indent}${this.indent}${this.indent}if (${transition.guard}) {`);
-                    if (transition.action) {
-                        lines.push(`${this.indent}${this.indent}${this.indent}${this.indent}${transition.action};`);
-                    }
-                    const targetName = this.resolveStateName(transition.target);
-                    lines.push(`${this.indent}${this.indent}${this.indent}${this.indent}status_ = Q_TRAN(&${this.stateMachine.name}_${targetName});`);
-                    lines.push(`${this.indent}${this.indent}${this.indent}} else {`);
-                    lines.push(`${this.indent}${this.indent}${this.indent}${this.indent}status_ = Q_UNHANDLED();`);
-                    lines.push(`${this.indent}${this.indent}${this.indent}}`);
-                } else {
-                    if (transition.action) {
-                        lines.push(`${this.indent}${this.indent}${this.indent}${transition.action};`);
-                    }
-                    const targetName = this.resolveStateName(transition.target);
-                    lines.push(`${this.indent}${this.indent}${this.indent}status_ = Q_TRAN(&${this.stateMachine.name}_${targetName});`);
-                }
-                
-                lines.push(`${this.indent}${this.indent}${this.indent}break;`);
-                lines.push(`${this.indent}${this.indent}}`);
-            } else {
-                // Internal transition
-                lines.push(`${this.indent}${this.indent}case ${transition.event}: {`);
-                if (transition.action) {
-                    lines.push(`${this.indent}${this.indent}${this.indent}${transition.action};`);
-                }
-                lines.push(`${this.indent}${this.indent}${this.indent}status_ = Q_HANDLED();`);
-                lines.push(`${this.indent}${this.indent}${this.indent}break;`);
-                lines.push(`${this.indent}${this.indent}}`);
-            }
+        for (const transition of rest) {
+            lines.push(...this.generateTransitionCase(transition));
         }
 
         // Default case
@@ -242,6 +256,622 @@ export class QpCodeGenerator {
         return lines;
     }
 
+    private generateTransitionCase(transition: Transition): string[] {
+        const lines: string[] = [];
+        if (!transition.isInternal) {
+            lines.push(`${this.indent}${this.indent}case ${transition.event}: {`);
+        
+            if (transition.guard) {
+                lines.push(`${this.indent}${this.indent}${this.indent}if (${transition.guard}) {`);
+                if (transition.action) {
+                    lines.push(`${this.indent}${this.indent}${this.indent}${this.indent}${transition.action};`);
+                }
+                const targetName = this.resolveStateName(transition.target);
+                lines.push(`${this.indent}${this.indent}${this.indent}${this.indent}status_ = Q_TRAN(&${this.stateMachine.name}_${targetName});`);
+                lines.push(`${this.indent}${this.indent}${this.indent}} else {`);
+                lines.push(`${this.indent}${this.indent}${this.indent}${this.indent}status_ = Q_UNHANDLED();`);
+                lines.push(`${this.indent}${this.indent}${this.indent}}`);
+            } else {
+                if (transition.action) {
+                    lines.push(`${this.indent}${this.indent}${this.indent}${transition.action};`);
+                }
+                const targetName = this.resolveStateName(transition.target);
+                lines.push(`${this.indent}${this.indent}${this.indent}status_ = Q_TRAN(&${this.stateMachine.name}_${targetName});`);
+            }
+        
+            lines.push(`${this.indent}${this.indent}${this.indent}break;`);
+            lines.push(`${this.indent}${this.indent}}`);
+        } else {
+            // Internal transition
+            lines.push(`${this.indent}${this.indent}case ${transition.event}: {`);
+            if (transition.action) {
+                lines.push(`${this.indent}${this.indent}${this.indent}${transition.action};`);
+            }
+            lines.push(`${this.indent}${this.indent}${this.indent}status_ = Q_HANDLED();`);
+            lines.push(`${this.indent}${this.indent}${this.indent}break;`);
+            lines.push(`${this.indent}${this.indent}}`);
+        }
+        return lines;
+    }
+
+    /**
+     * Splits the transitions of a state into hot ones, emitted first, and the
+     * rest. Hoists unguarded internal handlers of hot signals that the
+     * dispatch report flags as handled too high up into the leaf.
+     */
+    private orderTransitions(state: State): {
+        hot: Array<{ transition: Transition; hoistedFrom?: string }>;
+        rest: Transition[];
+    } {
+        const report = this.options.dispatchReport;
+        if (!report) {
+            return { hot: [], rest: state.transitions };
+        }
+        const hotSignals = new Set(report.signals.filter(s => s.hot).map(s => s.signal));
+        const hot: Array<{ transition: Transition; hoistedFrom?: string }> = state.transitions
+            .filter(t => hotSignals.has(t.event))
+            .map(transition => ({ transition }));
+        const all = this.getAllStates();
+        for (const cost of report.costs) {
+            if (cost.state !== state.name || !cost.hot || !cost.hoistable || cost.depth <= report.depthLimit) {
+                continue;
+            }
+            const from = all.find(s => s.name === cost.handledBy);
+            const transition = from?.transitions.find(t => t.event === cost.signal && t.isInternal && !t.guard);
+            if (from && transition) {
+                hot.push({ transition, hoistedFrom: from.name });
+            }
+        }
+        return { hot, rest: state.transitions.filter(t => !hotSignals.has(t.event)) };
+    }
+
+    private generateTableSource(): string {
+        const name = this.stateMachine.name;
+        const NAME = name.toUpperCase();
+        const ind = this.indent;
+        const lines: string[] = [];
+
+        // Leaves come first so the cell table needs one row per leaf only
+        const allStates = this.getAllStates();
+        const leaves = allStates.filter(s => s.children.length === 0);
+        const ordered = [...leaves, ...allStates.filter(s => s.children.length > 0)];
+        if (leaves.length === 0) {
+            throw new Error('Table mode requires at least one leaf state');
+        }
+        if (ordered.length > 255) {
+            // State IDs are uint8_t 0..254; 0xFF (255) is the _S_NONE_ sentinel
+            throw new Error('Table mode supports at most 255 states');
+        }
+        const stateId = new Map<string, number>();
+        ordered.forEach((s, i) => stateId.set(s.name, i));
+        const byName = new Map<string, State>(allStates.map(s => [s.name, s] as [string, State]));
+
+        const pathOf = (state: State): State[] => {
+            const path: State[] = [];
+            let s: State | undefined = state;
+            while (s) {
+                path.unshift(s);
+                s = s.parent ? byName.get(s.parent) : undefined;
+            }
+            return path;
+        };
+        const drill = (state: State): State[] => {
+            const path: State[] = [];
+            let s = state;
+            while (s.children.length > 0) {
+                const init = s.initialTransition ? byName.get(s.initialTransition.target) : undefined;
+                s = init ?? s.children[0];
+                path.push(s);
+            }
+            return path;
+        };
+
+        // Signals handled anywhere in the machine, in declaration order
+        const signals: string[] = [];
+        for (const state of allStates) {
+            for (const t of state.transitions) {
+                if (!t.event.startsWith('@') && !signals.includes(t.event)) {
+                    signals.push(t.event);
+                }
+            }
+        }
+
+        // Deduplicated guard/action bodies, index 0 means "none"
+        const guards: string[] = [''];
+        const actions: string[] = [''];
+        const intern = (list: string[], text?: string): number => {
+            if (!text) {
+                return 0;
+            }
+            let idx = list.indexOf(text);
+            if (idx < 0) {
+                idx = list.push(text) - 1;
+            }
+            return idx;
+        };
+
+        // Shared storage for exit/entry sequences
+        const paths: number[] = [];
+        const pathOffsets = new Map<string, number>();
+        const addPath = (ids: number[]): number => {
+            if (ids.length === 0) {
+                return 0;
+            }
+            const key = ids.join(',');
+            let off = pathOffsets.get(key);
+            if (off === undefined) {
+                off = paths.length;
+                paths.push(...ids);
+                pathOffsets.set(key, off);
+            }
+            return off;
+        };
+
+        const trans: TableTransition[] = [];
+        const transIdx = new Map<string, number>();
+        const addTran = (t: TableTransition): number => {
+            const key = JSON.stringify(t);
+            let idx = transIdx.get(key);
+            if (idx === undefined) {
+                idx = trans.push(t) - 1;
+                transIdx.set(key, idx);
+            }
+            return idx;
+        };
+
+        const flatten = (leaf: State, src: State, tr: Transition): TableTransition => {
+            const guard = intern(guards, tr.guard);
+            const action = intern(actions, tr.action);
+            if (tr.isInternal) {
+                return { guard, action, target: 255, exitOff: 0, exitLen: 0, entryOff: 0, entryLen: 0 };
+            }
+            const target = byName.get(tr.target);
+            if (!target) {
+                throw new Error(`Unknown transition target '${tr.target}' in state '${src.name}'`);
+            }
+            // Resolve the LCA the same way QHsm does: self and "up" transitions
+            // exit and re-enter the target, "down" transitions keep the source.
+            const srcPath = pathOf(src);
+            const tgtPath = pathOf(target);
+            let keep: number;
+            if (srcPath.includes(target)) {
+                keep = tgtPath.length - 1;
+            } else {
+                keep = 0;
+                while (keep < srcPath.length && keep < tgtPath.length && srcPath[keep] === tgtPath[keep]) {
+                    keep++;
+                }
+            }
+            const exits = pathOf(leaf).slice(keep).reverse();
+            const entries = [...tgtPath.slice(keep), ...drill(target)];
+            const exitIds = exits.map(s => stateId.get(s.name)!);
+            const entryIds = entries.map(s => stateId.get(s.name)!);
+            return {
+                guard,
+                action,
+                target: stateId.get(entries[entries.length - 1].name)!,
+                exitOff: addPath(exitIds),
+                exitLen: exitIds.length,
+                entryOff: addPath(entryIds),
+                entryLen: entryIds.length
+            };
+        };
+
+        // Flatten the hierarchy: each (leaf, signal) cell lists the candidate
+        // transitions of the leaf and then of each ancestor, in QHsm order.
+        const chain: number[] = [];
+        const chainOffsets = new Map<string, number>();
+        const cells: Array<Array<[number, number]>> = [];
+        for (const leaf of leaves) {
+            const row: Array<[number, number]> = [];
+            const up = pathOf(leaf).reverse();
+            for (const sig of signals) {
+                const ids: number[] = [];
+                for (const src of up) {
+                    for (const tr of src.transitions) {
+                        if (tr.event === sig) {
+                            ids.push(addTran(flatten(leaf, src, tr)));
+                        }
+                    }
+                }
+                const key = ids.join(',');
+                let off = chainOffsets.get(key);
+                if (off === undefined) {
+                    off = chain.length;
+                    chain.push(...ids);
+                    chainOffsets.set(key, off);
+                }
+                row.push([ids.length === 0 ? 0 : off, ids.length]);
+            }
+            cells.push(row);
+        }
+
+        const initPath = (() => {
+            const init = byName.get(this.stateMachine.initialState);
+            if (!init) {
+                throw new Error(`Unknown initial state '${this.stateMachine.initialState}'`);
+            }
+            const ids = [...pathOf(init), ...drill(init)].map(s => stateId.get(s.name)!);
+            return { off: addPath(ids), len: ids.length, leaf: ids[ids.length - 1] };
+        })();
+
+        // chain_[] holds uint8_t transition indices
+        if (guards.length > 255 || actions.length > 255 || trans.length > 255
+                || chain.length > 0xFFFF || paths.length > 0xFFFF) {
+            throw new Error('Table mode limits exceeded (255 guards/actions/transitions, 65535 table entries)');
+        }
+
+        const idxType = (n: number): string => (n <= 0xFF ? 'uint8_t' : 'uint16_t');
+        const offType = idxType(Math.max(paths.length, chain.length));
+        const stateEnum = (s: State): string => `${NAME}_S_${this.resolveStateName(s.name).toUpperCase()}`;
+
+        if (this.options.includeComments) {
+            lines.push('/*');
+            lines.push(` * ${name}.c`);
+            lines.push(' * Generated by QP Mermaid Extension (table backend)');
+            lines.push(' *');
+            lines.push(' * The state hierarchy is flattened at generation time: every');
+            lines.push(' * (leaf state, signal) cell lists its candidate transitions, own and');
+            lines.push(' * inherited, and each transition carries its precomputed exit/entry');
+            lines.push(' * sequence. QP sees a single state; dispatch is a table lookup.');
+            lines.push(' */');
+            lines.push('');
+        }
+
+        lines.push(`#include "qpc.h"`);
+        lines.push(`#include "${name}.h"`);
+        lines.push(`#include "bsp.h"`);
+        if (this.hasQsDictionary()) {
+            lines.push(`#include "qs_dict.h"`);
+        }
+        lines.push('');
+
+        lines.push('/* State identifiers (leaves first) */');
+        lines.push('enum {');
+        for (const s of ordered) {
+            lines.push(`${ind}${stateEnum(s)},`);
+        }
+        lines.push(`${ind}${NAME}_S_COUNT_,`);
+        lines.push(`${ind}${NAME}_S_NONE_ = 0xFF`);
+        lines.push('};');
+        lines.push('');
+
+        lines.push(`typedef void (*${name}_ActFn)(${name} * const me, QEvt const * const e);`);
+        lines.push(`typedef bool (*${name}_GuardFn)(${name} * const me, QEvt const * const e);`);
+        lines.push('');
+        lines.push('typedef struct {');
+        lines.push(`${ind}uint8_t guard;     /* index into ${name}_guard_[], 0 = none */`);
+        lines.push(`${ind}uint8_t action;    /* index into ${name}_action_[], 0 = none */`);
+        lines.push(`${ind}uint8_t target;    /* leaf after the transition, NONE = internal */`);
+        lines.push(`${ind}uint8_t exitLen;`);
+        lines.push(`${ind}uint8_t entryLen;`);
+        lines.push(`${ind}${offType} exitOff;  /* into ${name}_path_[] */`);
+        lines.push(`${ind}${offType} entryOff;`);
+        lines.push(`} ${name}_Tran;`);
+        lines.push('');
+        lines.push('typedef struct {');
+        lines.push(`${ind}${offType} first;  /* into ${name}_chain_[] */`);
+        lines.push(`${ind}uint8_t count;`);
+        lines.push(`} ${name}_Cell;`);
+        lines.push('');
+
+        // Handlers
+        lines.push(`static QState ${name}_initial(${name} * const me, QEvt const * const e);`);
+        lines.push(`static QState ${name}_active(${name} * const me, QEvt const * const e);`);
+        lines.push('');
+
+        lines.push(`/* Local instance */`);
+        lines.push(`static ${name} l_${name.toLowerCase()};`);
+        lines.push('');
+
+        if (this.stateMachine.type === 'QActive') {
+            lines.push(`/* Global pointer to the ${name} active object */`);
+            lines.push(`QActive * const AO_${name} = &l_${name.toLowerCase()}.super;`);
+            lines.push('');
+        }
+
+        lines.push(...this.generateQsDictionary([`${name}_initial`, `${name}_active`]));
+
+        // Entry/exit actions
+        const actTable = (kind: 'entry' | 'exit'): string[] => {
+            const out: string[] = [];
+            const refs: string[] = [];
+            for (const s of ordered) {
+                const body = kind === 'entry' ? s.entryActions : s.exitActions;
+                if (body.length === 0) {
+                    refs.push(`(${name}_ActFn)0`);
+                    continue;
+                }
+                const fn = `${name}_${kind}_${this.resolveStateName(s.name)}`;
+                out.push(`static void ${fn}(${name} * const me, QEvt const * const e) {`);
+                out.push(`${ind}(void)me;`);
+                out.push(`${ind}(void)e;`);
+                for (const a of body) {
+                    out.push(`${ind}${a};`);
+                }
+                out.push('}');
+                out.push('');
+                refs.push(`&${fn}`);
+            }
+            out.push(`static ${name}_ActFn const ${name}_${kind}_[${NAME}_S_COUNT_] = {`);
+            refs.forEach((r, i) => out.push(`${ind}${r}, /* ${ordered[i].name} */`));
+            out.push('};');
+            out.push('');
+            return out;
+        };
+        lines.push(...actTable('entry'));
+        lines.push(...actTable('exit'));
+
+        // Guards and transition actions
+        for (let i = 1; i < guards.length; i++) {
+            lines.push(`static bool ${name}_guard_${i}(${name} * const me, QEvt const * const e) {`);
+            lines.push(`${ind}(void)me;`);
+            lines.push(`${ind}(void)e;`);
+            lines.push(`${ind}return (${guards[i]});`);
+            lines.push('}');
+            lines.push('');
+        }
+        lines.push(`static ${name}_GuardFn const ${name}_guard_[${guards.length}] = {`);
+        lines.push(`${ind}(${name}_GuardFn)0,`);
+        for (let i = 1; i < guards.length; i++) {
+            lines.push(`${ind}&${name}_guard_${i},`);
+        }
+        lines.push('};');
+        lines.push('');
+        for (let i = 1; i < actions.length; i++) {
+            lines.push(`static void ${name}_action_${i}(${name} * const me, QEvt const * const e) {`);
+            lines.push(`${ind}(void)me;`);
+            lines.push(`${ind}(void)e;`);
+            lines.push(`${ind}${actions[i]};`);
+            lines.push('}');
+            lines.push('');
+        }
+        lines.push(`static ${name}_ActFn const ${name}_action_[${actions.length}] = {`);
+        lines.push(`${ind}(${name}_ActFn)0,`);
+        for (let i = 1; i < actions.length; i++) {
+            lines.push(`${ind}&${name}_action_${i},`);
+        }
+        lines.push('};');
+        lines.push('');
+
+        // ROM tables
+        if (this.options.includeComments) {
+            lines.push('/* Signal -> column (0 = not handled in any state) */');
+        }
+        lines.push(`static uint8_t const ${name}_sigCol_[] = {`);
+        lines.push(`${ind}[0] = 0U,`);
+        signals.forEach((sig, i) => lines.push(`${ind}[${sig}] = ${i + 1}U,`));
+        lines.push('};');
+        lines.push('');
+
+        if (this.options.includeComments) {
+            lines.push('/* Flattened exit/entry sequences (state ids) */');
+        }
+        lines.push(`static uint8_t const ${name}_path_[${Math.max(paths.length, 1)}] = {`);
+        lines.push(`${ind}${paths.length > 0 ? paths.map(p => `${p}U`).join(', ') : '0U'}`);
+        lines.push('};');
+        lines.push('');
+
+        lines.push(`static ${name}_Tran const ${name}_tran_[${Math.max(trans.length, 1)}] = {`);
+        if (trans.length === 0) {
+            lines.push(`${ind}{ 0U, 0U, ${NAME}_S_NONE_, 0U, 0U, 0U, 0U }`);
+        }
+        for (const t of trans) {
+            const target = t.target === 255 ? `${NAME}_S_NONE_` : stateEnum(ordered[t.target]);
+            lines.push(`${ind}{ ${t.guard}U, ${t.action}U, ${target}, ${t.exitLen}U, ${t.entryLen}U, ${t.exitOff}U, ${t.entryOff}U },`);
+        }
+        lines.push('};');
+        lines.push('');
+
+        lines.push(`static uint8_t const ${name}_chain_[${Math.max(chain.length, 1)}] = {`);
+        lines.push(`${ind}${chain.length > 0 ? chain.map(c => `${c}U`).join(', ') : '0U'}`);
+        lines.push('};');
+        lines.push('');
+
+        const sigDim = Math.max(signals.length, 1);
+        lines.push(`static ${name}_Cell const ${name}_cell_[${leaves.length}][${sigDim}] = {`);
+        leaves.forEach((leaf, i) => {
+            const row = cells[i].length > 0 ? cells[i].map(([f, c]) => `{ ${f}U, ${c}U }`).join(', ') : '{ 0U, 0U }';
+            lines.push(`${ind}{ ${row} }, /* ${leaf.name} */`);
+        });
+        lines.push('};');
+        lines.push('');
+
+        // Runtime
+        lines.push(`static void ${name}_run_(${name} * const me, ${name}_ActFn const * const fn,`);
+        lines.push(`${ind}${ind}${ind}${ind}${offType} const off, uint_fast8_t const len) {`);
+        lines.push(`${ind}for (uint_fast8_t i = 0U; i < len; ++i) {`);
+        lines.push(`${ind}${ind}${name}_ActFn const f = fn[${name}_path_[off + i]];`);
+        lines.push(`${ind}${ind}if (f != (${name}_ActFn)0) {`);
+        lines.push(`${ind}${ind}${ind}(*f)(me, (QEvt const *)0);`);
+        lines.push(`${ind}${ind}}`);
+        lines.push(`${ind}}`);
+        lines.push('}');
+        lines.push('');
+
+        lines.push(`static bool ${name}_dispatch_(${name} * const me, QEvt const * const e) {`);
+        lines.push(`${ind}if (e->sig >= Q_DIM(${name}_sigCol_)) {`);
+        lines.push(`${ind}${ind}return false;`);
+        lines.push(`${ind}}`);
+        lines.push(`${ind}uint_fast8_t const col = ${name}_sigCol_[e->sig];`);
+        lines.push(`${ind}if (col == 0U) {`);
+        lines.push(`${ind}${ind}return false;`);
+        lines.push(`${ind}}`);
+        lines.push(`${ind}${name}_Cell const * const cell = &${name}_cell_[me->state_][col - 1U];`);
+        lines.push(`${ind}for (uint_fast8_t i = 0U; i < cell->count; ++i) {`);
+        lines.push(`${ind}${ind}${name}_Tran const * const t = &${name}_tran_[${name}_chain_[cell->first + i]];`);
+        lines.push(`${ind}${ind}if ((t->guard != 0U) && !(*${name}_guard_[t->guard])(me, e)) {`);
+        lines.push(`${ind}${ind}${ind}continue;`);
+        lines.push(`${ind}${ind}}`);
+        lines.push(`${ind}${ind}if (t->action != 0U) {`);
+        lines.push(`${ind}${ind}${ind}(*${name}_action_[t->action])(me, e);`);
+        lines.push(`${ind}${ind}}`);
+        lines.push(`${ind}${ind}if (t->target != ${NAME}_S_NONE_) {`);
+        lines.push(`${ind}${ind}${ind}${name}_run_(me, ${name}_exit_, t->exitOff, t->exitLen);`);
+        lines.push(`${ind}${ind}${ind}${name}_run_(me, ${name}_entry_, t->entryOff, t->entryLen);`);
+        lines.push(`${ind}${ind}${ind}me->state_ = t->target;`);
+        lines.push(`${ind}${ind}}`);
+        lines.push(`${ind}${ind}return true;`);
+        lines.push(`${ind}}`);
+        lines.push(`${ind}return false;`);
+        lines.push('}');
+        lines.push('');
+
+        // Constructor
+        lines.push(`void ${name}_ctor(${name} * const me) {`);
+        lines.push(`${ind}${this.stateMachine.type}_ctor(&me->super, Q_STATE_CAST(&${name}_initial));`);
+        for (const member of this.stateMachine.dataMembers) {
+            if (member.type === 'QTimeEvt') {
+                lines.push(`${ind}QTimeEvt_ctorX(&me->${member.name}, &me->super, TIMEOUT_SIG, 0U);`);
+            }
+        }
+        lines.push(`${ind}me->state_ = ${NAME}_S_NONE_;`);
+        lines.push('}');
+        lines.push('');
+
+        lines.push(`/* Initial transition: enter the precomputed path to the initial leaf */`);
+        lines.push(`static QState ${name}_initial(${name} * const me, QEvt const * const e) {`);
+        lines.push(`${ind}(void)e; /* avoid compiler warning */`);
+        if (this.hasQsDictionary()) {
+            lines.push(`${ind}QS_DICT_SEND(${name});`);
+        }
+        lines.push(`${ind}${name}_run_(me, ${name}_entry_, ${initPath.off}U, ${initPath.len}U);`);
+        lines.push(`${ind}me->state_ = ${stateEnum(ordered[initPath.leaf])};`);
+        lines.push(`${ind}return Q_TRAN(&${name}_active);`);
+        lines.push('}');
+        lines.push('');
+
+        lines.push(`/* The only state QP sees; the hierarchy lives in the tables above */`);
+        lines.push(`static QState ${name}_active(${name} * const me, QEvt const * const e) {`);
+        lines.push(`${ind}return ${name}_dispatch_(me, e) ? Q_HANDLED() : Q_SUPER(&QHsm_top);`);
+        lines.push('}');
+        lines.push('');
+
+        if (this.options.includeComments) {
+            const rom = paths.length + chain.length + trans.length * (5 + 2 * (offType === 'uint8_t' ? 1 : 2))
+                + leaves.length * sigDim * (1 + (offType === 'uint8_t' ? 1 : 2));
+            lines.push(`/* Table footprint: ${ordered.length} states, ${signals.length} signals, ` +
+                `${trans.length} transitions, ~${rom} bytes of const data */`);
+        }
+
+        return lines.join('\n');
+    }
+
+    private hasQsDictionary(): boolean {
+        return this.options.qsDictionary !== false;
+    }
+
+    /**
+     * QS dictionaries as one const table (templates/services/qs_dict.h),
+     * sent by the initial transition in place of QS_*_DICTIONARY() calls
+     */
+    private generateQsDictionary(handlers: string[]): string[] {
+        if (!this.hasQsDictionary()) {
+            return [];
+        }
+        const name = this.stateMachine.name;
+        const obj = `&l_${name.toLowerCase()}`;
+        const lines: string[] = [];
+
+        if (this.options.includeComments) {
+            lines.push('/* QS dictionaries (with QS_DICT_ROM_ENABLE only their build ID is sent) */');
+        }
+        lines.push('#ifdef Q_SPY');
+        lines.push(`static QS_DICT_TABLE(${name}) = {`);
+        lines.push(`${this.indent}QS_DICT_OBJ(${obj}),`);
+        for (const member of this.stateMachine.dataMembers) {
+            if (member.type === 'QTimeEvt') {
+                lines.push(`${this.indent}QS_DICT_OBJ(${obj}.${member.name}),`);
+            }
+        }
+        for (const event of this.stateMachine.events) {
+            lines.push(`${this.indent}QS_DICT_SIG(${event.name}, ${obj}),`);
+        }
+        for (const handler of handlers) {
+            lines.push(`${this.indent}QS_DICT_FUN(&${handler}),`);
+        }
+        lines.push('};');
+        lines.push('#endif');
+        lines.push('');
+        return lines;
+    }
+
+    private generateBenchmark(): string {
+        const name = this.stateMachine.name;
+        const NAME = name.toUpperCase();
+        const ind = this.indent;
+        const mode = this.isTableMode() ? 'table' : 'switch';
+        const signals: string[] = [];
+        for (const state of this.getAllStates()) {
+            for (const t of state.transitions) {
+                if (!t.event.startsWith('@') && !signals.includes(t.event)) {
+                    signals.push(t.event);
+                }
+            }
+        }
+        const lines: string[] = [];
+
+        lines.push('/*');
+        lines.push(` * ${name}_bench.c`);
+        lines.push(` * Dispatch benchmark generated by QP Mermaid Extension (${mode} backend)`);
+        lines.push(' *');
+        lines.push(` * Build this file with ${name}.c generated in "switch" mode and again in`);
+        lines.push(' * "table" mode, against the same QP port and BSP, and compare the');
+        lines.push(' * reported time per event. Events are dispatched round-robin so both');
+        lines.push(' * handled and inherited/unhandled lookups are exercised.');
+        lines.push(' */');
+        lines.push('');
+        lines.push('#include "qpc.h"');
+        lines.push(`#include "${name}.h"`);
+        lines.push('#include <stdio.h>');
+        lines.push('');
+        lines.push(`#ifndef ${NAME}_BENCH_ITERATIONS`);
+        lines.push(`#define ${NAME}_BENCH_ITERATIONS 100000UL`);
+        lines.push('#endif');
+        lines.push('');
+        lines.push('/* Override with a cycle counter (e.g. BSP_cycles) on target */');
+        lines.push(`#ifndef ${NAME}_BENCH_NOW`);
+        lines.push('#include <time.h>');
+        lines.push(`#define ${NAME}_BENCH_NOW()   ((uint32_t)clock())`);
+        lines.push(`#define ${NAME}_BENCH_UNITS   "clock ticks"`);
+        lines.push('#endif');
+        lines.push(`#ifndef ${NAME}_BENCH_UNITS`);
+        lines.push(`#define ${NAME}_BENCH_UNITS   "cycles"`);
+        lines.push('#endif');
+        lines.push('');
+        lines.push('static QEvt const l_benchEvts[] = {');
+        if (signals.length === 0) {
+            lines.push(`${ind}QEVT_INITIALIZER(Q_USER_SIG),`);
+        }
+        for (const sig of signals) {
+            lines.push(`${ind}QEVT_INITIALIZER(${sig}),`);
+        }
+        lines.push('};');
+        lines.push('');
+        lines.push(`static ${name} l_benchSm;`);
+        lines.push('');
+        lines.push('int main(void) {');
+        lines.push(`${ind}QHsm * const sm = (QHsm *)&l_benchSm;`);
+        lines.push('');
+        lines.push(`${ind}${name}_ctor(&l_benchSm);`);
+        lines.push(`${ind}QHSM_INIT(sm, (void *)0, 0U);`);
+        lines.push('');
+        lines.push(`${ind}uint32_t const start = ${NAME}_BENCH_NOW();`);
+        lines.push(`${ind}for (unsigned long i = 0UL; i < ${NAME}_BENCH_ITERATIONS; ++i) {`);
+        lines.push(`${ind}${ind}QHSM_DISPATCH(sm, &l_benchEvts[i % Q_DIM(l_benchEvts)], 0U);`);
+        lines.push(`${ind}}`);
+        lines.push(`${ind}uint32_t const elapsed = ${NAME}_BENCH_NOW() - start;`);
+        lines.push('');
+        lines.push(`${ind}printf("${name} ${mode}: %lu events, %lu %s, %.3f per event\\n",`);
+        lines.push(`${ind}${ind}${ind}${NAME}_BENCH_ITERATIONS, (unsigned long)elapsed, ${NAME}_BENCH_UNITS,`);
+        lines.push(`${ind}${ind}${ind}(double)elapsed / (double)${NAME}_BENCH_ITERATIONS);`);
+        lines.push(`${ind}return 0;`);
+        lines.push('}');
+        lines.push('');
+
+        return lines.join('\n');
+    }
+
     private getAllStates(): State[] {
         const states: State[] = [];
         
@@ -49,10 +49,63 @@ export interface Parameter {
 export interface GeneratorOptions {
     language: 'C' | 'C++';
     includeComments: boolean;
+    /** 'switch' emits nested switch handlers, 'table' emits const dispatch tables */
+    mode?: 'switch' | 'table';
+    /** Also emit a host dispatch benchmark for the selected mode */
+    emitBenchmark?: boolean;
+    /** Switch mode: hot signal cases first, hot internal handlers hoisted into leaves */
+    dispatchReport?: DispatchReport;
+    /** Emit the QS dictionaries as a const qs_dict.h table (default: true) */
+    qsDictionary?: boolean;
+}
+
+/** QHsm dispatch cost of one signal while one leaf state is active */
+export interface DispatchCost {
+    state: string;
+    signal: string;
+    hot: boolean;
+    /** State handlers called until the first candidate (1 = the leaf itself) */
+    depth: number;
+    /** Same, when all guards fail until an unguarded handler or QHsm_top */
+    maxDepth: number;
+    /** State of the first candidate, undefined = unhandled */
+    handledBy?: string;
+    internal: boolean;
+    guarded: boolean;
+    /** States exited and entered (including initial drill-down) */
+    exits: number;
+    entries: number;
+    /** Entry/exit/transition action statements run */
+    actions: number;
+    /** depth + exits + entries */
+    calls: number;
+    /** Unguarded internal handler of a superstate, safe to copy into the leaf */
+    hoistable: boolean;
+}
+
+/** Per-signal summary over all reachable leaves */
+export interface SignalCost {
+    signal: string;
+    hot: boolean;
+    handledIn: number;
+    unhandledIn: number;
+    maxDepth: number;
+    meanDepth: number;
+    maxCalls: number;
+    maxActions: number;
+}
+
+export interface DispatchReport {
+    stateMachine: string;
+    hotSignals: string[];
+    depthLimit: number;
+    signals: SignalCost[];
+    costs: DispatchCost[];
 }
 
 export interface GeneratedCode {
     header: string;
     source: string;
     interface?: string;
+    benchmark?: string;
 }
\ No newline at end of file
@@ -1,4 +1,4 @@
-import { StateMachine, State, Transition } from '../types/stateMachine';
+import { StateMachine, State, Transition, DispatchCost, DispatchReport, SignalCost } from '../types/stateMachine';
 
 export interface ValidationError {
     severity: 'error' | 'warning' | 'info';
@@ -10,14 +10,25 @@ export interface ValidationError {
     };
 }
 
+export interface DispatchOptions {
+    /** Signals dispatched often enough to matter, with or without _SIG */
+    hotSignals?: string[];
+    /** Handler levels a hot signal may walk before it is flagged */
+    depthLimit?: number;
+}
+
+const DEFAULT_HOT_SIGNALS = ['TIMEOUT', 'TICK'];
+const DEFAULT_DEPTH_LIMIT = 2;
+
 /**
  * Validates QP state machines for correctness and best practices
  */
 export class StateMachineValidator {
     private errors: ValidationError[] = [];
     private visitedStates: Set<string> = new Set();
+    private dispatchReport?: DispatchReport;
 
-    validate(stateMachine: StateMachine): ValidationError[] {
+    validate(stateMachine: StateMachine, options: DispatchOptions = {}): ValidationError[] {
         this.errors = [];
         this.visitedStates.clear();
 
@@ -36,9 +47,18 @@ export class StateMachineValidator {
         // QP-specific validations
         this.validateQPConventions(stateMachine);
 
+        // Run-time cost of hot signals
+        this.dispatchReport = this.analyzeDispatch(stateMachine, options);
+        this.checkDispatchCost(this.dispatchReport);
+
         return this.errors;
     }
 
+    /** Dispatch report of the last validate() run */
+    getDispatchReport(): DispatchReport | undefined {
+        return this.dispatchReport;
+    }
+
     private validateBasicStructure(stateMachine: StateMachine) {
         // Must have a name
         if (!stateMachine.name || stateMachine.name === 'StateMachine') {
@@ -156,6 +176,12 @@ export class StateMachineValidator {
             return;
         }
 
+        // An active state keeps its superstates active: their transitions
+        // are inherited
+        if (state.parent) {
+            this.traverseFromState(state.parent, allStates);
+        }
+
         // Visit all transition targets
         for (const transition of state.transitions) {
             if (!transition.isInternal) {
@@ -273,6 +299,191 @@ export class StateMachineValidator {
         }
     }
 
+    /**
+     * Computes the QHsm dispatch cost of every signal in every reachable
+     * leaf: handler levels walked until the event is handled, and the
+     * exits, entries and actions of the transition it takes. The LCA search
+     * QHsm does on the first run of a transition is not counted.
+     */
+    analyzeDispatch(stateMachine: StateMachine, options: DispatchOptions = {}): DispatchReport {
+        const hotSignals = options.hotSignals ?? DEFAULT_HOT_SIGNALS;
+        const depthLimit = options.depthLimit ?? DEFAULT_DEPTH_LIMIT;
+        const allStates = this.collectStates(stateMachine.states);
+        const byName = new Map<string, State>(allStates.map(s => [s.name, s] as [string, State]));
+        const lookup = (name: string): State | undefined =>
+            byName.get(name) ?? byName.get(name.split('.').pop()!);
+
+        const pathOf = (state: State): State[] => {
+            const path: State[] = [];
+            let s: State | undefined = state;
+            while (s) {
+                path.unshift(s);
+                s = s.parent ? lookup(s.parent) : undefined;
+            }
+            return path;
+        };
+        const drill = (state: State): State[] => {
+            const path: State[] = [];
+            let s = state;
+            while (s.children.length > 0) {
+                const init = s.initialTransition ? lookup(s.initialTransition.target) : undefined;
+                s = init ?? s.children[0];
+                path.push(s);
+            }
+            return path;
+        };
+
+        // Only leaves the machine can get into; all leaves if the initial
+        // state is missing (reported by the structural checks)
+        this.visitedStates.clear();
+        if (stateMachine.initialState) {
+            this.traverseFromState(stateMachine.initialState, stateMachine.states);
+        }
+        let leaves = allStates.filter(s => s.children.length === 0 && this.visitedStates.has(s.name));
+        if (leaves.length === 0) {
+            leaves = allStates.filter(s => s.children.length === 0);
+        }
+
+        const signals: string[] = [];
+        for (const state of allStates) {
+            for (const t of state.transitions) {
+                if (t.event && !t.event.startsWith('@') && !signals.includes(t.event)) {
+                    signals.push(t.event);
+                }
+            }
+        }
+
+        const costs: DispatchCost[] = [];
+        for (const leaf of leaves) {
+            const up = pathOf(leaf).reverse();
+            for (const signal of signals) {
+                let first: { src: State; tr: Transition; depth: number } | undefined;
+                let maxDepth = up.length + 1;   // Unhandled: QHsm_top is called last
+                search:
+                for (let i = 0; i < up.length; i++) {
+                    for (const tr of up[i].transitions) {
+                        if (tr.event !== signal) {
+                            continue;
+                        }
+                        first = first ?? { src: up[i], tr, depth: i + 1 };
+                        if (!tr.guard) {
+                            maxDepth = i + 1;
+                            break search;
+                        }
+                    }
+                }
+
+                let exits = 0;
+                let entries = 0;
+                let actions = 0;
+                if (first) {
+                    actions = first.tr.action ? 1 : 0;
+                    const target = first.tr.isInternal ? undefined : lookup(first.tr.target);
+                    if (target) {
+                        // Same LCA rule as QHsm and the table backend
+                        const srcPath = pathOf(first.src);
+                        const tgtPath = pathOf(target);
+                        let keep: number;
+                        if (srcPath.includes(target)) {
+                            keep = tgtPath.length - 1;
+                        } else {
+                            keep = 0;
+                            while (keep < srcPath.length && keep < tgtPath.length && srcPath[keep] === tgtPath[keep]) {
+                                keep++;
+                            }
+                        }
+                        const exited = pathOf(leaf).slice(keep);
+                        const entered = [...tgtPath.slice(keep), ...drill(target)];
+                        exits = exited.length;
+                        entries = entered.length;
+                        actions += exited.reduce((n, s) => n + s.exitActions.length, 0)
+                            + entered.reduce((n, s) => n + s.entryActions.length, 0);
+                    }
+                }
+
+                const depth = first ? first.depth : maxDepth;
+                costs.push({
+                    state: leaf.name,
+                    signal,
+                    hot: this.isHotSignal(signal, hotSignals),
+                    depth,
+                    maxDepth,
+                    handledBy: first?.src.name,
+                    internal: first?.tr.isInternal === true,
+                    guarded: first?.tr.guard !== undefined,
+                    exits,
+                    entries,
+                    actions,
+                    calls: depth + exits + entries,
+                    hoistable: first !== undefined && first.depth > 1
+                        && first.tr.isInternal === true && !first.tr.guard
+                });
+            }
+        }
+
+        const summary: SignalCost[] = signals.map(signal => {
+            const own = costs.filter(c => c.signal === signal);
+            const handled = own.filter(c => c.handledBy !== undefined);
+            return {
+                signal,
+                hot: this.isHotSignal(signal, hotSignals),
+                handledIn: handled.length,
+                unhandledIn: own.length - handled.length,
+                maxDepth: Math.max(0, ...handled.map(c => c.maxDepth)),
+                meanDepth: handled.length > 0
+                    ? Math.round(100 * handled.reduce((n, c) => n + c.depth, 0) / handled.length) / 100
+                    : 0,
+                maxCalls: Math.max(0, ...handled.map(c => c.calls)),
+                maxActions: Math.max(0, ...handled.map(c => c.actions))
+            };
+        });
+
+        return {
+            stateMachine: stateMachine.name,
+            hotSignals,
+            depthLimit,
+            signals: summary,
+            costs
+        };
+    }
+
+    private checkDispatchCost(report: DispatchReport) {
+        for (const cost of report.costs) {
+            if (!cost.hot) {
+                continue;
+            }
+            if (cost.handledBy === undefined) {
+                // Often fine (the time event is disarmed there), but each
+                // occurrence walks the whole hierarchy to be discarded
+                if (cost.depth > report.depthLimit) {
+                    this.addError('info',
+                        `Hot signal '${cost.signal}' is not handled in '${cost.state}': ` +
+                        `${cost.depth} handler calls to discard it`,
+                        { state: cost.state, transition: cost.signal });
+                }
+            } else if (cost.depth > report.depthLimit) {
+                const hint = cost.hoistable ? '; the internal handler can be hoisted into the leaf' : '';
+                this.addError('warning',
+                    `Hot signal '${cost.signal}' in '${cost.state}' is handled ${cost.depth - 1} ` +
+                    `level(s) up in '${cost.handledBy}': ${cost.calls} handler calls per event${hint}`,
+                    { state: cost.state, transition: cost.signal });
+            }
+        }
+    }
+
+    private isHotSignal(signal: string, hotSignals: string[]): boolean {
+        const base = (name: string) => name.replace(/_SIG$/, '');
+        return hotSignals.some(h => base(h) === base(signal));
+    }
+
+    private collectStates(states: State[]): State[] {
+        const all: State[] = [];
+        for (const state of states) {
+            all.push(state, ...this.collectStates(state.children));
+        }
+        return all;
+    }
+
     private hasTimeoutEvents(states: State[]): boolean {
         for (const state of states) {
             if (state.transitions.some(t => t.event === 'TIMEOUT')) {